@@ -0,0 +1,123 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "async_command_exec.hpp"
+#include "io_ring.hpp"
+
+#include <sdbusplus/async.hpp>
+
+#include <fstream>
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+namespace
+{
+
+/**
+ * @brief Get the read syscalls of the process so far.
+ */
+uint64_t readSyscalls()
+{
+    std::ifstream ioStats("/proc/self/io");
+    std::string name;
+    uint64_t value{0};
+    while (ioStats >> name >> value)
+    {
+        if (name == "syscr:")
+        {
+            return value;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Run the benchmark loop on the event loop, as the commands can only
+ *        be awaited from a coroutine.
+ */
+// NOLINTNEXTLINE
+sdbusplus::async::task<> execCommands(sdbusplus::async::context& ctx,
+                                      benchmark::State& state,
+                                      const std::string& cmd)
+{
+    data_sync::async::AsyncCommandExecutor executor(ctx);
+    for (auto _ : state)
+    {
+        // NOLINTNEXTLINE
+        auto result = co_await executor.execCmd(cmd);
+        benchmark::DoNotOptimize(result);
+    }
+    ctx.request_stop();
+    co_return;
+}
+
+} // namespace
+
+static void bmExecCmd(benchmark::State& state)
+{
+    sdbusplus::async::context ctx;
+    ctx.spawn(execCommands(ctx, state, "true"));
+    ctx.run();
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(bmExecCmd)->UseRealTime();
+
+static void bmExecCmdWithOutput(benchmark::State& state)
+{
+    // Output similar in size to the rsync --stats report
+    const std::string cmd = "head -c " + std::to_string(state.range(0)) +
+                            " /dev/zero";
+
+    sdbusplus::async::context ctx;
+    ctx.spawn(execCommands(ctx, state, cmd));
+    ctx.run();
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(bmExecCmdWithOutput)->Arg(1024)->Arg(64 * 1024)->UseRealTime();
+
+// The same commands with the output read through the io_uring of the event
+// loop, besides the time and the CPU per command, the syscalls per 1k of them
+// are reported for both the backends: the read syscalls of the process, and
+// the io_uring submissions and wake ups.
+static void bmExecCmdWithOutputBackends(benchmark::State& state)
+{
+    const std::string cmd = "head -c " + std::to_string(state.range(1)) +
+                            " /dev/zero";
+
+    sdbusplus::async::context ctx;
+    std::unique_ptr<data_sync::io::Ring> ring;
+    if (state.range(0) != 0)
+    {
+        ring = data_sync::io::start(ctx);
+        if (!ring)
+        {
+            state.SkipWithError("io_uring isn't available");
+            return;
+        }
+    }
+
+    const auto readsBefore = readSyscalls();
+    ctx.spawn(execCommands(ctx, state, cmd));
+    ctx.run();
+
+    const auto perThousand = [&state](uint64_t count) {
+        return benchmark::Counter(
+            static_cast<double>(count) * 1000 /
+            static_cast<double>(std::max<int64_t>(state.iterations(), 1)));
+    };
+    state.counters["reads_per_1k"] = perThousand(readSyscalls() - readsBefore);
+    if (ring)
+    {
+        state.counters["submits_per_1k"] = perThousand(ring->stats().submits);
+        state.counters["wakeups_per_1k"] = perThousand(ring->stats().wakeUps);
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * state.range(1));
+}
+BENCHMARK(bmExecCmdWithOutputBackends)
+    ->ArgNames({"io_uring", "bytes"})
+    ->ArgsProduct({{0, 1}, {1024, 64 * 1024}})
+    ->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,48 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <sdbusplus/async.hpp>
+
+#include <cstdlib>
+#include <filesystem>
+
+namespace bench
+{
+
+/**
+ * @brief A temporary directory which is removed along with its contents.
+ */
+struct TmpDir
+{
+    TmpDir()
+    {
+        char tmpDir[] = "/tmp/pdsBenchXXXXXX";
+        path = mkdtemp(tmpDir);
+    }
+
+    ~TmpDir()
+    {
+        std::filesystem::remove_all(path);
+    }
+
+    TmpDir(const TmpDir&) = delete;
+    TmpDir& operator=(const TmpDir&) = delete;
+    TmpDir(TmpDir&&) = delete;
+    TmpDir& operator=(TmpDir&&) = delete;
+
+    std::filesystem::path path;
+};
+
+/**
+ * @brief Run the context until the already spawned work gets a chance to run
+ *        and stop it, so that it can be destroyed.
+ */
+inline void stopContext(sdbusplus::async::context& ctx)
+{
+    ctx.spawn(sdbusplus::async::execution::just() |
+              sdbusplus::async::execution::then(
+                  [&ctx]() { ctx.request_stop(); }));
+    ctx.run();
+}
+
+} // namespace bench
@@ -0,0 +1,79 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "bench_common.hpp"
+#include "chunk_store.hpp"
+
+#include <fstream>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+namespace
+{
+
+void appendRandom(const std::filesystem::path& path, size_t size,
+                  std::mt19937& gen)
+{
+    std::vector<char> data(size);
+    for (auto& byte : data)
+    {
+        byte = static_cast<char>(gen());
+    }
+    std::ofstream file(path, std::ios::binary | std::ios::app);
+    file.write(data.data(), static_cast<std::streamsize>(data.size()));
+}
+
+} // namespace
+
+static void bmSplitChunks(benchmark::State& state)
+{
+    std::mt19937 gen(1);
+    std::vector<uint8_t> data(static_cast<size_t>(state.range(0)));
+    for (auto& byte : data)
+    {
+        byte = static_cast<uint8_t>(gen());
+    }
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(data_sync::backup::splitChunks(data));
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(bmSplitChunks)->Arg(64 * 1024)->Arg(1024 * 1024);
+
+// Back up a growing log and a set of rarely changing configs as the sibling
+// data, reporting the cost against keeping plain copies of the versions.
+static void bmBackupVersions(benchmark::State& state)
+{
+    bench::TmpDir tmpDir;
+    const auto sourceDir = tmpDir.path / "source";
+    std::filesystem::create_directories(sourceDir);
+    std::mt19937 gen(2);
+    appendRandom(sourceDir / "events.log", 1024 * 1024, gen);
+    for (int i = 0; i < 16; ++i)
+    {
+        appendRandom(sourceDir / ("config" + std::to_string(i)), 2048, gen);
+    }
+
+    data_sync::backup::ChunkStore store(tmpDir.path / "store",
+                                        static_cast<size_t>(state.range(0)));
+    uint64_t logicalBytes{0};
+    uint64_t writtenBytes{0};
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        appendRandom(sourceDir / "events.log", 4096, gen);
+        state.ResumeTiming();
+
+        const auto stats = store.backup(sourceDir);
+        logicalBytes += stats.logicalBytes;
+        writtenBytes += stats.writtenBytes;
+    }
+
+    state.counters["WriteAmplification"] =
+        static_cast<double>(writtenBytes) / static_cast<double>(logicalBytes);
+    state.counters["DedupRatio"] = store.stats().dedupRatio();
+}
+BENCHMARK(bmBackupVersions)->Arg(5)->Arg(20)->Iterations(50);
@@ -0,0 +1,173 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "bench_common.hpp"
+#include "data_watcher.hpp"
+
+#include <sys/inotify.h>
+
+#include <sdbusplus/async.hpp>
+
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+namespace fs = std::filesystem;
+namespace inotify = data_sync::watch::inotify;
+
+namespace
+{
+
+/**
+ * @brief Exposes the event handling stages of the DataWatcher.
+ */
+class BenchDataWatcher : public inotify::DataWatcher
+{
+  public:
+    using inotify::DataWatcher::DataWatcher;
+    using inotify::DataWatcher::isPathExcluded;
+    using inotify::DataWatcher::isPathIncluded;
+    using inotify::DataWatcher::parseEvents;
+    using inotify::DataWatcher::processEvents;
+    using inotify::DataWatcher::readEvents;
+};
+
+/**
+ * @brief Build a buffer of inotify events as the kernel would return them.
+ */
+std::vector<uint8_t> makeEventBuffer(int wd, size_t numEvents, uint32_t mask)
+{
+    std::vector<uint8_t> buffer;
+    for (size_t i = 0; i < numEvents; ++i)
+    {
+        const std::string name = "file" + std::to_string(i);
+        // The kernel pads the name to keep the next event aligned
+        const size_t nameLen = (name.size() + sizeof(inotify_event)) &
+                               ~(sizeof(inotify_event) - 1);
+
+        inotify_event event{};
+        event.wd = wd;
+        event.mask = mask;
+        event.len = static_cast<uint32_t>(nameLen);
+
+        const auto offset = buffer.size();
+        buffer.resize(offset + sizeof(inotify_event) + nameLen, 0);
+        std::memcpy(&buffer[offset], &event, sizeof(inotify_event));
+        std::memcpy(&buffer[offset + sizeof(inotify_event)], name.data(),
+                    name.size());
+    }
+    return buffer;
+}
+
+std::vector<inotify::EventInfo> makeEvents(int wd, size_t numEvents,
+                                           uint32_t mask)
+{
+    std::vector<inotify::EventInfo> events;
+    events.reserve(numEvents);
+    for (size_t i = 0; i < numEvents; ++i)
+    {
+        events.emplace_back(wd, "file" + std::to_string(i), mask, 0);
+    }
+    return events;
+}
+
+std::unordered_set<fs::path> makePathList(const fs::path& root, size_t size)
+{
+    std::unordered_set<fs::path> paths;
+    for (size_t i = 0; i < size; ++i)
+    {
+        paths.emplace(root / ("dir" + std::to_string(i)) / "data");
+    }
+    return paths;
+}
+
+} // namespace
+
+static void bmParseEvents(benchmark::State& state)
+{
+    sdbusplus::async::context ctx;
+    bench::TmpDir dir;
+    BenchDataWatcher watcher(ctx, IN_NONBLOCK | IN_CLOEXEC,
+                             IN_CLOSE_WRITE | IN_CREATE | IN_DELETE, dir.path);
+
+    const auto wd = watcher.getWatchDescriptors().begin()->first;
+    const auto buffer = makeEventBuffer(wd, state.range(0), IN_CLOSE_WRITE);
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(watcher.parseEvents(buffer));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetBytesProcessed(state.iterations() * buffer.size());
+
+    bench::stopContext(ctx);
+}
+BENCHMARK(bmParseEvents)->RangeMultiplier(8)->Range(1, 512);
+
+static void bmProcessEvents(benchmark::State& state)
+{
+    sdbusplus::async::context ctx;
+    bench::TmpDir dir;
+    BenchDataWatcher watcher(ctx, IN_NONBLOCK | IN_CLOEXEC,
+                             IN_CLOSE_WRITE | IN_CREATE | IN_DELETE, dir.path);
+
+    const auto wd = watcher.getWatchDescriptors().begin()->first;
+    const auto events = makeEvents(wd, state.range(0), IN_CLOSE_WRITE);
+
+    for (auto _ : state)
+    {
+        watcher.processEvents(events);
+
+        // Clears the accumulated operations, returns as no events pending
+        state.PauseTiming();
+        benchmark::DoNotOptimize(watcher.readEvents());
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+
+    bench::stopContext(ctx);
+}
+BENCHMARK(bmProcessEvents)->RangeMultiplier(8)->Range(1, 512);
+
+static void bmIsPathExcluded(benchmark::State& state)
+{
+    sdbusplus::async::context ctx;
+    bench::TmpDir dir;
+    BenchDataWatcher watcher(ctx, IN_NONBLOCK | IN_CLOEXEC,
+                             IN_CLOSE_WRITE | IN_CREATE | IN_DELETE, dir.path,
+                             makePathList(dir.path, state.range(0)));
+
+    // Worst case, a path which doesn't match any of the excluded paths
+    const auto path = dir.path / "other" / "dir" / "file";
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(watcher.isPathExcluded(path));
+    }
+
+    bench::stopContext(ctx);
+}
+BENCHMARK(bmIsPathExcluded)->RangeMultiplier(4)->Range(1, 1024);
+
+static void bmIsPathIncluded(benchmark::State& state)
+{
+    sdbusplus::async::context ctx;
+    bench::TmpDir dir;
+    BenchDataWatcher watcher(ctx, IN_NONBLOCK | IN_CLOEXEC,
+                             IN_CLOSE_WRITE | IN_CREATE | IN_DELETE, dir.path,
+                             std::nullopt,
+                             makePathList(dir.path, state.range(0)));
+
+    const auto path = dir.path / "other" / "dir" / "file";
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(watcher.isPathIncluded(path));
+    }
+
+    bench::stopContext(ctx);
+}
+BENCHMARK(bmIsPathIncluded)->RangeMultiplier(4)->Range(1, 1024);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,91 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "bench_common.hpp"
+#include "manager.hpp"
+#include "mock_ext_data_ifaces.hpp"
+
+#include <nlohmann/json.hpp>
+#include <sdbusplus/async.hpp>
+
+#include <memory>
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+namespace ed = data_sync::ext_data;
+
+namespace
+{
+
+/**
+ * @brief Exposes the rsync command framing of the Manager.
+ */
+class BenchManager : public data_sync::Manager
+{
+  public:
+    using data_sync::Manager::getRsyncCmd;
+    using data_sync::Manager::Manager;
+};
+
+std::unique_ptr<ed::ExternalDataIFaces> makeExtDataIfaces()
+{
+    auto extDataIfaces = std::make_unique<
+        testing::NiceMock<ed::MockExternalDataIFaces>>();
+
+    ON_CALL(*extDataIfaces, fetchBMCRedundancyMgrProps())
+        // NOLINTNEXTLINE
+        .WillByDefault([]() -> sdbusplus::async::task<> { co_return; });
+    ON_CALL(*extDataIfaces, fetchBMCPosition())
+        // NOLINTNEXTLINE
+        .WillByDefault([]() -> sdbusplus::async::task<> { co_return; });
+    ON_CALL(*extDataIfaces, watchRedundancyMgrProps())
+        // NOLINTNEXTLINE
+        .WillByDefault([]() -> sdbusplus::async::task<> { co_return; });
+
+    return extDataIfaces;
+}
+
+nlohmann::json makeConfig(size_t excludeListSize)
+{
+    nlohmann::json config = {{"Path", "/var/lib/phosphor-bench/"},
+                             {"Description", "Benchmark data"},
+                             {"SyncDirection", "Active2Passive"},
+                             {"SyncType", "Immediate"}};
+    if (excludeListSize != 0)
+    {
+        auto excludeList = nlohmann::json::array();
+        for (size_t i = 0; i < excludeListSize; ++i)
+        {
+            excludeList.push_back("/var/lib/phosphor-bench/exclude" +
+                                  std::to_string(i));
+        }
+        config["ExcludeList"] = std::move(excludeList);
+    }
+    return config;
+}
+
+} // namespace
+
+static void bmGetRsyncCmd(benchmark::State& state)
+{
+    sdbusplus::async::context ctx;
+    bench::TmpDir cfgDir;
+    BenchManager manager(ctx, makeExtDataIfaces(), cfgDir.path);
+
+    const data_sync::config::DataSyncConfig dataSyncCfg(
+        makeConfig(state.range(0)), true);
+    const std::string srcPath = "/var/lib/phosphor-bench/dir/file";
+
+    for (auto _ : state)
+    {
+        std::string cmd;
+        manager.getRsyncCmd(data_sync::RsyncMode::Sync, dataSyncCfg, srcPath,
+                            cmd);
+        benchmark::DoNotOptimize(cmd);
+    }
+
+    bench::stopContext(ctx);
+}
+BENCHMARK(bmGetRsyncCmd)->Arg(0)->Arg(8)->Arg(64);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,92 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "bench_common.hpp"
+#include "data_sync_config.hpp"
+#include "persistent.hpp"
+#include "utility.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+namespace
+{
+
+/**
+ * @brief The trailing report printed by rsync --stats
+ */
+constexpr auto rsyncStatsOutput = R"(
+Number of files: 12 (reg: 10, dir: 2)
+Number of created files: 1 (reg: 1)
+Number of deleted files: 0
+Number of regular files transferred: 3
+Total file size: 53,452 bytes
+Total transferred file size: 6,240 bytes
+Literal data: 6240 bytes
+Matched data: 0 bytes
+File list size: 0
+File list generation time: 0.001 seconds
+File list transfer time: 0.000 seconds
+Total bytes sent: 6,691
+Total bytes received: 93
+
+sent 6,691 bytes  received 93 bytes  13,568.00 bytes/sec
+total size is 53,452  speedup is 7.88
+)";
+
+} // namespace
+
+static void bmGetTransferredDataBytes(benchmark::State& state)
+{
+    const std::string output(rsyncStatsOutput);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(
+            data_sync::utility::rsync::getTransferredDataBytes(output));
+    }
+}
+BENCHMARK(bmGetTransferredDataBytes);
+
+static void bmDataSyncConfigParsing(benchmark::State& state)
+{
+    nlohmann::json config = {{"Path", "/var/lib/phosphor-bench/"},
+                             {"Description", "Benchmark data"},
+                             {"SyncDirection", "Active2Passive"},
+                             {"SyncType", "Periodic"},
+                             {"Periodicity", "PT1M30S"},
+                             {"RetryAttempts", 3},
+                             {"RetryInterval", "PT10S"}};
+    auto excludeList = nlohmann::json::array();
+    for (int64_t i = 0; i < state.range(0); ++i)
+    {
+        excludeList.push_back("/var/lib/phosphor-bench/exclude" +
+                              std::to_string(i));
+    }
+    config["ExcludeList"] = std::move(excludeList);
+
+    for (auto _ : state)
+    {
+        data_sync::config::DataSyncConfig dataSyncCfg(config, true);
+        benchmark::DoNotOptimize(dataSyncCfg);
+    }
+}
+BENCHMARK(bmDataSyncConfigParsing)->Arg(0)->Arg(8)->Arg(64);
+
+static void bmPersistUpdate(benchmark::State& state)
+{
+    bench::TmpDir persistDir;
+    const auto persistFile = persistDir.path / "persistentData.json";
+
+    bool value{false};
+    for (auto _ : state)
+    {
+        value = !value;
+        data_sync::persist::update(data_sync::persist::key::disable, value,
+                                   persistFile);
+    }
+}
+BENCHMARK(bmPersistUpdate);
+
+BENCHMARK_MAIN();
@@ -7,8 +7,15 @@
 
 set -eu
 
+# The TLS transport of the daemon takes the place of stunnel
+GEN_STUNNEL=1
+if [ "${1-}" = "--no-stunnel" ]; then
+    GEN_STUNNEL=0
+    shift
+fi
+
 if [ "$#" -lt 4 ]; then
-    echo "Usage: $0 <input_cfg_dir> <output_cfg_dir> <sync_sock_cfg_dir> <sync_sock_cfg_prefix1> [<sync_sock_cfg_prefix2> ...]"
+    echo "Usage: $0 [--no-stunnel] <input_cfg_dir> <output_cfg_dir> <sync_sock_cfg_dir> <sync_sock_cfg_prefix1> [<sync_sock_cfg_prefix2> ...]"
     exit 1
 fi
 
@@ -24,15 +31,26 @@ CERT_DIR="/usr/share/phosphor-data-sync/certs"
 RSYNC_OUT_DIR="$OUT_CFG_DIR/config/rsync"
 STUNNEL_OUT_DIR="$OUT_CFG_DIR/config/stunnel"
 
+TEMPLATES="$RSYNC_TEMPLATE"
+if [ "$GEN_STUNNEL" -eq 1 ]; then
+    TEMPLATES="$TEMPLATES $STUNNEL_TEMPLATE"
+fi
+
 # Check template files exist
-for f in "$RSYNC_TEMPLATE" "$STUNNEL_TEMPLATE"; do
+for f in $TEMPLATES; do
     if [ ! -f "$f" ]; then
         echo "Missing required file: $f" >&2
         exit 1
     fi
 done
 
-mkdir -p "$RSYNC_OUT_DIR" "$STUNNEL_OUT_DIR"
+mkdir -p "$RSYNC_OUT_DIR"
+if [ "$GEN_STUNNEL" -eq 1 ]; then
+    mkdir -p "$STUNNEL_OUT_DIR"
+else
+    # Left by an earlier build with stunnel
+    rm -rf "$STUNNEL_OUT_DIR"
+fi
 
 # Read configuration fields from each sync socket configuration file
 # in the order specified by the "data_sync_list" option.
@@ -115,6 +133,10 @@ generate_conf() {
 
     sed "s|<BMC_RSYNC_PORT>|$RSYNC_PORT|g" "$RSYNC_TEMPLATE" > "$RSYNC_OUT"
 
+    if [ "$GEN_STUNNEL" -eq 0 ]; then
+        return
+    fi
+
     sed -e "s|<LOCAL_BMC_STUNNEL_PORT>|$STUNNEL_PORT|g" \
         -e "s|<LOCAL_BMC_RSYNC_PORT>|$RSYNC_PORT|g" \
         -e "s|<SIBLING_BMC_RSYNC_PORT>|$SIB_RSYNC_PORT|g" \
@@ -2,8 +2,17 @@
 
 #include "async_command_exec.hpp"
 
+#include "io_ring.hpp"
+#include "sync_metrics.hpp"
+
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
 #include <phosphor-logging/lg2.hpp>
 
+#include <optional>
+
 namespace data_sync::async
 {
 
@@ -91,12 +100,22 @@ std::pair<pid_t, int> AsyncCommandExecutor::spawnCommand(const std::string& cmd,
                                                          const auto& actions)
 {
     const char* argv[] = {"/bin/sh", "-c", cmd.c_str(), nullptr};
+
+    // The commands run with an empty environment, except in the unit tests
+    // which put the command stand-ins (e.g. a fault injecting rsync) in
+    // front of the real commands through the PATH.
+#ifdef UNIT_TEST
+    char* const* envp = environ;
+#else
+    char* const* envp = nullptr;
+#endif
+
     pid_t pid = -1;
     int spawnResult = posix_spawn(
         &pid, "/bin/sh", actions, nullptr,
         // [cppcoreguidelines-pro-type-const-cast,-warnings-as-errors]
         // NOLINTNEXTLINE
-        const_cast<char* const*>(argv), nullptr);
+        const_cast<char* const*>(argv), envp);
 
     if (spawnResult != 0)
     {
@@ -128,7 +147,10 @@ sdbusplus::async::task<std::pair<int, std::string>>
         co_return {-1, ""};
     }
 
+    std::optional<metrics::ScopedSpan> span(std::in_place,
+                                            metrics::Stage::Spawn);
     auto [pid, spawnResult] = spawnCommand(cmd, actions);
+    span.reset();
 
     // Manually close the write end of the pipe in parent because only the child
     // need to write.
@@ -139,16 +161,20 @@ sdbusplus::async::task<std::pair<int, std::string>>
     writeFd.reset();
 
     // Wait until the child writes into the fd.
+    span.emplace(metrics::Stage::Transfer);
     // NOLINTNEXTLINE
     auto output = co_await waitForCmdCompletion(readFd());
+    span.reset();
 
     // Manually close the read fd of the parent immediately instead of keeping
     // it open until RAII scope cleanup.
     readFd.reset();
 
     // Wait for child process to exit
-    int status = -1;
-    waitpid(pid, &status, 0);
+    span.emplace(metrics::Stage::Reap);
+    // NOLINTNEXTLINE
+    const int status = co_await waitForExit(pid);
+    span.reset();
 
     int exitCode = WIFEXITED(status) ? WEXITSTATUS(status) : -1;
     if (!WIFEXITED(status))
@@ -160,10 +186,55 @@ sdbusplus::async::task<std::pair<int, std::string>>
     co_return {exitCode, output};
 }
 
+sdbusplus::async::task<int>
+    // NOLINTNEXTLINE
+    AsyncCommandExecutor::waitForExit(pid_t pid)
+{
+    int status = -1;
+    if (pid <= 0)
+    {
+        co_return status;
+    }
+
+    const auto reaped = waitpid(pid, &status, WNOHANG);
+    if (reaped != 0)
+    {
+        // Mostly the child has exited already as its output got closed
+        co_return reaped == pid ? status : -1;
+    }
+
+    // Await the exit through a pidfd instead of blocking the event loop on
+    // a child which outlives its output, e.g. rsync tearing down the remote
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg)
+    FD pidFd(static_cast<int>(syscall(SYS_pidfd_open, pid, 0)));
+    if (pidFd() >= 0)
+    {
+        sdbusplus::async::fdio pidFdio(_ctx, pidFd());
+        while (!_ctx.stop_requested())
+        {
+            co_await pidFdio.next();
+            if (waitpid(pid, &status, WNOHANG) == pid)
+            {
+                co_return status;
+            }
+        }
+    }
+
+    // The pidfd isn't supported by the kernel, or the daemon is stopping
+    waitpid(pid, &status, 0);
+    co_return status;
+}
+
 sdbusplus::async::task<std::string>
     // NOLINTNEXTLINE
     AsyncCommandExecutor::waitForCmdCompletion(int fd)
 {
+    if (auto* ring = io::ring(); ring != nullptr)
+    {
+        // NOLINTNEXTLINE
+        co_return co_await readThroughRing(*ring, fd);
+    }
+
     // Set non-blocking mode for the file descriptor
     int flags = fcntl(fd, F_GETFL, 0);
     // NOLINTNEXTLINE - [cppcoreguidelines-pro-type-vararg,-warnings-as-errors]
@@ -209,4 +280,39 @@ sdbusplus::async::task<std::string>
     co_return output;
 }
 
+sdbusplus::async::task<std::string>
+    // NOLINTNEXTLINE
+    AsyncCommandExecutor::readThroughRing(io::Ring& ring, int fd)
+{
+    // The pipe stays blocking, the ring polls it and each read takes all the
+    // output written meanwhile into a registered buffer, appended from there.
+    std::string output;
+    io::Ring::Lease lease(ring);
+    while (!_ctx.stop_requested())
+    {
+        // NOLINTNEXTLINE
+        const auto bytes = co_await ring.read(fd, lease);
+        if (bytes > 0)
+        {
+            output.append(lease.data().data(), lease.data().size());
+        }
+        else if (bytes == 0)
+        {
+            // EOF
+            break;
+        }
+        else
+        {
+            if (bytes != -ECANCELED)
+            {
+                lg2::error("read failed on fd[{FD}] : [{ERROR}]", "FD", fd,
+                           "ERROR", strerror(static_cast<int>(-bytes)));
+            }
+            break;
+        }
+    }
+
+    co_return output;
+}
+
 } // namespace data_sync::async
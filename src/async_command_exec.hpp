@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include "io_ring.hpp"
 #include "utility.hpp"
 
 #include <fcntl.h>
@@ -147,6 +148,30 @@ class AsyncCommandExecutor
      */
     sdbusplus::async::task<std::string> waitForCmdCompletion(int fd);
 
+    /**
+     * @brief API to read and accumulate the output from the file descriptor
+     *        through the io_uring of the event loop until the end of it.
+     *
+     * @param[in] - ring - The io_uring of the event loop
+     * @param[in] - fd - file descriptor to read the data from.
+     *
+     * @return - sdbusplus::async::task<std::string>
+     *             The accumulated output from the descriptor.
+     */
+    sdbusplus::async::task<std::string> readThroughRing(io::Ring& ring,
+                                                        int fd);
+
+    /**
+     * @brief API to wait asynchronously until the child process exits and
+     *        reap it.
+     *
+     * @param[in] - pid - PID of the child process
+     *
+     * @return - sdbusplus::async::task<int>
+     *             The wait status of the child, -1 if it couldn't be reaped.
+     */
+    sdbusplus::async::task<int> waitForExit(pid_t pid);
+
     /**
      * @brief The async context object used to perform operations
      *        asynchronously as required.
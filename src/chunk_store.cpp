@@ -0,0 +1,516 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "chunk_store.hpp"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <phosphor-logging/lg2.hpp>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <charconv>
+#include <chrono>
+#include <format>
+#include <fstream>
+#include <ranges>
+#include <set>
+#include <stdexcept>
+
+namespace data_sync::backup
+{
+
+namespace
+{
+
+/**
+ * @brief The random values the gear hash adds per byte, generated with
+ *        splitmix64 so that the chunk boundaries are stable across builds.
+ */
+constexpr auto gearTable = []() {
+    std::array<uint64_t, 256> table{};
+    uint64_t state = 0;
+    for (auto& value : table)
+    {
+        state += 0x9E3779B97F4A7C15ULL;
+        uint64_t mixed = state;
+        mixed = (mixed ^ (mixed >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        mixed = (mixed ^ (mixed >> 27)) * 0x94D049BB133111EBULL;
+        value = mixed ^ (mixed >> 31);
+    }
+    return table;
+}();
+
+/**
+ * @brief The boundary pattern, checked on the high bits of the gear hash as
+ *        those depend on the most recent bytes.
+ */
+constexpr uint64_t boundaryMask = []() {
+    const auto bits = std::countr_zero(avgChunkSize);
+    return ((uint64_t{1} << bits) - 1) << (64 - bits);
+}();
+
+/**
+ * @brief The FNV-1a hash of the chunk, which addresses it in the store.
+ */
+uint64_t hashChunk(std::span<const uint8_t> chunk)
+{
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    for (const auto byte : chunk)
+    {
+        hash = (hash ^ byte) * 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+std::vector<uint8_t> readFile(const fs::path& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+    {
+        throw std::runtime_error("Failed to open " + path.string());
+    }
+    std::vector<uint8_t> data(fs::file_size(path));
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    file.read(reinterpret_cast<char*>(data.data()),
+              static_cast<std::streamsize>(data.size()));
+    if (!file)
+    {
+        throw std::runtime_error("Failed to read " + path.string());
+    }
+    return data;
+}
+
+/**
+ * @brief Write the given data into a temporary file and rename it to the
+ *        given path, so that the path never has a partial content.
+ */
+void writeFile(const fs::path& path, std::span<const uint8_t> data)
+{
+    fs::create_directories(path.parent_path());
+    fs::path tmpPath = path;
+    tmpPath += ".tmp";
+    {
+        std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        file.write(reinterpret_cast<const char*>(data.data()),
+                   static_cast<std::streamsize>(data.size()));
+        file.flush();
+        if (!file)
+        {
+            throw std::runtime_error("Failed to write " + tmpPath.string());
+        }
+    }
+    fs::rename(tmpPath, path);
+}
+
+/**
+ * @brief Check the manifest path doesn't lead out of the restore directory.
+ */
+fs::path checkedRelativePath(const std::string& path)
+{
+    const fs::path relPath{path};
+    if (relPath.empty() || relPath.is_absolute() ||
+        std::ranges::find(relPath, "..") != relPath.end())
+    {
+        throw std::runtime_error("Invalid path in the backup manifest: " +
+                                 path);
+    }
+    return relPath;
+}
+
+/**
+ * @brief Apply the backed up metadata to the restored path.
+ */
+void applyMetadata(const fs::path& path, const nlohmann::json& entry)
+{
+    if (entry["Type"] != "Symlink")
+    {
+        fs::permissions(path, static_cast<fs::perms>(entry["Mode"].get<int>()));
+    }
+
+    // Keep the restoring user as the owner if it may not change it
+    if (::lchown(path.c_str(), entry["Uid"].get<uid_t>(),
+                 entry["Gid"].get<gid_t>()) != 0)
+    {
+        lg2::debug("Failed to restore the owner of {PATH}, errno: {ERRNO}",
+                   "PATH", path, "ERRNO", errno);
+    }
+
+    const std::array<timespec, 2> times{
+        timespec{.tv_sec = 0, .tv_nsec = UTIME_OMIT},
+        timespec{.tv_sec = entry["MTime"].get<time_t>(), .tv_nsec = 0}};
+    ::utimensat(AT_FDCWD, path.c_str(), times.data(), AT_SYMLINK_NOFOLLOW);
+}
+
+} // namespace
+
+std::vector<size_t> splitChunks(std::span<const uint8_t> data)
+{
+    std::vector<size_t> sizes;
+    size_t start = 0;
+    while (start < data.size())
+    {
+        const size_t remaining = data.size() - start;
+        if (remaining <= minChunkSize)
+        {
+            sizes.push_back(remaining);
+            break;
+        }
+
+        // The bytes up to the minimum size can't end a chunk, so skip
+        // hashing them
+        const size_t end = std::min(remaining, maxChunkSize);
+        size_t size = minChunkSize;
+        uint64_t hash = 0;
+        while (size < end)
+        {
+            hash = (hash << 1) + gearTable[data[start + size++]];
+            if ((hash & boundaryMask) == 0)
+            {
+                break;
+            }
+        }
+        sizes.push_back(size);
+        start += size;
+    }
+    return sizes;
+}
+
+ChunkStore::ChunkStore(const fs::path& root, size_t retainedVersions) :
+    _root(root), _retainedVersions(std::max<size_t>(retainedVersions, 1))
+{
+    fs::create_directories(_root / "chunks");
+    fs::create_directories(_root / "versions");
+}
+
+BackupStats ChunkStore::backup(const fs::path& source)
+{
+    const auto sourceStatus = fs::symlink_status(source);
+    if (!fs::exists(sourceStatus))
+    {
+        throw std::runtime_error("The backup source doesn't exist: " +
+                                 source.string());
+    }
+
+    BackupStats stats;
+    const auto existing = versionNumbers();
+    stats.version = existing.empty() ? 1 : existing.back() + 1;
+
+    auto files = nlohmann::json::array();
+    auto addEntry = [this, &files, &stats](const fs::path& path,
+                                           const fs::path& relPath) {
+        struct stat pathStat{};
+        if (::lstat(path.c_str(), &pathStat) != 0)
+        {
+            // Removed while backing up, so not part of this version
+            return false;
+        }
+
+        nlohmann::json entry{{"Path", relPath.string()},
+                             {"Mode", pathStat.st_mode & 07777},
+                             {"Uid", pathStat.st_uid},
+                             {"Gid", pathStat.st_gid},
+                             {"MTime", pathStat.st_mtim.tv_sec}};
+        if (S_ISDIR(pathStat.st_mode))
+        {
+            entry["Type"] = "Directory";
+        }
+        else if (S_ISLNK(pathStat.st_mode))
+        {
+            entry["Type"] = "Symlink";
+            entry["Target"] = fs::read_symlink(path).string();
+        }
+        else if (S_ISREG(pathStat.st_mode))
+        {
+            const auto data = readFile(path);
+            auto chunks = nlohmann::json::array();
+            size_t offset = 0;
+            for (const auto size : splitChunks(data))
+            {
+                chunks.push_back(storeChunk(
+                    std::span(data).subspan(offset, size), stats));
+                offset += size;
+            }
+            entry["Type"] = "File";
+            entry["Size"] = data.size();
+            entry["Chunks"] = std::move(chunks);
+            stats.logicalBytes += data.size();
+            ++stats.files;
+        }
+        else
+        {
+            // The sockets, pipes and devices aren't data to back up
+            return false;
+        }
+        files.push_back(std::move(entry));
+        return true;
+    };
+
+    if (fs::is_directory(sourceStatus))
+    {
+        // The source keeps changing while it is backed up, e.g. a sync is
+        // received meanwhile, so the walk doesn't stop at a removed file
+        const auto sourceDir = fs::canonical(source);
+        const auto storeDir = fs::canonical(_root);
+        std::error_code ec;
+        fs::recursive_directory_iterator it(sourceDir, ec);
+        for (; !ec && it != fs::recursive_directory_iterator();
+             it.increment(ec))
+        {
+            // The store may be kept under the source, but isn't backed up
+            if (it->path() == storeDir ||
+                !addEntry(it->path(),
+                          it->path().lexically_relative(sourceDir)))
+            {
+                it.disable_recursion_pending();
+            }
+        }
+        if (ec)
+        {
+            throw fs::filesystem_error("Failed to walk the backup source",
+                                       source, ec);
+        }
+    }
+    else
+    {
+        addEntry(source, source.filename());
+    }
+
+    const auto now = std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch());
+    const nlohmann::json manifest{{"Version", stats.version},
+                                  {"Time", now.count()},
+                                  {"Source", source.string()},
+                                  {"LogicalBytes", stats.logicalBytes},
+                                  {"Files", std::move(files)}};
+    const auto manifestData = nlohmann::json::to_cbor(manifest);
+    writeFile(manifestPath(stats.version), manifestData);
+    stats.writtenBytes += manifestData.size();
+
+    prune();
+
+    lg2::info("Backed up {SOURCE} as version {VERSION}: {LOGICAL_BYTES} bytes "
+              "in {CHUNKS} chunks, wrote {NEW_CHUNKS} new chunks and "
+              "{WRITTEN_BYTES} bytes in total",
+              "SOURCE", source, "VERSION", stats.version, "LOGICAL_BYTES",
+              stats.logicalBytes, "CHUNKS", stats.chunks, "NEW_CHUNKS",
+              stats.newChunks, "WRITTEN_BYTES", stats.writtenBytes);
+    return stats;
+}
+
+void ChunkStore::restore(uint64_t version, const fs::path& destination) const
+{
+    const auto manifest = readManifest(version);
+
+    fs::create_directories(destination);
+
+    // The directories get their metadata once their content is restored
+    std::vector<std::pair<fs::path, const nlohmann::json*>> directories;
+    for (const auto& entry : manifest["Files"])
+    {
+        const auto path =
+            destination / checkedRelativePath(entry["Path"].get<std::string>());
+        const auto& type = entry["Type"];
+        if (type == "Directory")
+        {
+            fs::create_directories(path);
+            directories.emplace_back(path, &entry);
+            continue;
+        }
+
+        fs::create_directories(path.parent_path());
+        if (type == "Symlink")
+        {
+            std::error_code ec;
+            fs::remove(path, ec);
+            fs::create_symlink(entry["Target"].get<std::string>(), path);
+        }
+        else
+        {
+            std::vector<uint8_t> data;
+            data.reserve(entry["Size"].get<size_t>());
+            for (const auto& chunkId : entry["Chunks"])
+            {
+                const auto chunk =
+                    readFile(chunkPath(chunkId.get<std::string>()));
+                data.insert(data.end(), chunk.begin(), chunk.end());
+            }
+            if (data.size() != entry["Size"].get<size_t>())
+            {
+                throw std::runtime_error(
+                    "The chunks of " + entry["Path"].get<std::string>() +
+                    " don't match its size in the backup version " +
+                    std::to_string(version));
+            }
+            writeFile(path, data);
+        }
+        applyMetadata(path, entry);
+    }
+
+    for (const auto& [path, entry] : directories | std::views::reverse)
+    {
+        applyMetadata(path, *entry);
+    }
+
+    lg2::info("Restored the backup version {VERSION} of {SOURCE} into {PATH}",
+              "VERSION", version, "SOURCE",
+              manifest["Source"].get<std::string>(), "PATH", destination);
+}
+
+std::vector<VersionInfo> ChunkStore::versions() const
+{
+    std::vector<VersionInfo> versionInfos;
+    for (const auto version : versionNumbers())
+    {
+        const auto manifest = readManifest(version);
+        versionInfos.emplace_back(VersionInfo{
+            .version = version,
+            .timeSec = manifest["Time"].get<uint64_t>(),
+            .source = manifest["Source"].get<std::string>(),
+            .files = manifest["Files"].size(),
+            .logicalBytes = manifest["LogicalBytes"].get<uint64_t>()});
+    }
+    return versionInfos;
+}
+
+StoreStats ChunkStore::stats() const
+{
+    StoreStats stats;
+    for (const auto version : versionNumbers())
+    {
+        ++stats.versions;
+        stats.logicalBytes +=
+            readManifest(version)["LogicalBytes"].get<uint64_t>();
+        stats.storedBytes += fs::file_size(manifestPath(version));
+    }
+
+    for (const auto& entry : fs::recursive_directory_iterator(_root / "chunks"))
+    {
+        if (entry.is_regular_file())
+        {
+            ++stats.chunks;
+            stats.storedBytes += entry.file_size();
+        }
+    }
+    return stats;
+}
+
+std::string ChunkStore::storeChunk(std::span<const uint8_t> chunk,
+                                   BackupStats& stats)
+{
+    ++stats.chunks;
+    const auto baseId = std::format("{:016x}-{:x}", hashChunk(chunk),
+                                    chunk.size());
+    for (size_t collision = 0;; ++collision)
+    {
+        auto chunkId = collision == 0
+                           ? baseId
+                           : std::format("{}-{}", baseId, collision);
+        const auto path = chunkPath(chunkId);
+        if (!fs::exists(path))
+        {
+            writeFile(path, chunk);
+            ++stats.newChunks;
+            stats.writtenBytes += chunk.size();
+            return chunkId;
+        }
+
+        // A stored chunk which got corrupted doesn't match either, so it is
+        // stored afresh rather than referred to
+        if (std::ranges::equal(readFile(path), chunk))
+        {
+            return chunkId;
+        }
+    }
+}
+
+void ChunkStore::prune() const
+{
+    auto versions = versionNumbers();
+    if (versions.size() <= _retainedVersions)
+    {
+        return;
+    }
+
+    const auto expired = versions.size() - _retainedVersions;
+    for (const auto version : versions | std::views::take(expired))
+    {
+        fs::remove(manifestPath(version));
+        lg2::info("Pruned the backup version {VERSION}", "VERSION", version);
+    }
+
+    std::set<std::string> referenced;
+    for (const auto version : versions | std::views::drop(expired))
+    {
+        const auto manifest = readManifest(version);
+        for (const auto& entry : manifest["Files"])
+        {
+            if (entry.contains("Chunks"))
+            {
+                for (const auto& chunkId : entry["Chunks"])
+                {
+                    referenced.insert(chunkId.get<std::string>());
+                }
+            }
+        }
+    }
+
+    std::vector<fs::path> unreferenced;
+    for (const auto& entry : fs::recursive_directory_iterator(_root / "chunks"))
+    {
+        if (entry.is_regular_file() &&
+            !referenced.contains(entry.path().filename().string()))
+        {
+            unreferenced.push_back(entry.path());
+        }
+    }
+    for (const auto& path : unreferenced)
+    {
+        fs::remove(path);
+    }
+}
+
+fs::path ChunkStore::chunkPath(const std::string& chunkId) const
+{
+    return _root / "chunks" / chunkId.substr(0, 2) / chunkId;
+}
+
+fs::path ChunkStore::manifestPath(uint64_t version) const
+{
+    return _root / "versions" / std::format("{:010}", version);
+}
+
+std::vector<uint64_t> ChunkStore::versionNumbers() const
+{
+    std::vector<uint64_t> versions;
+    for (const auto& entry : fs::directory_iterator(_root / "versions"))
+    {
+        // Skip the temporary file of an interrupted backup
+        const auto name = entry.path().filename().string();
+        uint64_t version{0};
+        const auto [end, ec] = std::from_chars(
+            name.data(), name.data() + name.size(), version);
+        if (ec == std::errc{} && end == name.data() + name.size())
+        {
+            versions.push_back(version);
+        }
+    }
+    std::ranges::sort(versions);
+    return versions;
+}
+
+nlohmann::json ChunkStore::readManifest(uint64_t version) const
+{
+    const auto path = manifestPath(version);
+    if (!fs::exists(path))
+    {
+        throw std::runtime_error("The backup version " +
+                                 std::to_string(version) + " doesn't exist");
+    }
+    return nlohmann::json::from_cbor(readFile(path));
+}
+
+} // namespace data_sync::backup
@@ -0,0 +1,232 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "utility.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace data_sync::backup
+{
+
+namespace fs = std::filesystem;
+
+/**
+ * @brief The data the versions are taken of, the plain copy of the sibling
+ *        BMC's data on local BMC
+ */
+constexpr auto defaultBackupSource = utility::backupDataDir;
+
+/**
+ * @brief The directory of the store, kept apart from the backed up data so
+ *        that a backup doesn't chunk the store into itself
+ */
+constexpr auto defaultStoreDir =
+    "/var/lib/phosphor-data-sync/bmc_data_versions/";
+
+/**
+ * @brief The size limits of the content defined chunks, the boundaries are
+ *        chosen to give chunks of the average size in between.
+ */
+constexpr size_t minChunkSize = 2 * 1024;
+constexpr size_t avgChunkSize = 8 * 1024;
+constexpr size_t maxChunkSize = 64 * 1024;
+static_assert((avgChunkSize & (avgChunkSize - 1)) == 0,
+              "avgChunkSize must be power of 2");
+
+/**
+ * @brief Split the given data into content defined chunks.
+ *
+ * A gear rolling hash runs over the data and a chunk ends where the hash
+ * hits the boundary pattern, so the boundaries depend on the content around
+ * them and an insertion or a removal only changes the chunks it touches,
+ * unlike the fixed size blocks which all shift after it.
+ *
+ * @param[in] data - The data to split
+ *
+ * @return The sizes of the chunks in order, which add up to the data size
+ */
+std::vector<size_t> splitChunks(std::span<const uint8_t> data);
+
+/**
+ * @brief The cost of a backup against a plain copy of the same data.
+ */
+struct BackupStats
+{
+    uint64_t version{0};
+
+    /**
+     * @brief The bytes of the backed up files, which a plain copy writes
+     */
+    uint64_t logicalBytes{0};
+
+    /**
+     * @brief The bytes written to the flash, the new chunks and the manifest
+     */
+    uint64_t writtenBytes{0};
+
+    size_t files{0};
+    size_t chunks{0};
+    size_t newChunks{0};
+
+    /**
+     * @brief The bytes written per byte of a plain copy.
+     */
+    double writeAmplification() const noexcept
+    {
+        return logicalBytes == 0 ? 0.0
+                                 : static_cast<double>(writtenBytes) /
+                                       static_cast<double>(logicalBytes);
+    }
+};
+
+/**
+ * @brief The space the retained versions take against plain copies of them.
+ */
+struct StoreStats
+{
+    size_t versions{0};
+
+    /**
+     * @brief The bytes of the plain copies of all the retained versions
+     */
+    uint64_t logicalBytes{0};
+
+    /**
+     * @brief The bytes of the chunks and the manifests in the store
+     */
+    uint64_t storedBytes{0};
+
+    size_t chunks{0};
+
+    /**
+     * @brief The bytes of the plain copies per stored byte.
+     */
+    double dedupRatio() const noexcept
+    {
+        return storedBytes == 0 ? 0.0
+                                : static_cast<double>(logicalBytes) /
+                                      static_cast<double>(storedBytes);
+    }
+};
+
+/**
+ * @brief The summary of a backed up version.
+ */
+struct VersionInfo
+{
+    uint64_t version{0};
+    uint64_t timeSec{0};
+    std::string source;
+    size_t files{0};
+    uint64_t logicalBytes{0};
+};
+
+/**
+ * @class ChunkStore
+ *
+ * @brief A versioned, deduplicated store for the backups of the sibling BMC's
+ *        data.
+ *
+ * The files are split into content defined chunks, which are stored once
+ * under their hash in "chunks/", and every backup writes a compact CBOR
+ * manifest into "versions/" listing the files, their metadata and their
+ * chunks. So a backup writes only the chunks no retained version has yet,
+ * and a restore reads the chunks of the version back. The oldest versions
+ * beyond the retention are pruned with the chunks only they referenced.
+ *
+ * The chunk files and the manifests are written into a temporary file and
+ * renamed, so that an interrupted backup never leaves a torn one behind.
+ */
+class ChunkStore
+{
+  public:
+    ChunkStore(const ChunkStore&) = delete;
+    ChunkStore& operator=(const ChunkStore&) = delete;
+    ChunkStore(ChunkStore&&) = delete;
+    ChunkStore& operator=(ChunkStore&&) = delete;
+    ~ChunkStore() = default;
+
+    /**
+     * @brief The constructor
+     *
+     * @param[in] root - The directory of the store, created if missing
+     * @param[in] retainedVersions - The versions to keep, at least one
+     *
+     * @throw std::filesystem::filesystem_error if the directories of the
+     *        store can't be created
+     */
+    ChunkStore(const fs::path& root, size_t retainedVersions);
+
+    /**
+     * @brief Back up the given file or directory as a new version and prune
+     *        the versions beyond the retention.
+     *
+     * @param[in] source - The file or directory to back up
+     *
+     * @return The new version and its cost against a plain copy
+     *
+     * @throw std::runtime_error or std::filesystem::filesystem_error on
+     *        failure, in which case no version is added
+     */
+    BackupStats backup(const fs::path& source);
+
+    /**
+     * @brief Restore the given version into the given directory.
+     *
+     * The backed up directory is restored as the destination itself, a
+     * backed up file is restored into the destination under its name.
+     *
+     * @param[in] version - The version to restore
+     * @param[in] destination - The directory to restore into
+     *
+     * @throw std::runtime_error if the version doesn't exist or is corrupted
+     */
+    void restore(uint64_t version, const fs::path& destination) const;
+
+    /**
+     * @brief Get the retained versions, the oldest first.
+     */
+    std::vector<VersionInfo> versions() const;
+
+    /**
+     * @brief Get the space the retained versions take in the store.
+     */
+    StoreStats stats() const;
+
+  private:
+    /**
+     * @brief Store the given chunk unless it is stored already.
+     *
+     * The chunks are addressed by their hash and size, the contents are
+     * compared on a match and a colliding chunk gets a suffixed address.
+     *
+     * @param[in] chunk - The chunk data
+     * @param[in,out] stats - The stats of the backup to account the chunk
+     *
+     * @return The address of the chunk
+     */
+    std::string storeChunk(std::span<const uint8_t> chunk, BackupStats& stats);
+
+    /**
+     * @brief Remove the oldest versions beyond the retention and the chunks
+     *        no retained version refers to.
+     */
+    void prune() const;
+
+    fs::path chunkPath(const std::string& chunkId) const;
+    fs::path manifestPath(uint64_t version) const;
+    std::vector<uint64_t> versionNumbers() const;
+    nlohmann::json readManifest(uint64_t version) const;
+
+    fs::path _root;
+    size_t _retainedVersions;
+};
+
+} // namespace data_sync::backup
@@ -0,0 +1,69 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "clock.hpp"
+
+namespace data_sync::clock
+{
+
+namespace
+{
+
+/**
+ * @brief The real time interval at which the virtual waits check the clock
+ */
+constexpr auto virtualPollInterval = std::chrono::milliseconds(1);
+
+} // namespace
+
+sdbusplus::async::task<> SteadyClock::sleepFor(sdbusplus::async::context& ctx,
+                                               Duration duration)
+{
+    co_await sdbusplus::async::sleep_for(ctx, duration);
+}
+
+Clock& steady()
+{
+    static SteadyClock steadyClock;
+    return steadyClock;
+}
+
+sdbusplus::async::task<> VirtualClock::sleepFor(sdbusplus::async::context& ctx,
+                                                Duration duration)
+{
+    if (!_driving)
+    {
+        _driving = true;
+        ctx.spawn(drive(ctx));
+    }
+
+    const auto deadline = _now + duration;
+    auto pending = _deadlines.insert(deadline);
+    ++_generation;
+
+    while (_now < deadline && !ctx.stop_requested())
+    {
+        co_await sdbusplus::async::sleep_for(ctx, virtualPollInterval);
+    }
+
+    _deadlines.erase(pending);
+    ++_generation;
+}
+
+// NOLINTNEXTLINE
+sdbusplus::async::task<> VirtualClock::drive(sdbusplus::async::context& ctx)
+{
+    while (!ctx.stop_requested())
+    {
+        const auto generation = _generation;
+        co_await sdbusplus::async::sleep_for(ctx, _settleTime);
+
+        if (_busy == 0 && generation == _generation && !_deadlines.empty() &&
+            *_deadlines.begin() > _now)
+        {
+            advance(*_deadlines.begin() - _now);
+        }
+    }
+    _driving = false;
+}
+
+} // namespace data_sync::clock
@@ -0,0 +1,189 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <sdbusplus/async.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <set>
+
+namespace data_sync::clock
+{
+
+using Duration = std::chrono::steady_clock::duration;
+using TimePoint = std::chrono::steady_clock::time_point;
+
+/**
+ * @class Clock
+ *
+ * @brief The time source of the sync scheduling, the periodic syncs and the
+ *        retries wait through it so that the tests can run them on a virtual
+ *        time.
+ */
+class Clock
+{
+  public:
+    Clock() = default;
+    Clock(const Clock&) = delete;
+    Clock& operator=(const Clock&) = delete;
+    Clock(Clock&&) = delete;
+    Clock& operator=(Clock&&) = delete;
+    virtual ~Clock() = default;
+
+    /**
+     * @brief Get the current time of the clock.
+     */
+    virtual TimePoint now() const = 0;
+
+    /**
+     * @brief Wait for the given duration on the clock.
+     *
+     * @param[in] ctx - The async context
+     * @param[in] duration - The duration to wait
+     */
+    virtual sdbusplus::async::task<> sleepFor(sdbusplus::async::context& ctx,
+                                              Duration duration) = 0;
+
+    /**
+     * @brief Mark the start and the end of a work which the clock can't see,
+     *        such as a spawned rsync. A virtual clock doesn't advance while
+     *        any such work is in progress.
+     */
+    void enterBusy() noexcept
+    {
+        ++_busy;
+    }
+    void leaveBusy() noexcept
+    {
+        --_busy;
+    }
+
+  protected:
+    /**
+     * @brief The number of the works in progress outside of the clock
+     */
+    uint32_t _busy{0};
+};
+
+/**
+ * @brief The RAII helper to mark a work in progress outside of the clock.
+ */
+class BusyScope
+{
+  public:
+    BusyScope(const BusyScope&) = delete;
+    BusyScope& operator=(const BusyScope&) = delete;
+    BusyScope(BusyScope&&) = delete;
+    BusyScope& operator=(BusyScope&&) = delete;
+
+    explicit BusyScope(Clock& clock) : _clock(clock)
+    {
+        _clock.enterBusy();
+    }
+
+    ~BusyScope()
+    {
+        _clock.leaveBusy();
+    }
+
+  private:
+    Clock& _clock;
+};
+
+/**
+ * @class SteadyClock
+ *
+ * @brief The clock of the daemon, which waits on the real time.
+ */
+class SteadyClock : public Clock
+{
+  public:
+    TimePoint now() const override
+    {
+        return std::chrono::steady_clock::now();
+    }
+
+    sdbusplus::async::task<> sleepFor(sdbusplus::async::context& ctx,
+                                      Duration duration) override;
+};
+
+/**
+ * @brief Get the steady clock shared by the daemon.
+ */
+Clock& steady();
+
+/**
+ * @class VirtualClock
+ *
+ * @brief A clock for the tests, on which the time only advances once the
+ *        event loop is idle.
+ *
+ * The clock is idle when no other work is marked busy and no task started
+ * or finished waiting on it for the settle time, then it jumps straight to
+ * the earliest deadline so that the waits of seconds or minutes complete in
+ * milliseconds. The waits wake up in the order of their deadlines.
+ */
+class VirtualClock : public Clock
+{
+  public:
+    /**
+     * @param[in] settleTime - The real time without any activity after which
+     *                         the clock is considered idle
+     */
+    explicit VirtualClock(
+        Duration settleTime = std::chrono::milliseconds(20)) :
+        _settleTime(settleTime)
+    {}
+
+    TimePoint now() const override
+    {
+        return _now;
+    }
+
+    sdbusplus::async::task<> sleepFor(sdbusplus::async::context& ctx,
+                                      Duration duration) override;
+
+    /**
+     * @brief Advance the clock by the given duration right away.
+     */
+    void advance(Duration duration)
+    {
+        _now += duration;
+        ++_generation;
+    }
+
+    /**
+     * @brief Get the time elapsed on the clock since its construction.
+     */
+    Duration elapsed() const
+    {
+        return _now - TimePoint{};
+    }
+
+  private:
+    /**
+     * @brief Advance the clock to the earliest deadline whenever idle, until
+     *        the context stops.
+     */
+    sdbusplus::async::task<> drive(sdbusplus::async::context& ctx);
+
+    Duration _settleTime;
+
+    TimePoint _now{};
+
+    /**
+     * @brief The deadlines of the pending waits
+     */
+    std::multiset<TimePoint> _deadlines;
+
+    /**
+     * @brief Changes on every wait start, wait end and advance, so the driver
+     *        knows whether anything happened during the settle time.
+     */
+    uint64_t _generation{0};
+
+    bool _driving{false};
+};
+
+} // namespace data_sync::clock
@@ -24,6 +24,20 @@ bool Retry::operator==(const Retry& retry) const
            _retryIntervalInSec == retry._retryIntervalInSec;
 }
 
+HotPathBatching::HotPathBatching(uint32_t enterRatePerMin,
+                                 uint32_t exitRatePerMin,
+                                 const std::chrono::seconds& minSyncInterval) :
+    _enterRatePerMin(enterRatePerMin), _exitRatePerMin(exitRatePerMin),
+    _minSyncInterval(minSyncInterval)
+{}
+
+bool HotPathBatching::operator==(const HotPathBatching& hotPathBatching) const
+{
+    return _enterRatePerMin == hotPathBatching._enterRatePerMin &&
+           _exitRatePerMin == hotPathBatching._exitRatePerMin &&
+           _minSyncInterval == hotPathBatching._minSyncInterval;
+}
+
 NotifySiblingConfig::NotifySiblingConfig(const nlohmann::json& notifySibling)
 {
     if (notifySibling.contains("NotifyOnPaths"))
@@ -93,6 +107,47 @@ DataSyncConfig::DataSyncConfig(const nlohmann::json& config,
                        std::chrono::seconds(DEFAULT_RETRY_INTERVAL));
     }
 
+    if (_syncType == SyncType::Immediate &&
+        config.contains("HotPathBatching"))
+    {
+        constexpr uint32_t defEnterRatePerMin = 20;
+        constexpr uint32_t defExitRatePerMin = 5;
+        constexpr auto defMinSyncInterval = 30;
+
+        const auto& batching = config["HotPathBatching"];
+        const auto enterRate =
+            batching.value("EnterRatePerMin", defEnterRatePerMin);
+        auto exitRate = batching.value("ExitRatePerMin", defExitRatePerMin);
+        if (exitRate >= enterRate)
+        {
+            lg2::warning("The hot path exit rate [{EXIT}] of {PATH} must be "
+                         "below its enter rate [{ENTER}], using half of it",
+                         "EXIT", exitRate, "PATH", _path, "ENTER", enterRate);
+            exitRate = enterRate / 2;
+        }
+        auto minSyncInterval = std::chrono::seconds(defMinSyncInterval);
+        if (batching.contains("MinSyncInterval"))
+        {
+            minSyncInterval =
+                convertISODurationToSec(
+                    batching["MinSyncInterval"].get<std::string>())
+                    .value_or(minSyncInterval);
+        }
+        _hotPathBatching = HotPathBatching(enterRate, exitRate,
+                                           minSyncInterval);
+    }
+    else
+    {
+        _hotPathBatching = std::nullopt;
+    }
+
+    _syncMetadata = _syncType == SyncType::Immediate &&
+                    config.value("SyncMetadata", false);
+
+    _transferMode =
+        convertTransferModeToEnum(config.value("TransferMode", "Delta"))
+            .value_or(TransferMode::Delta);
+
     if (config.contains("ExcludeList"))
     {
         _excludeList.emplace(
@@ -124,6 +179,9 @@ bool DataSyncConfig::operator==(const DataSyncConfig& dataSyncCfg) const
            _syncType == dataSyncCfg._syncType &&
            _periodicityInSec == dataSyncCfg._periodicityInSec &&
            _retry == dataSyncCfg._retry &&
+           _hotPathBatching == dataSyncCfg._hotPathBatching &&
+           _syncMetadata == dataSyncCfg._syncMetadata &&
+           _transferMode == dataSyncCfg._transferMode &&
            _excludeList == dataSyncCfg._excludeList &&
            _includeList == dataSyncCfg._includeList;
 }
@@ -177,6 +235,10 @@ std::optional<SyncType>
     {
         return SyncType::Periodic;
     }
+    else if (syncType == "Notified")
+    {
+        return SyncType::Notified;
+    }
     else
     {
         lg2::error("Unsupported sync type [{SYNC_TYPE}]", "SYNC_TYPE",
@@ -185,6 +247,37 @@ std::optional<SyncType>
     }
 }
 
+std::optional<TransferMode>
+    DataSyncConfig::convertTransferModeToEnum(const std::string& transferMode)
+{
+    if (transferMode == "Delta")
+    {
+        return TransferMode::Delta;
+    }
+    else if (transferMode == "WholeFile")
+    {
+        return TransferMode::WholeFile;
+    }
+    else if (transferMode == "InPlace")
+    {
+        return TransferMode::InPlace;
+    }
+    else if (transferMode == "Sparse")
+    {
+        return TransferMode::Sparse;
+    }
+    else if (transferMode == "Auto")
+    {
+        return TransferMode::Auto;
+    }
+    else
+    {
+        lg2::error("Unsupported transfer mode [{TRANSFER_MODE}]",
+                   "TRANSFER_MODE", transferMode);
+        return std::nullopt;
+    }
+}
+
 std::optional<std::chrono::seconds> DataSyncConfig::convertISODurationToSec(
     const std::string& timeIntervalInISO)
 {
@@ -32,7 +32,36 @@ enum class SyncDirection
 enum class SyncType
 {
     Immediate,
-    Periodic
+    Periodic,
+
+    // Synced on the change records pushed by the writers through the
+    // dirty-path ring, without any inotify watch.
+    Notified
+};
+
+/**
+ * @brief The enum contains the ways to transfer the content of the files.
+ */
+enum class TransferMode
+{
+    // The rsync delta transfer, which sends only the blocks that differ
+    Delta,
+
+    // The whole files, without the block checksum pass over them
+    WholeFile,
+
+    // The delta transfer written into the files directly instead of into a
+    // temporary copy which replaces them. Only on an explicit choice, as an
+    // interrupted transfer (e.g. by a failover) leaves the sibling's copy
+    // half old and half new, and it doesn't resume from the partial data.
+    InPlace,
+
+    // The delta transfer which keeps the holes of the sparse files
+    Sparse,
+
+    // Chosen per file from its size, the delta efficiency of its previous
+    // syncs and the measured link throughput
+    Auto
 };
 
 /**
@@ -71,6 +100,41 @@ struct Retry
     std::chrono::seconds _retryIntervalInSec;
 };
 
+/**
+ * @brief The structure contains the limits to batch the syncs of the hot
+ *        paths of an Immediate configuration.
+ *
+ * A path whose change rate reaches the enter rate is synced at most once per
+ * minimum sync interval, until its change rate drops to the exit rate.
+ */
+struct HotPathBatching
+{
+    /**
+     * @brief The constructor
+     *
+     * @param[in] enterRatePerMin - The changes per minute to start batching
+     * @param[in] exitRatePerMin - The changes per minute to stop batching,
+     *                             below the enter rate for the hysteresis.
+     * @param[in] minSyncInterval - The minimum interval between the syncs of
+     *                              a batched path.
+     */
+    HotPathBatching(uint32_t enterRatePerMin, uint32_t exitRatePerMin,
+                    const std::chrono::seconds& minSyncInterval);
+
+    /**
+     * @brief Overload the == operator to compare objects.
+     *
+     * @param[in] hotPathBatching - The object to check
+     *
+     * @return True if it matches; otherwise, False.
+     */
+    bool operator==(const HotPathBatching& hotPathBatching) const;
+
+    uint32_t _enterRatePerMin;
+    uint32_t _exitRatePerMin;
+    std::chrono::seconds _minSyncInterval;
+};
+
 /**
  * @brief Configuration for notifying the sibling BMC after a successful sync.
  *
@@ -170,6 +234,8 @@ struct DataSyncConfig
                 return "Immediate";
             case SyncType::Periodic:
                 return "Periodic";
+            case SyncType::Notified:
+                return "Notified";
         }
         return "";
     }
@@ -221,6 +287,25 @@ struct DataSyncConfig
      */
     std::optional<Retry> _retry;
 
+    /**
+     * @brief The hot path batching limits.
+     *
+     * @note Holds a value if the Immediate file or directory opts to batch
+     *       the syncs of its frequently changing paths.
+     */
+    std::optional<HotPathBatching> _hotPathBatching;
+
+    /**
+     * @brief Whether to sync the metadata (mode, owner, times) changes of
+     *        the paths on their own, applicable to the Immediate sync type.
+     */
+    bool _syncMetadata;
+
+    /**
+     * @brief The way to transfer the content of the files, Delta by default.
+     */
+    TransferMode _transferMode;
+
     /**
      * @brief The list of paths to exclude from synchronization.
      *
@@ -253,6 +338,17 @@ struct DataSyncConfig
      */
     mutable std::unordered_set<fs::path> _syncInProgressPaths;
 
+    /**
+     * @brief A helper API to convert the time duration in ISO 8601 duration
+     *        format into seconds
+     *
+     * @param[in] - timeIntervalInISO - The time duration
+     *
+     * @returns The time interval in seconds on success; otherwise, nullopt.
+     */
+    static std::optional<std::chrono::seconds>
+        convertISODurationToSec(const std::string& timeIntervalInISO);
+
   private:
     /**
      * @brief A helper API to retrieve the corresponding enum type
@@ -277,15 +373,15 @@ struct DataSyncConfig
         convertSyncTypeToEnum(const std::string& syncType);
 
     /**
-     * @brief A helper API to convert the time duration in ISO 8601 duration
-     *        format into seconds
+     * @brief A helper API to retrieve the corresponding enum type
+     *        for a given transfer mode string.
      *
-     * @param[in] - timeIntervalInISO - The time duration
+     * @param[in] - transferMode - the transfer mode
      *
-     * @returns The time interval in seconds on success; otherwise, nullopt.
+     * @returns The enum value on success; otherwise, nullopt.
      */
-    static std::optional<std::chrono::seconds>
-        convertISODurationToSec(const std::string& timeIntervalInISO);
+    static std::optional<TransferMode>
+        convertTransferModeToEnum(const std::string& transferMode);
 };
 
 } // namespace data_sync::config
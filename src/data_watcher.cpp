@@ -2,33 +2,88 @@
 
 #include "data_watcher.hpp"
 
+#include "event_capture.hpp"
+#include "flight_recorder.hpp"
+#include "io_ring.hpp"
+#include "sync_metrics.hpp"
+
+#include <fcntl.h>
+
 #include <phosphor-logging/lg2.hpp>
 
 #include <cstring>
 #include <ranges>
+#include <span>
 #include <string>
 #include <utility>
 
 namespace data_sync::watch::inotify
 {
 
+namespace
+{
+
+/**
+ * @brief Maximum inotify events supported in the buffer
+ */
+constexpr auto maxEventBytes = sizeof(struct inotify_event) + NAME_MAX + 1;
+
+} // namespace
+
 DataWatcher::DataWatcher(
-    sdbusplus::async::context& ctx, const int inotifyFlags,
-    const uint32_t eventMasksToWatch, fs::path dataPathToWatch,
+    const int inotifyFlags, const uint32_t eventMasksToWatch,
+    fs::path dataPathToWatch,
     std::optional<std::unordered_set<fs::path>> excludeList,
     std::optional<std::unordered_set<fs::path>> includeList) :
     _inotifyFlags(inotifyFlags), _eventMasksToWatch(eventMasksToWatch),
     _dataPathToWatch(std::move(dataPathToWatch)),
     _excludeList(std::move(excludeList)), _includeList(std::move(includeList)),
-    _inotifyFileDescriptor(inotifyInit()),
-    _fdioInstance(
-        std::make_unique<sdbusplus::async::fdio>(ctx, _inotifyFileDescriptor()))
+    _inotifyFileDescriptor(inotifyInit())
 {
     createWatchers(_dataPathToWatch);
+
+    // The capture may start on another thread than the one driving this
+    // watcher, which writes its state on its next events instead
+    _captureId = capture::registerWatcher([this](uint16_t) {
+        _captureSnapshotPending.store(true, std::memory_order_release);
+    });
+}
+
+DataWatcher::DataWatcher(
+    sdbusplus::async::context& ctx, const int inotifyFlags,
+    const uint32_t eventMasksToWatch, fs::path dataPathToWatch,
+    std::optional<std::unordered_set<fs::path>> excludeList,
+    std::optional<std::unordered_set<fs::path>> includeList) :
+    DataWatcher(inotifyFlags, eventMasksToWatch, std::move(dataPathToWatch),
+                std::move(excludeList), std::move(includeList))
+{
+    if (auto* ring = io::ring(); ring != nullptr)
+    {
+        // The ring polls the inotify instance for its reads, which rather
+        // fail with EAGAIN if the instance doesn't block.
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg)
+        const auto flags = fcntl(_inotifyFileDescriptor(), F_GETFL, 0);
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg)
+        if (flags != -1 && fcntl(_inotifyFileDescriptor(), F_SETFL,
+                                 flags & ~O_NONBLOCK) != -1)
+        {
+            _ring = ring;
+        }
+    }
+    if (_ring == nullptr)
+    {
+        _fdioInstance = std::make_unique<sdbusplus::async::fdio>(
+            ctx, _inotifyFileDescriptor());
+    }
 }
 
 DataWatcher::~DataWatcher()
 {
+    if (_captureId != 0)
+    {
+        capture::unregisterWatcher(_captureId);
+    }
+
     if (_inotifyFileDescriptor() >= 0)
     {
         std::ranges::for_each(_watchDescriptors, [this](const auto& wd) {
@@ -166,6 +221,10 @@ void DataWatcher::addToWatchList(const fs::path& pathToWatch,
             (fs::is_directory(pathToWatch) ? pathToWatch / "" : pathToWatch));
         lg2::debug("Watch added. PATH : {PATH}, wd : {WD}", "PATH",
                    _watchDescriptors[wd], "WD", wd);
+        if (_captureId != 0 && !writeCaptureSnapshot())
+        {
+            capture::watchAdded(_captureId, wd, _watchDescriptors[wd]);
+        }
     }
 }
 
@@ -378,17 +437,46 @@ void DataWatcher::createWatchers(const fs::path& pathToWatch)
 // NOLINTNEXTLINE
 sdbusplus::async::task<DataOperations> DataWatcher::onDataChange()
 {
-    // NOLINTNEXTLINE
-    co_await _fdioInstance->next();
+    std::optional<std::vector<EventInfo>> receivedEvents;
+    if (_ring != nullptr)
+    {
+        // NOLINTNEXTLINE
+        receivedEvents = co_await readEventsThroughRing();
+    }
+    else
+    {
+        // NOLINTNEXTLINE
+        co_await _fdioInstance->next();
+
+        metrics::ScopedSpan span(metrics::Stage::InotifyRead);
+        receivedEvents = readEvents();
+    }
 
-    if (auto receivedEvents = readEvents(); receivedEvents.has_value())
+    if (receivedEvents.has_value())
     {
+        metrics::ScopedSpan span(metrics::Stage::EventFilter);
         processEvents(receivedEvents.value());
     }
 
     co_return _dataOperations;
 }
 
+DataOperations DataWatcher::handleEvents()
+{
+    std::optional<std::vector<EventInfo>> receivedEvents;
+    {
+        metrics::ScopedSpan span(metrics::Stage::InotifyRead);
+        receivedEvents = readEvents();
+    }
+
+    if (receivedEvents.has_value())
+    {
+        metrics::ScopedSpan span(metrics::Stage::EventFilter);
+        processEvents(receivedEvents.value());
+    }
+    return _dataOperations;
+}
+
 std::optional<std::vector<EventInfo>> DataWatcher::readEvents()
 {
     // Before reading the events clear the map of data operation to remove the
@@ -398,12 +486,10 @@ std::optional<std::vector<EventInfo>> DataWatcher::readEvents()
         _dataOperations.clear();
     }
 
-    // Maximum inotify events supported in the buffer
-    constexpr auto maxBytes = sizeof(struct inotify_event) + NAME_MAX + 1;
-    uint8_t buffer[maxBytes];
-    std::memset(buffer, '\0', maxBytes);
+    alignas(struct inotify_event) uint8_t buffer[maxEventBytes];
+    std::memset(buffer, '\0', maxEventBytes);
 
-    auto bytes = read(_inotifyFileDescriptor(), buffer, maxBytes);
+    auto bytes = read(_inotifyFileDescriptor(), buffer, maxEventBytes);
     if (0 > bytes)
     {
         // In non blocking mode, read returns immediately with EAGAIN /
@@ -416,12 +502,77 @@ std::optional<std::vector<EventInfo>> DataWatcher::readEvents()
         return std::nullopt;
     }
 
-    auto offset = 0;
+    return receiveEvents(
+        std::span<const uint8_t>(buffer, static_cast<size_t>(bytes)));
+}
+
+sdbusplus::async::task<std::optional<std::vector<EventInfo>>>
+    // NOLINTNEXTLINE
+    DataWatcher::readEventsThroughRing()
+{
+    _dataOperations.clear();
+
+    // Allocated, as the alignment of the locals of a coroutine isn't kept
+    std::vector<char> buffer(maxEventBytes);
+    // NOLINTNEXTLINE
+    const auto bytes = co_await _ring->read(_inotifyFileDescriptor(), buffer);
+    if (0 > bytes)
+    {
+        if (bytes != -ECANCELED)
+        {
+            lg2::error("Failed to read inotify event, error: {ERROR}", "ERROR",
+                       strerror(static_cast<int>(-bytes)));
+        }
+        co_return std::nullopt;
+    }
+
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    co_return receiveEvents(std::span<const uint8_t>(
+        reinterpret_cast<const uint8_t*>(buffer.data()),
+        static_cast<size_t>(bytes)));
+}
+
+std::vector<EventInfo>
+    DataWatcher::receiveEvents(std::span<const uint8_t> events)
+{
+    if (_captureId != 0)
+    {
+        writeCaptureSnapshot();
+        capture::batch(_captureId, events);
+    }
+    return parseEvents(events);
+}
+
+bool DataWatcher::writeCaptureSnapshot()
+{
+    if (!_captureSnapshotPending.exchange(false, std::memory_order_acquire))
+    {
+        return false;
+    }
+
+    auto toVector = [](const auto& list) {
+        return list.has_value()
+                   ? std::vector<fs::path>(list->begin(), list->end())
+                   : std::vector<fs::path>{};
+    };
+    capture::watcher(_captureId, _eventMasksToWatch, _dataPathToWatch,
+                     toVector(_excludeList), toVector(_includeList));
+    for (const auto& [wd, path] : _watchDescriptors)
+    {
+        capture::watchAdded(_captureId, wd, path);
+    }
+    return true;
+}
+
+std::vector<EventInfo> DataWatcher::parseEvents(std::span<const uint8_t> buffer)
+{
+    size_t offset = 0;
     std::vector<EventInfo> receivedEvents{};
-    while (offset < bytes)
+    while (offset + sizeof(inotify_event) <= buffer.size())
     {
         // NOLINTNEXTLINE to avoid cppcoreguidelines-pro-type-reinterpret-cast
-        auto* receivedEvent = reinterpret_cast<inotify_event*>(&buffer[offset]);
+        const auto* receivedEvent =
+            reinterpret_cast<const inotify_event*>(&buffer[offset]);
 
         // Using find() because,
         // IN_IGNORED events can arrive for already removed watch descriptors
@@ -441,6 +592,11 @@ std::optional<std::vector<EventInfo>> DataWatcher::readEvents()
             receivedEvents.emplace_back(receivedEvent->wd, receivedEvent->name,
                                         receivedEvent->mask,
                                         receivedEvent->cookie);
+            recorder::record(recorder::EventType::EventReceived,
+                             receivedEvent->len != 0
+                                 ? std::string_view(receivedEvent->name)
+                                 : std::string_view(pathStr),
+                             receivedEvent->wd, receivedEvent->mask);
         }
         else
         {
@@ -534,6 +690,10 @@ std::optional<DataOperation>
     {
         return processDelete(receivedEventInfo);
     }
+    else if ((std::get<2>(receivedEventInfo) & IN_ATTRIB) != 0)
+    {
+        return processAttrib(receivedEventInfo);
+    }
     else
     {
         lg2::debug("Skipping the uninterested inotify event [{EVENTS}] ",
@@ -835,6 +995,36 @@ std::optional<DataOperation>
     return std::nullopt;
 }
 
+std::optional<DataOperation>
+    DataWatcher::processAttrib(const EventInfo& receivedEventInfo)
+{
+    // The BaseName is empty if the watched path itself changed
+    fs::path changedPath =
+        _watchDescriptors.at(std::get<WD>(receivedEventInfo));
+    if (!std::get<BaseName>(receivedEventInfo).empty())
+    {
+        changedPath /= std::get<BaseName>(receivedEventInfo);
+    }
+
+    // Skip the parent watched for a configured path which doesn't exist yet,
+    // and a path which is gone already as its IN_ATTRIB is of the unlink.
+    std::error_code ec;
+    if (!changedPath.string().starts_with(_dataPathToWatch.string()) ||
+        !fs::exists(changedPath, ec))
+    {
+        return std::nullopt;
+    }
+
+    // Only the directory itself, not its contents
+    if (!changedPath.has_filename())
+    {
+        changedPath = changedPath.parent_path();
+    }
+
+    lg2::debug("Processing an IN_ATTRIB for {PATH}", "PATH", changedPath);
+    return std::make_pair(changedPath, DataOps::METADATA);
+}
+
 void DataWatcher::removeIncludeParentWatches()
 {
     auto hasWatches = [this](const auto& incPath) {
@@ -871,6 +1061,10 @@ void DataWatcher::removeWatch(int wd)
 
     inotify_rm_watch(_inotifyFileDescriptor(), wd);
     _watchDescriptors.erase(wd);
+    if (_captureId != 0 && !writeCaptureSnapshot())
+    {
+        capture::watchRemoved(_captureId, wd);
+    }
 
     lg2::debug("Stopped monitoring {PATH}, WD : {WD}", "PATH", pathToRemove,
                "WD", wd);
@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include "io_ring.hpp"
 #include "utility.hpp"
 
 #include <sys/inotify.h>
@@ -9,9 +10,12 @@
 #include <data_sync_config.hpp>
 #include <sdbusplus/async.hpp>
 
+#include <atomic>
 #include <filesystem>
 #include <map>
+#include <span>
 #include <unordered_set>
+#include <utility>
 
 namespace data_sync::watch::inotify
 {
@@ -39,7 +43,8 @@ using EventInfo = std::tuple<WD, BaseName, EventMask, Cookie>;
 enum class DataOps
 {
     COPY,
-    DELETE
+    DELETE,
+    METADATA
 };
 
 /**
@@ -68,6 +73,27 @@ class DataWatcher
     DataWatcher(DataWatcher&&) = delete;
     DataWatcher& operator=(DataWatcher&&) = delete;
 
+    /**
+     * @brief Constructor
+     *
+     * Create watcher for directories/files which is driven by a reactor of
+     * its own through fd() and handleEvents(), rather than the async
+     * context.
+     *
+     *  @param[in] inotifyFlags - inotify flags to watch
+     *  @param[in] eventMasksToWatch - mask of interested events to watch
+     *  @param[in] dataPathToWatch - The absolute path to be monitored using
+     *                               inotify
+     *  @param[in] excludeList - The list of paths to be excluded from
+     *                           monitoring
+     *  @param[in] includeList - The list of paths should be included while
+     *                           monitoring
+     */
+    DataWatcher(
+        int inotifyFlags, uint32_t eventMasksToWatch, fs::path dataPathToWatch,
+        std::optional<std::unordered_set<fs::path>> excludeList = std::nullopt,
+        std::optional<std::unordered_set<fs::path>> includeList = std::nullopt);
+
     /**
      * @brief Constructor
      *
@@ -105,6 +131,23 @@ class DataWatcher
      */
     sdbusplus::async::task<DataOperations> onDataChange();
 
+    /**
+     * @brief API to read and process the pending inotify events, for the
+     *        watcher driven by a reactor of its own.
+     *
+     * @returns The data operations to take on the received events
+     */
+    DataOperations handleEvents();
+
+    /**
+     * @brief Get the file descriptor of the inotify instance, to poll for
+     *        the events.
+     */
+    int fd() const
+    {
+        return _inotifyFileDescriptor();
+    }
+
     /**
      * @brief Get the current watch descriptors map
      *
@@ -120,6 +163,110 @@ class DataWatcher
         return _watchDescriptors;
     }
 
+  protected:
+    // The event handling stages are protected to allow the benchmarks and the
+    // event replay to exercise them without reading the inotify instance.
+
+    /**
+     * @brief API to read the triggered events from inotify structure
+     *
+     * returns : The vector of events read from the buffer
+     *         : std::nullopt , in case of any errors while reading from buffer
+     */
+    std::optional<std::vector<EventInfo>> readEvents();
+
+    /**
+     * @brief API to read the triggered events through the io_uring of the
+     *        event loop, which completes once there are events.
+     *
+     * returns : The vector of events read from the buffer
+     *         : std::nullopt , in case of any errors while reading from buffer
+     */
+    sdbusplus::async::task<std::optional<std::vector<EventInfo>>>
+        readEventsThroughRing();
+
+    /**
+     * @brief API to capture and parse the given buffer of the events read
+     *        from the inotify file descriptor.
+     *
+     * @param[in] events - The buffer of inotify_event structures
+     *
+     * returns : The vector of interested events parsed from the buffer
+     */
+    std::vector<EventInfo> receiveEvents(std::span<const uint8_t> events);
+
+    /**
+     * @brief API to write the state of the watcher into the inotify event
+     *        capture, if a capture started since the last events.
+     *
+     * returns : true if written, it includes the current watches already
+     */
+    bool writeCaptureSnapshot();
+
+    /**
+     * @brief API to parse the inotify events from the given buffer which holds
+     *        the events as read from the inotify file descriptor.
+     *
+     * @param[in] buffer - The buffer of inotify_event structures
+     *
+     * returns : The vector of interested events parsed from the buffer
+     */
+    std::vector<EventInfo> parseEvents(std::span<const uint8_t> buffer);
+
+    /**
+     * @brief API to trigger processing of the received inotify events.
+     *
+     * @param[in] receivedEvents : The vector of type eventInfo type which has
+     *                             the information of received inotify events.
+     *
+     */
+    void processEvents(const std::vector<EventInfo>& receivedEvents);
+
+    /**
+     * @brief API to process each of the received inotify event and to determine
+     * the type of operation need to trigger for the event.
+     *
+     * @param[in] receivedEvent : eventInfo type which has the information of
+     *                            received  inotify event.
+     *
+     * @returns DataOperation : If the received event need to handle in rsync
+     *          std::nullopt  : If the received event doesn't need to handle.
+     */
+    std::optional<DataOperation> processEvent(const EventInfo& receivedEvent);
+
+    /**
+     * @brief API to check whether the given path is part of exclude list.
+     *        The API will check whether the given path is in the configured
+     *        excludeList or the path is child of any of the excluded path.
+     *
+     * @param[in] path - absolute path of the data
+     * returns : True : If path need to be exlcuded.
+     *           False : If path doesn't need to exlcude.
+     */
+    bool isPathExcluded(const fs::path& path);
+
+    /**
+     * @brief API to check whether the given path is part of include list
+     *        The API will check whether the given path is in the configured
+     *        includeList or the path is a child of any of the included path.
+     *
+     * @param[in] path - absolute path of the data
+     * returns : True : If path need to be inlcuded.
+     *           False : If path doesn't need to inlcude.
+     */
+    bool isPathIncluded(const fs::path& path);
+
+    /**
+     * @brief API to take the data operations determined from the last
+     *        processed events.
+     *
+     * @returns DataOperations - The data operations, cleared in the watcher
+     */
+    DataOperations takeDataOperations()
+    {
+        return std::exchange(_dataOperations, {});
+    }
+
   private:
     /**
      * @brief inotify flags
@@ -184,6 +331,12 @@ class DataWatcher
      */
     std::unique_ptr<sdbusplus::async::fdio> _fdioInstance;
 
+    /**
+     * @brief The io_uring which reads the events instead of the fdio
+     *        instance, if the event loop has one
+     */
+    io::Ring* _ring{nullptr};
+
     /**
      * @brief Map of DataOperation
      */
@@ -197,6 +350,17 @@ class DataWatcher
      */
     std::map<Cookie, DataOperation> _movedFromDataOps;
 
+    /**
+     * @brief The id of the watcher in the inotify event capture
+     */
+    uint16_t _captureId{0};
+
+    /**
+     * @brief Set by the thread which starts a capture, until the thread
+     *        driving the watcher writes its state into the capture
+     */
+    std::atomic<bool> _captureSnapshotPending{false};
+
     /**
      * @brief initialize an inotify instance and returns file descriptor
      */
@@ -232,28 +396,6 @@ class DataWatcher
     void addToWatchList(const fs::path& pathToWatch,
                         uint32_t eventMasksToWatch);
 
-    /**
-     * @brief API to check whether the given path is part of exclude list.
-     *        The API will check whether the given path is in the configured
-     *        excludeList or the path is child of any of the excluded path.
-     *
-     * @param[in] path - absolute path of the data
-     * returns : True : If path need to be exlcuded.
-     *           False : If path doesn't need to exlcude.
-     */
-    bool isPathExcluded(const fs::path& path);
-
-    /**
-     * @brief API to check whether the given path is part of include list
-     *        The API will check whether the given path is in the configured
-     *        includeList or the path is a child of any of the included path.
-     *
-     * @param[in] path - absolute path of the data
-     * returns : True : If path need to be inlcuded.
-     *           False : If path doesn't need to inlcude.
-     */
-    bool isPathIncluded(const fs::path& path);
-
     /**
      * @brief Checks whether the given path is a parent of any configured
      *        include list paths.
@@ -282,35 +424,6 @@ class DataWatcher
      */
     void createWatchers(const std::filesystem::path& pathToWatch);
 
-    /**
-     * @brief API to read the triggered events from inotify structure
-     *
-     * returns : The vector of events read from the buffer
-     *         : std::nullopt , in case of any errors while reading from buffer
-     */
-    std::optional<std::vector<EventInfo>> readEvents();
-
-    /**
-     * @brief API to trigger processing of the received inotify events.
-     *
-     * @param[in] receivedEvents : The vector of type eventInfo type which has
-     *                             the information of received inotify events.
-     *
-     */
-    void processEvents(const std::vector<EventInfo>& receivedEvents);
-
-    /**
-     * @brief API to process each of the received inotify event and to determine
-     * the type of operation need to trigger for the event.
-     *
-     * @param[in] receivedEvent : eventInfo type which has the information of
-     *                            received  inotify event.
-     *
-     * @returns DataOperation : If the received event need to handle in rsync
-     *          std::nullopt  : If the received event doesn't need to handle.
-     */
-    std::optional<DataOperation> processEvent(const EventInfo& receivedEvent);
-
     /**
      * @brief API to handle the received IN_CLOSE_WRITE inotify events
      *
@@ -371,6 +484,19 @@ class DataWatcher
     std::optional<DataOperation>
         processDelete(const EventInfo& receivedEventInfo);
 
+    /**
+     * @brief API to handle the received IN_ATTRIB inotify events, which
+     *        change only the metadata (mode, owner, times) of a path.
+     *
+     * @param[in] receivedEventInfo : eventInfo type which has the information
+     *                                of received  inotify event.
+     *
+     * @returns DataOperation : If the received event need to handle in rsync
+     *          std::nullopt  : If the received event doesn't need to handle.
+     */
+    std::optional<DataOperation>
+        processAttrib(const EventInfo& receivedEventInfo);
+
     /**
      * @brief API to handle the received IN_DELETE_SELF inotify events
      *
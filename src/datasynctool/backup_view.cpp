@@ -0,0 +1,145 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "backup_view.hpp"
+
+#include "config.h"
+
+#include "chunk_store.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <chrono>
+#include <exception>
+#include <format>
+#include <print>
+
+namespace datasynctool::backup_view
+{
+
+namespace bkp = data_sync::backup;
+
+namespace
+{
+
+/**
+ * @brief Format the seconds since the epoch as UTC time.
+ */
+std::string formatTime(uint64_t timeSec)
+{
+    using namespace std::chrono;
+    const sys_seconds time{seconds(timeSec)};
+    return std::format("{:%FT%T}Z", time);
+}
+
+} // namespace
+
+int backup(const std::string& source, bool jsonOutput)
+{
+    try
+    {
+        bkp::ChunkStore store(bkp::defaultStoreDir,
+                              BACKUP_RETAINED_VERSIONS);
+        const auto stats = store.backup(source);
+
+        if (jsonOutput)
+        {
+            nlohmann::ordered_json backupJson{
+                {"Version", stats.version},
+                {"Files", stats.files},
+                {"LogicalBytes", stats.logicalBytes},
+                {"WrittenBytes", stats.writtenBytes},
+                {"Chunks", stats.chunks},
+                {"NewChunks", stats.newChunks},
+                {"WriteAmplification", stats.writeAmplification()}};
+            std::println("{}", backupJson.dump(4));
+            return 0;
+        }
+
+        std::println("Backed up {} as version {}", source, stats.version);
+        std::println("  Files               : {}", stats.files);
+        std::println("  Chunks (new)        : {} ({})", stats.chunks,
+                     stats.newChunks);
+        std::println("  Plain copy bytes    : {}", stats.logicalBytes);
+        std::println("  Written bytes       : {}", stats.writtenBytes);
+        std::println("  Write amplification : {:.3f}",
+                     stats.writeAmplification());
+    }
+    catch (const std::exception& e)
+    {
+        std::println(stderr, "Failed to back up {}: {}", source, e.what());
+        return 1;
+    }
+    return 0;
+}
+
+int listVersions(bool jsonOutput)
+{
+    try
+    {
+        bkp::ChunkStore store(bkp::defaultStoreDir,
+                              BACKUP_RETAINED_VERSIONS);
+        const auto versions = store.versions();
+        const auto stats = store.stats();
+
+        if (jsonOutput)
+        {
+            auto versionsJson = nlohmann::ordered_json::array();
+            for (const auto& version : versions)
+            {
+                versionsJson.push_back(
+                    {{"Version", version.version},
+                     {"Time", formatTime(version.timeSec)},
+                     {"Source", version.source},
+                     {"Files", version.files},
+                     {"LogicalBytes", version.logicalBytes}});
+            }
+            nlohmann::ordered_json storeJson{
+                {"Versions", std::move(versionsJson)},
+                {"LogicalBytes", stats.logicalBytes},
+                {"StoredBytes", stats.storedBytes},
+                {"Chunks", stats.chunks},
+                {"DedupRatio", stats.dedupRatio()}};
+            std::println("{}", storeJson.dump(4));
+            return 0;
+        }
+
+        std::println("{:>8} {:<22} {:>6} {:>12}  {}", "VERSION", "TIME",
+                     "FILES", "BYTES", "SOURCE");
+        for (const auto& version : versions)
+        {
+            std::println("{:>8} {:<22} {:>6} {:>12}  {}", version.version,
+                         formatTime(version.timeSec), version.files,
+                         version.logicalBytes, version.source);
+        }
+        std::println("\n{} bytes of plain copies stored in {} bytes, {} "
+                     "chunks, dedup ratio {:.2f}",
+                     stats.logicalBytes, stats.storedBytes, stats.chunks,
+                     stats.dedupRatio());
+    }
+    catch (const std::exception& e)
+    {
+        std::println(stderr, "Failed to read the backup store: {}", e.what());
+        return 1;
+    }
+    return 0;
+}
+
+int restore(uint64_t version, const std::string& destination)
+{
+    try
+    {
+        bkp::ChunkStore store(bkp::defaultStoreDir,
+                              BACKUP_RETAINED_VERSIONS);
+        store.restore(version, destination);
+    }
+    catch (const std::exception& e)
+    {
+        std::println(stderr, "Failed to restore the version {}: {}", version,
+                     e.what());
+        return 1;
+    }
+    std::println("Restored the version {} into {}", version, destination);
+    return 0;
+}
+
+} // namespace datasynctool::backup_view
@@ -0,0 +1,41 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace datasynctool::backup_view
+{
+
+/**
+ * @brief Back up the given path as a new version in the deduplicated backup
+ *        store and display its cost against a plain copy
+ *
+ * @param[in] source - The file or directory to back up
+ * @param[in] jsonOutput - Output in JSON format if true
+ *
+ * @return int - 0 on success; 1 on failure
+ */
+int backup(const std::string& source, bool jsonOutput);
+
+/**
+ * @brief Display the versions in the backup store along with the dedup
+ *        ratio of the store against plain copies
+ *
+ * @param[in] jsonOutput - Output in JSON format if true
+ *
+ * @return int - 0 on success; 1 on failure
+ */
+int listVersions(bool jsonOutput);
+
+/**
+ * @brief Restore the given version from the backup store
+ *
+ * @param[in] version - The version to restore
+ * @param[in] destination - The directory to restore into
+ *
+ * @return int - 0 on success; 1 on failure
+ */
+int restore(uint64_t version, const std::string& destination);
+
+} // namespace datasynctool::backup_view
@@ -2,6 +2,7 @@
 
 #include "dbus_interactions.hpp"
 
+#include "sync_path_iface.hpp"
 #include "utils.hpp"
 
 #include <phosphor-logging/lg2.hpp>
@@ -138,6 +139,34 @@ sdbusplus::async::task<> startFullSync(sdbusplus::async::context& ctx)
     }
 }
 
+sdbusplus::async::task<> syncPath(sdbusplus::async::context& ctx,
+                                  const std::string& path,
+                                  std::chrono::milliseconds timeout)
+{
+    try
+    {
+        lg2::info("datasynctool requesting the sync of {PATH}", "PATH", path);
+
+        auto synced = co_await sdbusplus::async::proxy()
+                          .service(SyncBMCData::interface)
+                          .path(SyncBMCData::instance_path)
+                          .interface(data_sync::dbus_ifaces::SyncPathIface::
+                                         interface)
+                          .call<bool>(ctx, "SyncPath", path,
+                                      static_cast<uint64_t>(timeout.count()));
+
+        std::println("{} {} to the sibling", path,
+                     synced ? "is synced" : "is not synced within the timeout");
+
+        co_return;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Error syncing " << path << ": " << e.what() << "\n";
+        throw;
+    }
+}
+
 sdbusplus::async::task<> setSyncEnabled(sdbusplus::async::context& ctx,
                                         bool enable)
 {
@@ -5,6 +5,7 @@
 #include <sdbusplus/async.hpp>
 #include <sdbusplus/bus.hpp>
 
+#include <chrono>
 #include <map>
 #include <string>
 #include <variant>
@@ -54,6 +55,20 @@ sdbusplus::async::task<> displayStatus(sdbusplus::async::context& ctx,
  */
 sdbusplus::async::task<> startFullSync(sdbusplus::async::context& ctx);
 
+/**
+ * @brief Sync the given path to the sibling right away and wait for the
+ *        sibling to confirm
+ *
+ * @param[in] ctx - Async context
+ * @param[in] path - The path to sync
+ * @param[in] timeout - The maximum time to wait for the sibling
+ *
+ * @return async task
+ */
+sdbusplus::async::task<> syncPath(sdbusplus::async::context& ctx,
+                                  const std::string& path,
+                                  std::chrono::milliseconds timeout);
+
 /**
  * @brief Set sync enabled/disabled state
  *
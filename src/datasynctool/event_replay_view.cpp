@@ -0,0 +1,142 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "event_replay_view.hpp"
+
+#include "config.h"
+
+#include "event_replay.hpp"
+#include "metrics_control.hpp"
+
+#include <nlohmann/json.hpp>
+#include <sdbusplus/async.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <format>
+#include <print>
+#include <vector>
+
+namespace datasynctool::event_replay_view
+{
+
+namespace replay_ns = data_sync::watch::replay;
+using data_sync::watch::inotify::DataOps;
+
+namespace
+{
+
+/**
+ * @brief The directory where the captured trees are recreated for the replay
+ */
+constexpr auto shadowRoot = "/tmp/phosphor-data-sync-replay";
+
+std::string opName(DataOps op)
+{
+    switch (op)
+    {
+        case DataOps::COPY:
+            return "COPY";
+        case DataOps::DELETE:
+            return "DELETE";
+        case DataOps::METADATA:
+            return "METADATA";
+    }
+    return "UNKNOWN";
+}
+
+} // namespace
+
+int capture(const std::string& action)
+{
+    using data_sync::metrics::Command;
+    const bool start = action == "start";
+    if (!metrics_control::signalDaemon(start ? Command::StartEventCapture
+                                             : Command::StopEventCapture))
+    {
+        return 1;
+    }
+
+    std::println("{} capturing the inotify events into {}",
+                 start ? "Started" : "Stopped", EVENT_CAPTURE_FILE);
+    return 0;
+}
+
+int replay(const std::string& captureFile, double speed, bool jsonOutput)
+{
+    replay_ns::ReplayReport report;
+    try
+    {
+        // The replayed watchers only need a context to be constructed
+        sdbusplus::async::context ctx;
+        report = replay_ns::replay(
+            ctx, captureFile.empty() ? EVENT_CAPTURE_FILE : captureFile,
+            {.shadowRoot = shadowRoot, .speed = speed});
+    }
+    catch (const std::exception& e)
+    {
+        std::println(stderr, "Failed to replay the capture: {}", e.what());
+        return 1;
+    }
+
+    std::vector<uint64_t> costsNs;
+    size_t events{0};
+    for (const auto& batch : report.batches)
+    {
+        costsNs.push_back(batch.cost.count());
+        events += batch.events;
+    }
+    std::ranges::sort(costsNs);
+    auto percentile = [&costsNs](size_t pct) -> uint64_t {
+        return costsNs.empty() ? 0 : costsNs[(costsNs.size() - 1) * pct / 100];
+    };
+
+    if (jsonOutput)
+    {
+        nlohmann::ordered_json out;
+        for (const auto& batch : report.batches)
+        {
+            nlohmann::ordered_json ops = nlohmann::ordered_json::array();
+            for (const auto& [path, op] : batch.operations)
+            {
+                ops.push_back({{"Path", path.string()}, {"Op", opName(op)}});
+            }
+            out["Batches"].push_back(
+                {{"CapturedAtNs", batch.capturedAt.count()},
+                 {"Watcher", batch.watcherPath.string()},
+                 {"Events", batch.events},
+                 {"CostNs", batch.cost.count()},
+                 {"Operations", ops}});
+        }
+        out["Summary"] = {{"Batches", report.batches.size()},
+                          {"Events", events},
+                          {"UnmatchedEvents", report.unmatchedEvents},
+                          {"P50CostNs", percentile(50)},
+                          {"P99CostNs", percentile(99)},
+                          {"MaxCostNs", costsNs.empty() ? 0 : costsNs.back()}};
+        std::println("{}", out.dump(4));
+        return 0;
+    }
+
+    std::println("{:>14} {:>7} {:>10}  {}", "TIME(ms)", "EVENTS", "COST(us)",
+                 "OPERATIONS");
+    for (const auto& batch : report.batches)
+    {
+        std::string ops;
+        for (const auto& [path, op] : batch.operations)
+        {
+            ops += std::format("{} {}  ", opName(op), path.string());
+        }
+        std::println("{:>14.3f} {:>7} {:>10.1f}  {}",
+                     static_cast<double>(batch.capturedAt.count()) / 1e6,
+                     batch.events,
+                     static_cast<double>(batch.cost.count()) / 1e3, ops);
+    }
+    std::println("\n{} batches, {} events, {} unmatched; processing cost "
+                 "p50 {}ns, p99 {}ns",
+                 report.batches.size(), events, report.unmatchedEvents,
+                 percentile(50), percentile(99));
+    return 0;
+}
+
+} // namespace datasynctool::event_replay_view
@@ -0,0 +1,32 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <string>
+
+namespace datasynctool::event_replay_view
+{
+
+/**
+ * @brief Start or stop capturing the inotify events in phosphor-data-sync
+ *
+ * @param[in] action - Either "start" or "stop"
+ *
+ * @return int - 0 on success; 1 on failure
+ */
+int capture(const std::string& action);
+
+/**
+ * @brief Replay the given inotify event capture and display the resulting
+ *        data operations and processing cost of each batch
+ *
+ * @param[in] captureFile - The capture file; if empty, the default capture
+ *                          file of the daemon.
+ * @param[in] speed - The replay speed relative to the captured timing, zero
+ *                    to replay as fast as possible.
+ * @param[in] jsonOutput - Output in JSON format if true
+ *
+ * @return int - 0 on success; 1 on failure
+ */
+int replay(const std::string& captureFile, double speed, bool jsonOutput);
+
+} // namespace datasynctool::event_replay_view
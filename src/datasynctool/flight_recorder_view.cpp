@@ -0,0 +1,131 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "flight_recorder_view.hpp"
+
+#include "config.h"
+
+#include "flight_recorder.hpp"
+#include "metrics_control.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <chrono>
+#include <exception>
+#include <filesystem>
+#include <format>
+#include <print>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace datasynctool::flight_recorder_view
+{
+
+namespace fs = std::filesystem;
+namespace recorder = data_sync::recorder;
+
+namespace
+{
+
+/**
+ * @brief Format the CLOCK_REALTIME microseconds as UTC time.
+ */
+std::string formatTime(uint64_t timeUs)
+{
+    using namespace std::chrono;
+    const sys_time<microseconds> time{microseconds(timeUs)};
+    return std::format("{:%FT%T}Z", time);
+}
+
+/**
+ * @brief Request the running daemon for a fresh dump and wait until the
+ *        dump file gets replaced.
+ */
+bool requestDump()
+{
+    constexpr auto maxWait = std::chrono::seconds(2);
+    constexpr auto pollInterval = std::chrono::milliseconds(20);
+
+    std::error_code ec;
+    const auto prevWriteTime = fs::last_write_time(FLIGHT_RECORDER_FILE, ec);
+
+    if (!metrics_control::signalDaemon(
+            data_sync::metrics::Command::DumpFlightRecorder))
+    {
+        return false;
+    }
+
+    const auto deadline = std::chrono::steady_clock::now() + maxWait;
+    while (std::chrono::steady_clock::now() < deadline)
+    {
+        const auto writeTime = fs::last_write_time(FLIGHT_RECORDER_FILE, ec);
+        if (!ec && writeTime != prevWriteTime)
+        {
+            return true;
+        }
+        std::this_thread::sleep_for(pollInterval);
+    }
+    std::println(stderr, "Timed out waiting for the flight recorder dump {}",
+                 FLIGHT_RECORDER_FILE);
+    return false;
+}
+
+} // namespace
+
+int display(const std::string& dumpFile, bool jsonOutput)
+{
+    if (dumpFile.empty() && !requestDump())
+    {
+        return 1;
+    }
+
+    const fs::path filePath = dumpFile.empty() ? FLIGHT_RECORDER_FILE
+                                               : dumpFile;
+    recorder::DumpHeader header{};
+    std::vector<recorder::Record> records;
+    try
+    {
+        records = recorder::readDump(filePath, header);
+    }
+    catch (const std::exception& e)
+    {
+        std::println(stderr, "{}", e.what());
+        return 1;
+    }
+
+    if (jsonOutput)
+    {
+        nlohmann::ordered_json dumpJson;
+        dumpJson["DaemonPid"] = header.daemonPid;
+        dumpJson["DumpTime"] = formatTime(header.dumpTimeUs);
+
+        auto entries = nlohmann::ordered_json::array();
+        for (const auto& entry : records)
+        {
+            entries.push_back(
+                {{"Time", formatTime(entry.timeUs)},
+                 {"Event", std::string(recorder::eventTypeName(entry.type))},
+                 {"Path", std::string(entry.path)},
+                 {"Code", entry.code},
+                 {"Value", entry.value}});
+        }
+        dumpJson["Entries"] = std::move(entries);
+        std::println("{}", dumpJson.dump(4));
+        return 0;
+    }
+
+    std::println("Flight recorder dump of pid {} at {}, {} entries\n",
+                 header.daemonPid, formatTime(header.dumpTimeUs),
+                 records.size());
+    std::println("{:<28} {:<14} {:>6} {:>12}  {}", "TIME", "EVENT", "CODE",
+                 "VALUE", "PATH");
+    for (const auto& entry : records)
+    {
+        std::println("{:<28} {:<14} {:>6} {:>12}  {}", formatTime(entry.timeUs),
+                     recorder::eventTypeName(entry.type), entry.code,
+                     entry.value, std::string(entry.path));
+    }
+    return 0;
+}
+
+} // namespace datasynctool::flight_recorder_view
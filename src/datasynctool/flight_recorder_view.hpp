@@ -0,0 +1,20 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <string>
+
+namespace datasynctool::flight_recorder_view
+{
+
+/**
+ * @brief Display the flight recorder entries of phosphor-data-sync
+ *
+ * @param[in] dumpFile - The dump file to decode; if empty, the running daemon
+ *                       is requested for a fresh dump into the default file.
+ * @param[in] jsonOutput - Output in JSON format if true
+ *
+ * @return int - 0 on success; 1 on failure
+ */
+int display(const std::string& dumpFile, bool jsonOutput);
+
+} // namespace datasynctool::flight_recorder_view
@@ -1,7 +1,12 @@
 // SPDX-License-Identifier: Apache-2.0
 
+#include "backup_view.hpp"
 #include "config_options.hpp"
 #include "dbus_interactions.hpp"
+#include "event_replay_view.hpp"
+#include "flight_recorder_view.hpp"
+#include "metrics_control.hpp"
+#include "status_view.hpp"
 
 #include <CLI/CLI.hpp>
 #include <sdbusplus/async.hpp>
@@ -19,6 +24,22 @@ int main(int argc, char* argv[])
     bool fullSync{false};
     fullSyncGroup->add_flag("-f,--fullSync", fullSync, "Start a full sync");
 
+    std::string syncPath;
+    fullSyncGroup
+        ->add_option("--syncPath", syncPath,
+                     "Sync the given path to the sibling right away and wait "
+                     "until the sibling has it")
+        ->type_name("<AbsoluteDataPath>")
+        ->check(CLI::ExistingPath);
+
+    uint64_t syncTimeoutInMs{5000};
+    fullSyncGroup
+        ->add_option("--syncTimeout", syncTimeoutInMs,
+                     "The maximum time to wait for the sibling with "
+                     "--syncPath (in milliseconds)")
+        ->type_name("<TimeoutInMs>")
+        ->check(CLI::PositiveNumber);
+
     auto* statusGroup = app.add_option_group(
         "Status Display", "Display current status of phosphor-data-sync");
 
@@ -28,6 +49,56 @@ int main(int argc, char* argv[])
     bool jsonOutput{false};
     statusGroup->add_flag("-j,--json", jsonOutput, "Display in JSON format");
 
+    uint32_t topIntervalInSec{0};
+    statusGroup
+        ->add_option(
+            "-t,--top", topIntervalInSec,
+            "Display the live sync counters from the shared status page, "
+            "refreshing at the given interval (in seconds, 0 to display once)")
+        ->type_name("<IntervalInSec>")
+        ->expected(0, 1)
+        ->default_val(1);
+
+    std::string metricsCmd;
+    statusGroup
+        ->add_option("-m,--metrics", metricsCmd,
+                     "Control the sync pipeline timing metrics of the daemon")
+        ->check(CLI::IsMember({"enable", "disable", "dump", "reset"}));
+
+    std::string flightRecorderFile;
+    statusGroup
+        ->add_option(
+            "-r,--flightRecorder", flightRecorderFile,
+            "Display the recent sync events from the daemon's flight recorder, "
+            "or decode the given dump file")
+        ->type_name("<DumpFile>")
+        ->expected(0, 1)
+        ->default_val("");
+
+    std::string captureCmd;
+    statusGroup
+        ->add_option("-c,--capture", captureCmd,
+                     "Start or stop capturing the inotify events of the daemon")
+        ->check(CLI::IsMember({"start", "stop"}));
+
+    std::string captureFile;
+    statusGroup
+        ->add_option(
+            "--replay", captureFile,
+            "Replay the daemon's inotify event capture, or the given capture "
+            "file, and display the resulting sync operations and their cost")
+        ->type_name("<CaptureFile>")
+        ->expected(0, 1)
+        ->default_val("");
+
+    double replaySpeed{0};
+    statusGroup
+        ->add_option("--replaySpeed", replaySpeed,
+                     "Replay at the given factor of the captured timing, "
+                     "0 to replay as fast as possible")
+        ->type_name("<Factor>")
+        ->check(CLI::NonNegativeNumber);
+
     auto* syncEnableGroup = app.add_option_group("Sync Enable",
                                                  "Enable or disable sync");
 
@@ -64,6 +135,38 @@ int main(int argc, char* argv[])
         ->expected(0, 1)
         ->default_val("");
 
+    auto* backupGroup = app.add_option_group(
+        "Backup", "Versioned backups of the data in the deduplicated store");
+
+    std::string backupPath;
+    backupGroup
+        ->add_option("--backup", backupPath,
+                     "Back up the given path as a new version and display "
+                     "its cost against a plain copy")
+        ->type_name("<AbsoluteDataPath>")
+        ->check(CLI::ExistingPath);
+
+    bool listBackups{false};
+    backupGroup->add_flag(
+        "--listBackups", listBackups,
+        "List the backed up versions and the dedup ratio of the store");
+
+    uint64_t restoreVersion{0};
+    auto* restoreOpt =
+        backupGroup
+            ->add_option("--restore", restoreVersion,
+                         "Restore the given backed up version")
+            ->type_name("<Version>");
+
+    std::string restoreDir;
+    auto* restoreToOpt =
+        backupGroup
+            ->add_option("--restoreTo", restoreDir,
+                         "The directory to restore the version into")
+            ->type_name("<Directory>");
+    restoreOpt->needs(restoreToOpt);
+    restoreToOpt->needs(restoreOpt);
+
     // Parse command line arguments
     if (argc == 1)
     {
@@ -73,6 +176,54 @@ int main(int argc, char* argv[])
 
     CLI11_PARSE(app, argc, argv);
 
+    if (app.count("--top") != 0U)
+    {
+        // The status page is sampled directly, so no D-Bus context is needed
+        return datasynctool::status_view::runTop(
+            std::chrono::seconds(topIntervalInSec), jsonOutput);
+    }
+
+    if (app.count("--flightRecorder") != 0U)
+    {
+        return datasynctool::flight_recorder_view::display(flightRecorderFile,
+                                                           jsonOutput);
+    }
+
+    if (!captureCmd.empty())
+    {
+        return datasynctool::event_replay_view::capture(captureCmd);
+    }
+
+    if (app.count("--replay") != 0U)
+    {
+        // The capture is replayed locally, it doesn't involve the daemon
+        return datasynctool::event_replay_view::replay(captureFile,
+                                                       replaySpeed, jsonOutput);
+    }
+
+    // The backup store is accessed locally, it doesn't involve the daemon
+    if (!backupPath.empty())
+    {
+        return datasynctool::backup_view::backup(backupPath, jsonOutput);
+    }
+
+    if (listBackups)
+    {
+        return datasynctool::backup_view::listVersions(jsonOutput);
+    }
+
+    if (*restoreOpt)
+    {
+        return datasynctool::backup_view::restore(restoreVersion, restoreDir);
+    }
+
+    if (!metricsCmd.empty())
+    {
+        // The daemon is controlled via signal, so no D-Bus context is needed
+        return datasynctool::metrics_control::sendCommand(metricsCmd,
+                                                          jsonOutput);
+    }
+
     sdbusplus::async::context ctx;
 
     if (enableSync)
@@ -116,6 +267,12 @@ int main(int argc, char* argv[])
         ctx.spawn(datasynctool::dbus_interactions::startFullSync(ctx));
     }
 
+    if (!syncPath.empty())
+    {
+        ctx.spawn(datasynctool::dbus_interactions::syncPath(
+            ctx, syncPath, std::chrono::milliseconds(syncTimeoutInMs)));
+    }
+
     ctx.spawn(
         sdbusplus::async::execution::just() |
         sdbusplus::async::execution::then([&ctx]() { ctx.request_stop(); }));
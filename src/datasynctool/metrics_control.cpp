@@ -0,0 +1,153 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "metrics_control.hpp"
+
+#include "config.h"
+
+#include "status_page.hpp"
+#include "sync_metrics.hpp"
+
+#include <signal.h>
+
+#include <nlohmann/json.hpp>
+
+#include <chrono>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <print>
+#include <thread>
+#include <utility>
+
+namespace datasynctool::metrics_control
+{
+
+using Command = data_sync::metrics::Command;
+namespace fs = std::filesystem;
+
+namespace
+{
+
+/**
+ * @brief Wait for the daemon to publish the requested dump and display it.
+ */
+int displayDump(bool jsonOutput)
+{
+    constexpr auto maxWait = std::chrono::seconds(2);
+    constexpr auto pollInterval = std::chrono::milliseconds(20);
+
+    const auto deadline = std::chrono::steady_clock::now() + maxWait;
+    while (!fs::exists(data_sync::metrics::dumpFile))
+    {
+        if (std::chrono::steady_clock::now() >= deadline)
+        {
+            std::println(stderr, "Timed out waiting for the metrics dump {}",
+                         data_sync::metrics::dumpFile);
+            return 1;
+        }
+        std::this_thread::sleep_for(pollInterval);
+    }
+
+    std::ifstream dumpFile(data_sync::metrics::dumpFile);
+    auto metricsJson = nlohmann::ordered_json::parse(dumpFile, nullptr, false);
+    if (metricsJson.is_discarded())
+    {
+        std::println(stderr, "Failed to parse the metrics dump {}",
+                     data_sync::metrics::dumpFile);
+        return 1;
+    }
+
+    if (jsonOutput)
+    {
+        std::println("{}", metricsJson.dump(4));
+        return 0;
+    }
+
+    std::println("Collection enabled: {}\n",
+                 metricsJson.value("Enabled", false));
+    std::println("{:<16} {:>10} {:>10} {:>10} {:>10} {:>12}", "STAGE", "COUNT",
+                 "AVG(us)", "P50(us)", "P99(us)", "MAX(us)");
+    for (const auto& [stage, hist] : metricsJson["Stages"].items())
+    {
+        std::println("{:<16} {:>10} {:>10} {:>10} {:>10} {:>12}", stage,
+                     hist.value("Count", uint64_t{0}),
+                     hist.value("AvgUs", uint64_t{0}),
+                     hist.value("P50Us", uint64_t{0}),
+                     hist.value("P99Us", uint64_t{0}),
+                     hist.value("MaxUs", uint64_t{0}));
+    }
+    return 0;
+}
+
+} // namespace
+
+bool signalDaemon(Command command)
+{
+    pid_t daemonPid{-1};
+    try
+    {
+        data_sync::status::StatusPageReader reader(STATUS_PAGE_FILE);
+        if (auto page = reader.snapshot(); page.has_value())
+        {
+            daemonPid = static_cast<pid_t>(page->daemonPid);
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::println(stderr, "Status page is not available: {}", e.what());
+        return false;
+    }
+
+    if (daemonPid <= 0)
+    {
+        std::println(stderr, "Failed to find the phosphor-data-sync process");
+        return false;
+    }
+
+    sigval value{};
+    value.sival_int = std::to_underlying(command);
+    if (sigqueue(daemonPid, SIGUSR2, value) != 0)
+    {
+        std::println(stderr, "Failed to send the command to the daemon: {}",
+                     std::strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+int sendCommand(const std::string& command, bool jsonOutput)
+{
+    static const std::map<std::string, Command> commands{
+        {"enable", Command::Enable},
+        {"disable", Command::Disable},
+        {"dump", Command::Dump},
+        {"reset", Command::Reset}};
+
+    auto cmdIt = commands.find(command);
+    if (cmdIt == commands.end())
+    {
+        std::println(stderr, "Unknown metrics command: {}", command);
+        return 1;
+    }
+
+    if (cmdIt->second == Command::Dump)
+    {
+        std::error_code ec;
+        fs::remove(data_sync::metrics::dumpFile, ec);
+    }
+
+    if (!signalDaemon(cmdIt->second))
+    {
+        return 1;
+    }
+
+    if (cmdIt->second == Command::Dump)
+    {
+        return displayDump(jsonOutput);
+    }
+    return 0;
+}
+
+} // namespace datasynctool::metrics_control
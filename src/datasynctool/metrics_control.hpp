@@ -0,0 +1,35 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include "sync_metrics.hpp"
+
+#include <string>
+
+namespace datasynctool::metrics_control
+{
+
+/**
+ * @brief Send the given command to phosphor-data-sync along with SIGUSR2
+ *
+ * The daemon is located through the shared status page.
+ *
+ * @param[in] command - The command to send
+ *
+ * @return bool - true if the command is sent; otherwise false
+ */
+bool signalDaemon(data_sync::metrics::Command command);
+
+/**
+ * @brief Send the metrics control command to phosphor-data-sync
+ *
+ * The daemon is located through the shared status page and the command is
+ * sent along with SIGUSR2 via sigqueue().
+ *
+ * @param[in] command - One of "enable", "disable", "dump" or "reset"
+ * @param[in] jsonOutput - Output the dumped metrics in JSON format if true
+ *
+ * @return int - 0 on success; 1 on failure
+ */
+int sendCommand(const std::string& command, bool jsonOutput);
+
+} // namespace datasynctool::metrics_control
@@ -0,0 +1,173 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "status_view.hpp"
+
+#include "config.h"
+
+#include "utils.hpp"
+
+#include <sdbusplus/message/native_types.hpp>
+#include <xyz/openbmc_project/Control/SyncBMCData/common.hpp>
+
+#include <exception>
+#include <print>
+#include <string>
+#include <thread>
+
+namespace datasynctool::status_view
+{
+
+using SyncBMCData =
+    sdbusplus::common::xyz::openbmc_project::control::SyncBMCData;
+
+namespace
+{
+
+template <typename EnumType>
+std::string enumName(uint8_t value)
+{
+    return utils::extractEnumValue(sdbusplus::message::convert_to_string(
+        static_cast<EnumType>(value)));
+}
+
+/**
+ * @brief Display the snapshot as a table, the rates are derived from the
+ *        previous snapshot if available.
+ */
+void displayTable(const data_sync::status::Page& page,
+                  const data_sync::status::Page* prevPage)
+{
+    std::println("phosphor-data-sync (pid {})  SyncEventsHealth: {}  "
+                 "FullSyncStatus: {}  DisableSync: {}",
+                 page.daemonPid,
+                 enumName<SyncBMCData::SyncEventsHealth>(page.syncEventsHealth),
+                 enumName<SyncBMCData::FullSyncStatus>(page.fullSyncStatus),
+                 page.disableSync != 0);
+    std::println("Queue depth: {}  In-flight syncs: {}  Scrub passes: {}  "
+                 "Scrub coverage: {}%\n",
+                 page.queueDepth, page.inFlightSyncs, page.scrubPasses,
+                 page.scrubCoverage);
+
+    std::println("{:<48} {:>8} {:>8} {:>8} {:>8} {:>12} {:>10} {:>5} {:>7}",
+                 "PATH", "STARTED", "OK", "FAILED", "RETRIES", "BYTES",
+                 "BYTES/S", "EXIT", "BATCHED");
+
+    double elapsedSec = 0;
+    if (prevPage != nullptr && page.updatedTimeUs > prevPage->updatedTimeUs)
+    {
+        elapsedSec = static_cast<double>(page.updatedTimeUs -
+                                         prevPage->updatedTimeUs) /
+                     1e6;
+    }
+
+    for (uint32_t slot = 0; slot < page.configCount; ++slot)
+    {
+        const auto& stats = page.configs[slot];
+        uint64_t rate = 0;
+        if (elapsedSec > 0 && slot < prevPage->configCount &&
+            stats.bytesTransferred >= prevPage->configs[slot].bytesTransferred)
+        {
+            rate = static_cast<uint64_t>(
+                static_cast<double>(stats.bytesTransferred -
+                                    prevPage->configs[slot].bytesTransferred) /
+                elapsedSec);
+        }
+        std::println(
+            "{:<48} {:>8} {:>8} {:>8} {:>8} {:>12} {:>10} {:>5} {:>7}",
+            std::string(stats.path), stats.syncsStarted, stats.syncsSucceeded,
+            stats.syncsFailed, stats.retries, stats.bytesTransferred, rate,
+            stats.lastExitCode, stats.batchedPaths);
+    }
+}
+
+} // namespace
+
+json buildPageJson(const data_sync::status::Page& page)
+{
+    json pageJson;
+    pageJson["DaemonPid"] = page.daemonPid;
+    pageJson["UpdatedTimeUs"] = page.updatedTimeUs;
+    pageJson["SyncEventsHealth"] =
+        enumName<SyncBMCData::SyncEventsHealth>(page.syncEventsHealth);
+    pageJson["FullSyncStatus"] =
+        enumName<SyncBMCData::FullSyncStatus>(page.fullSyncStatus);
+    pageJson["DisableSync"] = page.disableSync != 0;
+    pageJson["QueueDepth"] = page.queueDepth;
+    pageJson["InFlightSyncs"] = page.inFlightSyncs;
+    pageJson["ScrubPasses"] = page.scrubPasses;
+    pageJson["ScrubCoverage"] = page.scrubCoverage;
+
+    json paths = json::array();
+    for (uint32_t slot = 0; slot < page.configCount; ++slot)
+    {
+        const auto& stats = page.configs[slot];
+        paths.push_back({{"Path", std::string(stats.path)},
+                         {"SyncsStarted", stats.syncsStarted},
+                         {"SyncsSucceeded", stats.syncsSucceeded},
+                         {"SyncsFailed", stats.syncsFailed},
+                         {"Retries", stats.retries},
+                         {"BytesTransferred", stats.bytesTransferred},
+                         {"LastSyncTimeUs", stats.lastSyncTimeUs},
+                         {"LastSyncDurationUs", stats.lastSyncDurationUs},
+                         {"LastExitCode", stats.lastExitCode},
+                         {"InFlight", stats.inFlight},
+                         {"BatchedPaths", stats.batchedPaths},
+                         {"ModeChanges", stats.modeChanges},
+                         {"InterruptedSyncs", stats.interruptedSyncs},
+                         {"ResumedBytes", stats.resumedBytes},
+                         {"MatchedBytes", stats.matchedBytes},
+                         {"ScrubbedFiles", stats.scrubbedFiles},
+                         {"ScrubbedBytes", stats.scrubbedBytes},
+                         {"ScrubMismatches", stats.scrubMismatches}});
+    }
+    pageJson["Paths"] = std::move(paths);
+    return pageJson;
+}
+
+int runTop(std::chrono::milliseconds interval, bool jsonOutput)
+{
+    try
+    {
+        data_sync::status::StatusPageReader reader(STATUS_PAGE_FILE);
+        std::optional<data_sync::status::Page> prevPage;
+
+        while (true)
+        {
+            auto page = reader.snapshot();
+            if (!page.has_value())
+            {
+                std::println(stderr, "Failed to take a consistent status "
+                                     "snapshot, retrying");
+            }
+            else if (jsonOutput)
+            {
+                std::println("{}", buildPageJson(*page).dump(4));
+            }
+            else
+            {
+                if (interval.count() != 0)
+                {
+                    // Clear the screen and move the cursor to the top
+                    std::print("\033[2J\033[H");
+                }
+                displayTable(*page,
+                             prevPage.has_value() ? &*prevPage : nullptr);
+                prevPage = page;
+            }
+
+            if (interval.count() == 0)
+            {
+                break;
+            }
+            std::this_thread::sleep_for(interval);
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::println(stderr, "Status page is not available: {}", e.what());
+        return 1;
+    }
+    return 0;
+}
+
+} // namespace datasynctool::status_view
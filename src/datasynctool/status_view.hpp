@@ -0,0 +1,36 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include "status_page.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <chrono>
+
+namespace datasynctool::status_view
+{
+
+using json = nlohmann::ordered_json;
+
+/**
+ * @brief Build JSON object from a status page snapshot
+ *
+ * @param[in] page - The consistent copy of the status page
+ *
+ * @return json - JSON object containing the page fields and the per path
+ *                counters
+ */
+json buildPageJson(const data_sync::status::Page& page);
+
+/**
+ * @brief Display the live status of phosphor-data-sync by sampling the
+ *        shared status page which doesn't involve D-Bus.
+ *
+ * @param[in] interval - The refresh interval; zero to display only once
+ * @param[in] jsonOutput - Output in JSON format if true
+ *
+ * @return int - 0 on success; 1 if the status page is not available
+ */
+int runTop(std::chrono::milliseconds interval, bool jsonOutput);
+
+} // namespace datasynctool::status_view
@@ -0,0 +1,448 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "dirty_ring.hpp"
+
+#include "config.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <csignal>
+#include <cstring>
+#include <ctime>
+#include <experimental/scope>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+
+namespace data_sync::dirty_ring
+{
+
+namespace
+{
+
+std::runtime_error ringError(const std::string& what, const fs::path& path)
+{
+    return std::runtime_error(what + " " + path.string() + " : " +
+                              std::strerror(errno));
+}
+
+bool isValid(const Ring& ring)
+{
+    return ring.magic == ringMagic && ring.version == ringVersion &&
+           ring.capacity == ringCapacity;
+}
+
+/**
+ * @brief Write to the FIFO without raising SIGPIPE in the writer process if
+ *        the daemon closed it.
+ *
+ * @return The result of write(2)
+ */
+ssize_t writeNoSigPipe(int fd, const void* data, size_t size)
+{
+    sigset_t sigPipe;
+    sigset_t oldMask;
+    sigemptyset(&sigPipe);
+    sigaddset(&sigPipe, SIGPIPE);
+
+    sigset_t pending;
+    sigpending(&pending);
+    const bool alreadyPending = sigismember(&pending, SIGPIPE) == 1;
+    pthread_sigmask(SIG_BLOCK, &sigPipe, &oldMask);
+
+    const auto written = write(fd, data, size);
+    const auto writeErrno = errno;
+    if (written < 0 && writeErrno == EPIPE && !alreadyPending)
+    {
+        // Consume the SIGPIPE raised by this write
+        const timespec noWait{};
+        sigtimedwait(&sigPipe, nullptr, &noWait);
+    }
+
+    pthread_sigmask(SIG_SETMASK, &oldMask, nullptr);
+    errno = writeErrno;
+    return written;
+}
+
+} // namespace
+
+fs::path wakePath(const fs::path& ringPath)
+{
+    return fs::path(ringPath.native() + ".wake");
+}
+
+DirtyRingWriter::DirtyRingWriter(const fs::path& ringPath) :
+    _wakePath(wakePath(ringPath))
+{
+    const int ringFd = open(ringPath.c_str(), O_RDWR | O_CLOEXEC);
+    if (ringFd < 0)
+    {
+        throw ringError("Failed to open the dirty-path ring", ringPath);
+    }
+    auto closeFd = std::experimental::scope_exit([ringFd]() { close(ringFd); });
+
+    struct stat ringStat{};
+    if (fstat(ringFd, &ringStat) != 0 ||
+        static_cast<size_t>(ringStat.st_size) != sizeof(Ring))
+    {
+        throw std::runtime_error("Unexpected dirty-path ring size " +
+                                 ringPath.string());
+    }
+
+    void* addr = mmap(nullptr, sizeof(Ring), PROT_READ | PROT_WRITE,
+                      MAP_SHARED, ringFd, 0);
+    if (addr == MAP_FAILED)
+    {
+        throw ringError("Failed to map the dirty-path ring", ringPath);
+    }
+    _ring = static_cast<Ring*>(addr);
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (!isValid(*_ring))
+    {
+        munmap(_ring, sizeof(Ring));
+        _ring = nullptr;
+        throw std::runtime_error("Invalid or unsupported dirty-path ring " +
+                                 ringPath.string());
+    }
+}
+
+DirtyRingWriter::~DirtyRingWriter()
+{
+    if (_ring != nullptr)
+    {
+        munmap(_ring, sizeof(Ring));
+    }
+    if (const int fd = _wakeFd.load(); fd >= 0)
+    {
+        close(fd);
+    }
+}
+
+bool DirtyRingWriter::push(std::string_view path) noexcept
+{
+    if (path.empty() || path.size() >= maxPathLen)
+    {
+        return false;
+    }
+
+    std::atomic_ref<uint64_t> head(_ring->head);
+    auto pos = head.load(std::memory_order_relaxed);
+    Slot* slot{nullptr};
+    while (true)
+    {
+        slot = &_ring->slots[pos & (ringCapacity - 1)];
+        const auto seq = std::atomic_ref<uint64_t>(slot->sequence)
+                             .load(std::memory_order_acquire);
+        const auto diff = static_cast<int64_t>(seq - pos);
+        if (diff == 0)
+        {
+            if (head.compare_exchange_weak(pos, pos + 1,
+                                           std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (diff < 0)
+        {
+            // The consumer hasn't freed the slot of the previous lap yet, it
+            // resyncs on the drop and skips a slot of a dead producer
+            std::atomic_ref<uint64_t>(_ring->dropped)
+                .fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            wakeIfWaiting();
+            return false;
+        }
+        else
+        {
+            // Claimed by another producer meanwhile
+            pos = head.load(std::memory_order_relaxed);
+        }
+    }
+
+    std::atomic_ref<uint32_t>(slot->pid)
+        .store(static_cast<uint32_t>(getpid()), std::memory_order_relaxed);
+    slot->length = static_cast<uint16_t>(path.size());
+    std::memcpy(slot->path, path.data(), path.size());
+    slot->path[path.size()] = '\0';
+    auto expected = pos;
+    if (!std::atomic_ref<uint64_t>(slot->sequence)
+             .compare_exchange_strong(expected, pos + 1,
+                                      std::memory_order_release,
+                                      std::memory_order_relaxed))
+    {
+        // Taken for abandoned and skipped by the consumer, which counted the
+        // drop already
+        return false;
+    }
+
+    // Pairs with the fence in DirtyRingReader::prepareWait(), either the
+    // consumer sees the record or this producer sees it waiting.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    wakeIfWaiting();
+    return true;
+}
+
+void DirtyRingWriter::wakeIfWaiting() noexcept
+{
+    if (std::atomic_ref<uint32_t>(_ring->consumerWaiting)
+            .load(std::memory_order_relaxed) != 0)
+    {
+        wake();
+    }
+}
+
+void DirtyRingWriter::wake() noexcept
+{
+    // Retry once with a fresh descriptor as the daemon may have reopened the
+    // FIFO since the last wakeup.
+    for (auto attempt = 0; attempt < 2; ++attempt)
+    {
+        int fd = _wakeFd.load(std::memory_order_acquire);
+        if (fd < 0)
+        {
+            // Fails with ENXIO if the daemon doesn't have the FIFO open
+            fd = open(_wakePath.c_str(), O_WRONLY | O_NONBLOCK | O_CLOEXEC);
+            if (fd < 0)
+            {
+                return;
+            }
+            int expected{-1};
+            if (!_wakeFd.compare_exchange_strong(expected, fd))
+            {
+                close(fd);
+                fd = expected;
+            }
+        }
+
+        const char byte{0};
+        if (writeNoSigPipe(fd, &byte, sizeof(byte)) >= 0 || errno != EPIPE)
+        {
+            // EAGAIN means the consumer has enough wakeups pending already
+            return;
+        }
+
+        int expected{fd};
+        if (_wakeFd.compare_exchange_strong(expected, -1))
+        {
+            close(fd);
+        }
+    }
+}
+
+DirtyRingReader::DirtyRingReader(const fs::path& ringPath)
+{
+    std::error_code ec;
+    fs::create_directories(ringPath.parent_path(), ec);
+
+    const int ringFd = open(ringPath.c_str(), O_RDWR | O_CREAT | O_CLOEXEC,
+                            0660);
+    if (ringFd < 0)
+    {
+        throw ringError("Failed to create the dirty-path ring", ringPath);
+    }
+    auto closeFd = std::experimental::scope_exit([ringFd]() { close(ringFd); });
+
+    struct stat ringStat{};
+    if (fstat(ringFd, &ringStat) != 0)
+    {
+        throw ringError("Failed to stat the dirty-path ring", ringPath);
+    }
+    const bool sized = static_cast<size_t>(ringStat.st_size) == sizeof(Ring);
+    if (!sized && ftruncate(ringFd, sizeof(Ring)) != 0)
+    {
+        throw ringError("Failed to size the dirty-path ring", ringPath);
+    }
+
+    void* addr = mmap(nullptr, sizeof(Ring), PROT_READ | PROT_WRITE,
+                      MAP_SHARED, ringFd, 0);
+    if (addr == MAP_FAILED)
+    {
+        throw ringError("Failed to map the dirty-path ring", ringPath);
+    }
+    _ring = static_cast<Ring*>(addr);
+
+    if (!sized || !isValid(*_ring))
+    {
+        // No writer maps an invalid ring, so it can be initialized in place.
+        std::memset(static_cast<void*>(_ring), 0, sizeof(Ring));
+        for (uint32_t pos = 0; pos < ringCapacity; ++pos)
+        {
+            _ring->slots[pos].sequence = pos;
+        }
+        _ring->version = ringVersion;
+        _ring->capacity = ringCapacity;
+
+        // Publish the magic at last, writers treat the ring as valid only
+        // then.
+        std::atomic_thread_fence(std::memory_order_release);
+        _ring->magic = ringMagic;
+    }
+    else if (const auto pos = _ring->tail;
+             _ring->slots[pos & (ringCapacity - 1)].sequence ==
+             pos + ringCapacity)
+    {
+        // The previous daemon instance stopped in the middle of a pop
+        _ring->tail = pos + 1;
+    }
+    _ring->daemonPid = static_cast<uint32_t>(getpid());
+    std::atomic_ref<uint32_t>(_ring->consumerWaiting)
+        .store(0, std::memory_order_relaxed);
+
+    const auto fifoPath = wakePath(ringPath);
+    if (mkfifo(fifoPath.c_str(), 0660) != 0 && errno != EEXIST)
+    {
+        munmap(_ring, sizeof(Ring));
+        _ring = nullptr;
+        throw ringError("Failed to create the wakeup FIFO", fifoPath);
+    }
+
+    _wakeFd = open(fifoPath.c_str(), O_RDWR | O_NONBLOCK | O_CLOEXEC);
+    if (_wakeFd < 0)
+    {
+        munmap(_ring, sizeof(Ring));
+        _ring = nullptr;
+        throw ringError("Failed to open the wakeup FIFO", fifoPath);
+    }
+}
+
+DirtyRingReader::~DirtyRingReader()
+{
+    if (_ring != nullptr)
+    {
+        std::atomic_ref<uint32_t>(_ring->consumerWaiting)
+            .store(0, std::memory_order_relaxed);
+        munmap(_ring, sizeof(Ring));
+    }
+    if (_wakeFd >= 0)
+    {
+        close(_wakeFd);
+    }
+}
+
+std::optional<std::string> DirtyRingReader::pop() noexcept
+{
+    std::atomic_ref<uint64_t> tail(_ring->tail);
+    const auto pos = tail.load(std::memory_order_relaxed);
+    auto& slot = _ring->slots[pos & (ringCapacity - 1)];
+    std::atomic_ref<uint64_t> sequence(slot.sequence);
+    if (auto seq = sequence.load(std::memory_order_acquire); seq != pos + 1)
+    {
+        // Empty, or the producer of this position is still writing
+        if (seq != pos || !isAbandoned(pos, slot) ||
+            !sequence.compare_exchange_strong(seq, pos + ringCapacity,
+                                              std::memory_order_acq_rel))
+        {
+            return std::nullopt;
+        }
+
+        // The change of the dead producer is lost, the drop resyncs it
+        _stalledPos.reset();
+        std::atomic_ref<uint64_t>(_ring->dropped)
+            .fetch_add(1, std::memory_order_relaxed);
+        tail.store(pos + 1, std::memory_order_relaxed);
+        return pop();
+    }
+    _stalledPos.reset();
+
+    std::string path(slot.path, std::min<size_t>(slot.length, maxPathLen - 1));
+    sequence.store(pos + ringCapacity, std::memory_order_release);
+    tail.store(pos + 1, std::memory_order_relaxed);
+    return path;
+}
+
+bool DirtyRingReader::isAbandoned(uint64_t pos, Slot& slot) noexcept
+{
+    // Claimed, or just empty
+    if (std::atomic_ref<uint64_t>(_ring->head).load(
+            std::memory_order_relaxed) <= pos)
+    {
+        return false;
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    if (_stalledPos != pos)
+    {
+        _stalledPos = pos;
+        _stalledSince = now;
+        return false;
+    }
+
+    // The pid is of the previous lap's producer until the claiming one
+    // stores its own
+    const auto pid = static_cast<pid_t>(
+        std::atomic_ref<uint32_t>(slot.pid).load(
+            std::memory_order_relaxed));
+    return (pid > 0 && kill(pid, 0) != 0 && errno == ESRCH) ||
+           now - _stalledSince >= abandonedSlotTimeout;
+}
+
+bool DirtyRingReader::prepareWait() noexcept
+{
+    std::atomic_ref<uint32_t>(_ring->consumerWaiting)
+        .store(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    const auto pos = std::atomic_ref<uint64_t>(_ring->tail)
+                         .load(std::memory_order_relaxed);
+    const auto seq =
+        std::atomic_ref<uint64_t>(
+            _ring->slots[pos & (ringCapacity - 1)].sequence)
+            .load(std::memory_order_acquire);
+    if (seq == pos + 1)
+    {
+        finishWait();
+        return false;
+    }
+    return true;
+}
+
+void DirtyRingReader::finishWait() noexcept
+{
+    std::atomic_ref<uint32_t>(_ring->consumerWaiting)
+        .store(0, std::memory_order_relaxed);
+
+    char buffer[64];
+    while (read(_wakeFd, buffer, sizeof(buffer)) > 0)
+    {}
+}
+
+uint64_t DirtyRingReader::dropped() const noexcept
+{
+    return std::atomic_ref<uint64_t>(_ring->dropped)
+        .load(std::memory_order_relaxed);
+}
+
+bool notifyPathChanged(const fs::path& path) noexcept
+{
+    static std::mutex openMutex;
+    static std::unique_ptr<DirtyRingWriter> writer;
+    static std::atomic<DirtyRingWriter*> mapped{nullptr};
+
+    auto* ring = mapped.load(std::memory_order_acquire);
+    if (ring == nullptr)
+    {
+        std::lock_guard lock(openMutex);
+        ring = mapped.load(std::memory_order_relaxed);
+        if (ring == nullptr)
+        {
+            try
+            {
+                writer = std::make_unique<DirtyRingWriter>(DIRTY_RING_FILE);
+            }
+            catch (const std::exception&)
+            {
+                // The daemon is not running or doesn't provide the ring
+                return false;
+            }
+            ring = writer.get();
+            mapped.store(ring, std::memory_order_release);
+        }
+    }
+    return ring->push(path.native());
+}
+
+} // namespace data_sync::dirty_ring
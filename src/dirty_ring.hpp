@@ -0,0 +1,284 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace data_sync::dirty_ring
+{
+
+namespace fs = std::filesystem;
+
+/**
+ * @brief Identifies a valid dirty-path ring ("DSDR") and its layout version.
+ */
+constexpr uint32_t ringMagic = 0x52445344;
+constexpr uint16_t ringVersion = 1;
+
+/**
+ * @brief The number of slots (a power of two) and the maximum length of a
+ *        path stored in a slot (including the terminator).
+ */
+constexpr uint32_t ringCapacity = 1024;
+constexpr size_t maxPathLen = 256;
+
+static_assert((ringCapacity & (ringCapacity - 1)) == 0,
+              "The ring capacity must be a power of two");
+
+/**
+ * @brief The time a claimed slot may stay unpublished before the consumer
+ *        takes its producer for dead, even if the process of the slot still
+ *        runs (its pid may be of the previous lap's producer).
+ */
+constexpr auto abandonedSlotTimeout = std::chrono::seconds(10);
+
+/**
+ * @brief A "path changed" record.
+ */
+struct Slot
+{
+    /**
+     * @brief The slot sequence, the producer which claimed the position `pos`
+     *        publishes the record by storing `pos + 1` and the consumer frees
+     *        the slot for the next lap by storing `pos + ringCapacity`, also
+     *        if the producer died before publishing.
+     *
+     * @note Accessed only through std::atomic_ref.
+     */
+    alignas(std::atomic_ref<uint64_t>::required_alignment) uint64_t sequence;
+    uint32_t pid;
+    uint16_t length;
+    uint16_t reserved;
+    char path[maxPathLen];
+};
+
+/**
+ * @brief The fixed layout of the ring shared between the writers (producers)
+ *        and the daemon (the single consumer).
+ *
+ * The producers claim a position by advancing `head` and publish their record
+ * through the slot sequence, so they never block each other or the consumer.
+ */
+struct Ring
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t reserved;
+    uint32_t capacity;
+    uint32_t daemonPid;
+
+    /**
+     * @brief The next position to claim by the producers and to consume by
+     *        the consumer, kept apart to avoid sharing a cache line.
+     */
+    alignas(64) uint64_t head;
+    alignas(64) uint64_t tail;
+
+    /**
+     * @brief Non zero while the consumer is about to wait on the wakeup FIFO,
+     *        the producers signal the FIFO only then.
+     */
+    alignas(64) uint32_t consumerWaiting;
+    uint32_t reserved2;
+
+    /**
+     * @brief The number of records dropped because the ring was full.
+     */
+    uint64_t dropped;
+
+    Slot slots[ringCapacity];
+};
+
+static_assert(std::atomic_ref<uint64_t>::is_always_lock_free,
+              "The dirty-path ring requires a lock free 64bit atomic");
+static_assert(std::is_trivially_copyable_v<Ring>,
+              "The dirty-path ring must be trivially copyable");
+
+/**
+ * @brief Get the wakeup FIFO path of the given ring.
+ */
+fs::path wakePath(const fs::path& ringPath);
+
+/**
+ * @class DirtyRingWriter
+ *
+ * @brief Maps the ring of the daemon and pushes the "path changed" records,
+ *        it is the producer side used by the cooperating writers.
+ *
+ * @note push() is lock-free and can be used from any number of threads and
+ *       processes concurrently.
+ */
+class DirtyRingWriter
+{
+  public:
+    DirtyRingWriter(const DirtyRingWriter&) = delete;
+    DirtyRingWriter& operator=(const DirtyRingWriter&) = delete;
+    DirtyRingWriter(DirtyRingWriter&&) = delete;
+    DirtyRingWriter& operator=(DirtyRingWriter&&) = delete;
+
+    /**
+     * @brief The constructor maps the ring.
+     *
+     * @param[in] ringPath - The ring file of the daemon
+     *
+     * @throw std::runtime_error if the ring is not available or not valid.
+     */
+    explicit DirtyRingWriter(const fs::path& ringPath);
+
+    ~DirtyRingWriter();
+
+    /**
+     * @brief Push a "path changed" record and wake the daemon if it waits.
+     *
+     * @param[in] path - The absolute path which got changed
+     *
+     * @return true if queued; false if the path is too long or the ring is
+     *         full, the record is counted as dropped in the latter case and
+     *         the daemon is woken to resync.
+     */
+    bool push(std::string_view path) noexcept;
+
+  private:
+    /**
+     * @brief Wake the consumer through the FIFO if it waits, nothing is done
+     *        if the daemon doesn't have it open.
+     */
+    void wakeIfWaiting() noexcept;
+
+    /**
+     * @brief Wake the consumer through the FIFO, nothing is done if the
+     *        daemon doesn't have it open.
+     */
+    void wake() noexcept;
+
+    /**
+     * @brief The mapped ring
+     */
+    Ring* _ring{nullptr};
+
+    /**
+     * @brief The wakeup FIFO path and its descriptor, opened on the first
+     *        wakeup since the daemon opens it only once it consumes.
+     */
+    fs::path _wakePath;
+    std::atomic<int> _wakeFd{-1};
+};
+
+/**
+ * @class DirtyRingReader
+ *
+ * @brief Creates (or reuses) the ring and its wakeup FIFO and consumes the
+ *        records, it is the single consumer side used by the daemon.
+ *
+ * An existing valid ring is reused, so that the records pushed while the
+ * daemon was restarting are not lost.
+ *
+ * A producer which dies between claiming and publishing a slot would stall
+ * the consumption at that slot, so the consumer skips the slot once its
+ * process is gone or after abandonedSlotTimeout, and counts it as dropped.
+ */
+class DirtyRingReader
+{
+  public:
+    DirtyRingReader(const DirtyRingReader&) = delete;
+    DirtyRingReader& operator=(const DirtyRingReader&) = delete;
+    DirtyRingReader(DirtyRingReader&&) = delete;
+    DirtyRingReader& operator=(DirtyRingReader&&) = delete;
+
+    /**
+     * @brief The constructor creates or maps the ring and its wakeup FIFO.
+     *
+     * @param[in] ringPath - The ring file to publish
+     *
+     * @throw std::runtime_error if the ring or the FIFO can't be created.
+     */
+    explicit DirtyRingReader(const fs::path& ringPath);
+
+    /**
+     * @brief The destructor unmaps the ring, the file is kept for the
+     *        writers which already mapped it.
+     */
+    ~DirtyRingReader();
+
+    /**
+     * @brief Pop the oldest published record, skipping the slot of a dead
+     *        producer.
+     *
+     * @return The changed path; std::nullopt if there is none.
+     */
+    std::optional<std::string> pop() noexcept;
+
+    /**
+     * @brief Prepare to wait on the wakeup FIFO.
+     *
+     * @return true if the consumer can wait; false if records got published
+     *         meanwhile and need to be consumed first.
+     */
+    bool prepareWait() noexcept;
+
+    /**
+     * @brief Consume the pending wakeups once woken up.
+     */
+    void finishWait() noexcept;
+
+    /**
+     * @brief Get the number of records dropped because the ring was full.
+     */
+    uint64_t dropped() const noexcept;
+
+    /**
+     * @brief Get the descriptor of the wakeup FIFO to wait on.
+     */
+    int wakeFd() const noexcept
+    {
+        return _wakeFd;
+    }
+
+  private:
+    /**
+     * @brief Check whether the producer which claimed the given position
+     *        died before publishing it, which is taken only once the slot
+     *        stayed claimed across two checks.
+     */
+    bool isAbandoned(uint64_t pos, Slot& slot) noexcept;
+
+    /**
+     * @brief The mapped ring
+     */
+    Ring* _ring{nullptr};
+
+    /**
+     * @brief The claimed position the consumption stopped at, and since when
+     */
+    std::optional<uint64_t> _stalledPos;
+    std::chrono::steady_clock::time_point _stalledSince;
+
+    /**
+     * @brief The wakeup FIFO opened for reading (and writing, so that it
+     *        never reports EOF while no producer has it open).
+     */
+    int _wakeFd{-1};
+};
+
+/**
+ * @brief Notify the daemon that the given path has changed.
+ *
+ * The client API for the writers of the synced data, the ring of the daemon
+ * is mapped on the first call (and on the subsequent calls until the daemon
+ * provides it).
+ *
+ * @param[in] path - The absolute path which got changed
+ *
+ * @return true if the daemon is notified; false otherwise, the daemon then
+ *         relies on its inotify watches (if any) to see the change.
+ */
+bool notifyPathChanged(const fs::path& path) noexcept;
+
+} // namespace data_sync::dirty_ring
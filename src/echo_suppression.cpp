@@ -0,0 +1,241 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "echo_suppression.hpp"
+
+#include <sys/stat.h>
+#include <sys/xattr.h>
+
+#include <phosphor-logging/lg2.hpp>
+
+#include <array>
+#include <cerrno>
+#include <charconv>
+#include <format>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace data_sync::echo
+{
+
+namespace
+{
+
+/**
+ * @brief The fingerprint of the content of a file.
+ */
+struct Fingerprint
+{
+    int64_t mtimeNs{0};
+    int64_t size{0};
+
+    bool operator==(const Fingerprint&) const = default;
+};
+
+std::optional<Fingerprint> fingerprintOf(const fs::path& path)
+{
+    struct stat st{};
+    if (lstat(path.c_str(), &st) != 0 || !S_ISREG(st.st_mode))
+    {
+        return std::nullopt;
+    }
+    return Fingerprint{
+        .mtimeNs = (static_cast<int64_t>(st.st_mtim.tv_sec) * 1'000'000'000) +
+                   st.st_mtim.tv_nsec,
+        .size = st.st_size};
+}
+
+/**
+ * @brief The attributes of a file which an IN_ATTRIB can be about, the
+ *        change time moves with any of them.
+ */
+struct Attributes
+{
+    int64_t ctimeNs{0};
+    int64_t mtimeNs{0};
+    mode_t mode{0};
+    uid_t uid{0};
+    gid_t gid{0};
+
+    bool operator==(const Attributes&) const = default;
+};
+
+std::optional<Attributes> attributesOf(const fs::path& path)
+{
+    struct stat st{};
+    if (lstat(path.c_str(), &st) != 0)
+    {
+        return std::nullopt;
+    }
+    return Attributes{
+        .ctimeNs = (static_cast<int64_t>(st.st_ctim.tv_sec) * 1'000'000'000) +
+                   st.st_ctim.tv_nsec,
+        .mtimeNs = (static_cast<int64_t>(st.st_mtim.tv_sec) * 1'000'000'000) +
+                   st.st_mtim.tv_nsec,
+        .mode = st.st_mode,
+        .uid = st.st_uid,
+        .gid = st.st_gid};
+}
+
+/**
+ * @brief The tags written at most before the oldest records are dropped, a
+ *        dropped one costs a metadata sync only.
+ */
+constexpr size_t maxTagWrites = 4096;
+
+/**
+ * @brief The attributes of the files right after this BMC tagged them, the
+ *        tagging runs on the worker threads. Nullopt while being tagged.
+ */
+std::mutex tagWritesMutex;
+std::unordered_map<std::string, std::optional<Attributes>> tagWrites;
+
+void recordTagWrite(const fs::path& path, std::optional<Attributes> attributes)
+{
+    std::lock_guard lock(tagWritesMutex);
+    if (tagWrites.size() >= maxTagWrites && !tagWrites.contains(path))
+    {
+        tagWrites.clear();
+    }
+    tagWrites.insert_or_assign(path.native(), attributes);
+}
+
+/**
+ * @brief Read the origin tag of a file.
+ *
+ * @return The origin BMC position and the fingerprint of the content it
+ *         sent, nullopt if the file isn't tagged or the tag is malformed.
+ */
+std::optional<std::pair<size_t, Fingerprint>> readTag(const fs::path& path)
+{
+    std::array<char, 64> tag{};
+    const auto len = lgetxattr(path.c_str(), originXattr, tag.data(),
+                               tag.size());
+    if (len <= 0)
+    {
+        return std::nullopt;
+    }
+
+    size_t origin{0};
+    Fingerprint tagged;
+    const char* pos = tag.data();
+    const char* end = tag.data() + len;
+    auto parse = [&pos, end](auto& value) {
+        auto result = std::from_chars(pos, end, value);
+        pos = (result.ptr != end) ? result.ptr + 1 : end;
+        return result.ec == std::errc{};
+    };
+    if (!parse(origin) || !parse(tagged.mtimeNs) || !parse(tagged.size))
+    {
+        lg2::debug("Ignoring the malformed origin tag of {PATH}", "PATH", path);
+        return std::nullopt;
+    }
+    return std::make_pair(origin, tagged);
+}
+
+bool tagFile(const fs::path& path, size_t bmcPosition)
+{
+    auto fingerprint = fingerprintOf(path);
+    if (!fingerprint.has_value())
+    {
+        // Only the regular files are tagged
+        return true;
+    }
+
+    // Leave a file tagged already alone, a write changes its change time
+    // and costs a flash metadata write. That includes the files received
+    // from the sibling: their tag would flip back and forth with each sync,
+    // and each flip is an attribute change to sync.
+    if (auto currentTag = readTag(path);
+        currentTag.has_value() && currentTag->second == *fingerprint)
+    {
+        return true;
+    }
+
+    const auto tag = std::format("{} {} {}", bmcPosition, fingerprint->mtimeNs,
+                                 fingerprint->size);
+
+    recordTagWrite(path, std::nullopt);
+    if (lsetxattr(path.c_str(), originXattr, tag.data(), tag.size(), 0) != 0)
+    {
+        lg2::debug("Failed to tag the origin of {PATH}, errno : {ERRNO}",
+                   "PATH", path, "ERRNO", errno);
+        return false;
+    }
+    recordTagWrite(path, attributesOf(path));
+    return true;
+}
+
+} // namespace
+
+bool supportsTags(const fs::path& path)
+{
+    // The nearest existing path, the configured one may not be created yet
+    std::error_code ec;
+    auto probePath = path;
+    while (!fs::exists(fs::symlink_status(probePath, ec)) &&
+           probePath.has_relative_path())
+    {
+        probePath = probePath.parent_path();
+    }
+
+    // A filesystem without user extended attributes has no handler for
+    // them, reading one fails without touching the path
+    std::array<char, 64> tag{};
+    if (lgetxattr(probePath.c_str(), originXattr, tag.data(), tag.size()) < 0 &&
+        errno == ENOTSUP)
+    {
+        lg2::warning("User extended attributes aren't supported on {PATH}, "
+                     "the echo suppression is disabled for it",
+                     "PATH", path);
+        return false;
+    }
+    return true;
+}
+
+bool tagOrigin(const fs::path& path, size_t bmcPosition)
+{
+    std::error_code ec;
+    if (!fs::is_directory(fs::symlink_status(path, ec)))
+    {
+        return tagFile(path, bmcPosition);
+    }
+
+    bool tagged{true};
+    for (const auto& entry : fs::recursive_directory_iterator(
+             path, fs::directory_options::skip_permission_denied, ec))
+    {
+        tagged = tagFile(entry.path(), bmcPosition) && tagged;
+    }
+    return tagged;
+}
+
+bool isOwnTagWrite(const fs::path& path)
+{
+    std::lock_guard lock(tagWritesMutex);
+    auto it = tagWrites.find(path.native());
+    if (it == tagWrites.end())
+    {
+        return false;
+    }
+
+    // Nothing else changed the attributes if they are still the same as
+    // right after the tagging
+    const bool own = !it->second.has_value() ||
+                     attributesOf(path) == it->second;
+    tagWrites.erase(it);
+    return own;
+}
+
+bool isEcho(const fs::path& path, size_t bmcPosition)
+{
+    auto tag = readTag(path);
+
+    // A local modification after the receive changes the fingerprint
+    return tag.has_value() && tag->first != bmcPosition &&
+           fingerprintOf(path) == tag->second;
+}
+
+} // namespace data_sync::echo
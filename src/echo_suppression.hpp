@@ -0,0 +1,76 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+
+namespace data_sync::echo
+{
+
+namespace fs = std::filesystem;
+
+/**
+ * @brief The extended attribute which tags a synced file with its origin.
+ *
+ * The value is "<BMC position> <mtime in ns> <size>", the fingerprint of the
+ * content the origin BMC sent. rsync carries it over (--xattrs) along with
+ * the modification time (--times), so the receiving BMC can tell its own
+ * writes from the ones it received from the sibling.
+ */
+constexpr auto originXattr = "user.phosphor-data-sync.origin";
+
+/**
+ * @brief Check whether the filesystem of the given path supports the origin
+ *        tag, i.e. user extended attributes.
+ *
+ * @param[in] path - The configured path, its nearest existing parent is
+ *                   probed if it doesn't exist
+ *
+ * @return false if the files there can't be tagged, then neither can they
+ *         on the sibling with the same filesystem layout
+ */
+bool supportsTags(const fs::path& path);
+
+/**
+ * @brief Tag the given file, or the files under the given directory, with
+ *        this BMC as the origin of their current content.
+ *
+ * The files whose tag matches their content already aren't written to,
+ * whichever BMC tagged them.
+ *
+ * @param[in] path - The path which is about to be synced to the sibling
+ * @param[in] bmcPosition - The position of this BMC
+ *
+ * @return false if any of the files couldn't be tagged (e.g. the filesystem
+ *         doesn't support user extended attributes); otherwise true
+ */
+bool tagOrigin(const fs::path& path, size_t bmcPosition);
+
+/**
+ * @brief Check whether the attribute change (IN_ATTRIB) on the given path is
+ *        the one of the origin tag written by this BMC, i.e. nothing else
+ *        changed the attributes of the file since.
+ *
+ * A file is tagged only if its tag doesn't match its content already, the
+ * check forgets about the tag write.
+ *
+ * @param[in] path - The path whose attributes changed
+ *
+ * @return true if the change needn't be synced to the sibling
+ */
+bool isOwnTagWrite(const fs::path& path);
+
+/**
+ * @brief Check whether the change on the given path is the echo of a write
+ *        received from the sibling, i.e. the path is tagged by another BMC
+ *        and still has the content that BMC sent.
+ *
+ * @param[in] path - The changed path
+ * @param[in] bmcPosition - The position of this BMC
+ *
+ * @return true if the change needn't be synced back to the sibling
+ */
+bool isEcho(const fs::path& path, size_t bmcPosition);
+
+} // namespace data_sync::echo
@@ -0,0 +1,173 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "error_log_aggregator.hpp"
+
+#include <phosphor-logging/lg2.hpp>
+
+#include <algorithm>
+#include <experimental/scope>
+#include <format>
+#include <ranges>
+
+namespace data_sync::error_log
+{
+
+namespace
+{
+
+std::string toString(std::chrono::system_clock::time_point time)
+{
+    return std::format(
+        "{:%FT%T}Z", std::chrono::floor<std::chrono::seconds>(time));
+}
+
+} // namespace
+
+Aggregator::Aggregator(sdbusplus::async::context& ctx, clock::Clock& clock,
+                       ext_data::ExternalDataIFaces& extDataIfaces,
+                       clock::Duration window, size_t maxLogsPerWindow) :
+    _ctx(ctx), _clock(clock), _extDataIfaces(extDataIfaces), _window(window),
+    _maxLogsPerWindow(maxLogsPerWindow)
+{}
+
+// NOLINTNEXTLINE
+sdbusplus::async::task<> Aggregator::createErrorLog(
+    const std::string& errMsg, ext_data::ErrorLevel errSeverity,
+    const std::string& source, const fs::path& path,
+    ext_data::AdditionalData& additionalDetails, bool critical)
+{
+    auto [it, firstOfKind] = _aggregates.try_emplace(Kind{errMsg, source});
+    if (firstOfKind)
+    {
+        it->second.severity = errSeverity;
+        it->second.windowEnd = _clock.now() + _window;
+        if (!_flushing)
+        {
+            _flushing = true;
+            _ctx.spawn(flush());
+        }
+
+        if (acquire(critical))
+        {
+            co_await _extDataIfaces.createErrorLog(errMsg, errSeverity,
+                                                   additionalDetails);
+            co_return;
+        }
+    }
+
+    auto& aggregate = it->second;
+    const auto now = std::chrono::system_clock::now();
+    if (aggregate.count++ == 0)
+    {
+        aggregate.details = additionalDetails;
+        aggregate.first = now;
+    }
+    aggregate.last = now;
+    if (aggregate.samplePaths.size() < maxSamplePaths &&
+        std::ranges::find(aggregate.samplePaths, path.string()) ==
+            aggregate.samplePaths.end())
+    {
+        aggregate.samplePaths.emplace_back(path.string());
+    }
+    ++_foldedLogs;
+
+    lg2::debug("Folded the error log {ERR_MSG} for {SOURCE} into its summary",
+               "ERR_MSG", errMsg, "SOURCE", source);
+    co_return;
+}
+
+bool Aggregator::acquire(bool force)
+{
+    const auto now = _clock.now();
+    while (!_createdLogs.empty() && _createdLogs.front() + _window <= now)
+    {
+        _createdLogs.pop_front();
+    }
+
+    if (!force && _createdLogs.size() >= _maxLogsPerWindow)
+    {
+        return false;
+    }
+    _createdLogs.push_back(now);
+    return true;
+}
+
+// NOLINTNEXTLINE
+sdbusplus::async::task<> Aggregator::flush()
+{
+    auto cleanup =
+        std::experimental::scope_exit([this]() { _flushing = false; });
+
+    while (!_ctx.stop_requested() && !_aggregates.empty())
+    {
+        const auto windowEnd = std::ranges::min(
+            _aggregates | std::views::values |
+            std::views::transform(&Aggregate::windowEnd));
+        if (const auto now = _clock.now(); windowEnd > now)
+        {
+            co_await _clock.sleepFor(_ctx, windowEnd - now);
+            continue;
+        }
+
+        // Take the elapsed ones out first, as the map may change while the
+        // summaries are created
+        std::vector<std::pair<Kind, Aggregate>> summaries;
+        for (auto it = _aggregates.begin(); it != _aggregates.end();)
+        {
+            auto& [kind, aggregate] = *it;
+            if (aggregate.windowEnd > windowEnd)
+            {
+                ++it;
+                continue;
+            }
+
+            if (aggregate.count != 0 && !acquire(false))
+            {
+                // Retry once the oldest error log leaves the window
+                aggregate.windowEnd = _createdLogs.front() + _window;
+                ++it;
+                continue;
+            }
+
+            if (aggregate.count != 0)
+            {
+                summaries.emplace_back(kind, std::move(aggregate));
+            }
+            it = _aggregates.erase(it);
+        }
+
+        for (auto& [kind, aggregate] : summaries)
+        {
+            auto& details = aggregate.details;
+            for (auto& value : details | std::views::values)
+            {
+                if (value.size() > maxSummaryDetailLength)
+                {
+                    value.resize(maxSummaryDetailLength);
+                    value += "...";
+                }
+            }
+            details["DS_Aggregated_Count"] = std::to_string(aggregate.count);
+            details["DS_Aggregated_Source"] = kind.second;
+            details["DS_Aggregated_First"] = toString(aggregate.first);
+            details["DS_Aggregated_Last"] = toString(aggregate.last);
+
+            std::string samplePaths;
+            for (const auto& path : aggregate.samplePaths)
+            {
+                samplePaths += (samplePaths.empty() ? "" : ",") + path;
+            }
+            details["DS_Aggregated_Paths"] = samplePaths;
+
+            lg2::info("Creating the summary of {COUNT} error logs {ERR_MSG} "
+                      "for {SOURCE}",
+                      "COUNT", aggregate.count, "ERR_MSG", kind.first,
+                      "SOURCE", kind.second);
+            co_await _extDataIfaces.createErrorLog(
+                kind.first, aggregate.severity, details);
+        }
+    }
+    co_return;
+}
+
+} // namespace data_sync::error_log
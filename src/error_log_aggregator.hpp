@@ -0,0 +1,162 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "clock.hpp"
+#include "external_data_ifaces.hpp"
+
+#include <sdbusplus/async.hpp>
+
+#include <chrono>
+#include <deque>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace data_sync::error_log
+{
+
+namespace fs = std::filesystem;
+
+/**
+ * @brief The window in which the repeated error logs of a kind are folded
+ *        into a summary, and the error logs created at most within it.
+ */
+constexpr auto defaultAggregationWindow = std::chrono::minutes(5);
+constexpr size_t defaultMaxLogsPerWindow = 10;
+
+/**
+ * @brief The paths of the folded error logs kept as a sample in the summary,
+ *        and the length the summary trims the details of the error to.
+ */
+constexpr size_t maxSamplePaths = 5;
+constexpr size_t maxSummaryDetailLength = 256;
+
+/**
+ * @class Aggregator
+ *
+ * @brief Creates the error logs of the daemon without flooding the logging
+ *        service while, for instance, the sibling BMC is unreachable and all
+ *        the paths fail to sync.
+ *
+ * The first error log of a kind (the error and the configuration it is for)
+ * is created right away, the repeated ones within the window are folded into
+ * a summary which is created once the window elapses, with the count, the
+ * first and the last time and a sample of the paths. At most the given number
+ * of error logs are created within any window, a critical error is created
+ * right away regardless, and a rate limited one is folded into its summary.
+ */
+class Aggregator
+{
+  public:
+    Aggregator(const Aggregator&) = delete;
+    Aggregator& operator=(const Aggregator&) = delete;
+    Aggregator(Aggregator&&) = delete;
+    Aggregator& operator=(Aggregator&&) = delete;
+    ~Aggregator() = default;
+
+    /**
+     * @brief The constructor
+     *
+     * @param[in] ctx - The async context
+     * @param[in] clock - The clock of the window
+     * @param[in] extDataIfaces - The interfaces to create the error logs
+     * @param[in] window - The aggregation window
+     * @param[in] maxLogsPerWindow - The error logs created at most within
+     *                               the window
+     */
+    Aggregator(sdbusplus::async::context& ctx, clock::Clock& clock,
+               ext_data::ExternalDataIFaces& extDataIfaces,
+               clock::Duration window = defaultAggregationWindow,
+               size_t maxLogsPerWindow = defaultMaxLogsPerWindow);
+
+    /**
+     * @brief Create the given error log, or fold it into the summary of its
+     *        kind.
+     *
+     * @param[in] errMsg - The error message of the error log
+     * @param[in] errSeverity - The severity of the error log
+     * @param[in] source - The configuration, service or file the error is
+     *                     for, which tells the kinds of the error apart
+     * @param[in] path - The path the error is for
+     * @param[in] additionalDetails - The additional details of the error
+     * @param[in] critical - Whether to create it regardless of the rate limit
+     */
+    sdbusplus::async::task<> createErrorLog(
+        const std::string& errMsg, ext_data::ErrorLevel errSeverity,
+        const std::string& source, const fs::path& path,
+        ext_data::AdditionalData& additionalDetails, bool critical = false);
+
+    /**
+     * @brief Get the number of the error logs folded into the summaries
+     *        since the start.
+     */
+    uint64_t foldedLogs() const noexcept
+    {
+        return _foldedLogs;
+    }
+
+  private:
+    /**
+     * @brief The error logs of a kind within the window.
+     */
+    struct Aggregate
+    {
+        ext_data::ErrorLevel severity;
+        clock::TimePoint windowEnd;
+
+        /**
+         * @brief The details of the first folded error, for the summary
+         */
+        ext_data::AdditionalData details;
+
+        /**
+         * @brief The folded errors, their first and last wall clock time
+         *        and a sample of their paths
+         */
+        size_t count{0};
+        std::chrono::system_clock::time_point first;
+        std::chrono::system_clock::time_point last;
+        std::vector<std::string> samplePaths;
+    };
+
+    using Kind = std::pair<std::string, std::string>;
+
+    /**
+     * @brief Check the rate limit and account an error log if it allows one.
+     *
+     * @param[in] force - Whether to account it regardless of the limit
+     *
+     * @return true if the error log can be created; otherwise false
+     */
+    bool acquire(bool force);
+
+    /**
+     * @brief Create the summaries of the elapsed windows until no error is
+     *        folded anymore.
+     */
+    sdbusplus::async::task<> flush();
+
+    sdbusplus::async::context& _ctx;
+    clock::Clock& _clock;
+    ext_data::ExternalDataIFaces& _extDataIfaces;
+    clock::Duration _window;
+    size_t _maxLogsPerWindow;
+
+    /**
+     * @brief The kinds of the error logged within the window
+     */
+    std::map<Kind, Aggregate> _aggregates;
+
+    /**
+     * @brief The time of the error logs created within the window
+     */
+    std::deque<clock::TimePoint> _createdLogs;
+
+    uint64_t _foldedLogs{0};
+    bool _flushing{false};
+};
+
+} // namespace data_sync::error_log
@@ -0,0 +1,272 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "event_capture.hpp"
+
+#include <phosphor-logging/lg2.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+
+namespace data_sync::capture
+{
+
+namespace
+{
+
+/**
+ * @brief The capture state, the sharded watchers write their records from
+ *        the shard threads. Recursive, as the snapshots of the watchers write
+ *        their records while a capture starts.
+ */
+struct State
+{
+    std::recursive_mutex mutex;
+    std::map<uint16_t, SnapshotFn> watchers;
+    uint16_t nextId{1};
+    std::optional<std::ofstream> file;
+    std::chrono::steady_clock::time_point start;
+
+    // Read without the lock, so the watchers pay nothing when not capturing
+    std::atomic<bool> active{false};
+};
+
+State& state()
+{
+    static State captureState;
+    return captureState;
+}
+
+void writeRecord(RecordType type, uint16_t id,
+                 std::initializer_list<std::span<const uint8_t>> parts)
+{
+    auto& captureState = state();
+    std::lock_guard lock(captureState.mutex);
+    if (!captureState.file.has_value())
+    {
+        return;
+    }
+
+    RecordHeader header{};
+    header.type = type;
+    header.watcher = id;
+    for (const auto& part : parts)
+    {
+        header.size += static_cast<uint32_t>(part.size());
+    }
+    header.timeNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now() - captureState.start)
+                        .count();
+
+    auto& out = captureState.file.value();
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (const auto& part : parts)
+    {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        out.write(reinterpret_cast<const char*>(part.data()),
+                  static_cast<std::streamsize>(part.size()));
+    }
+
+    if (!out.good())
+    {
+        lg2::error("Failed to write the inotify event capture, stopping it");
+        captureState.file.reset();
+        captureState.active.store(false, std::memory_order_relaxed);
+    }
+}
+
+template <typename T>
+std::span<const uint8_t> asBytes(const T& value)
+{
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    return {reinterpret_cast<const uint8_t*>(&value), sizeof(value)};
+}
+
+std::span<const uint8_t> asBytes(const std::string& str)
+{
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    return {reinterpret_cast<const uint8_t*>(str.data()), str.size()};
+}
+
+} // namespace
+
+uint16_t registerWatcher(SnapshotFn snapshot)
+{
+    auto& captureState = state();
+    std::lock_guard lock(captureState.mutex);
+    const auto id = captureState.nextId++;
+    if (active())
+    {
+        snapshot(id);
+    }
+    captureState.watchers.emplace(id, std::move(snapshot));
+    return id;
+}
+
+void unregisterWatcher(uint16_t id)
+{
+    auto& captureState = state();
+    std::lock_guard lock(captureState.mutex);
+    captureState.watchers.erase(id);
+}
+
+bool start(const fs::path& captureFile)
+{
+    stop();
+
+    std::error_code ec;
+    fs::create_directories(captureFile.parent_path(), ec);
+
+    auto& captureState = state();
+    std::lock_guard lock(captureState.mutex);
+    std::ofstream out(captureFile, std::ios::binary | std::ios::trunc);
+    if (!out.is_open())
+    {
+        lg2::error("Failed to open the inotify event capture file {FILE}",
+                   "FILE", captureFile);
+        return false;
+    }
+
+    FileHeader header{};
+    header.magic = captureMagic;
+    header.version = captureVersion;
+    header.startTimeUs =
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::system_clock::now().time_since_epoch())
+            .count();
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    captureState.file = std::move(out);
+    captureState.start = std::chrono::steady_clock::now();
+    captureState.active.store(true, std::memory_order_relaxed);
+
+    // The replay needs to know what each watcher was watching already.
+    for (const auto& [id, snapshot] : captureState.watchers)
+    {
+        snapshot(id);
+    }
+
+    lg2::info("Started capturing the inotify events into {FILE}", "FILE",
+              captureFile);
+    return true;
+}
+
+void stop()
+{
+    auto& captureState = state();
+    std::lock_guard lock(captureState.mutex);
+    captureState.active.store(false, std::memory_order_relaxed);
+    if (captureState.file.has_value())
+    {
+        captureState.file->close();
+        captureState.file.reset();
+        lg2::info("Stopped capturing the inotify events");
+    }
+}
+
+bool active() noexcept
+{
+    return state().active.load(std::memory_order_relaxed);
+}
+
+void watcher(uint16_t id, uint32_t eventMasks, const fs::path& dataPath,
+             const std::vector<fs::path>& excludeList,
+             const std::vector<fs::path>& includeList)
+{
+    if (!active())
+    {
+        return;
+    }
+
+    std::string paths = dataPath.string();
+    for (const auto& path : excludeList)
+    {
+        paths.append("\n-" + path.string());
+    }
+    for (const auto& path : includeList)
+    {
+        paths.append("\n+" + path.string());
+    }
+    writeRecord(RecordType::Watcher, id, {asBytes(eventMasks), asBytes(paths)});
+}
+
+void watchAdded(uint16_t id, int wd, const fs::path& path)
+{
+    if (active())
+    {
+        // The replay needs to recreate the watched directories as such
+        std::string watched = path.native();
+        std::error_code ec;
+        if (!watched.ends_with('/') && fs::is_directory(path, ec))
+        {
+            watched.push_back('/');
+        }
+        writeRecord(RecordType::WatchAdded, id,
+                    {asBytes(wd), asBytes(watched)});
+    }
+}
+
+void watchRemoved(uint16_t id, int wd)
+{
+    if (active())
+    {
+        writeRecord(RecordType::WatchRemoved, id, {asBytes(wd)});
+    }
+}
+
+void batch(uint16_t id, std::span<const uint8_t> events)
+{
+    if (active())
+    {
+        writeRecord(RecordType::Batch, id, {events});
+    }
+}
+
+std::vector<Record> readCapture(const fs::path& captureFile,
+                                FileHeader& header)
+{
+    std::ifstream in(captureFile, std::ios::binary);
+    if (!in.is_open())
+    {
+        throw std::runtime_error("Failed to open " + captureFile.string());
+    }
+
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    in.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!in.good() || header.magic != captureMagic ||
+        header.version != captureVersion)
+    {
+        throw std::runtime_error("Invalid or unsupported inotify capture " +
+                                 captureFile.string());
+    }
+
+    std::vector<Record> records;
+    Record record{};
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    while (in.read(reinterpret_cast<char*>(&record.header),
+                   sizeof(record.header)))
+    {
+        record.payload.resize(record.header.size);
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        if (!in.read(reinterpret_cast<char*>(record.payload.data()),
+                     record.header.size))
+        {
+            // The daemon may have stopped in the middle of a record
+            lg2::warning("Ignoring the truncated record at the end of {FILE}",
+                         "FILE", captureFile);
+            break;
+        }
+        records.push_back(record);
+    }
+    return records;
+}
+
+} // namespace data_sync::capture
@@ -0,0 +1,149 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <span>
+#include <vector>
+
+namespace data_sync::capture
+{
+
+namespace fs = std::filesystem;
+
+/**
+ * @brief Identifies an inotify event capture file ("DSEV") and its version.
+ */
+constexpr uint32_t captureMagic = 0x56455344;
+constexpr uint16_t captureVersion = 1;
+
+/**
+ * @brief The types of the captured records.
+ */
+enum class RecordType : uint8_t
+{
+    Watcher = 1,      // payload: event masks (u32), the configured path and
+                      // one line per excluded ("-") and included ("+") path
+    WatchAdded = 2,   // payload: watch descriptor (i32), the watched path
+                      // (with a trailing "/" if a directory)
+    WatchRemoved = 3, // payload: watch descriptor (i32)
+    Batch = 4         // payload: the inotify_event structures as read
+};
+
+/**
+ * @brief The header of the capture file, followed by the records.
+ */
+struct FileHeader
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t reserved;
+
+    /**
+     * @brief The CLOCK_REALTIME timestamp (in microseconds) of the start
+     */
+    uint64_t startTimeUs;
+};
+
+/**
+ * @brief The header of each record, followed by its payload.
+ */
+struct RecordHeader
+{
+    RecordType type;
+    uint8_t reserved;
+
+    /**
+     * @brief The capture id of the watcher which produced the record
+     */
+    uint16_t watcher;
+    uint32_t size;
+
+    /**
+     * @brief The time since the capture start in nanoseconds
+     */
+    uint64_t timeNs;
+};
+
+static_assert(sizeof(RecordHeader) == 16, "Keep the record header compact");
+
+/**
+ * @brief A record read from a capture file.
+ */
+struct Record
+{
+    RecordHeader header;
+    std::vector<uint8_t> payload;
+};
+
+/**
+ * @brief The callback through which a watcher writes its current state (the
+ *        Watcher and WatchAdded records) when a capture starts.
+ *
+ * It is invoked on the thread which starts the capture, a watcher driven by
+ * another thread rather defers the write to that thread.
+ */
+using SnapshotFn = std::function<void(uint16_t id)>;
+
+/**
+ * @brief Register a watcher to be captured.
+ *
+ * @param[in] snapshot - The callback to write the state of the watcher, it is
+ *                       invoked right away if a capture is in progress.
+ *
+ * @return The capture id of the watcher
+ */
+uint16_t registerWatcher(SnapshotFn snapshot);
+
+/**
+ * @brief Unregister the watcher of the given capture id.
+ */
+void unregisterWatcher(uint16_t id);
+
+/**
+ * @brief Start capturing the inotify events of all the watchers into the
+ *        given file, overwriting it.
+ *
+ * @param[in] captureFile - The file to write
+ *
+ * @return true if started; otherwise false
+ */
+bool start(const fs::path& captureFile);
+
+/**
+ * @brief Stop the capture in progress, if any.
+ */
+void stop();
+
+/**
+ * @brief Check whether a capture is in progress.
+ */
+bool active() noexcept;
+
+/**
+ * @brief Helpers to write the records, they do nothing when no capture is in
+ *        progress. Safe to call from the watch shard threads.
+ */
+void watcher(uint16_t id, uint32_t eventMasks, const fs::path& dataPath,
+             const std::vector<fs::path>& excludeList,
+             const std::vector<fs::path>& includeList);
+void watchAdded(uint16_t id, int wd, const fs::path& path);
+void watchRemoved(uint16_t id, int wd);
+void batch(uint16_t id, std::span<const uint8_t> events);
+
+/**
+ * @brief Read the records from the given capture file.
+ *
+ * @param[in] captureFile - The file to read
+ * @param[out] header - The read file header
+ *
+ * @return The records in the captured order
+ *
+ * @throw std::runtime_error if the file is not a valid capture
+ */
+std::vector<Record> readCapture(const fs::path& captureFile,
+                                FileHeader& header);
+
+} // namespace data_sync::capture
@@ -0,0 +1,399 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "event_replay.hpp"
+
+#include "event_capture.hpp"
+
+#include <phosphor-logging/lg2.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <optional>
+#include <ranges>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <utility>
+
+namespace data_sync::watch::replay
+{
+
+namespace
+{
+
+using inotify::BaseName;
+using inotify::Cookie;
+using inotify::EventInfo;
+using inotify::WD;
+
+/**
+ * @brief The DataWatcher which receives the captured batches instead of
+ *        reading its inotify instance.
+ */
+class ReplayWatcher : public inotify::DataWatcher
+{
+  public:
+    using DataWatcher::DataWatcher;
+    using DataWatcher::parseEvents;
+
+    inotify::DataOperations process(const std::vector<EventInfo>& events)
+    {
+        takeDataOperations();
+        processEvents(events);
+        return takeDataOperations();
+    }
+};
+
+/**
+ * @brief A captured watcher and its replay state.
+ */
+struct CapturedWatcher
+{
+    uint32_t eventMasks{0};
+    fs::path dataPath;
+    std::optional<std::unordered_set<fs::path>> excludeList;
+    std::optional<std::unordered_set<fs::path>> includeList;
+
+    /**
+     * @brief The captured watch descriptors and their paths
+     */
+    std::map<WD, fs::path> watches;
+
+    /**
+     * @brief The IN_MOVED_FROM paths (in the shadow tree) per cookie, waiting
+     *        for the corresponding IN_MOVED_TO.
+     */
+    std::map<Cookie, fs::path> movedFrom;
+
+    std::unique_ptr<ReplayWatcher> watcher;
+};
+
+fs::path shadowOf(const fs::path& shadowRoot, const fs::path& path)
+{
+    return shadowRoot / path.relative_path();
+}
+
+fs::path capturedOf(const fs::path& shadowRoot, const fs::path& path)
+{
+    const auto& shadow = shadowRoot.native();
+    return path.native().starts_with(shadow)
+               ? fs::path(path.native().substr(shadow.size()))
+               : path;
+}
+
+/**
+ * @brief Create the given directory or file (without modifying an existing
+ *        file) in the shadow tree.
+ */
+void create(const fs::path& path, bool isDir)
+{
+    std::error_code ec;
+    if (isDir)
+    {
+        fs::create_directories(path, ec);
+        return;
+    }
+    fs::create_directories(path.parent_path(), ec);
+    std::ofstream(path, std::ios::app);
+}
+
+CapturedWatcher parseWatcher(const capture::Record& record)
+{
+    CapturedWatcher captured;
+    std::memcpy(&captured.eventMasks, record.payload.data(),
+                sizeof(captured.eventMasks));
+
+    std::string paths(record.payload.begin() + sizeof(captured.eventMasks),
+                      record.payload.end());
+    for (const auto& entry : std::views::split(paths, '\n'))
+    {
+        const std::string line(entry.begin(), entry.end());
+        if (captured.dataPath.empty())
+        {
+            captured.dataPath = line;
+        }
+        else if (line.starts_with('-'))
+        {
+            captured.excludeList.emplace().emplace(line.substr(1));
+        }
+        else if (line.starts_with('+'))
+        {
+            captured.includeList.emplace().emplace(line.substr(1));
+        }
+    }
+    return captured;
+}
+
+/**
+ * @brief Apply the filesystem change reported by the event on the shadow
+ *        tree, as it already happened when the daemon read the event.
+ */
+void applyEvent(CapturedWatcher& captured, const fs::path& watched,
+                const EventInfo& event)
+{
+    const auto& [wd, name, mask, cookie] = event;
+    const fs::path target = name.empty() ? watched : watched / name;
+    const bool isDir = (mask & IN_ISDIR) != 0;
+
+    std::error_code ec;
+    if ((mask & IN_CREATE) != 0)
+    {
+        create(target, isDir);
+    }
+    else if ((mask & IN_CLOSE_WRITE) != 0)
+    {
+        create(target, false);
+    }
+    else if ((mask & IN_MOVED_FROM) != 0)
+    {
+        captured.movedFrom[cookie] = target;
+    }
+    else if ((mask & IN_MOVED_TO) != 0)
+    {
+        auto from = captured.movedFrom.find(cookie);
+        if (from != captured.movedFrom.end() && fs::exists(from->second, ec))
+        {
+            fs::create_directories(target.parent_path(), ec);
+            fs::rename(from->second, target, ec);
+            captured.movedFrom.erase(from);
+        }
+        else
+        {
+            // Moved in from outside of the watched tree
+            create(target, isDir);
+        }
+    }
+    else if ((mask & IN_DELETE) != 0)
+    {
+        fs::remove_all(target, ec);
+    }
+    else if ((mask & IN_DELETE_SELF) != 0)
+    {
+        fs::remove_all(watched, ec);
+    }
+}
+
+/**
+ * @brief Remove the paths moved out of the watched tree, the kernel queues
+ *        the IN_MOVED_TO right after its IN_MOVED_FROM, so an IN_MOVED_FROM
+ *        which is not followed by its pair in the next batch has no pair.
+ */
+void removeMovedOut(CapturedWatcher& captured,
+                    const std::vector<EventInfo>& events)
+{
+    std::erase_if(captured.movedFrom, [&events](const auto& movedFrom) {
+        const bool paired = std::ranges::any_of(
+            events, [&movedFrom](const EventInfo& event) {
+            return std::get<3>(event) == movedFrom.first &&
+                   (std::get<2>(event) & IN_MOVED_TO) != 0;
+        });
+        if (!paired)
+        {
+            std::error_code ec;
+            fs::remove_all(movedFrom.second, ec);
+        }
+        return !paired;
+    });
+}
+
+/**
+ * @brief Map the captured watch descriptor to the one of the replayed
+ *        watcher through the watched path.
+ *
+ * @return The replayed watch descriptor; std::nullopt if the replayed watcher
+ *         is not watching the path.
+ */
+std::optional<WD> replayedWd(const CapturedWatcher& captured, WD capturedWd,
+                             const fs::path& shadowRoot)
+{
+    auto watched = captured.watches.find(capturedWd);
+    if (watched == captured.watches.end())
+    {
+        return std::nullopt;
+    }
+
+    // The captured directories carry a trailing "/" which the watched paths
+    // may not have.
+    const auto shadow = shadowOf(shadowRoot, watched->second) / "";
+    const auto& replayedWatches = captured.watcher->getWatchDescriptors();
+    auto replayed = std::ranges::find_if(
+        replayedWatches,
+        [&shadow](const auto& wd) { return wd.second / "" == shadow; });
+    if (replayed == replayedWatches.end())
+    {
+        return std::nullopt;
+    }
+    return replayed->first;
+}
+
+} // namespace
+
+ReplayReport replay(sdbusplus::async::context& ctx, const fs::path& captureFile,
+                    const ReplayOptions& options)
+{
+    capture::FileHeader header{};
+    const auto records = capture::readCapture(captureFile, header);
+
+    // The shadow paths are mapped back by stripping the root
+    const fs::path shadowRoot = options.shadowRoot.has_filename()
+                                    ? options.shadowRoot
+                                    : options.shadowRoot.parent_path();
+
+    std::error_code ec;
+    fs::remove_all(shadowRoot, ec);
+    fs::create_directories(shadowRoot);
+
+    std::map<uint16_t, CapturedWatcher> watchers;
+    ReplayReport report;
+    const auto replayStart = std::chrono::steady_clock::now();
+
+    for (const auto& record : records)
+    {
+        const auto id = record.header.watcher;
+        switch (record.header.type)
+        {
+            case capture::RecordType::Watcher:
+            {
+                watchers.insert_or_assign(id, parseWatcher(record));
+                break;
+            }
+            case capture::RecordType::WatchAdded:
+            {
+                auto it = watchers.find(id);
+                if (it == watchers.end())
+                {
+                    break;
+                }
+                WD wd{0};
+                std::memcpy(&wd, record.payload.data(), sizeof(wd));
+                fs::path path(std::string(record.payload.begin() + sizeof(wd),
+                                          record.payload.end()));
+
+                // Recreate the trees which were watched before the replayed
+                // watcher starts, the later ones are created by the events.
+                if (!it->second.watcher)
+                {
+                    create(shadowOf(shadowRoot, path),
+                           path.native().ends_with('/'));
+                }
+                it->second.watches.insert_or_assign(wd, std::move(path));
+                break;
+            }
+            case capture::RecordType::WatchRemoved:
+            {
+                if (auto it = watchers.find(id); it != watchers.end())
+                {
+                    WD wd{0};
+                    std::memcpy(&wd, record.payload.data(), sizeof(wd));
+                    it->second.watches.erase(wd);
+                }
+                break;
+            }
+            case capture::RecordType::Batch:
+            {
+                auto it = watchers.find(id);
+                if (it == watchers.end())
+                {
+                    break;
+                }
+                auto& captured = it->second;
+
+                if (!captured.watcher)
+                {
+                    auto shadowList = [&shadowRoot](const auto& list) {
+                        std::optional<std::unordered_set<fs::path>> shadow;
+                        if (list.has_value())
+                        {
+                            shadow.emplace();
+                            for (const auto& path : list.value())
+                            {
+                                shadow->emplace(
+                                    shadowOf(shadowRoot, path));
+                            }
+                        }
+                        return shadow;
+                    };
+                    captured.watcher = std::make_unique<ReplayWatcher>(
+                        ctx, IN_NONBLOCK, captured.eventMasks,
+                        shadowOf(shadowRoot, captured.dataPath),
+                        shadowList(captured.excludeList),
+                        shadowList(captured.includeList));
+                }
+
+                if (options.speed > 0)
+                {
+                    std::this_thread::sleep_until(
+                        replayStart +
+                        std::chrono::duration_cast<
+                            std::chrono::steady_clock::duration>(
+                            std::chrono::nanoseconds(record.header.timeNs) /
+                            options.speed));
+                }
+
+                // Map the captured watch descriptors to the replayed ones
+                // through the watched paths.
+                std::vector<EventInfo> events;
+                for (auto event : captured.watcher->parseEvents(record.payload))
+                {
+                    auto wd = replayedWd(captured, std::get<WD>(event),
+                                         shadowRoot);
+                    if (!wd.has_value())
+                    {
+                        ++report.unmatchedEvents;
+                        continue;
+                    }
+                    std::get<WD>(event) = wd.value();
+                    events.push_back(std::move(event));
+                }
+
+                removeMovedOut(captured, events);
+                for (const auto& event : events)
+                {
+                    applyEvent(captured,
+                               captured.watcher->getWatchDescriptors().at(
+                                   std::get<WD>(event)),
+                               event);
+                }
+
+                BatchResult result;
+                result.capturedAt =
+                    std::chrono::nanoseconds(record.header.timeNs);
+                result.watcherPath = captured.dataPath;
+                result.events = events.size();
+
+                const auto processStart = std::chrono::steady_clock::now();
+                try
+                {
+                    result.operations = captured.watcher->process(events);
+                }
+                catch (const std::exception& e)
+                {
+                    lg2::error("Failed to replay the batch at {TIME}ns : "
+                               "{ERROR}",
+                               "TIME", record.header.timeNs, "ERROR", e);
+                }
+                result.cost = std::chrono::steady_clock::now() - processStart;
+
+                for (auto& operation : result.operations)
+                {
+                    operation.first =
+                        capturedOf(shadowRoot, operation.first);
+                }
+                report.batches.push_back(std::move(result));
+                break;
+            }
+            default:
+            {
+                lg2::warning("Skipping the unknown capture record type {TYPE}",
+                             "TYPE", std::to_underlying(record.header.type));
+                break;
+            }
+        }
+    }
+    return report;
+}
+
+} // namespace data_sync::watch::replay
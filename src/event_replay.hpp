@@ -0,0 +1,101 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "data_watcher.hpp"
+
+#include <sdbusplus/async.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+namespace data_sync::watch::replay
+{
+
+namespace fs = std::filesystem;
+
+/**
+ * @brief The options of a replay.
+ */
+struct ReplayOptions
+{
+    /**
+     * @brief The directory under which the captured trees are recreated, it
+     *        is removed at the start of the replay.
+     */
+    fs::path shadowRoot;
+
+    /**
+     * @brief The replay speed relative to the captured timing, zero to replay
+     *        as fast as possible.
+     */
+    double speed{0};
+};
+
+/**
+ * @brief The outcome of a replayed inotify batch.
+ */
+struct BatchResult
+{
+    /**
+     * @brief The time since the capture start at which the batch was read
+     */
+    std::chrono::nanoseconds capturedAt{0};
+
+    /**
+     * @brief The path configured for the watcher which read the batch
+     */
+    fs::path watcherPath;
+
+    size_t events{0};
+
+    /**
+     * @brief The time spent by the watcher to process the batch
+     */
+    std::chrono::nanoseconds cost{0};
+
+    /**
+     * @brief The resulting data operations, with the captured paths
+     */
+    inotify::DataOperations operations;
+};
+
+/**
+ * @brief The outcome of a replay.
+ */
+struct ReplayReport
+{
+    std::vector<BatchResult> batches;
+
+    /**
+     * @brief The number of events dropped because the replayed watcher wasn't
+     *        watching their path, it is non zero only if the replay diverged
+     *        from the capture.
+     */
+    size_t unmatchedEvents{0};
+};
+
+/**
+ * @brief Replay the given inotify event capture.
+ *
+ * The captured trees are recreated under the shadow root from the watches of
+ * each watcher and kept in step with the captured events, so the watchers'
+ * filesystem checks see what the daemon saw. The captured batches are then
+ * fed into a DataWatcher per captured watcher, bypassing the reads from its
+ * inotify instance.
+ *
+ * @param[in] ctx - The async context for the replayed watchers, it doesn't
+ *                  need to run.
+ * @param[in] captureFile - The capture file
+ * @param[in] options - The replay options
+ *
+ * @return The replay report
+ *
+ * @throw std::runtime_error if the capture file is not valid.
+ */
+ReplayReport replay(sdbusplus::async::context& ctx, const fs::path& captureFile,
+                    const ReplayOptions& options);
+
+} // namespace data_sync::watch::replay
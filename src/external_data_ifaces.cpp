@@ -2,6 +2,8 @@
 
 #include "external_data_ifaces.hpp"
 
+#include <utility>
+
 namespace data_sync::ext_data
 {
 
@@ -20,7 +22,15 @@ BMCRole ExternalDataIFaces::bmcRole() const
 
 void ExternalDataIFaces::bmcRole(const BMCRole& bmcRole)
 {
-    _bmcRole = bmcRole;
+    if (std::exchange(_bmcRole, bmcRole) != bmcRole && _roleChangedCallback)
+    {
+        _roleChangedCallback(bmcRole);
+    }
+}
+
+void ExternalDataIFaces::onRoleChanged(RoleChangedCallback callback)
+{
+    _roleChangedCallback = std::move(callback);
 }
 
 BMCRedundancy ExternalDataIFaces::bmcRedundancy() const
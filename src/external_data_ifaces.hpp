@@ -7,6 +7,8 @@
 #include <xyz/openbmc_project/Logging/Entry/server.hpp>
 #include <xyz/openbmc_project/State/BMC/Redundancy/common.hpp>
 
+#include <functional>
+
 namespace data_sync::ext_data
 {
 
@@ -15,6 +17,8 @@ using BMCRole = RBMC::Role;
 using BMCRedundancy = bool;
 using BMCPosition = size_t;
 
+using RoleChangedCallback = std::function<void(BMCRole)>;
+
 using json = nlohmann::json;
 using AdditionalData = std::map<std::string, std::string>;
 using Logging = sdbusplus::common::xyz::openbmc_project::logging::Create;
@@ -118,6 +122,13 @@ class ExternalDataIFaces
      */
     virtual sdbusplus::async::task<> watchRedundancyMgrProps() = 0;
 
+    /**
+     * @brief Register the callback to invoke when the BMC role changes.
+     *
+     * @param[in] callback - The callback, which receives the new role
+     */
+    void onRoleChanged(RoleChangedCallback callback);
+
   protected:
     /**
      * @brief Used to retrieve the BMC role.
@@ -162,6 +173,11 @@ class ExternalDataIFaces
      */
     BMCRole _bmcRole{BMCRole::Unknown};
 
+    /**
+     * @brief The callback to invoke when the BMC role changes.
+     */
+    RoleChangedCallback _roleChangedCallback;
+
     /**
      * @brief Indicates whether BMC redundancy is enabled in the system.
      */
@@ -170,7 +186,7 @@ class ExternalDataIFaces
     /**
      * @brief hold the BMC Position
      */
-    BMCPosition _bmcPosition;
+    BMCPosition _bmcPosition{0};
 };
 
 } // namespace data_sync::ext_data
@@ -0,0 +1,204 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "flight_recorder.hpp"
+
+#include "status_page.hpp"
+
+#include <unistd.h>
+
+#include <phosphor-logging/lg2.hpp>
+
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace data_sync::recorder
+{
+
+namespace
+{
+
+std::atomic<uint64_t> head{0};
+std::array<Record, capacity> ring{};
+
+} // namespace
+
+void record(EventType type, std::string_view path, int32_t code,
+            uint64_t value) noexcept
+{
+    const auto position = head.fetch_add(1, std::memory_order_relaxed);
+    auto& slot = ring[position & (capacity - 1)];
+
+    std::atomic_ref<uint64_t> sequence(slot.sequence);
+    sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot.timeUs = status::nowInUs();
+    slot.value = value;
+    slot.code = code;
+    slot.type = type;
+
+    if (path.size() >= maxPathLen)
+    {
+        // Keep the tail as it is the most meaningful part of the path.
+        path.remove_prefix(path.size() - (maxPathLen - 1));
+    }
+    std::memset(slot.path, '\0', maxPathLen);
+    std::memcpy(slot.path, path.data(), path.size());
+
+    sequence.store(position + 1, std::memory_order_release);
+}
+
+std::vector<Record> snapshot()
+{
+    const auto end = head.load(std::memory_order_acquire);
+    const auto begin = end > capacity ? end - capacity : 0;
+
+    std::vector<Record> records;
+    records.reserve(end - begin);
+    for (auto position = begin; position < end; ++position)
+    {
+        auto& slot = ring[position & (capacity - 1)];
+        std::atomic_ref<uint64_t> sequence(slot.sequence);
+
+        if (sequence.load(std::memory_order_acquire) != position + 1)
+        {
+            // Being written or already overwritten by a newer record
+            continue;
+        }
+        Record copy{};
+        std::memcpy(&copy, &slot, sizeof(Record));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sequence.load(std::memory_order_relaxed) == position + 1)
+        {
+            records.push_back(copy);
+        }
+    }
+    return records;
+}
+
+void reset() noexcept
+{
+    head.store(0, std::memory_order_relaxed);
+    for (auto& slot : ring)
+    {
+        std::atomic_ref<uint64_t>(slot.sequence)
+            .store(0, std::memory_order_relaxed);
+    }
+}
+
+bool dumpToFile(const fs::path& dumpFile)
+{
+    try
+    {
+        auto records = snapshot();
+
+        DumpHeader header{};
+        header.magic = dumpMagic;
+        header.version = dumpVersion;
+        header.recordSize = sizeof(Record);
+        header.recordCount = static_cast<uint32_t>(records.size());
+        header.daemonPid = static_cast<uint32_t>(getpid());
+        header.dumpTimeUs = status::nowInUs();
+
+        std::error_code ec;
+        fs::create_directories(dumpFile.parent_path(), ec);
+
+        // Write into a temporary file and rename, so that the previous dump
+        // stays intact if the write fails.
+        fs::path tmpDumpFile = dumpFile;
+        tmpDumpFile += ".tmp";
+        {
+            std::ofstream file(tmpDumpFile, std::ios::binary | std::ios::trunc);
+            if (!file.is_open())
+            {
+                lg2::error("Failed to open the flight recorder dump {FILE}",
+                           "FILE", tmpDumpFile);
+                return false;
+            }
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+            file.write(reinterpret_cast<const char*>(records.data()),
+                       static_cast<std::streamsize>(records.size() *
+                                                    sizeof(Record)));
+            if (!file.good())
+            {
+                lg2::error("Failed to write the flight recorder dump {FILE}",
+                           "FILE", tmpDumpFile);
+                return false;
+            }
+        }
+        fs::rename(tmpDumpFile, dumpFile);
+
+        lg2::info("Dumped {COUNT} flight recorder entries to {FILE}", "COUNT",
+                  records.size(), "FILE", dumpFile);
+        return true;
+    }
+    catch (const std::exception& e)
+    {
+        lg2::error("Error writing the flight recorder dump: {ERROR}", "ERROR",
+                   e);
+    }
+    return false;
+}
+
+std::vector<Record> readDump(const fs::path& dumpFile, DumpHeader& header)
+{
+    std::ifstream file(dumpFile, std::ios::binary);
+    if (!file.is_open())
+    {
+        throw std::runtime_error("Failed to open " + dumpFile.string());
+    }
+
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!file.good() || header.magic != dumpMagic ||
+        header.version != dumpVersion || header.recordSize != sizeof(Record) ||
+        header.recordCount > capacity)
+    {
+        throw std::runtime_error("Invalid flight recorder dump " +
+                                 dumpFile.string());
+    }
+
+    std::vector<Record> records(header.recordCount);
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    file.read(reinterpret_cast<char*>(records.data()),
+              static_cast<std::streamsize>(records.size() * sizeof(Record)));
+    if (!file.good())
+    {
+        throw std::runtime_error("Truncated flight recorder dump " +
+                                 dumpFile.string());
+    }
+    return records;
+}
+
+std::string_view eventTypeName(EventType type)
+{
+    switch (type)
+    {
+        case EventType::EventReceived:
+            return "EventReceived";
+        case EventType::OpCoalesced:
+            return "OpCoalesced";
+        case EventType::SyncStarted:
+            return "SyncStarted";
+        case EventType::SyncFinished:
+            return "SyncFinished";
+        case EventType::Retry:
+            return "Retry";
+        case EventType::NotifySent:
+            return "NotifySent";
+        case EventType::NotifyApplied:
+            return "NotifyApplied";
+        case EventType::HealthChanged:
+            return "HealthChanged";
+        case EventType::ModeChanged:
+            return "ModeChanged";
+        default:
+            return "Unknown";
+    }
+}
+
+} // namespace data_sync::recorder
@@ -0,0 +1,144 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+#include <vector>
+
+namespace data_sync::recorder
+{
+
+namespace fs = std::filesystem;
+
+/**
+ * @brief The recorded sync pipeline events.
+ */
+enum class EventType : uint8_t
+{
+    EventReceived, // Inotify event accepted, value: the event mask
+    OpCoalesced,   // Sync skipped as one is already in progress for the path
+    SyncStarted,   // rsync spawned, code: the retry count
+    SyncFinished,  // rsync finished, code: exit code, value: transferred bytes
+    Retry,         // Sync retry scheduled, code: the retry count
+    NotifySent,    // Notify request sent to the sibling, code: exit code
+    NotifyApplied, // Notify request from the sibling processed
+    HealthChanged, // SyncEventsHealth changed, code: the new value
+    ModeChanged,   // Hot path sync mode changed, code: 1 if batched
+    Count
+};
+
+/**
+ * @brief The number of records kept, the oldest are overwritten first.
+ */
+constexpr size_t capacity = 4096;
+static_assert((capacity & (capacity - 1)) == 0, "capacity must be power of 2");
+
+/**
+ * @brief The maximum stored path length (including the terminator), longer
+ *        paths are truncated from the front.
+ */
+constexpr size_t maxPathLen = 32;
+
+/**
+ * @brief Identifies a flight recorder dump file ("DSFR") and its version.
+ */
+constexpr uint32_t dumpMagic = 0x52465344;
+constexpr uint16_t dumpVersion = 1;
+
+/**
+ * @brief A compact fixed size record of an event.
+ */
+struct Record
+{
+    /**
+     * @brief The position of the record in the ring plus one; zero while the
+     *        record is being written.
+     *
+     * @note Accessed only through std::atomic_ref.
+     */
+    alignas(std::atomic_ref<uint64_t>::required_alignment) uint64_t sequence;
+
+    /**
+     * @brief The CLOCK_REALTIME timestamp in microseconds
+     */
+    uint64_t timeUs;
+    uint64_t value;
+    int32_t code;
+    EventType type;
+    uint8_t reserved[3];
+    char path[maxPathLen];
+};
+
+static_assert(sizeof(Record) == 64, "Keep the record compact");
+static_assert(std::atomic_ref<uint64_t>::is_always_lock_free,
+              "The flight recorder requires a lock free 64bit atomic");
+
+/**
+ * @brief The header of the dump file, followed by the records (oldest first).
+ */
+struct DumpHeader
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t recordSize;
+    uint32_t recordCount;
+    uint32_t daemonPid;
+    uint64_t dumpTimeUs;
+};
+
+/**
+ * @brief Record an event into the ring.
+ *
+ * This never blocks, allocates or performs I/O, so it is safe to call on
+ * the hot paths.
+ *
+ * @param[in] type - The event type
+ * @param[in] path - The related path
+ * @param[in] code - The event specific code
+ * @param[in] value - The event specific value
+ */
+void record(EventType type, std::string_view path, int32_t code = 0,
+            uint64_t value = 0) noexcept;
+
+/**
+ * @brief Take a copy of the consistent records currently in the ring.
+ *
+ * @return The records, oldest first
+ */
+std::vector<Record> snapshot();
+
+/**
+ * @brief Clear all the records.
+ */
+void reset() noexcept;
+
+/**
+ * @brief Dump the records into the given file.
+ *
+ * @param[in] dumpFile - The file to write
+ *
+ * @return true if dumped; otherwise false
+ */
+bool dumpToFile(const fs::path& dumpFile);
+
+/**
+ * @brief Read the records from the given dump file.
+ *
+ * @param[in] dumpFile - The file to read
+ * @param[out] header - The read dump header
+ *
+ * @return The records, oldest first
+ *
+ * @throw std::runtime_error if the file is not a valid dump
+ */
+std::vector<Record> readDump(const fs::path& dumpFile, DumpHeader& header);
+
+/**
+ * @brief Get the name of the given event type.
+ */
+std::string_view eventTypeName(EventType type);
+
+} // namespace data_sync::recorder
@@ -0,0 +1,110 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "hot_path_tracker.hpp"
+
+#include <cmath>
+
+namespace data_sync::hot_path
+{
+
+namespace
+{
+
+/**
+ * @brief The time constant of the rate decay.
+ */
+constexpr auto rateWindow = std::chrono::minutes(1);
+
+/**
+ * @brief The number of tracked paths above which the cold paths are dropped.
+ */
+constexpr size_t pruneThreshold = 256;
+
+} // namespace
+
+HotPathTracker::HotPathTracker(const config::HotPathBatching& limits) :
+    _limits(limits)
+{}
+
+double HotPathTracker::decayed(const PathRate& pathRate, clock::TimePoint now)
+{
+    const auto elapsed =
+        std::chrono::duration<double>(now - pathRate.last).count();
+    if (elapsed <= 0)
+    {
+        return pathRate.count;
+    }
+    return pathRate.count *
+           std::exp(-elapsed /
+                    std::chrono::duration<double>(rateWindow).count());
+}
+
+Mode HotPathTracker::onChange(const fs::path& path, clock::TimePoint now)
+{
+    if (_paths.size() > pruneThreshold)
+    {
+        prune(now);
+    }
+
+    auto& pathRate = _paths[path];
+    pathRate.count = decayed(pathRate, now) + 1;
+    pathRate.last = now;
+
+    if (pathRate.mode == Mode::Immediate &&
+        pathRate.count >= static_cast<double>(_limits._enterRatePerMin))
+    {
+        pathRate.mode = Mode::Batched;
+        ++_batchedCount;
+    }
+
+    if (pathRate.mode == Mode::Batched)
+    {
+        pathRate.pending = true;
+    }
+    return pathRate.mode;
+}
+
+bool HotPathTracker::takePending(const fs::path& path)
+{
+    auto it = _paths.find(path);
+    if (it == _paths.end() || !it->second.pending)
+    {
+        return false;
+    }
+    it->second.pending = false;
+    return true;
+}
+
+Mode HotPathTracker::refresh(const fs::path& path, clock::TimePoint now)
+{
+    auto it = _paths.find(path);
+    if (it == _paths.end())
+    {
+        return Mode::Immediate;
+    }
+
+    auto& pathRate = it->second;
+    if (pathRate.mode == Mode::Batched && !pathRate.pending &&
+        decayed(pathRate, now) <= static_cast<double>(_limits._exitRatePerMin))
+    {
+        pathRate.mode = Mode::Immediate;
+        --_batchedCount;
+    }
+    return pathRate.mode;
+}
+
+double HotPathTracker::rate(const fs::path& path, clock::TimePoint now) const
+{
+    auto it = _paths.find(path);
+    return it == _paths.end() ? 0 : decayed(it->second, now);
+}
+
+void HotPathTracker::prune(clock::TimePoint now)
+{
+    std::erase_if(_paths, [now](const auto& entry) {
+        return entry.second.mode == Mode::Immediate &&
+               decayed(entry.second, now) < 1;
+    });
+}
+
+} // namespace data_sync::hot_path
@@ -0,0 +1,128 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "clock.hpp"
+#include "data_sync_config.hpp"
+
+#include <filesystem>
+#include <unordered_map>
+
+namespace data_sync::hot_path
+{
+
+namespace fs = std::filesystem;
+
+/**
+ * @brief The sync modes of a path.
+ */
+enum class Mode
+{
+    Immediate,
+    Batched
+};
+
+/**
+ * @class HotPathTracker
+ *
+ * @brief Tracks the change rate of the paths of a configuration and decides
+ *        when a path switches to the batched sync and back.
+ *
+ * The rate is an exponentially decayed count of the changes with a time
+ * constant of one minute, so it approximates the changes in the last minute
+ * without keeping a history per path.
+ *
+ * @note Not thread-safe, all updates are expected from the event loop thread.
+ */
+class HotPathTracker
+{
+  public:
+    /**
+     * @brief The constructor
+     *
+     * @param[in] limits - The batching limits of the configuration
+     */
+    explicit HotPathTracker(const config::HotPathBatching& limits);
+
+    /**
+     * @brief Account a change of the given path.
+     *
+     * @param[in] path - The changed path
+     * @param[in] now - The time of the change
+     *
+     * @return The mode to sync the change with, a batched change is marked
+     *         as pending for the batched sync.
+     */
+    Mode onChange(const fs::path& path, clock::TimePoint now);
+
+    /**
+     * @brief Take the pending change of the given batched path.
+     *
+     * @return true if the path has a pending change; otherwise false
+     */
+    bool takePending(const fs::path& path);
+
+    /**
+     * @brief Re-evaluate the mode of the given batched path, it goes back to
+     *        the immediate mode once its rate drops to the exit rate and no
+     *        change is pending.
+     *
+     * @param[in] path - The batched path
+     * @param[in] now - The current time
+     *
+     * @return The mode of the path
+     */
+    Mode refresh(const fs::path& path, clock::TimePoint now);
+
+    /**
+     * @brief Get the number of the paths in the batched mode.
+     */
+    size_t batchedCount() const noexcept
+    {
+        return _batchedCount;
+    }
+
+    /**
+     * @brief Get the change rate (per minute) of the given path as of the
+     *        given time.
+     */
+    double rate(const fs::path& path, clock::TimePoint now) const;
+
+  private:
+    /**
+     * @brief The rate state of a path.
+     */
+    struct PathRate
+    {
+        double count{0};
+        clock::TimePoint last;
+        Mode mode{Mode::Immediate};
+        bool pending{false};
+    };
+
+    /**
+     * @brief Get the decayed count of the given state as of the given time.
+     */
+    static double decayed(const PathRate& pathRate, clock::TimePoint now);
+
+    /**
+     * @brief Drop the cold paths in the immediate mode, so that the changes
+     *        of many distinct paths (e.g. the files of a directory) don't
+     *        grow the tracked paths.
+     */
+    void prune(clock::TimePoint now);
+
+    /**
+     * @brief The batching limits
+     */
+    config::HotPathBatching _limits;
+
+    /**
+     * @brief The tracked paths
+     */
+    std::unordered_map<fs::path, PathRate> _paths;
+
+    size_t _batchedCount{0};
+};
+
+} // namespace data_sync::hot_path
@@ -0,0 +1,406 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "config.h"
+
+#include "io_ring.hpp"
+
+#include <sys/eventfd.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#if IO_URING
+#include <liburing.h>
+#endif
+
+#include <phosphor-logging/lg2.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <experimental/scope>
+#include <stdexcept>
+
+namespace data_sync::io
+{
+
+namespace
+{
+
+/**
+ * @brief The ring of the event loop, there is a single one per process.
+ */
+Ring* activeRing{nullptr};
+
+} // namespace
+
+#if IO_URING
+
+void Ring::RingDeleter::operator()(io_uring* ring) const
+{
+    io_uring_queue_exit(ring);
+    // NOLINTNEXTLINE(cppcoreguidelines-owning-memory)
+    delete ring;
+}
+
+Ring::Ring(sdbusplus::async::context& ctx, unsigned entries) :
+    _ctx(ctx), _eventFd(::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK))
+{
+    auto ring = std::make_unique<io_uring>();
+    if (const auto rc = io_uring_queue_init(entries, ring.get(), 0); rc < 0)
+    {
+        throw std::runtime_error("Failed to set up the io_uring, error: " +
+                                 std::string(strerror(-rc)));
+    }
+    _ring.reset(ring.release());
+
+    if (_eventFd() < 0 ||
+        io_uring_register_eventfd(_ring.get(), _eventFd()) < 0)
+    {
+        throw std::runtime_error("Failed to register the eventfd of the "
+                                 "io_uring");
+    }
+
+    _buffers.resize(registeredBuffers);
+    std::vector<iovec> iovecs;
+    for (auto& buffer : _buffers)
+    {
+        buffer.resize(registeredBufferSize);
+        iovecs.push_back({buffer.data(), buffer.size()});
+    }
+    if (const auto rc = io_uring_register_buffers(
+            _ring.get(), iovecs.data(), static_cast<unsigned>(iovecs.size()));
+        rc < 0)
+    {
+        // The reads work with their own buffers too, just mapped per read
+        lg2::warning("Failed to register the io_uring buffers, error: {ERROR}",
+                     "ERROR", strerror(-rc));
+        _buffers.clear();
+    }
+    for (size_t index = 0; index < _buffers.size(); ++index)
+    {
+        _freeBuffers.push_back(index);
+    }
+
+    _eventFdio = std::make_unique<sdbusplus::async::fdio>(ctx, _eventFd());
+    // NOLINTNEXTLINE
+    _ctx.spawn(reap());
+
+    if (activeRing == nullptr)
+    {
+        activeRing = this;
+    }
+}
+
+Ring::~Ring()
+{
+    cancelAll();
+    if (activeRing == this)
+    {
+        activeRing = nullptr;
+    }
+}
+
+// NOLINTNEXTLINE
+sdbusplus::async::task<ssize_t> Ring::read(int fd, std::span<char> buffer)
+{
+    if (_stopped)
+    {
+        co_return -ECANCELED;
+    }
+
+    auto* entry = acquireEntry();
+    if (entry == nullptr)
+    {
+        co_return -EBUSY;
+    }
+
+    auto operation = std::make_shared<Operation>();
+    if (buffer.size() >= registeredBufferSize && !_freeBuffers.empty())
+    {
+        const auto index = _freeBuffers.back();
+        _freeBuffers.pop_back();
+        operation->registeredBuffer = index;
+        io_uring_prep_read_fixed(entry, fd, _buffers[index].data(),
+                                 registeredBufferSize, -1,
+                                 static_cast<int>(index));
+    }
+    else
+    {
+        operation->buffer.resize(buffer.size());
+        io_uring_prep_read(entry, fd, operation->buffer.data(),
+                           static_cast<unsigned>(buffer.size()), -1);
+    }
+    queue(entry, operation);
+
+    co_await Completion{operation.get()};
+
+    const auto& source = operation->registeredBuffer.has_value()
+                             ? _buffers[*operation->registeredBuffer]
+                             : operation->buffer;
+    if (operation->result > 0)
+    {
+        std::copy_n(source.begin(), operation->result, buffer.begin());
+    }
+    if (operation->registeredBuffer.has_value())
+    {
+        _freeBuffers.push_back(*operation->registeredBuffer);
+    }
+    co_return operation->result;
+}
+
+// NOLINTNEXTLINE
+sdbusplus::async::task<ssize_t> Ring::read(int fd, Lease& lease)
+{
+    lease._data = {};
+    if (_stopped)
+    {
+        co_return -ECANCELED;
+    }
+
+    auto* entry = acquireEntry();
+    if (entry == nullptr)
+    {
+        co_return -EBUSY;
+    }
+
+    if (!lease._registeredBuffer.has_value() && !_freeBuffers.empty())
+    {
+        lease._registeredBuffer = _freeBuffers.back();
+        _freeBuffers.pop_back();
+    }
+
+    // The operation owns the buffer while the kernel may write into it
+    auto operation = std::make_shared<Operation>();
+    if (lease._registeredBuffer.has_value())
+    {
+        const auto index = *lease._registeredBuffer;
+        lease._registeredBuffer.reset();
+        operation->registeredBuffer = index;
+        io_uring_prep_read_fixed(entry, fd, _buffers[index].data(),
+                                 registeredBufferSize, -1,
+                                 static_cast<int>(index));
+    }
+    else
+    {
+        operation->buffer = std::move(lease._buffer);
+        operation->buffer.resize(registeredBufferSize);
+        io_uring_prep_read(entry, fd, operation->buffer.data(),
+                           registeredBufferSize, -1);
+    }
+    queue(entry, operation);
+
+    co_await Completion{operation.get()};
+
+    const char* data{nullptr};
+    if (operation->registeredBuffer.has_value())
+    {
+        lease._registeredBuffer = operation->registeredBuffer;
+        data = _buffers[*operation->registeredBuffer].data();
+    }
+    else
+    {
+        lease._buffer = std::move(operation->buffer);
+        data = lease._buffer.data();
+    }
+    if (operation->result > 0)
+    {
+        lease._data = {data, static_cast<size_t>(operation->result)};
+    }
+    co_return operation->result;
+}
+
+Ring::Lease::~Lease()
+{
+    if (_registeredBuffer.has_value())
+    {
+        _ring._freeBuffers.push_back(*_registeredBuffer);
+    }
+}
+
+io_uring_sqe* Ring::acquireEntry()
+{
+    auto* entry = io_uring_get_sqe(_ring.get());
+    if (entry == nullptr)
+    {
+        submit();
+        entry = io_uring_get_sqe(_ring.get());
+    }
+    if (entry == nullptr)
+    {
+        lg2::error("The io_uring submission queue is full");
+    }
+    return entry;
+}
+
+void Ring::queue(io_uring_sqe* entry, std::shared_ptr<Operation> operation)
+{
+    const auto id = _nextId++;
+    io_uring_sqe_set_data64(entry, id);
+    _inFlight.emplace(id, std::move(operation));
+    ++_stats.operations;
+
+    if (!_reaping)
+    {
+        submit();
+    }
+}
+
+void Ring::submit()
+{
+    if (io_uring_sq_ready(_ring.get()) == 0)
+    {
+        return;
+    }
+
+    ++_stats.submits;
+    if (const auto rc = io_uring_submit(_ring.get()); rc < 0)
+    {
+        // The entries stay queued for the next submission
+        lg2::error("Failed to submit to the io_uring, error: {ERROR}",
+                   "ERROR", strerror(-rc));
+    }
+}
+
+void Ring::complete()
+{
+    std::vector<std::shared_ptr<Operation>> completed;
+    io_uring_cqe* cqe{nullptr};
+    while (io_uring_peek_cqe(_ring.get(), &cqe) == 0 && cqe != nullptr)
+    {
+        const auto id = io_uring_cqe_get_data64(cqe);
+        const auto result = cqe->res;
+        io_uring_cqe_seen(_ring.get(), cqe);
+
+        auto it = _inFlight.find(id);
+        if (it == _inFlight.end())
+        {
+            // The completion of a cancellation request
+            continue;
+        }
+        it->second->result = result;
+        it->second->done = true;
+        completed.emplace_back(std::move(it->second));
+        _inFlight.erase(it);
+        ++_stats.completions;
+    }
+
+    // Resume the tasks once the queue is reaped, as they may queue more
+    for (const auto& operation : completed)
+    {
+        if (operation->waiter)
+        {
+            std::exchange(operation->waiter, nullptr).resume();
+        }
+    }
+}
+
+// NOLINTNEXTLINE
+sdbusplus::async::task<> Ring::reap()
+{
+    // The tasks in flight get resumed however the loop ends, including its
+    // cancellation once the event loop stops
+    auto cancel =
+        std::experimental::scope_exit([this]() { cancelAll(); });
+
+    while (!_ctx.stop_requested())
+    {
+        // NOLINTNEXTLINE
+        co_await _eventFdio->next();
+
+        uint64_t count{0};
+        [[maybe_unused]] const auto bytes =
+            ::read(_eventFd(), &count, sizeof(count));
+        ++_stats.wakeUps;
+
+        _reaping = true;
+        complete();
+        _reaping = false;
+
+        // The next reads of the resumed tasks, in a single submission
+        submit();
+    }
+}
+
+void Ring::cancelAll()
+{
+    _stopped = true;
+    if (!_ring || _inFlight.empty())
+    {
+        return;
+    }
+
+    for (const auto& [id, operation] : _inFlight)
+    {
+        auto* entry = acquireEntry();
+        if (entry == nullptr)
+        {
+            break;
+        }
+        io_uring_prep_cancel64(entry, id, 0);
+        io_uring_sqe_set_data64(entry, 0);
+    }
+    io_uring_submit(_ring.get());
+
+    // The kernel owns the buffers until the operations complete
+    while (!_inFlight.empty())
+    {
+        io_uring_cqe* cqe{nullptr};
+        if (io_uring_wait_cqe(_ring.get(), &cqe) < 0)
+        {
+            break;
+        }
+        _reaping = true;
+        complete();
+        _reaping = false;
+    }
+}
+
+#else
+
+void Ring::RingDeleter::operator()(io_uring* /*ring*/) const {}
+
+Ring::Ring(sdbusplus::async::context& ctx, unsigned /*entries*/) :
+    _ctx(ctx), _eventFd(-1)
+{
+    throw std::runtime_error("Built without io_uring");
+}
+
+Ring::~Ring() = default;
+
+// NOLINTNEXTLINE
+sdbusplus::async::task<ssize_t> Ring::read(int /*fd*/,
+                                           std::span<char> /*buffer*/)
+{
+    co_return -ENOTSUP;
+}
+
+// NOLINTNEXTLINE
+sdbusplus::async::task<ssize_t> Ring::read(int /*fd*/, Lease& /*lease*/)
+{
+    co_return -ENOTSUP;
+}
+
+Ring::Lease::~Lease() = default;
+
+#endif
+
+std::unique_ptr<Ring> start(sdbusplus::async::context& ctx)
+{
+    try
+    {
+        auto ring = std::make_unique<Ring>(ctx);
+        lg2::info("Running the reads of the event loop through io_uring");
+        return ring;
+    }
+    catch (const std::exception& e)
+    {
+        lg2::info("Not using io_uring, error: {ERROR}", "ERROR", e);
+    }
+    return nullptr;
+}
+
+Ring* ring()
+{
+    return activeRing;
+}
+
+} // namespace data_sync::io
@@ -0,0 +1,290 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "utility.hpp"
+
+#include <sys/types.h>
+
+#include <sdbusplus/async.hpp>
+
+#include <coroutine>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+struct io_uring;
+struct io_uring_sqe;
+
+namespace data_sync::io
+{
+
+/**
+ * @brief The submission queue entries of the ring, the completion queue is
+ *        twice as big.
+ */
+constexpr unsigned defaultEntries = 64;
+
+/**
+ * @brief The buffers registered with the kernel for the big reads, e.g. of
+ *        the command outputs, so that they aren't mapped on every read.
+ */
+constexpr size_t registeredBuffers = 4;
+constexpr size_t registeredBufferSize = 64 * 1024;
+
+/**
+ * @brief The counters of the ring, to compare against the syscall per
+ *        operation path.
+ */
+struct Stats
+{
+    /**
+     * @brief The io_uring_enter syscalls submitting the operations
+     */
+    uint64_t submits{0};
+
+    /**
+     * @brief The operations queued and completed
+     */
+    uint64_t operations{0};
+    uint64_t completions{0};
+
+    /**
+     * @brief The wake ups of the event loop to reap the completions
+     */
+    uint64_t wakeUps{0};
+};
+
+/**
+ * @class Ring
+ *
+ * @brief Runs the reads of the event loop through io_uring.
+ *
+ * Instead of waiting for the readiness of a descriptor and reading it with a
+ * syscall of its own, a read is queued onto the ring and the awaiting task
+ * resumes with its result. The completions are reaped together on a single
+ * eventfd wake up, and the reads the resumed tasks queue meanwhile, like the
+ * next read of an inotify instance or of a command output, go out together in
+ * one submission.
+ *
+ * The ring belongs to the event loop thread, the watchers running on a shard
+ * thread don't use it.
+ */
+class Ring
+{
+  public:
+    Ring(const Ring&) = delete;
+    Ring& operator=(const Ring&) = delete;
+    Ring(Ring&&) = delete;
+    Ring& operator=(Ring&&) = delete;
+
+    /**
+     * @brief The constructor, which makes the ring the one returned by
+     *        ring().
+     *
+     * @param[in] ctx - The async context to reap the completions on
+     * @param[in] entries - The submission queue entries
+     *
+     * @throw std::runtime_error if io_uring isn't built in or the kernel
+     *        doesn't allow it
+     */
+    explicit Ring(sdbusplus::async::context& ctx,
+                  unsigned entries = defaultEntries);
+
+    /**
+     * @brief The destructor, which cancels the reads still in flight.
+     */
+    ~Ring();
+
+    /**
+     * @class Lease
+     *
+     * @brief The buffer a reader keeps across its reads, a registered one
+     *        where one is free, which the reads land in and the reader takes
+     *        the data from without a copy of its own.
+     */
+    class Lease
+    {
+      public:
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+        Lease(Lease&&) = delete;
+        Lease& operator=(Lease&&) = delete;
+
+        explicit Lease(Ring& ring) : _ring(ring) {}
+
+        /**
+         * @brief The destructor, which gives the registered buffer back.
+         */
+        ~Lease();
+
+        /**
+         * @brief Get the data of the last read, valid until the next read
+         *        with the lease or its destruction.
+         */
+        std::span<const char> data() const noexcept
+        {
+            return _data;
+        }
+
+      private:
+        friend class Ring;
+
+        Ring& _ring;
+        std::optional<size_t> _registeredBuffer;
+        std::vector<char> _buffer;
+        std::span<const char> _data;
+    };
+
+    /**
+     * @brief Read from the given descriptor through the ring.
+     *
+     * The descriptor must be in the blocking mode, the ring polls it and
+     * completes the read once there is data, instead of failing it with
+     * EAGAIN. A registered buffer is used if the given buffer is at least
+     * registeredBufferSize big and one is free.
+     *
+     * @param[in] fd - The descriptor to read from
+     * @param[out] buffer - The buffer to read into
+     *
+     * @return The read bytes, 0 on the end of the file, or the negated errno
+     *         on failure, e.g. -ECANCELED once the event loop stops
+     */
+    sdbusplus::async::task<ssize_t> read(int fd, std::span<char> buffer);
+
+    /**
+     * @brief Read from the given descriptor through the ring into the buffer
+     *        of the given lease, see Lease::data().
+     *
+     * The descriptor must be in the blocking mode, as for the other read.
+     *
+     * @param[in] fd - The descriptor to read from
+     * @param[in,out] lease - The lease of the reader
+     *
+     * @return The read bytes, 0 on the end of the file, or the negated errno
+     *         on failure, e.g. -ECANCELED once the event loop stops
+     */
+    sdbusplus::async::task<ssize_t> read(int fd, Lease& lease);
+
+    /**
+     * @brief Get the counters of the ring.
+     */
+    const Stats& stats() const noexcept
+    {
+        return _stats;
+    }
+
+  private:
+    /**
+     * @brief A queued operation, owned by the ring until it completes, as
+     *        the kernel may write into its buffer until then.
+     */
+    struct Operation
+    {
+        ssize_t result{0};
+        bool done{false};
+        std::coroutine_handle<> waiter;
+        std::vector<char> buffer;
+        std::optional<size_t> registeredBuffer;
+    };
+
+    /**
+     * @brief Suspends the awaiting task until its operation completes, the
+     *        task keeps the operation alive meanwhile.
+     */
+    struct Completion
+    {
+        Operation* operation;
+
+        bool await_ready() const noexcept
+        {
+            return operation->done;
+        }
+
+        void await_suspend(std::coroutine_handle<> handle) const noexcept
+        {
+            operation->waiter = handle;
+        }
+
+        void await_resume() const noexcept {}
+    };
+
+    struct RingDeleter
+    {
+        void operator()(io_uring* ring) const;
+    };
+
+    /**
+     * @brief Get a free submission queue entry, submitting the queued ones
+     *        if the queue is full.
+     *
+     * @return The entry, or nullptr if there is none
+     */
+    io_uring_sqe* acquireEntry();
+
+    /**
+     * @brief Track the operation of the given prepared entry, and submit it
+     *        unless the completions are being reaped, which submits all the
+     *        operations queued by the resumed tasks at once.
+     */
+    void queue(io_uring_sqe* entry, std::shared_ptr<Operation> operation);
+
+    /**
+     * @brief Submit the queued entries to the kernel.
+     */
+    void submit();
+
+    /**
+     * @brief Complete the operations of the completion queue entries and
+     *        resume their tasks.
+     */
+    void complete();
+
+    /**
+     * @brief Reap the completions on the wake ups of the ring, until the
+     *        event loop stops.
+     */
+    sdbusplus::async::task<> reap();
+
+    /**
+     * @brief Cancel the operations in flight and wait for them to complete,
+     *        so that no task is left waiting on the ring.
+     */
+    void cancelAll();
+
+    sdbusplus::async::context& _ctx;
+    std::unique_ptr<io_uring, RingDeleter> _ring;
+    utility::FD _eventFd;
+    std::unique_ptr<sdbusplus::async::fdio> _eventFdio;
+
+    std::vector<std::vector<char>> _buffers;
+    std::vector<size_t> _freeBuffers;
+
+    std::unordered_map<uint64_t, std::shared_ptr<Operation>> _inFlight;
+    uint64_t _nextId{1};
+    bool _reaping{false};
+    bool _stopped{false};
+    Stats _stats;
+};
+
+/**
+ * @brief Set up the ring of the event loop if io_uring is available.
+ *
+ * @param[in] ctx - The async context of the event loop
+ *
+ * @return The ring, which must outlive the users of ring(), or nullptr if
+ *         the operations keep to the syscall per operation path
+ */
+std::unique_ptr<Ring> start(sdbusplus::async::context& ctx);
+
+/**
+ * @brief Get the ring of the event loop.
+ *
+ * @return The ring, or nullptr if there is none
+ */
+Ring* ring();
+
+} // namespace data_sync::io
@@ -0,0 +1,81 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include "external_data_ifaces.hpp"
+
+#include <phosphor-logging/lg2.hpp>
+
+namespace loadgen
+{
+
+namespace ext_data = data_sync::ext_data;
+
+/**
+ * @class LoadExtDataIFaces
+ *
+ * @brief Provides the fixed BMC state of an active redundant BMC, so that the
+ *        Manager can run without the BMC D-Bus services.
+ */
+class LoadExtDataIFaces : public ext_data::ExternalDataIFaces
+{
+  public:
+    /**
+     * @brief Constructor
+     *
+     * @param[in] bmcPosition - The BMC position to act as
+     */
+    explicit LoadExtDataIFaces(ext_data::BMCPosition bmcPosition) :
+        _position(bmcPosition)
+    {}
+
+    // NOLINTNEXTLINE
+    sdbusplus::async::task<bool> systemdServiceAction(
+        [[maybe_unused]] const std::string& service,
+        [[maybe_unused]] const std::string& method) override
+    {
+        co_return true;
+    }
+
+    // NOLINTNEXTLINE
+    sdbusplus::async::task<> createErrorLog(
+        const std::string& errMsg,
+        [[maybe_unused]] const ext_data::ErrorLevel& errSeverity,
+        [[maybe_unused]] ext_data::AdditionalData& additionalDetails,
+        [[maybe_unused]] const std::optional<ext_data::json>& calloutsDetails)
+        override
+    {
+        lg2::warning("Error log requested during the load run : {MSG}", "MSG",
+                     errMsg);
+        co_return;
+    }
+
+    // NOLINTNEXTLINE
+    sdbusplus::async::task<> watchRedundancyMgrProps() override
+    {
+        co_return;
+    }
+
+  protected:
+    // NOLINTNEXTLINE
+    sdbusplus::async::task<> fetchBMCRedundancyMgrProps() override
+    {
+        bmcRole(ext_data::BMCRole::Active);
+        bmcRedundancy(true);
+        co_return;
+    }
+
+    // NOLINTNEXTLINE
+    sdbusplus::async::task<> fetchBMCPosition() override
+    {
+        bmcPosition(_position);
+        co_return;
+    }
+
+  private:
+    /**
+     * @brief The BMC position to act as
+     */
+    ext_data::BMCPosition _position;
+};
+
+} // namespace loadgen
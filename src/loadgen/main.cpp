@@ -0,0 +1,206 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "config.h"
+
+#include "load_ext_data_ifaces.hpp"
+#include "manager.hpp"
+#include "persistent.hpp"
+#include "replication_observer.hpp"
+#include "rsyncd_instance.hpp"
+#include "write_patterns.hpp"
+
+#include <CLI/CLI.hpp>
+#include <nlohmann/json.hpp>
+#include <phosphor-logging/lg2.hpp>
+#include <sdbusplus/async.hpp>
+
+#include <atomic>
+#include <fstream>
+#include <print>
+#include <thread>
+
+namespace
+{
+
+namespace fs = std::filesystem;
+using namespace std::chrono_literals;
+
+/**
+ * @brief Write the data sync configuration which syncs the whole source tree
+ *        immediately to the sibling.
+ */
+void writeSyncConfig(const fs::path& cfgDir, const fs::path& srcRoot)
+{
+    fs::create_directories(cfgDir);
+    nlohmann::json cfg{
+        {"Directories",
+         {{{"Path", srcRoot.string() + "/"},
+           {"Description", "Load generator source tree"},
+           {"SyncDirection", "Active2Passive"},
+           {"SyncType", "Immediate"}}}}};
+    std::ofstream(cfgDir / "loadgen.json") << cfg.dump(4);
+}
+
+/**
+ * @brief Stop the context once the load run is done.
+ */
+// NOLINTNEXTLINE
+sdbusplus::async::task<> stopWhenDone(sdbusplus::async::context& ctx,
+                                      const std::atomic<bool>& done)
+{
+    while (!done)
+    {
+        co_await sdbusplus::async::sleep_for(ctx, 100ms);
+    }
+    ctx.request_stop();
+    co_return;
+}
+
+void report(const loadgen::LoadTotals& totals,
+            const loadgen::LatencyReport& latency, bool jsonOutput)
+{
+    const auto seconds = static_cast<double>(totals.elapsed.count()) / 1e6;
+    const auto opsPerSec =
+        seconds > 0 ? static_cast<double>(totals.operations) / seconds : 0;
+    const auto mbPerSec =
+        seconds > 0 ? static_cast<double>(totals.bytes) / seconds / 1e6 : 0;
+
+    if (jsonOutput)
+    {
+        nlohmann::json out{{"Operations", totals.operations},
+                           {"Bytes", totals.bytes},
+                           {"ElapsedUs", totals.elapsed.count()},
+                           {"OpsPerSec", opsPerSec},
+                           {"MBPerSec", mbPerSec},
+                           {"Replicated", latency.replicated},
+                           {"Unreplicated", latency.unreplicated},
+                           {"P50Us", latency.p50Us},
+                           {"P99Us", latency.p99Us},
+                           {"P999Us", latency.p999Us},
+                           {"MaxUs", latency.maxUs},
+                           {"MaxRsyncProcs", latency.maxRsyncProcs},
+                           {"AvgRsyncProcs", latency.avgRsyncProcs}};
+        std::println("{}", out.dump(4));
+        return;
+    }
+
+    std::println("Offered load : {} ops, {} bytes in {:.2f}s "
+                 "({:.1f} ops/s, {:.2f} MB/s)",
+                 totals.operations, totals.bytes, seconds, opsPerSec,
+                 mbPerSec);
+    std::println("Replicated   : {} / {} ({} not replicated)",
+                 latency.replicated, latency.writes, latency.unreplicated);
+    std::println("Latency (us) : p50 {}  p99 {}  p999 {}  max {}",
+                 latency.p50Us, latency.p99Us, latency.p999Us, latency.maxUs);
+    std::println("rsync procs  : max {}  avg {:.2f}", latency.maxRsyncProcs,
+                 latency.avgRsyncProcs);
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    CLI::App app{"Data Sync Load Generator - Measures the end-to-end "
+                 "replication latency of phosphor-data-sync between two local "
+                 "rsync daemons"};
+
+    std::string patternName{"churn"};
+    app.add_option("-p,--pattern", patternName, "The write pattern")
+        ->check(CLI::IsMember({"churn", "untar", "append", "delete", "mixed"}))
+        ->capture_default_str();
+
+    loadgen::LoadSpec spec;
+    uint32_t durationInSec{10};
+    app.add_option("-d,--duration", durationInSec,
+                   "The load duration in seconds")
+        ->capture_default_str();
+    app.add_option("-r,--rate", spec.rate,
+                   "The write operations (untar bursts) per second")
+        ->check(CLI::PositiveNumber)
+        ->capture_default_str();
+    app.add_option("-n,--files", spec.files,
+                   "The files in the churn set or in one untar burst")
+        ->check(CLI::PositiveNumber)
+        ->capture_default_str();
+    app.add_option("-s,--size", spec.size, "The bytes per file write")
+        ->capture_default_str();
+
+    uint32_t drainInSec{30};
+    app.add_option("--drain", drainInSec,
+                   "The maximum seconds to wait for the replication to catch "
+                   "up after the load")
+        ->capture_default_str();
+
+    fs::path workDir{"/tmp/phosphor-data-sync-loadgen"};
+    app.add_option("-w,--workdir", workDir,
+                   "The scratch directory, removed at the start of the run")
+        ->capture_default_str();
+
+    bool jsonOutput{false};
+    app.add_flag("-j,--json", jsonOutput, "Display the report in JSON format");
+
+    CLI11_PARSE(app, argc, argv);
+
+    spec.pattern = loadgen::toPattern(patternName).value();
+    spec.duration = std::chrono::seconds(durationInSec);
+
+    try
+    {
+        fs::remove_all(workDir);
+        const auto srcRoot = workDir / "src";
+        fs::create_directories(srcRoot);
+        writeSyncConfig(workDir / "config", srcRoot);
+        data_sync::persist::DBusPropDataFile = workDir / "persist" /
+                                               "dbus_props.json";
+
+        // This process acts as BMC0, so it syncs into the BMC1 daemon.
+        loadgen::RsyncdInstance bmc0Rsyncd(LOADGEN_RSYNCD_CONF, BMC0_RSYNC_PORT,
+                                           workDir / "bmc0", workDir);
+        loadgen::RsyncdInstance bmc1Rsyncd(LOADGEN_RSYNCD_CONF, BMC1_RSYNC_PORT,
+                                           workDir / "bmc1", workDir);
+        loadgen::ReplicationObserver observer(
+            workDir / "bmc1", {bmc0Rsyncd.pid(), bmc1Rsyncd.pid()});
+
+        sdbusplus::async::context ctx;
+        data_sync::Manager manager{
+            ctx, std::make_unique<loadgen::LoadExtDataIFaces>(0),
+            workDir / "config"};
+
+        std::atomic<bool> done{false};
+        loadgen::LoadTotals totals;
+        std::jthread writer([&]() {
+            try
+            {
+                // Let the manager finish the full sync and start watching.
+                std::this_thread::sleep_for(1s);
+                totals = loadgen::generateLoad(spec, srcRoot, observer);
+
+                const auto drainEnd = loadgen::Clock::now() +
+                                      std::chrono::seconds(drainInSec);
+                while (observer.pending() != 0 &&
+                       loadgen::Clock::now() < drainEnd)
+                {
+                    std::this_thread::sleep_for(10ms);
+                }
+            }
+            catch (const std::exception& e)
+            {
+                lg2::error("Load generation failed : {ERROR}", "ERROR", e);
+            }
+            done = true;
+        });
+
+        ctx.spawn(stopWhenDone(ctx, done));
+        ctx.run();
+        writer.join();
+
+        report(totals, observer.finish(), jsonOutput);
+    }
+    catch (const std::exception& e)
+    {
+        lg2::error("Load run failed : {ERROR}", "ERROR", e);
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
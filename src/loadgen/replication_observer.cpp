@@ -0,0 +1,332 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "replication_observer.hpp"
+
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include <phosphor-logging/lg2.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <ranges>
+#include <sstream>
+#include <stdexcept>
+
+namespace loadgen
+{
+
+namespace
+{
+
+/**
+ * @brief Get the value at the given percentile of the sorted samples.
+ */
+uint64_t percentile(const std::vector<uint64_t>& sorted, double pct)
+{
+    if (sorted.empty())
+    {
+        return 0;
+    }
+    auto rank = static_cast<size_t>(pct / 100.0 *
+                                    static_cast<double>(sorted.size() - 1));
+    return sorted[rank];
+}
+
+} // namespace
+
+ReplicationObserver::ReplicationObserver(const fs::path& destRoot,
+                                         std::vector<pid_t> excludedPids) :
+    _destRoot(destRoot), _excludedPids(std::move(excludedPids))
+{
+    _inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (_inotifyFd < 0)
+    {
+        throw std::runtime_error("inotify_init1 failed : " +
+                                 std::string(std::strerror(errno)));
+    }
+
+    fs::create_directories(_destRoot);
+    addWatch(_destRoot);
+
+    _watchThread = std::thread([this]() { watchLoop(); });
+    _sampleThread = std::thread([this]() { sampleLoop(); });
+}
+
+ReplicationObserver::~ReplicationObserver()
+{
+    _stop = true;
+    if (_watchThread.joinable())
+    {
+        _watchThread.join();
+    }
+    if (_sampleThread.joinable())
+    {
+        _sampleThread.join();
+    }
+    if (_inotifyFd >= 0)
+    {
+        close(_inotifyFd);
+    }
+}
+
+void ReplicationObserver::wrote(const fs::path& srcPath)
+{
+    const auto now = Clock::now();
+    std::lock_guard lock(_mutex);
+    _pending[srcPath.string()].writes.push_back(now);
+    ++_writes;
+    ++_pendingCount;
+}
+
+void ReplicationObserver::removed(const fs::path& srcPath)
+{
+    const auto now = Clock::now();
+    std::lock_guard lock(_mutex);
+    _pending[srcPath.string()].removals.push_back(now);
+    ++_writes;
+    ++_pendingCount;
+}
+
+uint64_t ReplicationObserver::pending() const
+{
+    std::lock_guard lock(_mutex);
+    return _pendingCount;
+}
+
+LatencyReport ReplicationObserver::finish()
+{
+    _stop = true;
+    if (_watchThread.joinable())
+    {
+        _watchThread.join();
+    }
+    if (_sampleThread.joinable())
+    {
+        _sampleThread.join();
+    }
+
+    std::lock_guard lock(_mutex);
+    std::ranges::sort(_latenciesUs);
+
+    LatencyReport report;
+    report.writes = _writes;
+    report.replicated = _latenciesUs.size();
+    report.unreplicated = _pendingCount;
+    report.p50Us = percentile(_latenciesUs, 50);
+    report.p99Us = percentile(_latenciesUs, 99);
+    report.p999Us = percentile(_latenciesUs, 99.9);
+    report.maxUs = _latenciesUs.empty() ? 0 : _latenciesUs.back();
+    report.maxRsyncProcs = _maxRsyncProcs;
+    report.avgRsyncProcs =
+        _rsyncProcSamples == 0
+            ? 0
+            : static_cast<double>(_rsyncProcSum) /
+                  static_cast<double>(_rsyncProcSamples);
+    return report;
+}
+
+void ReplicationObserver::addWatch(const fs::path& dir)
+{
+    const int wd = inotify_add_watch(_inotifyFd, dir.c_str(),
+                                     IN_CREATE | IN_MOVED_TO | IN_CLOSE_WRITE |
+                                         IN_DELETE | IN_ONLYDIR);
+    if (wd < 0)
+    {
+        lg2::warning("Failed to watch {DIR}, error : {ERROR}", "DIR", dir,
+                     "ERROR", std::strerror(errno));
+        return;
+    }
+    _watches[wd] = dir;
+
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator(dir, ec))
+    {
+        if (entry.is_directory(ec))
+        {
+            addWatch(entry.path());
+        }
+        else
+        {
+            arrived(entry.path(), false);
+        }
+    }
+}
+
+void ReplicationObserver::arrived(const fs::path& destPath, bool isRemoval)
+{
+    const auto now = Clock::now();
+
+    // The destination tree mirrors the absolute source paths (--relative)
+    const auto srcPath = "/" / destPath.lexically_relative(_destRoot);
+
+    std::lock_guard lock(_mutex);
+    auto it = _pending.find(srcPath.string());
+    if (it == _pending.end())
+    {
+        // rsync temporary files and already replicated files
+        return;
+    }
+
+    auto& ops = isRemoval ? it->second.removals : it->second.writes;
+    for (const auto& wroteAt : ops)
+    {
+        _latenciesUs.push_back(
+            std::chrono::duration_cast<std::chrono::microseconds>(now - wroteAt)
+                .count());
+    }
+    _pendingCount -= ops.size();
+    ops.clear();
+
+    if (it->second.writes.empty() && it->second.removals.empty())
+    {
+        _pending.erase(it);
+    }
+}
+
+void ReplicationObserver::watchLoop()
+{
+    alignas(inotify_event) std::array<uint8_t, 64 * 1024> buf{};
+    pollfd pfd{.fd = _inotifyFd, .events = POLLIN, .revents = 0};
+
+    while (!_stop)
+    {
+        if (poll(&pfd, 1, 100) <= 0)
+        {
+            continue;
+        }
+
+        const auto len = read(_inotifyFd, buf.data(), buf.size());
+        if (len <= 0)
+        {
+            continue;
+        }
+
+        for (ssize_t offset = 0; offset < len;)
+        {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+            const auto* event =
+                reinterpret_cast<const inotify_event*>(buf.data() + offset);
+            offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+
+            auto dir = _watches.find(event->wd);
+            if (dir == _watches.end() || event->len == 0)
+            {
+                continue;
+            }
+            const auto path = dir->second / event->name;
+
+            if ((event->mask & IN_ISDIR) != 0)
+            {
+                if ((event->mask & (IN_CREATE | IN_MOVED_TO)) != 0)
+                {
+                    addWatch(path);
+                }
+            }
+            else if ((event->mask & (IN_MOVED_TO | IN_CLOSE_WRITE)) != 0)
+            {
+                arrived(path, false);
+            }
+            else if ((event->mask & IN_DELETE) != 0)
+            {
+                arrived(path, true);
+            }
+        }
+    }
+}
+
+void ReplicationObserver::sampleLoop()
+{
+    using namespace std::chrono_literals;
+    while (!_stop)
+    {
+        const auto count = countRsyncProcs();
+        {
+            std::lock_guard lock(_mutex);
+            _maxRsyncProcs = std::max(_maxRsyncProcs, count);
+            _rsyncProcSum += count;
+            ++_rsyncProcSamples;
+        }
+        std::this_thread::sleep_for(20ms);
+    }
+}
+
+uint32_t ReplicationObserver::countRsyncProcs() const
+{
+    struct ProcInfo
+    {
+        pid_t ppid;
+        bool isRsync;
+    };
+    std::unordered_map<pid_t, ProcInfo> procs;
+
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator("/proc", ec))
+    {
+        const auto name = entry.path().filename().string();
+        if (!std::ranges::all_of(name, ::isdigit))
+        {
+            continue;
+        }
+
+        // The comm field is in parentheses and may contain spaces.
+        std::ifstream stat(entry.path() / "stat");
+        std::string line;
+        if (!std::getline(stat, line))
+        {
+            continue;
+        }
+        const auto commBegin = line.find('(');
+        const auto commEnd = line.rfind(')');
+        if (commBegin == std::string::npos || commEnd == std::string::npos)
+        {
+            continue;
+        }
+        pid_t ppid = 0;
+        char state = 0;
+        std::istringstream rest(line.substr(commEnd + 1));
+        rest >> state >> ppid;
+        const auto comm =
+            line.substr(commBegin + 1, commEnd - commBegin - 1);
+        procs.emplace(std::stoi(name), ProcInfo{ppid, comm == "rsync"});
+    }
+
+    const pid_t self = getpid();
+    uint32_t count = 0;
+    for (const auto& [pid, info] : procs)
+    {
+        if (!info.isRsync)
+        {
+            continue;
+        }
+
+        // Count only the rsync clients spawned (directly or through a shell)
+        // by this process, not the daemons and their connection handlers.
+        bool isClient = false;
+        for (pid_t ancestor = info.ppid; ancestor > 1;)
+        {
+            if (std::ranges::contains(_excludedPids, ancestor))
+            {
+                break;
+            }
+            if (ancestor == self)
+            {
+                isClient = true;
+                break;
+            }
+            auto parent = procs.find(ancestor);
+            if (parent == procs.end())
+            {
+                break;
+            }
+            ancestor = parent->second.ppid;
+        }
+        count += isClient ? 1 : 0;
+    }
+    return count;
+}
+
+} // namespace loadgen
@@ -0,0 +1,151 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <sys/types.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace loadgen
+{
+
+namespace fs = std::filesystem;
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief The summary of the replication latencies observed during a run.
+ */
+struct LatencyReport
+{
+    uint64_t writes{0};
+    uint64_t replicated{0};
+    uint64_t unreplicated{0};
+    uint64_t p50Us{0};
+    uint64_t p99Us{0};
+    uint64_t p999Us{0};
+    uint64_t maxUs{0};
+    uint32_t maxRsyncProcs{0};
+    double avgRsyncProcs{0};
+};
+
+/**
+ * @class ReplicationObserver
+ *
+ * @brief Measures the time between a write on the source tree and its arrival
+ *        on the destination tree of the sibling rsync daemon.
+ *
+ * The writer records every completed source operation, the observer thread
+ * watches the destination tree through inotify and matches the arrivals
+ * (rsync renames its temporary file into place) and removals against them.
+ * It also samples the number of rsync client processes spawned by the
+ * daemon logic of this process.
+ */
+class ReplicationObserver
+{
+  public:
+    ReplicationObserver(const ReplicationObserver&) = delete;
+    ReplicationObserver& operator=(const ReplicationObserver&) = delete;
+    ReplicationObserver(ReplicationObserver&&) = delete;
+    ReplicationObserver& operator=(ReplicationObserver&&) = delete;
+
+    /**
+     * @brief Constructor starts watching the destination tree.
+     *
+     * @param[in] destRoot - The module root of the destination rsync daemon
+     * @param[in] excludedPids - The pids whose process trees are not counted
+     *                           as rsync clients (the rsync daemons)
+     *
+     * @throw std::runtime_error if inotify is not available.
+     */
+    ReplicationObserver(const fs::path& destRoot,
+                        std::vector<pid_t> excludedPids);
+
+    ~ReplicationObserver();
+
+    /**
+     * @brief Record a completed write of the given source file.
+     */
+    void wrote(const fs::path& srcPath);
+
+    /**
+     * @brief Record a removal of the given source file.
+     */
+    void removed(const fs::path& srcPath);
+
+    /**
+     * @brief Get the number of operations not replicated yet.
+     */
+    uint64_t pending() const;
+
+    /**
+     * @brief Stop observing and summarize the run.
+     */
+    LatencyReport finish();
+
+  private:
+    /**
+     * @brief The operations waiting to be replicated, per source file.
+     */
+    struct PendingOps
+    {
+        std::vector<Clock::time_point> writes;
+        std::vector<Clock::time_point> removals;
+    };
+
+    /**
+     * @brief The inotify event loop of the observer thread.
+     */
+    void watchLoop();
+
+    /**
+     * @brief Add a watch on the given destination directory and treat its
+     *        already present files as arrivals, they may have been created
+     *        before the watch was in place.
+     */
+    void addWatch(const fs::path& dir);
+
+    /**
+     * @brief Complete the pending operations of the given destination path.
+     */
+    void arrived(const fs::path& destPath, bool isRemoval);
+
+    /**
+     * @brief The rsync process sampler loop of the sampler thread.
+     */
+    void sampleLoop();
+
+    /**
+     * @brief Count the rsync processes which are not part of the excluded
+     *        process trees.
+     */
+    uint32_t countRsyncProcs() const;
+
+    fs::path _destRoot;
+    std::vector<pid_t> _excludedPids;
+
+    int _inotifyFd{-1};
+    std::unordered_map<int, fs::path> _watches;
+
+    mutable std::mutex _mutex;
+    std::unordered_map<std::string, PendingOps> _pending;
+    std::vector<uint64_t> _latenciesUs;
+    uint64_t _writes{0};
+    uint64_t _pendingCount{0};
+
+    uint32_t _maxRsyncProcs{0};
+    uint64_t _rsyncProcSamples{0};
+    uint64_t _rsyncProcSum{0};
+
+    std::atomic<bool> _stop{false};
+    std::thread _watchThread;
+    std::thread _sampleThread;
+};
+
+} // namespace loadgen
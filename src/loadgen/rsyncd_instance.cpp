@@ -0,0 +1,138 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "config.h"
+
+#include "rsyncd_instance.hpp"
+
+#include <netinet/in.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <phosphor-logging/lg2.hpp>
+
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <regex>
+#include <stdexcept>
+#include <thread>
+
+extern char** environ;
+
+namespace loadgen
+{
+
+namespace
+{
+
+/**
+ * @brief Check whether something accepts connections on the local port.
+ */
+bool isListening(const std::string& port)
+{
+    const int sock = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (sock < 0)
+    {
+        return false;
+    }
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(std::stoi(port)));
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    const bool connected = connect(sock, reinterpret_cast<sockaddr*>(&addr),
+                                   sizeof(addr)) == 0;
+    close(sock);
+    return connected;
+}
+
+} // namespace
+
+RsyncdInstance::RsyncdInstance(const fs::path& confTemplate,
+                               const std::string& port,
+                               const fs::path& moduleRoot,
+                               const fs::path& workDir)
+{
+    if (isListening(port))
+    {
+        throw std::runtime_error("Port " + port + " is already in use");
+    }
+
+    fs::create_directories(moduleRoot);
+    const auto confFile = workDir / ("rsyncd-" + port + ".conf");
+    generateConfig(confTemplate, port, moduleRoot, confFile);
+
+    const std::string configArg = "--config=" + confFile.string();
+    const char* argv[] = {"rsync", "--daemon", "--no-detach",
+                          configArg.c_str(), nullptr};
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+    if (int ret = posix_spawnp(&_pid, "rsync", nullptr, nullptr,
+                               const_cast<char* const*>(argv), environ);
+        ret != 0)
+    {
+        throw std::runtime_error("Failed to spawn rsync daemon : " +
+                                 std::string(std::strerror(ret)));
+    }
+
+    using namespace std::chrono_literals;
+    for (auto waited = 0ms; waited < 5s; waited += 10ms)
+    {
+        if (isListening(port))
+        {
+            lg2::info("Started rsync daemon [{PID}] on port {PORT} at {ROOT}",
+                      "PID", _pid, "PORT", port, "ROOT", moduleRoot);
+            return;
+        }
+        std::this_thread::sleep_for(10ms);
+    }
+
+    kill(_pid, SIGTERM);
+    waitpid(_pid, nullptr, 0);
+    throw std::runtime_error("rsync daemon didn't start listening on port " +
+                             port);
+}
+
+RsyncdInstance::~RsyncdInstance()
+{
+    if (_pid > 0)
+    {
+        kill(_pid, SIGTERM);
+        waitpid(_pid, nullptr, 0);
+    }
+}
+
+void RsyncdInstance::generateConfig(const fs::path& confTemplate,
+                                    const std::string& port,
+                                    const fs::path& moduleRoot,
+                                    const fs::path& confFile)
+{
+    std::ifstream in(confTemplate);
+    if (!in.is_open())
+    {
+        throw std::runtime_error("Failed to open the rsyncd template " +
+                                 confTemplate.string());
+    }
+
+    std::ofstream out(confFile);
+    std::string line;
+    while (std::getline(in, line))
+    {
+        // The BMC only settings: running as root and the BMC filesystem
+        // filter which would reject the synthetic trees.
+        if (std::regex_search(line, std::regex(R"(^\s*(uid|gid|filter)\s*=)")))
+        {
+            continue;
+        }
+        line = std::regex_replace(line, std::regex("<BMC_RSYNC_PORT>"), port);
+        line = std::regex_replace(line, std::regex("@RSYNCD_MODULE_NAME@"),
+                                  RSYNCD_MODULE_NAME);
+        line = std::regex_replace(line, std::regex(R"(^(\s*path\s*=).*)"),
+                                  "$1 " + moduleRoot.string());
+        out << line << '\n';
+    }
+}
+
+} // namespace loadgen
@@ -0,0 +1,69 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <sys/types.h>
+
+#include <filesystem>
+#include <string>
+
+namespace loadgen
+{
+
+namespace fs = std::filesystem;
+
+/**
+ * @class RsyncdInstance
+ *
+ * @brief Runs a local rsync daemon which stands in for the sibling BMC.
+ *
+ * The daemon configuration is generated from the installed rsyncd.conf
+ * template, with the module rooted at the given directory instead of "/" so
+ * that the replicated data doesn't overwrite the source on the same host.
+ */
+class RsyncdInstance
+{
+  public:
+    RsyncdInstance(const RsyncdInstance&) = delete;
+    RsyncdInstance& operator=(const RsyncdInstance&) = delete;
+    RsyncdInstance(RsyncdInstance&&) = delete;
+    RsyncdInstance& operator=(RsyncdInstance&&) = delete;
+
+    /**
+     * @brief Constructor starts the daemon and waits until it listens.
+     *
+     * @param[in] confTemplate - The rsyncd.conf template
+     * @param[in] port - The port to listen on
+     * @param[in] moduleRoot - The directory to root the module at
+     * @param[in] workDir - The directory to write the generated config
+     *
+     * @throw std::runtime_error if the daemon couldn't be started.
+     */
+    RsyncdInstance(const fs::path& confTemplate, const std::string& port,
+                   const fs::path& moduleRoot, const fs::path& workDir);
+
+    /**
+     * @brief Destructor stops the daemon.
+     */
+    ~RsyncdInstance();
+
+    pid_t pid() const
+    {
+        return _pid;
+    }
+
+  private:
+    /**
+     * @brief Generate the daemon configuration from the template.
+     */
+    static void generateConfig(const fs::path& confTemplate,
+                               const std::string& port,
+                               const fs::path& moduleRoot,
+                               const fs::path& confFile);
+
+    /**
+     * @brief The pid of the daemon
+     */
+    pid_t _pid{-1};
+};
+
+} // namespace loadgen
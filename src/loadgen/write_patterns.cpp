@@ -0,0 +1,219 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "write_patterns.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <array>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace loadgen
+{
+
+namespace
+{
+
+/**
+ * @brief Write the given bytes into the file and close it, so that the
+ *        daemon sees a single IN_CLOSE_WRITE for the operation.
+ */
+void writeFile(const fs::path& path, const std::vector<char>& data,
+               bool append)
+{
+    const int flags =
+        O_WRONLY | O_CREAT | O_CLOEXEC | (append ? O_APPEND : O_TRUNC);
+    const int fd = open(path.c_str(), flags, 0644);
+    if (fd < 0)
+    {
+        throw std::runtime_error("Failed to open " + path.string() + " : " +
+                                 std::strerror(errno));
+    }
+
+    size_t written = 0;
+    while (written < data.size())
+    {
+        const auto ret =
+            write(fd, data.data() + written, data.size() - written);
+        if (ret < 0)
+        {
+            close(fd);
+            throw std::runtime_error("Failed to write " + path.string() +
+                                     " : " + std::strerror(errno));
+        }
+        written += static_cast<size_t>(ret);
+    }
+    close(fd);
+}
+
+/**
+ * @brief Generates the operations of each pattern, one step per tick.
+ */
+class Generator
+{
+  public:
+    Generator(const LoadSpec& spec, const fs::path& srcRoot,
+              ReplicationObserver& observer) :
+        _spec(spec), _srcRoot(srcRoot), _observer(observer),
+        _data(spec.size, 'x')
+    {
+        fs::create_directories(_srcRoot / "churn");
+        fs::create_directories(_srcRoot / "logs");
+        fs::create_directories(_srcRoot / "untar");
+        fs::create_directories(_srcRoot / "delete");
+    }
+
+    void step(Pattern pattern)
+    {
+        switch (pattern)
+        {
+            case Pattern::Churn:
+                churn();
+                break;
+            case Pattern::Untar:
+                untar();
+                break;
+            case Pattern::Append:
+                append();
+                break;
+            case Pattern::Delete:
+                remove();
+                break;
+            case Pattern::Mixed:
+                step(mixed[_mixedStep++ % mixed.size()]);
+                break;
+        }
+    }
+
+    const LoadTotals& totals() const
+    {
+        return _totals;
+    }
+
+  private:
+    static constexpr std::array mixed{Pattern::Churn, Pattern::Append,
+                                      Pattern::Delete, Pattern::Untar};
+
+    /**
+     * @brief The number of growing log files used by the Append pattern.
+     */
+    static constexpr uint32_t logFiles = 4;
+
+    void wrote(const fs::path& path, bool append = false)
+    {
+        writeFile(path, _data, append);
+        _observer.wrote(path);
+        ++_totals.operations;
+        _totals.bytes += _data.size();
+    }
+
+    void churn()
+    {
+        wrote(_srcRoot / "churn" /
+              ("file" + std::to_string(_churnStep++ % _spec.files)));
+    }
+
+    void untar()
+    {
+        const auto dir = _srcRoot / "untar" /
+                         ("archive" + std::to_string(_untarStep++));
+        fs::create_directories(dir);
+        for (uint32_t file = 0; file < _spec.files; ++file)
+        {
+            wrote(dir / ("file" + std::to_string(file)));
+        }
+    }
+
+    void append()
+    {
+        wrote(_srcRoot / "logs" /
+                  ("log" + std::to_string(_appendStep++ % logFiles)),
+              true);
+    }
+
+    void remove()
+    {
+        // Create a file on one step and remove it on the next one, so that
+        // both the creation and the removal get replicated.
+        const auto path = _srcRoot / "delete" /
+                          ("file" + std::to_string(_deleteStep / 2));
+        if (_deleteStep++ % 2 == 0)
+        {
+            wrote(path);
+        }
+        else
+        {
+            fs::remove(path);
+            _observer.removed(path);
+            ++_totals.operations;
+        }
+    }
+
+    const LoadSpec& _spec;
+    fs::path _srcRoot;
+    ReplicationObserver& _observer;
+    std::vector<char> _data;
+    LoadTotals _totals;
+
+    size_t _mixedStep{0};
+    uint64_t _churnStep{0};
+    uint64_t _untarStep{0};
+    uint64_t _appendStep{0};
+    uint64_t _deleteStep{0};
+};
+
+} // namespace
+
+std::optional<Pattern> toPattern(const std::string& name)
+{
+    if (name == "churn")
+    {
+        return Pattern::Churn;
+    }
+    if (name == "untar")
+    {
+        return Pattern::Untar;
+    }
+    if (name == "append")
+    {
+        return Pattern::Append;
+    }
+    if (name == "delete")
+    {
+        return Pattern::Delete;
+    }
+    if (name == "mixed")
+    {
+        return Pattern::Mixed;
+    }
+    return std::nullopt;
+}
+
+LoadTotals generateLoad(const LoadSpec& spec, const fs::path& srcRoot,
+                        ReplicationObserver& observer)
+{
+    Generator generator(spec, srcRoot, observer);
+
+    const auto interval = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::seconds(1)) / std::max(spec.rate, 1U);
+    const auto start = Clock::now();
+    const auto end = start + spec.duration;
+
+    // Pace against the absolute schedule, so that a slow step doesn't lower
+    // the offered rate.
+    for (auto next = start; next < end; next += interval)
+    {
+        std::this_thread::sleep_until(next);
+        generator.step(spec.pattern);
+    }
+
+    auto totals = generator.totals();
+    totals.elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+        Clock::now() - start);
+    return totals;
+}
+
+} // namespace loadgen
@@ -0,0 +1,91 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include "replication_observer.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+
+namespace loadgen
+{
+
+namespace fs = std::filesystem;
+
+/**
+ * @brief The write patterns the generator can produce on the source tree.
+ *
+ * - Churn : Rewrite a fixed set of small files over and over.
+ * - Untar : Create a new directory with a burst of files at once.
+ * - Append : Append records to a few growing log files.
+ * - Delete : Create files and remove them again.
+ * - Mixed : Round robin of all the above.
+ */
+enum class Pattern
+{
+    Churn,
+    Untar,
+    Append,
+    Delete,
+    Mixed
+};
+
+/**
+ * @brief Get the pattern from its name.
+ *
+ * @return The pattern; std::nullopt if the name is unknown.
+ */
+std::optional<Pattern> toPattern(const std::string& name);
+
+/**
+ * @brief The load parameters.
+ */
+struct LoadSpec
+{
+    Pattern pattern{Pattern::Churn};
+
+    /**
+     * @brief The number of write operations (bursts for Untar) per second.
+     */
+    uint32_t rate{100};
+
+    /**
+     * @brief The number of files in the churn set or in one untar burst.
+     */
+    uint32_t files{64};
+
+    /**
+     * @brief The bytes written per file write or log append.
+     */
+    size_t size{4096};
+
+    std::chrono::seconds duration{10};
+};
+
+/**
+ * @brief The totals of the generated load.
+ */
+struct LoadTotals
+{
+    uint64_t operations{0};
+    uint64_t bytes{0};
+    std::chrono::microseconds elapsed{0};
+};
+
+/**
+ * @brief Generate the load on the given source tree and record every
+ *        completed operation into the observer.
+ *
+ * @param[in] spec - The load parameters
+ * @param[in] srcRoot - The source tree (the configured sync directory)
+ * @param[in] observer - The replication observer
+ *
+ * @return The totals of the generated load.
+ */
+LoadTotals generateLoad(const LoadSpec& spec, const fs::path& srcRoot,
+                        ReplicationObserver& observer);
+
+} // namespace loadgen
@@ -5,8 +5,16 @@
 #include "manager.hpp"
 
 #include "async_command_exec.hpp"
+#include "chunk_store.hpp"
 #include "data_watcher.hpp"
+#include "dirty_ring.hpp"
+#include "echo_suppression.hpp"
+#include "event_capture.hpp"
+#include "flight_recorder.hpp"
 #include "notify_sibling.hpp"
+#include "partial_transfer.hpp"
+#include "peer_lane.hpp"
+#include "sync_metrics.hpp"
 #include "utility.hpp"
 
 #include <sys/signalfd.h>
@@ -16,6 +24,7 @@
 #include <phosphor-logging/lg2.hpp>
 #include <sdbusplus/async/context.hpp>
 
+#include <array>
 #include <chrono>
 #include <csignal>
 #include <cstring>
@@ -26,22 +35,44 @@
 #include <iterator>
 #include <sstream>
 #include <string>
+#include <utility>
 
 namespace data_sync
 {
 
 Manager::Manager(sdbusplus::async::context& ctx,
                  std::unique_ptr<ext_data::ExternalDataIFaces>&& extDataIfaces,
-                 const fs::path& dataSyncCfgDir) :
-    _ctx(ctx), _extDataIfaces(std::move(extDataIfaces)),
-    _dataSyncCfgDir(dataSyncCfgDir), _syncBMCDataIface(ctx, *this)
+                 const fs::path& dataSyncCfgDir, clock::Clock& clock) :
+    _ctx(ctx), _clock(clock), _extDataIfaces(std::move(extDataIfaces)),
+    _errorLogs(ctx, clock, *_extDataIfaces), _dataSyncCfgDir(dataSyncCfgDir),
+    _syncBMCDataIface(ctx, *this), _syncPathIface(ctx, *this),
+    _statusPage(STATUS_PAGE_FILE),
+    _scrubber(static_cast<uint64_t>(SCRUB_KIB_PER_SEC) * 1024),
+    _workers(ctx, clock)
 {
-// Skip SIGUSR1 registration in unit tests to avoid waiting
+    if constexpr (WATCH_SHARDS > 0)
+    {
+        _watchShards =
+            std::make_unique<watch::shard::ShardPool>(ctx, WATCH_SHARDS);
+    }
+
+    // Publish the restored D-Bus properties into the status page.
+    _statusPage.update([this](status::Page& page) {
+        page.syncEventsHealth =
+            std::to_underlying(_syncBMCDataIface.sync_events_health());
+        page.fullSyncStatus =
+            std::to_underlying(_syncBMCDataIface.full_sync_status());
+        page.disableSync = _syncBMCDataIface.disable_sync() ? 1 : 0;
+    });
+
+// Skip SIGUSR1/SIGUSR2 registration in unit tests to avoid waiting
 // indefinitely for a signal and time out issues.
 #ifndef UNIT_TEST
-    // Register SIGUSR1 handler
+    // Register SIGUSR1/SIGUSR2 handler
     registerSignalHandler();
 #endif
+    _extDataIfaces->onRoleChanged(
+        [this](ext_data::BMCRole role) { bmcRoleChanged(role); });
     _ctx.spawn(init());
 }
 
@@ -68,6 +99,13 @@ sdbusplus::async::task<> Manager::init()
      * role changes, ensuring data is synchronized according to the new role.
      */
     _ctx.spawn(_extDataIfaces->watchRedundancyMgrProps());
+
+    // The sibling may leave the partial data here regardless of the role and
+    // the sync state of this BMC.
+    _ctx.spawn(cleanupPartialTransfers());
+
+    // The sibling syncs its data here in the passive role of this BMC
+    _ctx.spawn(monitorReceivedData());
 #endif
 
     if (!_extDataIfaces->bmcRedundancy() || _syncBMCDataIface.disable_sync())
@@ -131,9 +169,10 @@ sdbusplus::async::task<> Manager::parseConfiguration()
                 {"DS_Parser_Msg",
                  "Exception: Failed to parse the data sync configuration"}};
             additionalDetails["DS_Config_File"] = configFile.path();
-            co_await _extDataIfaces->createErrorLog(
+            co_await _errorLogs.createErrorLog(
                 "xyz.openbmc_project.RBMC_DataSync.Error.ParserFailure",
-                ext_data::ErrorLevel::Warning, additionalDetails);
+                ext_data::ErrorLevel::Warning, configFile.path().string(),
+                configFile.path(), additionalDetails);
         }
         co_return;
     };
@@ -146,6 +185,50 @@ sdbusplus::async::task<> Manager::parseConfiguration()
         }
     }
 
+    co_await parsePeersConfiguration();
+
+    co_return;
+}
+
+// NOLINTNEXTLINE
+sdbusplus::async::task<> Manager::parsePeersConfiguration()
+{
+    bool exception{false};
+    try
+    {
+        for (auto& peerCfg : peer::parsePeers(PEERS_CONFIG_FILE))
+        {
+            lg2::info("Replicating to the peer {PEER} at {URL} as well",
+                      "PEER", peerCfg._name, "URL", peerCfg._url);
+            _peerLanes.emplace_back(std::make_unique<peer::PeerLane>(
+                _ctx, _clock, std::move(peerCfg)));
+        }
+
+        if (!_peerLanes.empty())
+        {
+            // The batches left by an earlier run are of no use
+            fs::remove_all(FANOUT_BATCH_DIR);
+            fs::create_directories(FANOUT_BATCH_DIR);
+        }
+    }
+    catch (const std::exception& e)
+    {
+        lg2::error("Failed to parse the peers configuration file : "
+                   "{CONFIG_FILE}, exception : {EXCEPTION}",
+                   "CONFIG_FILE", PEERS_CONFIG_FILE, "EXCEPTION", e);
+        _peerLanes.clear();
+        exception = true;
+    }
+    if (exception)
+    {
+        ext_data::AdditionalData additionalDetails = {
+            {"DS_Parser_Msg", "Exception: Failed to parse the peers"}};
+        additionalDetails["DS_Config_File"] = PEERS_CONFIG_FILE;
+        co_await _errorLogs.createErrorLog(
+            "xyz.openbmc_project.RBMC_DataSync.Error.ParserFailure",
+            ext_data::ErrorLevel::Warning, PEERS_CONFIG_FILE,
+            PEERS_CONFIG_FILE, additionalDetails);
+    }
     co_return;
 }
 
@@ -161,10 +244,11 @@ sdbusplus::async::task<> Manager::processPendingNotifications()
     for (const auto& path : fs::directory_iterator(NOTIFY_SERVICES_DIR))
     {
         _notifyReqs.emplace_back(std::make_unique<notify::NotifyService>(
-            _ctx, *_extDataIfaces, path, [this](notify::NotifyService* ptr) {
+            _ctx, *_extDataIfaces, path,
+            [this](notify::NotifyService* ptr) {
             std::erase_if(_notifyReqs,
                           [ptr](const auto& p) { return p.get() == ptr; });
-        }));
+        }, _clock, &_errorLogs));
     }
 
     co_return;
@@ -204,7 +288,7 @@ sdbusplus::async::task<> Manager::monitorServiceNotifications()
                         std::erase_if(_notifyReqs, [ptr](const auto& p) {
                             return p.get() == ptr;
                         });
-                    }));
+                    }, _clock, &_errorLogs));
                 }
             }
         }
@@ -222,23 +306,29 @@ sdbusplus::async::task<> Manager::monitorServiceNotifications()
             {"DS_Notify_DIR", notifyDir},
             {"DS_Notify_Msg",
              "Exception: Failed to create inotify watcher for notify services directory"}};
-        co_await _extDataIfaces->createErrorLog(
+        co_await _errorLogs.createErrorLog(
             "xyz.openbmc_project.RBMC_DataSync.Error.NotifyFailure",
-            ext_data::ErrorLevel::Informational, additionalDetails);
+            ext_data::ErrorLevel::Informational, notifyDir, notifyDir,
+            additionalDetails);
     }
     co_return;
 }
 
-bool Manager::isSyncEligible(const config::DataSyncConfig& dataSyncCfg)
+bool Manager::isStandby(const config::DataSyncConfig& dataSyncCfg) const
 {
     using enum config::SyncDirection;
     using enum ext_data::BMCRole;
 
-    if ((dataSyncCfg._syncDirection == Bidirectional) ||
-        ((dataSyncCfg._syncDirection == Active2Passive) &&
-         this->_extDataIfaces->bmcRole() == Active) ||
-        ((dataSyncCfg._syncDirection == Passive2Active) &&
-         this->_extDataIfaces->bmcRole() == Passive))
+    return !((dataSyncCfg._syncDirection == Bidirectional) ||
+             ((dataSyncCfg._syncDirection == Active2Passive) &&
+              this->_extDataIfaces->bmcRole() == Active) ||
+             ((dataSyncCfg._syncDirection == Passive2Active) &&
+              this->_extDataIfaces->bmcRole() == Passive));
+}
+
+bool Manager::isSyncEligible(const config::DataSyncConfig& dataSyncCfg)
+{
+    if (!isStandby(dataSyncCfg))
     {
         return true;
     }
@@ -254,16 +344,119 @@ bool Manager::isSyncEligible(const config::DataSyncConfig& dataSyncCfg)
     return false;
 }
 
+const config::DataSyncConfig* Manager::findCfg(const fs::path& path)
+{
+    auto cfg = std::ranges::find_if(
+        _dataSyncConfiguration, [&path](const auto& dataSyncCfg) {
+        return path == dataSyncCfg._path ||
+               (dataSyncCfg._isPathDir &&
+                path.native().starts_with(dataSyncCfg._path.native()));
+    });
+    return cfg == _dataSyncConfiguration.end() ? nullptr : &(*cfg);
+}
+
+const config::DataSyncConfig* Manager::findSyncCfg(const fs::path& path)
+{
+    const auto* cfg = findCfg(path);
+    if (cfg == nullptr || !isSyncEligible(*cfg))
+    {
+        return nullptr;
+    }
+    return cfg;
+}
+
+void Manager::syncPath(fs::path path, std::chrono::milliseconds timeout,
+                       std::function<void(bool)> reply)
+{
+    auto barrier = std::make_shared<SyncBarrier>(std::move(reply));
+    const auto* cfg = findSyncCfg(path);
+    if (cfg == nullptr)
+    {
+        barrier->complete(false);
+        return;
+    }
+
+    lg2::debug("Syncing [{PATH}] on request, timeout : {TIMEOUT}ms", "PATH",
+               path, "TIMEOUT", timeout.count());
+
+    _ctx.spawn(
+        syncForBarrier(*cfg, path == cfg->_path ? fs::path{} : path, barrier));
+
+    // The sync continues in the background once the barrier expires
+    auto expire = [](Manager& self, fs::path path,
+                     std::chrono::milliseconds timeout,
+                     std::shared_ptr<SyncBarrier> barrier)
+        -> sdbusplus::async::task<> {
+        co_await self._clock.sleepFor(self._ctx, timeout);
+        if (!barrier->replied)
+        {
+            lg2::warning(
+                "Timed out syncing [{PATH}] on request after {TIMEOUT}ms",
+                "PATH", path, "TIMEOUT", timeout.count());
+            barrier->complete(false);
+        }
+    };
+    _ctx.spawn(expire(*this, std::move(path), timeout, std::move(barrier)));
+}
+
+sdbusplus::async::task<>
+    // NOLINTNEXTLINE
+    Manager::syncForBarrier(const config::DataSyncConfig& dataSyncCfg,
+                            fs::path srcPath,
+                            std::shared_ptr<SyncBarrier> barrier)
+{
+    // An in-progress sync may have read the path before the caller's write,
+    // sync it again once that one completes.
+    const std::array<fs::path, 2> busyPaths{
+        srcPath.empty() ? dataSyncCfg._path : srcPath, dataSyncCfg._path};
+    for (const auto& busyPath : busyPaths)
+    {
+        if (dataSyncCfg._syncInProgressPaths.contains(busyPath))
+        {
+            _syncDoneWaiters[busyPath].emplace_back(
+                [this, &dataSyncCfg, srcPath, barrier]() {
+                _ctx.spawn(syncForBarrier(dataSyncCfg, srcPath, barrier));
+            });
+            co_return;
+        }
+    }
+
+    // NOLINTNEXTLINE
+    const bool synced = co_await syncData(dataSyncCfg, std::move(srcPath));
+    barrier->complete(synced);
+}
+
+void Manager::notifySyncDone(const fs::path& path) noexcept
+{
+    auto waiters = _syncDoneWaiters.extract(path);
+    if (waiters.empty())
+    {
+        return;
+    }
+
+    for (const auto& resume : waiters.mapped())
+    {
+        try
+        {
+            resume();
+        }
+        catch (const std::exception& e)
+        {
+            lg2::error("Failed to resume a sync waiting for {PATH} : {ERROR}",
+                       "PATH", path, "ERROR", e);
+        }
+    }
+}
+
 // NOLINTNEXTLINE
 sdbusplus::async::task<> Manager::startSyncEvents()
 {
     lg2::info("Starting background sync.");
-    std::ranges::for_each(
-        _dataSyncConfiguration |
-            std::views::filter([this](const auto& dataSyncCfg) {
-        return this->isSyncEligible(dataSyncCfg);
-    }),
-        [this](const auto& dataSyncCfg) {
+
+    // The units of the data which the sibling syncs in the current role run
+    // in standby, so that they take over at once on a role change.
+    std::ranges::for_each(_dataSyncConfiguration,
+                          [this](const auto& dataSyncCfg) {
         using enum config::SyncType;
         if (dataSyncCfg._syncType == Immediate)
         {
@@ -294,6 +487,29 @@ sdbusplus::async::task<> Manager::startSyncEvents()
             }
         }
     });
+
+    // The writers of the Notified paths push their changes through the
+    // dirty-path ring, they are not watched otherwise.
+    if (!_dirtyRingMonitored &&
+        std::ranges::any_of(_dataSyncConfiguration,
+                            [](const auto& dataSyncCfg) {
+        return dataSyncCfg._syncType == config::SyncType::Notified;
+    }))
+    {
+        _dirtyRingMonitored = true;
+        _ctx.spawn(monitorDirtyRing());
+    }
+
+    // The divergence which the syncs missed, e.g. a manual edit on the
+    // sibling, is found by the background scrub.
+    if constexpr (SCRUB_KIB_PER_SEC > 0)
+    {
+        if (!_scrubbing)
+        {
+            _scrubbing = true;
+            _ctx.spawn(scrubData());
+        }
+    }
     co_return;
 }
 
@@ -320,15 +536,43 @@ bool Manager::isRetryEligible(uint8_t errCode) noexcept
 // Disabled because this function conditionally accesses class members when
 // unit tests are not enabled.
 // NOLINTNEXTLINE(readability-convert-member-functions-to-static)
+bool Manager::tagsOrigin(const config::DataSyncConfig& dataSyncCfg)
+{
+    if (dataSyncCfg._syncDirection != config::SyncDirection::Bidirectional)
+    {
+        return false;
+    }
+
+    // rsync fails the whole sync if the receiver can't set the tag, go
+    // without the echo suppression instead
+    auto it = _originTagging.find(&dataSyncCfg);
+    if (it == _originTagging.end())
+    {
+        it = _originTagging
+                 .emplace(&dataSyncCfg, echo::supportsTags(dataSyncCfg._path))
+                 .first;
+    }
+    return it->second;
+}
+
 void Manager::getRsyncCmd(RsyncMode mode,
                           const config::DataSyncConfig& dataSyncCfg,
-                          const std::string& srcPath, std::string& cmd)
+                          const std::string& srcPath, std::string& cmd,
+                          const peer::PeerConfig* peer,
+                          const fs::path& batchFile,
+                          config::TransferMode transferMode)
 {
     using namespace std::string_literals;
 
+    if (mode == RsyncMode::Scrub)
+    {
+        // Leave the disk and the CPU to the syncs and the other services
+        cmd.append("ionice -c 3 nice -n 19 "s);
+    }
+
     cmd.append("rsync --compress --recursive --perms --group --owner --times "
-               "--atimes --update"s);
-    if (mode == RsyncMode::Sync)
+               "--atimes"s);
+    if (mode == RsyncMode::Sync || mode == RsyncMode::Replay)
     {
         // Appending required flags to sync data between BMCs
         // For more details about CLI options, refer rsync man page.
@@ -336,18 +580,98 @@ void Manager::getRsyncCmd(RsyncMode mode,
 
         cmd.append(" --relative --delete --delete-missing-args --stats"s);
 
+        // Itemize the changed paths to notify the sibling about them only
+        cmd.append(" --out-format='"s + utility::rsync::itemizedOutFormat +
+                   "'");
+
+        // Keep the partial data of an interrupted transfer on the sibling,
+        // so that the next attempt resumes from it. An in-place transfer
+        // leaves it in the file itself, rsync rejects the two together.
+        if (transferMode != config::TransferMode::InPlace)
+        {
+            cmd.append(" --partial-dir="s + partial::stagingDirName);
+        }
+        cmd.append(transfer::rsyncFlags(transferMode));
+
+        // The scrub found the content of the path to differ, while its size
+        // and times may match or the sibling's copy may be newer, e.g. after
+        // a manual edit there. Otherwise the newer copies of the sibling are
+        // left alone, and always for a bidirectional path, whose newer copy
+        // on the sibling is a legitimate edit there.
+        if (_scrubMismatches.contains(srcPath))
+        {
+            cmd.append(" --checksum"s);
+        }
+        if (!_scrubMismatches.contains(srcPath) ||
+            dataSyncCfg._syncDirection == config::SyncDirection::Bidirectional)
+        {
+            cmd.append(" --update"s);
+        }
+
         if (dataSyncCfg._excludeList.has_value())
         {
             cmd.append(dataSyncCfg._excludeList->second);
         }
+
+        if (tagsOrigin(dataSyncCfg))
+        {
+            // Carry the origin tag over to the sibling
+            cmd.append(" --xattrs"s);
+        }
+
+        if (!batchFile.empty())
+        {
+            // Record the transfer to replay it to the peers, or replay it
+            cmd.append((mode == RsyncMode::Sync ? " --write-batch="s
+                                                : " --read-batch="s) +
+                       batchFile.string());
+        }
     }
     else if (mode == RsyncMode::Notify)
     {
         // Appending the required flags to notify the siblng
-        cmd.append(" --remove-source-files"s);
+        cmd.append(" --update --remove-source-files"s);
+    }
+    else if (mode == RsyncMode::Metadata || mode == RsyncMode::MetadataProbe)
+    {
+        // Only update the attributes of the paths the sibling has already,
+        // the same size is taken as the same content. A content change comes
+        // with its own IN_CLOSE_WRITE. A directory is updated alone, not its
+        // entries. No --update, a change may set the times back, e.g. a
+        // "touch -d" or a restored timestamp, except for a bidirectional
+        // path whose newer copy on the sibling is a legitimate edit there.
+        cmd.append(" --relative --existing --size-only --no-recursive --dirs"s);
+        if (dataSyncCfg._syncDirection == config::SyncDirection::Bidirectional)
+        {
+            cmd.append(" --update"s);
+        }
+
+        if (mode == RsyncMode::MetadataProbe)
+        {
+            // Itemize the paths whose size differs, rsync would send them
+            cmd.append(" --dry-run --out-format='"s +
+                       utility::rsync::itemizedOutFormat + "'");
+        }
+    }
+    else if (mode == RsyncMode::Scrub)
+    {
+        // Only itemize the files whose content differs on the sibling, also
+        // the ones newer there unless the sibling syncs them back, as both
+        // BMCs scrub a bidirectional path
+        cmd.append(" --relative --dry-run --checksum --no-recursive"s);
+        if (dataSyncCfg._syncDirection == config::SyncDirection::Bidirectional)
+        {
+            cmd.append(" --update"s);
+        }
+        cmd.append(" --out-format='"s + utility::rsync::itemizedOutFormat +
+                   "'");
     }
 
-    if (!srcPath.empty())
+    if (mode == RsyncMode::Replay)
+    {
+        // The batch carries the source data
+    }
+    else if (!srcPath.empty())
     {
         // Append the modified path name as its available
         cmd.append(" "s + srcPath);
@@ -384,18 +708,27 @@ void Manager::getRsyncCmd(RsyncMode mode,
         cmd.append(" "s + dataSyncCfg._path.string());
     }
 
+    if (peer != nullptr)
+    {
+        cmd.append(" "s + peer->_url);
+    }
+    else
+    {
 #ifdef UNIT_TEST
-    cmd.append(" "s);
+        cmd.append(" "s);
 #else
-    static const std::string rsyncdURL(
-        std::format(" rsync://localhost:{}/{}",
-                    (_extDataIfaces->bmcPosition() == 0 ? BMC1_RSYNC_PORT
-                                                        : BMC0_RSYNC_PORT),
-                    RSYNCD_MODULE_NAME));
-    cmd.append(rsyncdURL);
+        static const std::string rsyncdURL(std::format(
+            " rsync://localhost:{}/{}",
+            (_extDataIfaces->bmcPosition() == 0 ? BMC1_RSYNC_PORT
+                                                : BMC0_RSYNC_PORT),
+            RSYNCD_MODULE_NAME));
+        cmd.append(rsyncdURL);
 #endif
+    }
 
-    if (mode == RsyncMode::Sync)
+    if (mode == RsyncMode::Sync || mode == RsyncMode::Replay ||
+        mode == RsyncMode::Metadata || mode == RsyncMode::MetadataProbe ||
+        mode == RsyncMode::Scrub)
     {
         // Add destination data path if configured
         cmd.append(dataSyncCfg._destPath.value_or(fs::path("")).string());
@@ -411,30 +744,20 @@ sdbusplus::async::task<void>
     Manager::triggerSiblingNotification(
         const config::DataSyncConfig& dataSyncCfg, const std::string& srcPath)
 {
-    std::error_code ec;
-    if (dataSyncCfg._notifySibling.has_value() &&
-        dataSyncCfg._notifySibling.value()._paths.has_value())
-    {
-        if (!(dataSyncCfg._notifySibling.value()._paths.value().contains(
-                srcPath)) &&
-            (!fs::equivalent(srcPath, dataSyncCfg._path, ec)))
-        {
-            // Modified path doesn't need to notify
-            lg2::debug("Sibling notification not configured for the path : "
-                       "[{SRCPATH}] under the configured Path : [{CFGPATH}]",
-                       "SRCPATH", srcPath, "CFGPATH", dataSyncCfg._path);
-            co_return;
-        }
-    }
-
     bool exception{false};
 
     try
     {
         // initiate sibling notification
-        notify::NotifySibling notifySibling(dataSyncCfg, srcPath);
-        co_await syncNotifyRequest(dataSyncCfg, srcPath,
-                                   notifySibling.getNotifyFilePath());
+        metrics::ScopedSpan span(metrics::Stage::Notify);
+
+        // Write the request off the event loop, the flash may stall it
+        const auto notifyFilePath =
+            co_await _workers.run([&dataSyncCfg, srcPath]() {
+            return notify::NotifySibling(dataSyncCfg, srcPath)
+                .getNotifyFilePath();
+        });
+        co_await syncNotifyRequest(dataSyncCfg, srcPath, notifyFilePath);
     }
     catch (const std::exception& e)
     {
@@ -451,9 +774,10 @@ sdbusplus::async::task<void>
             {"DS_Notify_ModifiedPath", srcPath},
             {"DS_Notify_Msg",
              "Exception: Failed to trigger sibling notification request for the path"}};
-        co_await _extDataIfaces->createErrorLog(
+        co_await _errorLogs.createErrorLog(
             "xyz.openbmc_project.RBMC_DataSync.Error.NotifyFailure",
-            ext_data::ErrorLevel::Informational, additionalDetails);
+            ext_data::ErrorLevel::Informational, dataSyncCfg._path.string(),
+            srcPath, additionalDetails);
     }
 
     co_return;
@@ -475,8 +799,12 @@ sdbusplus::async::task<bool>
             cfg._retry->_maxRetryAttempts, "SRC_PATH", currentSrcPath,
             "RETRY_INTERVAL", cfg._retry->_retryIntervalInSec.count());
 
-        co_await sleep_for(_ctx, std::chrono::seconds(
-                                     cfg._retry->_retryIntervalInSec.count()));
+        _statusPage.updateStats(
+            cfg._path, [](status::SyncStats& stats) { ++stats.retries; });
+        recorder::record(recorder::EventType::Retry, currentSrcPath.native(),
+                         static_cast<int32_t>(retryCount));
+
+        co_await _clock.sleepFor(_ctx, cfg._retry->_retryIntervalInSec);
 
         // NOLINTNEXTLINE
         co_return co_await syncData(cfg, std::move(srcPath), retryCount);
@@ -499,10 +827,12 @@ sdbusplus::async::task<bool>
     const fs::path currentSrcPath = srcPath.empty() ? dataSyncCfg._path
                                                     : srcPath;
 
-    auto cleanup = scope_exit([&dataSyncCfg, &currentSrcPath]() noexcept {
+    auto cleanup = scope_exit([this, &dataSyncCfg,
+                               &currentSrcPath]() noexcept {
         // remove this path from the in-progress set once the first(main)
         // attempt completes
         dataSyncCfg._syncInProgressPaths.erase(currentSrcPath);
+        notifySyncDone(currentSrcPath);
     });
 
     if (retryCount == 0)
@@ -511,6 +841,8 @@ sdbusplus::async::task<bool>
         {
             lg2::debug("Skipping sync for [{SRC}]: already in progress", "SRC",
                        currentSrcPath);
+            recorder::record(recorder::EventType::OpCoalesced,
+                             currentSrcPath.native());
             cleanup.release(); // nothing inserted, skip cleanup
             co_return true;
         }
@@ -522,8 +854,31 @@ sdbusplus::async::task<bool>
         cleanup.release();
     }
 
+    // Prepare the transfer once for the peers taking it now, the others
+    // and the big transfers get a sync from scratch
+    std::shared_ptr<peer::BatchFile> batch;
+    bool batched = std::ranges::any_of(
+        _peerLanes, [](const auto& lane) { return lane->accepting(); });
+    if (batched)
+    {
+        batched = co_await _workers.run(
+            [currentSrcPath]() { return peer::fitsInBatch(currentSrcPath); });
+    }
+    if (batched)
+    {
+        batch = std::make_shared<peer::BatchFile>(
+            fs::path(FANOUT_BATCH_DIR) / std::to_string(++_batchSeq));
+    }
+
     std::string syncCmd{};
-    getRsyncCmd(RsyncMode::Sync, dataSyncCfg, srcPath.string(), syncCmd);
+    const auto transferMode =
+        _transferSelector.select(dataSyncCfg, currentSrcPath);
+    {
+        metrics::ScopedSpan span(metrics::Stage::RsyncCmdBuild);
+        getRsyncCmd(RsyncMode::Sync, dataSyncCfg, srcPath.string(), syncCmd,
+                    nullptr, batch ? batch->path() : fs::path{},
+                    transferMode);
+    }
 
     if (syncCmd.empty())
     {
@@ -532,18 +887,116 @@ sdbusplus::async::task<bool>
 
     lg2::debug("Rsync command: {CMD}", "CMD", syncCmd);
 
+    if (tagsOrigin(dataSyncCfg))
+    {
+        // Let the sibling know that it receives the content from this BMC,
+        // so that it doesn't sync it back. Walk the tree off the event loop,
+        // it can be large.
+        co_await _workers.run(
+            [currentSrcPath, bmcPosition = _extDataIfaces->bmcPosition()]() {
+            echo::tagOrigin(currentSrcPath, bmcPosition);
+        });
+    }
+
+    // Track the request in the status page until the main attempt (including
+    // its retries) completes.
+    auto queueTracker = scope_exit([this]() noexcept {
+        _statusPage.update([](status::Page& page) { --page.queueDepth; });
+    });
+    if (retryCount == 0)
+    {
+        _statusPage.update([](status::Page& page) { ++page.queueDepth; });
+        _statusPage.updateStats(
+            dataSyncCfg._path,
+            [](status::SyncStats& stats) { ++stats.syncsStarted; });
+    }
+    else
+    {
+        queueTracker.release();
+    }
+
+    _statusPage.update([](status::Page& page) { ++page.inFlightSyncs; });
+    _statusPage.updateStats(dataSyncCfg._path,
+                            [](status::SyncStats& stats) { ++stats.inFlight; });
+    const auto syncStartTime = std::chrono::steady_clock::now();
+    recorder::record(recorder::EventType::SyncStarted, currentSrcPath.native(),
+                     static_cast<int32_t>(retryCount));
+
     data_sync::async::AsyncCommandExecutor executor(_ctx);
-    // NOLINTNEXTLINE
-    auto result = co_await executor.execCmd(syncCmd);
+    std::pair<int, std::string> result;
+    {
+        clock::BusyScope busy(_clock);
+        // NOLINTNEXTLINE
+        result = co_await executor.execCmd(syncCmd);
+    }
+    // The itemized paths are for the notifications only, a failed directory
+    // sync has a line per path
+    const auto rsyncMsg = utility::rsync::withoutItemizedPaths(result.second);
     lg2::debug(
         "Rsync cmd output for [{PATH}] : return code : {RET} : output : {OUTPUT}",
-        "PATH", currentSrcPath, "RET", result.first, "OUTPUT", result.second);
+        "PATH", currentSrcPath, "RET", result.first, "OUTPUT", rsyncMsg);
+
+    const auto syncDuration =
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - syncStartTime);
+    const bool syncSucceeded = (result.first == 0 || result.first == 24);
+    const size_t transferredBytes =
+        (result.first == 0)
+            ? utility::rsync::getTransferredDataBytes(result.second)
+            : 0;
+    const size_t matchedBytes =
+        (result.first == 0)
+            ? utility::rsync::getMatchedDataBytes(result.second)
+            : 0;
+    if (result.first == 0 &&
+        dataSyncCfg._transferMode == config::TransferMode::Auto)
+    {
+        _transferSelector.onTransferred(currentSrcPath, transferMode,
+                                        transferredBytes, matchedBytes,
+                                        syncDuration);
+    }
+    if (syncSucceeded)
+    {
+        _scrubMismatches.erase(currentSrcPath);
+    }
+    const bool interrupted = partial::isInterrupted(result.first);
+    size_t resumedBytes{0};
+    if (interrupted)
+    {
+        _interruptedPaths.emplace(currentSrcPath);
+    }
+    else if (syncSucceeded && _interruptedPaths.erase(currentSrcPath) != 0)
+    {
+        // The sibling matched the kept partial data, so that only the rest of
+        // it is transferred.
+        resumedBytes = utility::rsync::getMatchedDataBytes(result.second);
+        lg2::info("Resumed the interrupted sync of {PATH}, {BYTES} bytes "
+                  "reused",
+                  "PATH", currentSrcPath, "BYTES", resumedBytes);
+    }
+    recorder::record(recorder::EventType::SyncFinished,
+                     currentSrcPath.native(), result.first, transferredBytes);
+    _statusPage.update([](status::Page& page) { --page.inFlightSyncs; });
+    _statusPage.updateStats(
+        dataSyncCfg._path,
+        [&result, &syncDuration, syncSucceeded, transferredBytes,
+         matchedBytes, interrupted, resumedBytes](status::SyncStats& stats) {
+        --stats.inFlight;
+        syncSucceeded ? ++stats.syncsSucceeded : ++stats.syncsFailed;
+        stats.bytesTransferred += transferredBytes;
+        stats.matchedBytes += matchedBytes;
+        stats.interruptedSyncs += interrupted ? 1 : 0;
+        stats.resumedBytes += resumedBytes;
+        stats.lastExitCode = result.first;
+        stats.lastSyncTimeUs = status::nowInUs();
+        stats.lastSyncDurationUs = syncDuration.count();
+    });
 
     ext_data::AdditionalData additionalDetails = {
         {"BMC_Role", _extDataIfaces->bmcRoleInStr()},
         {"DS_Sync_Path", currentSrcPath.string()},
         {"DS_Sync_ErrCode", std::to_string(result.first)},
-        {"DS_Sync_ErrMsg", result.second}};
+        {"DS_Sync_ErrMsg", rsyncMsg}};
 
     additionalDetails["DS_Sync_Type"] = dataSyncCfg.getSyncTypeInStr();
     additionalDetails["DS_Sync_Direction"] =
@@ -553,25 +1006,29 @@ sdbusplus::async::task<bool>
     {
         case 0: // Success
         {
-            // Notify only if configured, we know the concrete path,
-            // and bytes > 0
-            if (dataSyncCfg._notifySibling &&
-                utility::rsync::getTransferredDataBytes(result.second) != 0)
+            fanOut(dataSyncCfg, srcPath, batch);
+
+            // Notify only if configured and only about the paths which the
+            // sync changed on the sibling, as rsync success alone doesn't
+            // guarantee any data got updated on the remote.
+            if (dataSyncCfg._notifySibling)
             {
-                // Rsync success alone doesn’t guarantee data got updated on the
-                // remote.
-                // Checking bytes transferred helps to confirm if any data
-                // mismatch was actually synced.
-                // initiate sibling notification
-                // NOLINTNEXTLINE
-                co_await triggerSiblingNotification(dataSyncCfg,
-                                                    currentSrcPath.string());
+                for (const auto& path : notify::NotifySibling::getPathsToNotify(
+                         dataSyncCfg, currentSrcPath,
+                         utility::rsync::getChangedPaths(result.second)))
+                {
+                    // NOLINTNEXTLINE
+                    co_await triggerSiblingNotification(dataSyncCfg,
+                                                        path.string());
+                }
             }
             co_return true;
         }
 
         case 24: // Vanished source: treat as success
         {
+            fanOut(dataSyncCfg, srcPath, batch);
+
             // TODO: Revisit notification handling for vanished files if partial
             // data got synced
             lg2::debug(
@@ -588,7 +1045,7 @@ sdbusplus::async::task<bool>
                     "Error syncing [{PATH}], ErrCode: {ERRCODE}, ErrMsg: {ERRMSG}"
                     "SyncCmd : [{SYNC_CMD}]",
                     "PATH", currentSrcPath, "ERRCODE", result.first, "ERRMSG",
-                    result.second, "SYNC_CMD", syncCmd);
+                    rsyncMsg, "SYNC_CMD", syncCmd);
                 // Mark sync event health as critical when a non-retryable
                 // (permanent) sync error occurs.
                 setSyncEventsHealth(SyncEventsHealth::Critical);
@@ -599,16 +1056,17 @@ sdbusplus::async::task<bool>
                 additionalDetails["DS_Sync_Msg"] =
                     "Permanent rsync failure occurred for the path";
 
-                co_await _extDataIfaces->createErrorLog(
+                co_await _errorLogs.createErrorLog(
                     "xyz.openbmc_project.RBMC_DataSync.Error.SyncFailure",
-                    ext_data::ErrorLevel::Warning, additionalDetails);
+                    ext_data::ErrorLevel::Warning, dataSyncCfg._path.string(),
+                    currentSrcPath, additionalDetails, true);
                 co_return false;
             }
 
             lg2::debug(
                 "Retrying rsync for [{SRC}] after ErrCode: {ERRCODE}, ErrMsg: {ERRMSG}",
                 "SRC", currentSrcPath, "ERRCODE", result.first, "ERRMSG",
-                result.second);
+                rsyncMsg);
 
             auto retrySuccess = co_await retrySync(
                 dataSyncCfg, srcPath.empty() ? fs::path{} : currentSrcPath,
@@ -624,7 +1082,7 @@ sdbusplus::async::task<bool>
                         ? dataSyncCfg._retry.value()._maxRetryAttempts
                         : 0,
                     "SRC_PATH", currentSrcPath, "ERRCODE", result.first,
-                    "ERRMSG", result.second, "SYNC_CMD", syncCmd);
+                    "ERRMSG", rsyncMsg, "SYNC_CMD", syncCmd);
 
                 // All retry attempts exhausted, mark sync event health as
                 // critical
@@ -634,9 +1092,10 @@ sdbusplus::async::task<bool>
                 additionalDetails["DS_Sync_Msg"] =
                     "Maximum retries exceeded, sync failed for the path";
 
-                co_await _extDataIfaces->createErrorLog(
+                co_await _errorLogs.createErrorLog(
                     "xyz.openbmc_project.RBMC_DataSync.Error.SyncFailure",
-                    ext_data::ErrorLevel::Warning, additionalDetails);
+                    ext_data::ErrorLevel::Warning, dataSyncCfg._path.string(),
+                    currentSrcPath, additionalDetails, true);
             }
             co_return retrySuccess;
         }
@@ -659,7 +1118,12 @@ sdbusplus::async::task<>
            retryAttempts++ <= cfg._retry->_maxRetryAttempts)
     {
         data_sync::async::AsyncCommandExecutor executor(_ctx);
-        result = co_await executor.execCmd(notifyCmd);
+        {
+            clock::BusyScope busy(_clock);
+            result = co_await executor.execCmd(notifyCmd);
+        }
+        recorder::record(recorder::EventType::NotifySent,
+                         modifiedPath.native(), result.first);
 
         switch (result.first)
         {
@@ -709,8 +1173,7 @@ sdbusplus::async::task<>
             cfg._retry->_maxRetryAttempts, "INTERVAL",
             cfg._retry->_retryIntervalInSec.count());
 
-        co_await sleep_for(_ctx, std::chrono::seconds(
-                                     cfg._retry->_retryIntervalInSec.count()));
+        co_await _clock.sleepFor(_ctx, cfg._retry->_retryIntervalInSec);
     }
 
     lg2::error("Failed to send notify request[{NOTIFYPATH}] to sibling BMC "
@@ -726,9 +1189,10 @@ sdbusplus::async::task<>
         {"DS_Notify_Path", notifyPath.string()},
         {"DS_Notify_ModifiedPath", modifiedPath.string()},
         {"DS_Notify_Msg", "Failed to send notify request for the path"}};
-    co_await _extDataIfaces->createErrorLog(
+    co_await _errorLogs.createErrorLog(
         "xyz.openbmc_project.RBMC_DataSync.Error.NotifyFailure",
-        ext_data::ErrorLevel::Informational, additionalDetails);
+        ext_data::ErrorLevel::Informational, cfg._path.string(), modifiedPath,
+        additionalDetails);
 
     co_return;
 }
@@ -745,6 +1209,10 @@ sdbusplus::async::task<>
         {
             eventMasksToWatch |= IN_CREATE | IN_DELETE;
         }
+        if (dataSyncCfg._syncMetadata)
+        {
+            eventMasksToWatch |= IN_ATTRIB;
+        }
 
         auto excludeList =
             dataSyncCfg._excludeList.has_value()
@@ -752,6 +1220,30 @@ sdbusplus::async::task<>
                       dataSyncCfg._excludeList.value().first)
                 : std::nullopt;
 
+        if (_watchShards)
+        {
+            // The inotify events are read and processed on a shard thread
+            auto [it, inserted] = _shardedWatches.emplace(
+                dataSyncCfg._path,
+                _watchShards->watch({dataSyncCfg._path, eventMasksToWatch,
+                                     excludeList, dataSyncCfg._includeList}));
+
+            auto* shardedWatch = it->second.get();
+
+            auto cleanup =
+                std::experimental::scope_exit([this, &dataSyncCfg]() {
+                    _shardedWatches.erase(dataSyncCfg._path);
+                });
+
+            while (!_ctx.stop_requested() && !_syncBMCDataIface.disable_sync())
+            {
+                // NOLINTNEXTLINE
+                processDataOperations(dataSyncCfg,
+                                      co_await shardedWatch->onDataChange());
+            }
+            co_return;
+        }
+
         auto [it, inserted] = _activeWatchers.emplace(
             dataSyncCfg._path,
             std::make_unique<watch::inotify::DataWatcher>(
@@ -768,17 +1260,8 @@ sdbusplus::async::task<>
         while (!_ctx.stop_requested() && !_syncBMCDataIface.disable_sync())
         {
             // NOLINTNEXTLINE
-            if (auto dataOperations = co_await dataWatcher->onDataChange();
-                !dataOperations.empty())
-            {
-                for (const auto& [path, dataOp] : dataOperations)
-                {
-                    // NOLINTNEXTLINE
-                    _ctx.spawn(
-                        syncData(dataSyncCfg, path) |
-                        stdexec::then([]([[maybe_unused]] bool result) {}));
-                }
-            }
+            processDataOperations(dataSyncCfg,
+                                  co_await dataWatcher->onDataChange());
         }
     }
     catch (std::exception& e)
@@ -794,61 +1277,785 @@ sdbusplus::async::task<>
             {"DS_Events_Path", dataSyncCfg._path.string()},
             {"DS_Events_Msg",
              "Exception: Failed to create inotify watcher for the configured path"}};
-        co_await _extDataIfaces->createErrorLog(
+        co_await _errorLogs.createErrorLog(
             "xyz.openbmc_project.RBMC_DataSync.Error.SyncEventsFailure",
-            ext_data::ErrorLevel::Warning, additionalDetails);
+            ext_data::ErrorLevel::Warning, dataSyncCfg._path.string(),
+            dataSyncCfg._path, additionalDetails);
     }
     co_return;
 }
 
-sdbusplus::async::task<>
-    // NOLINTNEXTLINE
-    Manager::monitorTimerToSync(const config::DataSyncConfig& dataSyncCfg)
+void Manager::processDataOperations(
+    const config::DataSyncConfig& dataSyncCfg,
+    const watch::inotify::DataOperations& dataOperations)
 {
-    while (!_ctx.stop_requested() && !_syncBMCDataIface.disable_sync() &&
-           dataSyncCfg._periodicityInSec.has_value())
+    for (const auto& [path, dataOp] : dataOperations)
     {
-        co_await sdbusplus::async::sleep_for(
-            _ctx, dataSyncCfg._periodicityInSec.value());
+        // The partial data which the sibling is sending here
+        if (partial::isStaging(path))
+        {
+            continue;
+        }
+
+        if (isStandby(dataSyncCfg))
+        {
+            markStandbyDirty(dataSyncCfg, path);
+            continue;
+        }
+
+        // The origin tag tells about the content only, so a metadata change
+        // received from the sibling is synced back once, which changes
+        // nothing there.
+        if (dataOp == watch::inotify::DataOps::METADATA)
+        {
+            // The origin tag written ahead of a sync changes the attributes
+            // too
+            if (dataSyncCfg._syncDirection !=
+                    config::SyncDirection::Bidirectional ||
+                !echo::isOwnTagWrite(path))
+            {
+                queueMetadataSync(dataSyncCfg, path);
+            }
+            continue;
+        }
+
+        if (dataSyncCfg._syncDirection ==
+                config::SyncDirection::Bidirectional &&
+            echo::isEcho(path, _extDataIfaces->bmcPosition()))
+        {
+            lg2::debug("Skipping the sync of {PATH} as it is received from "
+                       "the sibling",
+                       "PATH", path);
+            continue;
+        }
+
+        if (dataSyncCfg._hotPathBatching.has_value() &&
+            batchHotPath(dataSyncCfg, path))
+        {
+            continue;
+        }
+
         // NOLINTNEXTLINE
-        co_await syncData(dataSyncCfg);
+        _ctx.spawn(syncData(dataSyncCfg, path) |
+                   stdexec::then([]([[maybe_unused]] bool result) {}));
     }
-    co_return;
 }
 
-void Manager::disableSyncPropChanged(bool disableSync)
+void Manager::queueMetadataSync(const config::DataSyncConfig& dataSyncCfg,
+                                const fs::path& path)
 {
-    if (disableSync)
-    {
-        // TODO: Disable all sync events using Sender Receiver.
-        lg2::info("Sync is Disabled, Stopping events");
-    }
-    else
+    auto& paths = _pendingMetadata[&dataSyncCfg];
+    if (paths.empty())
     {
-        lg2::info("Sync is Enabled, Starting events");
-        _ctx.spawn(startSyncEvents());
+        // NOLINTNEXTLINE
+        _ctx.spawn(syncMetadata(dataSyncCfg));
     }
+    paths.emplace(path);
 }
 
-void Manager::setFullSyncStatus(const FullSyncStatus& fullSyncStatus)
+sdbusplus::async::task<>
+    // NOLINTNEXTLINE
+    Manager::syncMetadata(const config::DataSyncConfig& dataSyncCfg)
 {
-    if (_syncBMCDataIface.full_sync_status() == fullSyncStatus)
-    {
-        return;
-    }
-    _syncBMCDataIface.full_sync_status(fullSyncStatus);
+    co_await _clock.sleepFor(_ctx, metadataBatchDelay);
 
-    // Don't persist InProgress status as it's a transient state
-    if (fullSyncStatus == FullSyncStatus::FullSyncInProgress)
+    auto paths = std::move(_pendingMetadata[&dataSyncCfg]);
+    _pendingMetadata.erase(&dataSyncCfg);
+    if (_syncBMCDataIface.disable_sync())
     {
-        return;
+        co_return;
     }
 
-    try
+    while (!paths.empty() && !_ctx.stop_requested())
     {
-        data_sync::persist::update(data_sync::persist::key::fullSyncStatus,
-                                   fullSyncStatus);
-    }
+        std::vector<fs::path> candidates;
+        while (!paths.empty() && candidates.size() < maxMetadataPathsPerSync)
+        {
+            candidates.emplace_back(
+                std::move(paths.extract(paths.begin()).value()));
+        }
+
+        // Stat the paths off the event loop, a burst can be large
+        auto batch = co_await _workers.run(
+            [candidates = std::move(candidates)]() mutable {
+            std::erase_if(candidates, [](const fs::path& path) {
+                std::error_code ec;
+                return !fs::exists(path, ec);
+            });
+            return std::move(candidates);
+        });
+        if (batch.empty())
+        {
+            continue;
+        }
+
+        // The paths whose size differs on the sibling changed in content as
+        // well, they take the regular sync instead of getting their content
+        // sent by the metadata sync.
+        // NOLINTNEXTLINE
+        const auto changed = co_await probeMetadata(dataSyncCfg, batch);
+        for (const auto& path : changed)
+        {
+            std::erase(batch, path);
+            // NOLINTNEXTLINE
+            _ctx.spawn(syncData(dataSyncCfg, path) |
+                       stdexec::then([]([[maybe_unused]] bool result) {}));
+        }
+        if (batch.empty())
+        {
+            continue;
+        }
+
+        std::string srcPaths;
+        for (const auto& path : batch)
+        {
+            srcPaths.append((srcPaths.empty() ? "" : " ") + path.string());
+        }
+
+        std::string syncCmd{};
+        getRsyncCmd(RsyncMode::Metadata, dataSyncCfg, srcPaths, syncCmd);
+        lg2::debug("Rsync command to sync the metadata: {CMD}", "CMD",
+                   syncCmd);
+
+        data_sync::async::AsyncCommandExecutor executor(_ctx);
+        std::pair<int, std::string> result;
+        {
+            clock::BusyScope busy(_clock);
+            // NOLINTNEXTLINE
+            result = co_await executor.execCmd(syncCmd);
+        }
+
+        if (result.first == 0 || result.first == 24)
+        {
+            continue;
+        }
+
+        lg2::warning("Failed to sync the metadata of {COUNT} paths of "
+                     "{CFGPATH}, syncing them regularly. ErrCode: {ERRCODE}, "
+                     "ErrMsg: {ERRMSG}",
+                     "COUNT", batch.size(), "CFGPATH", dataSyncCfg._path,
+                     "ERRCODE", result.first, "ERRMSG", result.second);
+        for (const auto& path : batch)
+        {
+            // NOLINTNEXTLINE
+            _ctx.spawn(syncData(dataSyncCfg, path) |
+                       stdexec::then([]([[maybe_unused]] bool result) {}));
+        }
+    }
+    co_return;
+}
+
+sdbusplus::async::task<std::vector<fs::path>>
+    // NOLINTNEXTLINE
+    Manager::probeMetadata(const config::DataSyncConfig& dataSyncCfg,
+                           const std::vector<fs::path>& paths)
+{
+    std::string srcPaths;
+    for (const auto& path : paths)
+    {
+        srcPaths.append((srcPaths.empty() ? "" : " ") + path.string());
+    }
+
+    std::string probeCmd{};
+    getRsyncCmd(RsyncMode::MetadataProbe, dataSyncCfg, srcPaths, probeCmd);
+    lg2::debug("Rsync command to probe the metadata sync: {CMD}", "CMD",
+               probeCmd);
+
+    data_sync::async::AsyncCommandExecutor executor(_ctx);
+    std::pair<int, std::string> result;
+    {
+        clock::BusyScope busy(_clock);
+        // NOLINTNEXTLINE
+        result = co_await executor.execCmd(probeCmd);
+    }
+
+    // The metadata sync reports its own failure
+    if (result.first != 0 && result.first != 24)
+    {
+        co_return std::vector<fs::path>{};
+    }
+    co_return utility::rsync::getChangedPaths(result.second);
+}
+
+sdbusplus::async::task<>
+    // NOLINTNEXTLINE
+    Manager::monitorTimerToSync(const config::DataSyncConfig& dataSyncCfg)
+{
+    while (!_ctx.stop_requested() && !_syncBMCDataIface.disable_sync() &&
+           dataSyncCfg._periodicityInSec.has_value())
+    {
+        co_await _clock.sleepFor(_ctx, dataSyncCfg._periodicityInSec.value());
+
+        // The next period after a role change covers the standby time
+        if (!isStandby(dataSyncCfg))
+        {
+            // NOLINTNEXTLINE
+            co_await syncData(dataSyncCfg);
+        }
+    }
+    co_return;
+}
+
+bool Manager::batchHotPath(const config::DataSyncConfig& dataSyncCfg,
+                           const fs::path& path)
+{
+    auto& tracker =
+        _hotPathTrackers
+            .try_emplace(dataSyncCfg._path,
+                         dataSyncCfg._hotPathBatching.value())
+            .first->second;
+
+    const auto batchedCount = tracker.batchedCount();
+    if (tracker.onChange(path, _clock.now()) == hot_path::Mode::Immediate)
+    {
+        return false;
+    }
+
+    if (tracker.batchedCount() != batchedCount)
+    {
+        // Just got hot, the batched sync takes over its changes
+        hotPathModeChanged(dataSyncCfg, path, hot_path::Mode::Batched);
+        _ctx.spawn(syncBatchedPath(dataSyncCfg, path));
+    }
+    return true;
+}
+
+sdbusplus::async::task<>
+    // NOLINTNEXTLINE
+    Manager::syncBatchedPath(const config::DataSyncConfig& dataSyncCfg,
+                             fs::path path)
+{
+    auto& tracker = _hotPathTrackers.at(dataSyncCfg._path);
+    while (!_ctx.stop_requested())
+    {
+        co_await _clock.sleepFor(
+            _ctx, dataSyncCfg._hotPathBatching->_minSyncInterval);
+
+        if (tracker.takePending(path))
+        {
+            // NOLINTNEXTLINE
+            co_await syncData(dataSyncCfg, path);
+        }
+
+        if (tracker.refresh(path, _clock.now()) == hot_path::Mode::Immediate)
+        {
+            hotPathModeChanged(dataSyncCfg, path, hot_path::Mode::Immediate);
+            break;
+        }
+    }
+    co_return;
+}
+
+void Manager::hotPathModeChanged(const config::DataSyncConfig& dataSyncCfg,
+                                 const fs::path& path, hot_path::Mode mode)
+{
+    const auto& tracker = _hotPathTrackers.at(dataSyncCfg._path);
+    const bool batched = mode == hot_path::Mode::Batched;
+    lg2::info("{PATH} changes {RATE} times per minute, syncing it {MODE}",
+              "PATH", path, "RATE",
+              static_cast<uint32_t>(tracker.rate(path, _clock.now())), "MODE",
+              batched ? "in batches" : "immediately");
+    recorder::record(recorder::EventType::ModeChanged, path.native(),
+                     batched ? 1 : 0);
+
+    const auto batchedPaths = static_cast<uint32_t>(tracker.batchedCount());
+    _statusPage.updateStats(dataSyncCfg._path,
+                            [batchedPaths](status::SyncStats& stats) {
+        stats.batchedPaths = batchedPaths;
+        ++stats.modeChanges;
+    });
+}
+
+// NOLINTNEXTLINE
+sdbusplus::async::task<> Manager::monitorDirtyRing()
+{
+    auto cleanup = std::experimental::scope_exit(
+        [this]() { _dirtyRingMonitored = false; });
+
+    std::unique_ptr<dirty_ring::DirtyRingReader> ring;
+    try
+    {
+        ring = std::make_unique<dirty_ring::DirtyRingReader>(DIRTY_RING_FILE);
+    }
+    catch (const std::exception& e)
+    {
+        lg2::error("Failed to set up the dirty-path ring, the Notified paths "
+                   "won't be synced. Exception : {ERROR}",
+                   "ERROR", e);
+        setSyncEventsHealth(SyncEventsHealth::Critical);
+        co_return;
+    }
+
+    sdbusplus::async::fdio wakeFdio(_ctx, ring->wakeFd());
+    auto dropped = ring->dropped();
+    lg2::info("Consuming the dirty-path ring {RING}", "RING", DIRTY_RING_FILE);
+
+    while (!_ctx.stop_requested())
+    {
+        while (auto path = ring->pop())
+        {
+            // The records are dropped while the sync is disabled, the full
+            // sync covers them once it is enabled again.
+            const auto* cfg = findCfg(*path);
+            if (cfg == nullptr ||
+                cfg->_syncType == config::SyncType::Periodic ||
+                partial::isStaging(*path))
+            {
+                lg2::debug("Ignoring the dirty-path record of {PATH}", "PATH",
+                           *path);
+                continue;
+            }
+
+            if (isStandby(*cfg))
+            {
+                markStandbyDirty(*cfg, *path);
+                continue;
+            }
+
+            if (cfg->_syncDirection == config::SyncDirection::Bidirectional &&
+                echo::isEcho(*path, _extDataIfaces->bmcPosition()))
+            {
+                continue;
+            }
+
+            if (cfg->_hotPathBatching.has_value() && batchHotPath(*cfg, *path))
+            {
+                continue;
+            }
+
+            // NOLINTNEXTLINE
+            _ctx.spawn(syncData(*cfg, *path) |
+                       stdexec::then([]([[maybe_unused]] bool result) {}));
+        }
+
+        if (const auto nowDropped = ring->dropped(); nowDropped != dropped)
+        {
+            // The Notified paths have no other way to see the lost changes
+            lg2::warning("The dirty-path ring dropped {COUNT} records, syncing "
+                         "all the Notified paths",
+                         "COUNT", nowDropped - dropped);
+            dropped = nowDropped;
+            for (const auto& dataSyncCfg : _dataSyncConfiguration)
+            {
+                if (dataSyncCfg._syncType != config::SyncType::Notified)
+                {
+                    continue;
+                }
+
+                if (isStandby(dataSyncCfg))
+                {
+                    auto& dirty = _standbyDirtyPaths[&dataSyncCfg];
+                    dirty.overflow = true;
+                    dirty.paths.clear();
+                    continue;
+                }
+
+                // NOLINTNEXTLINE
+                _ctx.spawn(syncData(dataSyncCfg) |
+                           stdexec::then([]([[maybe_unused]] bool result) {}));
+            }
+        }
+
+        if (ring->prepareWait())
+        {
+            co_await wakeFdio.next();
+            ring->finishWait();
+        }
+    }
+    co_return;
+}
+
+void Manager::fanOut(const config::DataSyncConfig& dataSyncCfg,
+                     const fs::path& srcPath,
+                     const std::shared_ptr<const peer::BatchFile>& batch)
+{
+    std::error_code ec;
+    const bool batchWritten = batch && fs::exists(batch->path(), ec);
+    for (auto& lane : _peerLanes)
+    {
+        peer::Transfer transfer{
+            .path = srcPath.empty() ? dataSyncCfg._path : srcPath,
+            .batch = batchWritten ? batch : nullptr,
+            .replayCmd = {},
+            .resyncCmd = {}};
+        if (batchWritten)
+        {
+            getRsyncCmd(RsyncMode::Replay, dataSyncCfg, {}, transfer.replayCmd,
+                        &lane->config(), batch->path());
+        }
+        getRsyncCmd(RsyncMode::Sync, dataSyncCfg, srcPath.string(),
+                    transfer.resyncCmd, &lane->config(), {},
+                    _transferSelector.select(dataSyncCfg, transfer.path));
+        if (!transfer.resyncCmd.empty())
+        {
+            lane->submit(std::move(transfer));
+        }
+    }
+}
+
+void Manager::markStandbyDirty(const config::DataSyncConfig& dataSyncCfg,
+                               const fs::path& path)
+{
+    auto& dirty = _standbyDirtyPaths[&dataSyncCfg];
+    if (dirty.overflow)
+    {
+        return;
+    }
+
+    if (dirty.paths.size() >= maxStandbyDirtyPaths &&
+        !dirty.paths.contains(path))
+    {
+        lg2::debug("Too many standby changes under {PATH}, catching up all "
+                   "of it on a role change",
+                   "PATH", dataSyncCfg._path);
+        dirty.overflow = true;
+        dirty.paths.clear();
+        return;
+    }
+    dirty.paths.emplace(path);
+}
+
+void Manager::bmcRoleChanged(ext_data::BMCRole role)
+{
+    lg2::info("The BMC role changed to {ROLE}", "ROLE", role);
+
+    // The full sync covers the changes once the sync is enabled
+    if (!_extDataIfaces->bmcRedundancy() || _syncBMCDataIface.disable_sync())
+    {
+        return;
+    }
+
+    for (auto it = _standbyDirtyPaths.begin(); it != _standbyDirtyPaths.end();)
+    {
+        const auto& dataSyncCfg = *it->first;
+        if (isStandby(dataSyncCfg))
+        {
+            ++it;
+            continue;
+        }
+
+        // The unit is live already, only the changes it saw in standby are
+        // left to sync.
+        auto dirty = std::move(it->second);
+        it = _standbyDirtyPaths.erase(it);
+        if (dirty.overflow)
+        {
+            lg2::info("Catching up all of {PATH} after the role change",
+                      "PATH", dataSyncCfg._path);
+            // NOLINTNEXTLINE
+            _ctx.spawn(syncData(dataSyncCfg) |
+                       stdexec::then([]([[maybe_unused]] bool result) {}));
+            continue;
+        }
+        lg2::info("Catching up {COUNT} changes of {PATH} after the role change",
+                  "COUNT", dirty.paths.size(), "PATH", dataSyncCfg._path);
+        for (const auto& path : dirty.paths)
+        {
+            _catchUpPaths.emplace_back(&dataSyncCfg, path);
+        }
+    }
+
+    // Not a process and a connection to the sibling per recorded change at
+    // once while taking over
+    while (_catchUpSyncs < maxCatchUpSyncs &&
+           _catchUpSyncs < _catchUpPaths.size())
+    {
+        ++_catchUpSyncs;
+        // NOLINTNEXTLINE
+        _ctx.spawn(syncCatchUpPaths());
+    }
+}
+
+// NOLINTNEXTLINE
+sdbusplus::async::task<> Manager::syncCatchUpPaths()
+{
+    auto cleanup = std::experimental::scope_exit(
+        [this]() { --_catchUpSyncs; });
+
+    while (!_catchUpPaths.empty() && !_ctx.stop_requested())
+    {
+        auto [dataSyncCfg, path] = std::move(_catchUpPaths.front());
+        _catchUpPaths.pop_front();
+        co_await syncData(*dataSyncCfg, std::move(path));
+    }
+    co_return;
+}
+
+// NOLINTNEXTLINE
+sdbusplus::async::task<> Manager::scrubData()
+{
+    while (!_ctx.stop_requested() && !_syncBMCDataIface.disable_sync())
+    {
+        auto chunk = _scrubber.nextChunk();
+        if (!chunk.has_value())
+        {
+            co_await startScrubPass();
+            continue;
+        }
+
+        // The role may have changed since the pass started
+        if (isStandby(*chunk->cfg))
+        {
+            continue;
+        }
+
+        std::string srcPaths;
+        for (const auto& path : chunk->paths)
+        {
+            srcPaths.append((srcPaths.empty() ? "" : " ") + path.string());
+        }
+
+        std::string scrubCmd{};
+        getRsyncCmd(RsyncMode::Scrub, *chunk->cfg, srcPaths, scrubCmd);
+        lg2::debug("Rsync command to scrub: {CMD}", "CMD", scrubCmd);
+
+        data_sync::async::AsyncCommandExecutor executor(_ctx);
+        std::pair<int, std::string> result;
+        {
+            clock::BusyScope busy(_clock);
+            // NOLINTNEXTLINE
+            result = co_await executor.execCmd(scrubCmd);
+        }
+
+        size_t mismatches{0};
+        if (result.first == 0 || result.first == 24)
+        {
+            for (auto& path : utility::rsync::getChangedPaths(result.second))
+            {
+                lg2::info("The scrub found {PATH} to differ on the sibling, "
+                          "syncing it",
+                          "PATH", path);
+                ++mismatches;
+                _scrubMismatches.emplace(path);
+                // NOLINTNEXTLINE
+                _ctx.spawn(syncData(*chunk->cfg, std::move(path)) |
+                           stdexec::then([]([[maybe_unused]] bool result) {}));
+            }
+        }
+        else
+        {
+            lg2::warning("Failed to scrub {COUNT} paths of {CFGPATH}. "
+                         "ErrCode: {ERRCODE}, ErrMsg: {ERRMSG}",
+                         "COUNT", chunk->paths.size(), "CFGPATH",
+                         chunk->cfg->_path, "ERRCODE", result.first, "ERRMSG",
+                         utility::rsync::withoutItemizedPaths(result.second));
+        }
+
+        _scrubber.onScrubbed(*chunk, mismatches);
+        _statusPage.updateStats(
+            chunk->cfg->_path, [&chunk, mismatches](status::SyncStats& stats) {
+            stats.scrubbedFiles += chunk->paths.size();
+            stats.scrubbedBytes += chunk->bytes;
+            stats.scrubMismatches += mismatches;
+        });
+        _statusPage.update([&pass = _scrubber.pass()](status::Page& page) {
+            page.scrubCoverage = static_cast<uint32_t>(
+                pass.scrubbedFiles * 100 /
+                std::max<size_t>(pass.totalFiles, 1));
+        });
+
+        co_await _clock.sleepFor(_ctx, _scrubber.pause(*chunk));
+    }
+    _scrubbing = false;
+    co_return;
+}
+
+// NOLINTNEXTLINE
+sdbusplus::async::task<> Manager::startScrubPass()
+{
+    if (const auto& pass = _scrubber.pass(); pass.totalFiles != 0)
+    {
+        const auto duration = std::chrono::duration_cast<std::chrono::seconds>(
+            _clock.now() - pass.startTime);
+        lg2::info("Scrubbed {FILES} files of {BYTES} bytes in {SECONDS}s, "
+                  "{MISMATCHES} differed on the sibling",
+                  "FILES", pass.scrubbedFiles, "BYTES", pass.scrubbedBytes,
+                  "SECONDS", duration.count(), "MISMATCHES", pass.mismatches);
+        _statusPage.update([](status::Page& page) { ++page.scrubPasses; });
+    }
+
+    co_await _clock.sleepFor(_ctx, _scrubber.untilNextPass(_clock.now()));
+
+    std::vector<const config::DataSyncConfig*> cfgs;
+    for (const auto& dataSyncCfg : _dataSyncConfiguration)
+    {
+        if (!isStandby(dataSyncCfg))
+        {
+            cfgs.emplace_back(&dataSyncCfg);
+        }
+    }
+
+    // Walk the trees off the event loop, they can be large
+    auto files = co_await _workers.run([cfgs = std::move(cfgs)]() {
+        std::vector<std::pair<const config::DataSyncConfig*,
+                              std::vector<scrub::ScrubFile>>>
+            cfgFiles;
+        for (const auto* cfg : cfgs)
+        {
+            cfgFiles.emplace_back(cfg, scrub::listFiles(*cfg));
+        }
+        return cfgFiles;
+    });
+    _scrubber.startPass(std::move(files), _clock.now());
+    _statusPage.update([](status::Page& page) { page.scrubCoverage = 0; });
+    co_return;
+}
+
+// NOLINTNEXTLINE
+sdbusplus::async::task<> Manager::cleanupPartialTransfers()
+{
+    while (!_ctx.stop_requested())
+    {
+        std::vector<std::pair<fs::path, bool>> roots;
+        for (const auto& dataSyncCfg : _dataSyncConfiguration)
+        {
+            // The sibling keeps the same paths under the destination path
+            const auto destPath = dataSyncCfg._destPath.value_or("/") /
+                                  dataSyncCfg._path.relative_path();
+            roots.emplace_back(dataSyncCfg._isPathDir ? destPath
+                                                      : destPath.parent_path(),
+                               dataSyncCfg._isPathDir);
+        }
+
+        // Walk the trees off the event loop, they can be large
+        const auto removed =
+            co_await _workers.run([roots = std::move(roots)]() {
+            partial::CleanupResult result;
+            for (const auto& [root, recursive] : roots)
+            {
+                const auto rootRemoved = partial::cleanupStaging(
+                    root, recursive, partial::maxStagingAge);
+                result.removedFiles += rootRemoved.removedFiles;
+                result.removedBytes += rootRemoved.removedBytes;
+            }
+            return result;
+        });
+
+        if (removed.removedFiles != 0)
+        {
+            lg2::info("Removed {FILES} unclaimed partial transfers of {BYTES} "
+                      "bytes",
+                      "FILES", removed.removedFiles, "BYTES",
+                      removed.removedBytes);
+        }
+
+        co_await _clock.sleepFor(_ctx, partial::stagingCleanupInterval);
+    }
+    co_return;
+}
+
+// NOLINTNEXTLINE
+sdbusplus::async::task<> Manager::monitorReceivedData()
+{
+    constexpr auto backupDir{backup::defaultBackupSource};
+    std::unique_ptr<watch::inotify::DataWatcher> backupWatcher;
+    try
+    {
+        // rsync renames the received files into place, unless it writes
+        // them in place (--inplace, --append) or only sets their metadata
+        backupWatcher = std::make_unique<watch::inotify::DataWatcher>(
+            _ctx, IN_NONBLOCK | IN_CLOEXEC,
+            IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_DELETE | IN_ATTRIB,
+            backupDir);
+    }
+    catch (const std::exception& e)
+    {
+        lg2::error("Failed to create watcher for {PATH}, the received data "
+                   "isn't backed up. Exception : {EXCEP}",
+                   "PATH", backupDir, "EXCEP", e);
+        co_return;
+    }
+
+    while (!_ctx.stop_requested())
+    {
+        // NOLINTNEXTLINE
+        if (auto dataOperations = co_await backupWatcher->onDataChange();
+            !dataOperations.empty())
+        {
+            _backupPending = true;
+            if (!_backupRunning)
+            {
+                _backupRunning = true;
+                _ctx.spawn(backupReceivedData());
+            }
+        }
+    }
+    co_return;
+}
+
+// NOLINTNEXTLINE
+sdbusplus::async::task<> Manager::backupReceivedData()
+{
+    auto cleanup = std::experimental::scope_exit(
+        [this]() { _backupRunning = false; });
+
+    while (_backupPending && !_ctx.stop_requested())
+    {
+        // A sync brings many files, which make a single version
+        co_await _clock.sleepFor(_ctx, backupSettleDelay);
+        _backupPending = false;
+
+        try
+        {
+            // Chunking the data is blocking work
+            const auto stats = co_await _workers.run([]() {
+                backup::ChunkStore store(backup::defaultStoreDir,
+                                         BACKUP_RETAINED_VERSIONS);
+                return store.backup(backup::defaultBackupSource);
+            });
+            lg2::debug("Backed up the received data as version {VERSION}",
+                       "VERSION", stats.version);
+        }
+        catch (const std::exception& e)
+        {
+            // The next received sync takes the version
+            lg2::error("Failed to back up {PATH}, exception : {EXCEP}",
+                       "PATH", backup::defaultBackupSource, "EXCEP", e);
+        }
+    }
+    co_return;
+}
+
+void Manager::disableSyncPropChanged(bool disableSync)
+{
+    _statusPage.update([disableSync](status::Page& page) {
+        page.disableSync = disableSync ? 1 : 0;
+    });
+
+    if (disableSync)
+    {
+        // TODO: Disable all sync events using Sender Receiver.
+        lg2::info("Sync is Disabled, Stopping events");
+    }
+    else
+    {
+        lg2::info("Sync is Enabled, Starting events");
+        _ctx.spawn(startSyncEvents());
+    }
+}
+
+void Manager::setFullSyncStatus(const FullSyncStatus& fullSyncStatus)
+{
+    if (_syncBMCDataIface.full_sync_status() == fullSyncStatus)
+    {
+        return;
+    }
+    _syncBMCDataIface.full_sync_status(fullSyncStatus);
+    _statusPage.update([&fullSyncStatus](status::Page& page) {
+        page.fullSyncStatus = std::to_underlying(fullSyncStatus);
+    });
+
+    // Don't persist InProgress status as it's a transient state
+    if (fullSyncStatus == FullSyncStatus::FullSyncInProgress)
+    {
+        return;
+    }
+
+    try
+    {
+        data_sync::persist::update(data_sync::persist::key::fullSyncStatus,
+                                   fullSyncStatus);
+    }
     catch (const std::exception& e)
     {
         lg2::error(
@@ -864,6 +2071,16 @@ void Manager::setSyncEventsHealth(const SyncEventsHealth& syncEventsHealth)
         return;
     }
     _syncBMCDataIface.sync_events_health(syncEventsHealth);
+    _statusPage.update([&syncEventsHealth](status::Page& page) {
+        page.syncEventsHealth = std::to_underlying(syncEventsHealth);
+    });
+    recorder::record(recorder::EventType::HealthChanged, "",
+                     std::to_underlying(syncEventsHealth));
+    if (syncEventsHealth == SyncEventsHealth::Critical)
+    {
+        // Preserve the events which led to the critical state
+        recorder::dumpToFile(FLIGHT_RECORDER_FILE);
+    }
     try
     {
         data_sync::persist::update(data_sync::persist::key::syncEventsHealth,
@@ -916,8 +2133,7 @@ sdbusplus::async::task<void> Manager::startFullSync()
 
     while (spawnedTasks > 0)
     {
-        co_await sdbusplus::async::sleep_for(_ctx,
-                                             std::chrono::milliseconds(50));
+        co_await _clock.sleepFor(_ctx, std::chrono::milliseconds(50));
     }
 
     auto fullSyncEndTime = std::chrono::steady_clock::now();
@@ -952,7 +2168,7 @@ nlohmann::json Manager::collectAllWatchingPaths() const
     nlohmann::json watchingPaths;
 
     lg2::debug("Collecting the {COUNT} active watchers", "COUNT",
-               _activeWatchers.size());
+               _activeWatchers.size() + _shardedWatches.size());
 
     for (const auto& [configPath, dataWatcher] : _activeWatchers)
     {
@@ -968,6 +2184,16 @@ nlohmann::json Manager::collectAllWatchingPaths() const
         watchingPaths.emplace(configPath.string(), std::move(paths));
     }
 
+    for (const auto& [configPath, shardedWatch] : _shardedWatches)
+    {
+        std::vector<std::string> paths;
+        std::ranges::transform(shardedWatch->watchedPaths(),
+                               std::back_inserter(paths),
+                               [](const auto& path) { return path.string(); });
+
+        watchingPaths.emplace(configPath.string(), std::move(paths));
+    }
+
     result["watching_paths"] = watchingPaths;
 
     // Add timestamp of collecting along with the list of watchers
@@ -984,19 +2210,20 @@ void Manager::registerSignalHandler()
 {
     try
     {
-        // Block SIGUSR1 so it's delivered via signalfd instead of default
-        // handler
+        // Block SIGUSR1 and SIGUSR2 so they're delivered via signalfd instead
+        // of default handler
         sigset_t ss;
-        if (sigemptyset(&ss) < 0 || sigaddset(&ss, SIGUSR1) < 0)
+        if (sigemptyset(&ss) < 0 || sigaddset(&ss, SIGUSR1) < 0 ||
+            sigaddset(&ss, SIGUSR2) < 0)
         {
-            lg2::error("Failed to setup signal mask for SIGUSR1");
+            lg2::error("Failed to setup signal mask for SIGUSR1/SIGUSR2");
             return;
         }
 
         if (pthread_sigmask(SIG_BLOCK, &ss, nullptr) != 0)
         {
-            lg2::error("Failed to block SIGUSR1 signal: {ERROR}", "ERROR",
-                       std::strerror(errno));
+            lg2::error("Failed to block SIGUSR1/SIGUSR2 signals: {ERROR}",
+                       "ERROR", std::strerror(errno));
             return;
         }
 
@@ -1023,7 +2250,13 @@ void Manager::registerSignalHandler()
                 signalfd_siginfo si{};
                 ssize_t s = read(sigusr1Fd(), &si, sizeof(si));
 
-                if (s == sizeof(si))
+                if (s == sizeof(si) && si.ssi_signo == SIGUSR2)
+                {
+                    // Commands are sent via sigqueue(), plain kill toggles
+                    mgr->handleMetricsRequest(
+                        si.ssi_code == SI_QUEUE ? si.ssi_int : 0);
+                }
+                else if (s == sizeof(si))
                 {
                     lg2::info(
                         "Received SIGUSR1 (signal {SIG}), dumping all watching paths",
@@ -1044,6 +2277,70 @@ void Manager::registerSignalHandler()
     }
 }
 
+void Manager::handleMetricsRequest(int command)
+{
+    using metrics::Command;
+
+    if (command == 0)
+    {
+        command = std::to_underlying(metrics::enabled() ? Command::Disable
+                                                        : Command::Enable);
+        if (metrics::enabled())
+        {
+            // Keep what was collected before turning off
+            metrics::dumpToFile();
+        }
+    }
+
+    switch (static_cast<Command>(command))
+    {
+        case Command::Enable:
+        {
+            lg2::info("Enabling the sync pipeline metrics collection");
+            metrics::setEnabled(true);
+            _ctx.spawn(metrics::monitorLoopLag(_ctx));
+            break;
+        }
+        case Command::Disable:
+        {
+            lg2::info("Disabling the sync pipeline metrics collection");
+            metrics::setEnabled(false);
+            break;
+        }
+        case Command::Dump:
+        {
+            metrics::dumpToFile();
+            break;
+        }
+        case Command::Reset:
+        {
+            metrics::reset();
+            break;
+        }
+        case Command::DumpFlightRecorder:
+        {
+            recorder::dumpToFile(FLIGHT_RECORDER_FILE);
+            break;
+        }
+        case Command::StartEventCapture:
+        {
+            capture::start(EVENT_CAPTURE_FILE);
+            break;
+        }
+        case Command::StopEventCapture:
+        {
+            capture::stop();
+            break;
+        }
+        default:
+        {
+            lg2::error("Ignoring the unknown metrics command : {CMD}", "CMD",
+                       command);
+            break;
+        }
+    }
+}
+
 void Manager::dumpWatchingPathsToFile() const
 {
     constexpr auto outputFile = "/tmp/data_sync_watching_paths.json";
@@ -2,21 +2,35 @@
 
 #pragma once
 
+#include "clock.hpp"
 #include "data_sync_config.hpp"
 #include "data_watcher.hpp"
+#include "error_log_aggregator.hpp"
 #include "external_data_ifaces.hpp"
+#include "hot_path_tracker.hpp"
 #include "notify_service.hpp"
+#include "peer_lane.hpp"
 #include "persistent.hpp"
+#include "scrubber.hpp"
+#include "status_page.hpp"
 #include "sync_bmc_data_ifaces.hpp"
+#include "sync_path_iface.hpp"
+#include "transfer_selector.hpp"
+#include "watch_shards.hpp"
+#include "worker_pool.hpp"
 
 #include <sdbusplus/async.hpp>
 
 #include <atomic>
+#include <deque>
 #include <filesystem>
+#include <functional>
 #include <map>
 #include <memory>
 #include <optional>
 #include <ranges>
+#include <set>
+#include <utility>
 #include <vector>
 
 namespace data_sync
@@ -31,8 +45,12 @@ namespace fs = std::filesystem;
 
 enum class RsyncMode
 {
-    Sync,  // perform sync
-    Notify // perform sibling notification
+    Sync,   // perform sync
+    Notify,  // perform sibling notification
+    Replay,  // replay the batch of a sync to a peer
+    Metadata, // sync only the metadata of the paths
+    MetadataProbe, // find the paths whose content differs for a metadata sync
+    Scrub     // compare the checksums of the paths with the sibling's copies
 };
 
 /**
@@ -57,10 +75,13 @@ class Manager
      * @param[in] ctx - The async context
      * @param[in] extDataIfaces - The external data interfaces object
      * @param[in] dataSyncCfgDir - The data sync configuration directory
+     * @param[in] clock - The clock to schedule the periodic syncs and the
+     *                    retries on
      */
     Manager(sdbusplus::async::context& ctx,
             std::unique_ptr<ext_data::ExternalDataIFaces>&& extDataIfaces,
-            const fs::path& dataSyncCfgDir);
+            const fs::path& dataSyncCfgDir,
+            clock::Clock& clock = clock::steady());
 
     /**
      * @brief An API helper to verify if the manager contains the given
@@ -85,6 +106,36 @@ class Manager
      */
     sdbusplus::async::task<> startFullSync();
 
+    /**
+     * @brief Find the data sync configuration which syncs the given path from
+     *        this BMC.
+     *
+     * @param[in] path - A configured path or a path inside a configured
+     *                   directory
+     *
+     * @return The configuration; nullptr if the path is not synced from this
+     *         BMC.
+     */
+    const config::DataSyncConfig* findSyncCfg(const fs::path& path);
+
+    /**
+     * @brief Sync the given path to the sibling right away, ahead of the
+     *        pending sync events, and wait for the sibling to confirm.
+     *
+     *        - A sync of the path which is already in progress may have
+     *          started before the caller's write, so it is waited for and
+     *          the path is synced again.
+     *        - The sync continues in the background if it times out.
+     *
+     * @param[in] path - A configured path or a path inside a configured
+     *                   directory
+     * @param[in] timeout - The maximum time to wait for the sibling
+     * @param[in] reply - Invoked once, with True if the sibling confirmed
+     *                    the sync within the timeout; otherwise False.
+     */
+    void syncPath(fs::path path, std::chrono::milliseconds timeout,
+                  std::function<void(bool)> reply);
+
     /**
      * @brief Helper API that retrieves the sibling BMC availability
      *
@@ -123,6 +174,14 @@ class Manager
      */
     void disableSyncPropChanged(bool disableSync);
 
+    /**
+     * @brief Helper API fetches the Disable sync Dbus status-property.
+     */
+    bool getDisableSyncStatus() const
+    {
+        return _syncBMCDataIface.disable_sync();
+    }
+
     /**
      * @brief Helper API to set the Disable sync Dbus status-property.
      *        Specifically, for unit testing purposes.
@@ -151,6 +210,34 @@ class Manager
      */
     void setSyncEventsHealth(const SyncEventsHealth& syncEventsHealth);
 
+  protected:
+    // Protected to allow the benchmarks to exercise the command framing.
+
+    /**
+     * @brief API to frame the RSYNC CLI command
+     *
+     * @param[in] mode - enum RsyncMode : sync, notify, replay or metadata
+     * @param[in] dataSyncCfg - The data sync config to sync
+     * @param[in] srcPath - The modified path inside the cfg path.
+     *                      Will be empty if not available. The space
+     *                      separated paths in the metadata mode.
+     * @param[out] cmd - string where the framed RSYNC command holds.
+     * @param[in] peer - The extra peer to transfer to, the sibling BMC if
+     *                   null.
+     * @param[in] batchFile - The batch file to write while syncing, or to
+     *                        replay. None if empty.
+     * @param[in] transferMode - The way to transfer the content in the sync
+     *                           mode, other than Auto.
+     */
+    // Disabled because this function conditionally accesses class members when
+    // unit tests are not enabled.
+    // NOLINTNEXTLINE(readability-convert-member-functions-to-static)
+    void getRsyncCmd(
+        RsyncMode mode, const config::DataSyncConfig& dataSyncCfg,
+        const std::string& srcPath, std::string& cmd,
+        const peer::PeerConfig* peer = nullptr, const fs::path& batchFile = {},
+        config::TransferMode transferMode = config::TransferMode::Delta);
+
   private:
     /**
      * @brief A helper API to start the data sync operation.
@@ -189,11 +276,11 @@ class Manager
     sdbusplus::async::task<> startSyncEvents();
 
     /**
-     * @brief API responsible to trigger sibling notification if required.
+     * @brief API responsible to trigger sibling notification for a path.
      *
      * @param[in] dataSyncCfg - The data sync config to sync
-     * @param[in] srcPath - The modified path inside the cfg path.
-     *                      Will be empty if not available.
+     * @param[in] srcPath - The changed path to notify about, as selected by
+     *                      NotifySibling::getPathsToNotify().
      *
      * @return : none
      */
@@ -201,21 +288,6 @@ class Manager
         triggerSiblingNotification(const config::DataSyncConfig& dataSyncCfg,
                                    const std::string& srcPath);
 
-    /**
-     * @brief API to frame the RSYNC CLI command
-     *
-     * @param[in] mode - enum RsyncMode : sync or notify
-     * @param[in] dataSyncCfg - The data sync config to sync
-     * @param[in] srcPath - The modified path inside the cfg path.
-     *                      Will be empty if not available.
-     * @param[out] cmd - string where the framed RSYNC command holds.
-     */
-    // Disabled because this function conditionally accesses class members when
-    // unit tests are not enabled.
-    // NOLINTNEXTLINE(readability-convert-member-functions-to-static)
-    void getRsyncCmd(RsyncMode mode, const config::DataSyncConfig& dataSyncCfg,
-                     const std::string& srcPath, std::string& cmd);
-
     /**
      * @brief A helper rsync wrapper API that syncs data to sibling
      *        BMC, with different behavior in the unit test environment,
@@ -269,6 +341,17 @@ class Manager
     sdbusplus::async::task<>
         monitorDataToSync(const config::DataSyncConfig& dataSyncCfg);
 
+    /**
+     * @brief Schedule the syncs of the data operations received from the
+     *        watcher of the given configuration.
+     *
+     * @param[in] dataSyncCfg - The data sync config of the watcher
+     * @param[in] dataOperations - The received data operations
+     */
+    void processDataOperations(
+        const config::DataSyncConfig& dataSyncCfg,
+        const watch::inotify::DataOperations& dataOperations);
+
     /**
      * @brief A helper to API to sync data periodically.
      *
@@ -277,6 +360,182 @@ class Manager
     sdbusplus::async::task<>
         monitorTimerToSync(const config::DataSyncConfig& dataSyncCfg);
 
+    /**
+     * @brief A helper API to account a change of a path of a configuration
+     *        which batches its hot paths, and switch the path to the batched
+     *        sync once it changes too often.
+     *
+     * @param[in] dataSyncCfg - The data sync config of the path
+     * @param[in] path - The changed path
+     *
+     * @return true if the change is left to the batched sync; false if it is
+     *         to be synced immediately.
+     */
+    bool batchHotPath(const config::DataSyncConfig& dataSyncCfg,
+                      const fs::path& path);
+
+    /**
+     * @brief A helper API to queue a metadata change of a path, the changes
+     *        queued within a short delay are synced by a single rsync.
+     *
+     * @param[in] dataSyncCfg - The data sync config of the path
+     * @param[in] path - The path whose metadata changed
+     */
+    void queueMetadataSync(const config::DataSyncConfig& dataSyncCfg,
+                           const fs::path& path);
+
+    /**
+     * @brief A helper API to sync the metadata (mode, owner, times) of the
+     *        queued paths of a configuration without comparing their content.
+     *        The paths whose size differs on the sibling or whose metadata
+     *        sync fails get a regular sync.
+     *
+     * @param[in] dataSyncCfg - The data sync config of the paths
+     */
+    sdbusplus::async::task<>
+        syncMetadata(const config::DataSyncConfig& dataSyncCfg);
+
+    /**
+     * @brief The reply of a SyncPath request, sent by the sync or by the
+     *        timeout, whichever comes first.
+     */
+    struct SyncBarrier
+    {
+        std::function<void(bool)> reply;
+        bool replied{false};
+
+        void complete(bool synced)
+        {
+            if (!std::exchange(replied, true))
+            {
+                reply(synced);
+            }
+        }
+    };
+
+    /**
+     * @brief A helper API to sync the path of a SyncPath request once no
+     *        earlier sync of it is in progress.
+     *
+     * @param[in] dataSyncCfg - The data sync config of the path
+     * @param[in] srcPath - The path to sync, empty for the config path
+     * @param[in] barrier - The request to complete with the sync result
+     */
+    sdbusplus::async::task<>
+        syncForBarrier(const config::DataSyncConfig& dataSyncCfg,
+                       fs::path srcPath, std::shared_ptr<SyncBarrier> barrier);
+
+    /**
+     * @brief A helper API to resume the waiters of the in-progress sync of
+     *        the given path, once it completes.
+     *
+     * @param[in] path - The path whose sync completed
+     */
+    void notifySyncDone(const fs::path& path) noexcept;
+
+    /**
+     * @brief A helper API to check whether the syncs of the given config
+     *        carry the origin tag, i.e. it is bidirectional and its
+     *        filesystem supports the tag.
+     *
+     * @param[in] dataSyncCfg - The data sync config to check
+     *
+     * @return true if the synced paths are tagged and sent with --xattrs
+     */
+    bool tagsOrigin(const config::DataSyncConfig& dataSyncCfg);
+
+    /**
+     * @brief A helper API to find the paths of a metadata sync whose size
+     *        differs on the sibling, which the metadata sync would send.
+     *
+     * @param[in] dataSyncCfg - The data sync config of the paths
+     * @param[in] paths - The paths of the metadata sync
+     *
+     * @return The paths whose size differs, none if the probe failed
+     */
+    sdbusplus::async::task<std::vector<fs::path>>
+        probeMetadata(const config::DataSyncConfig& dataSyncCfg,
+                      const std::vector<fs::path>& paths);
+
+    /**
+     * @brief A helper API to sync a batched path at most once per minimum
+     *        sync interval, until it cools down.
+     *
+     * @param[in] dataSyncCfg - The data sync config of the path
+     * @param[in] path - The batched path
+     */
+    sdbusplus::async::task<>
+        syncBatchedPath(const config::DataSyncConfig& dataSyncCfg,
+                        fs::path path);
+
+    /**
+     * @brief A helper API to publish a sync mode change of a hot path.
+     *
+     * @param[in] dataSyncCfg - The data sync config of the path
+     * @param[in] path - The path
+     * @param[in] mode - The new mode
+     */
+    void hotPathModeChanged(const config::DataSyncConfig& dataSyncCfg,
+                            const fs::path& path, hot_path::Mode mode);
+
+    /**
+     * @brief A helper API to consume the "path changed" records which the
+     *        cooperating writers push into the dirty-path ring, and sync the
+     *        Immediate and Notified paths among them.
+     */
+    sdbusplus::async::task<> monitorDirtyRing();
+
+    /**
+     * @brief A helper API to scrub the configured data in the background,
+     *        comparing it chunk by chunk with the sibling's copies within the
+     *        I/O budget, and to sync the paths found to differ.
+     */
+    sdbusplus::async::task<> scrubData();
+
+    /**
+     * @brief A helper API to report the finished scrub pass, if any, and to
+     *        start the next one over the data which this BMC syncs in its
+     *        current role, once the minimum pass interval has passed.
+     */
+    sdbusplus::async::task<> startScrubPass();
+
+    /**
+     * @brief A helper API to periodically remove the partial data of the
+     *        interrupted transfers which no later sync claimed, from the
+     *        staging directories under the configured destination paths.
+     */
+    sdbusplus::async::task<> cleanupPartialTransfers();
+
+    /**
+     * @brief A helper API to monitor the sibling BMC's data received on this
+     *        BMC and to schedule a backup of it once a sync changed it.
+     */
+    sdbusplus::async::task<> monitorReceivedData();
+
+    /**
+     * @brief A helper API to take a version of the sibling BMC's data into
+     *        the backup store once the received sync settled, until no
+     *        change is left to back up.
+     */
+    sdbusplus::async::task<> backupReceivedData();
+
+    /**
+     * @brief A helper API to set up the scheduler lanes of the extra peers
+     *        configured in the peers configuration file.
+     */
+    sdbusplus::async::task<> parsePeersConfiguration();
+
+    /**
+     * @brief A helper API to fan a successful sync out to the extra peers.
+     *
+     * @param[in] dataSyncCfg - The data sync config of the sync
+     * @param[in] srcPath - The synced path, empty if the whole config
+     * @param[in] batch - The batch written by the sync, null if none
+     */
+    void fanOut(const config::DataSyncConfig& dataSyncCfg,
+                const fs::path& srcPath,
+                const std::shared_ptr<const peer::BatchFile>& batch);
+
     /**
      * @brief A helper to API Checks if the data can be synchronize.
      *
@@ -290,6 +549,54 @@ class Manager
      */
     bool isSyncEligible(const config::DataSyncConfig& dataSyncCfg);
 
+    /**
+     * @brief A helper API to check whether the given data is synced by the
+     *        sibling in the current role of this BMC, so that this BMC only
+     *        keeps its sync units armed in standby for a role change.
+     *
+     * @param[in] dataSyncCfg - The data sync config
+     *
+     * @return True if in standby; otherwise False.
+     */
+    bool isStandby(const config::DataSyncConfig& dataSyncCfg) const;
+
+    /**
+     * @brief A helper API to find the data sync configuration of the given
+     *        path, regardless of the role of this BMC.
+     *
+     * @param[in] path - A configured path or a path inside a configured
+     *                   directory
+     *
+     * @return The configuration; nullptr if the path is not configured.
+     */
+    const config::DataSyncConfig* findCfg(const fs::path& path);
+
+    /**
+     * @brief A helper API to record a change of a standby path, to catch it
+     *        up once a role change makes this BMC sync it.
+     *
+     * @param[in] dataSyncCfg - The data sync config of the path
+     * @param[in] path - The changed path
+     */
+    void markStandbyDirty(const config::DataSyncConfig& dataSyncCfg,
+                          const fs::path& path);
+
+    /**
+     * @brief A helper API to hand the sync units over on a BMC role change,
+     *        the armed standby units of the data this BMC syncs in its new
+     *        role take over at once with a catch-up of the recorded changes.
+     *
+     * @param[in] role - The new BMC role
+     */
+    void bmcRoleChanged(ext_data::BMCRole role);
+
+    /**
+     * @brief A helper API to sync the queued catch-up paths one after the
+     *        other, a few of these run at once to bound the rsync processes
+     *        started while the BMC takes over.
+     */
+    sdbusplus::async::task<> syncCatchUpPaths();
+
     /**
      * @brief Wrapper API to check whether the receieved RSYNC error code
      *        need to retry or not.
@@ -301,13 +608,22 @@ class Manager
     static bool isRetryEligible(uint8_t errCode) noexcept;
 
     /**
-     * @brief Register SIGUSR1 signal handler using signalfd
+     * @brief Register SIGUSR1 and SIGUSR2 signal handler using signalfd
      *
-     * Sets up signalfd to receive SIGUSR1 signals and creates an fdio instance
-     * to monitor it.
+     * Sets up signalfd to receive SIGUSR1 (dump watching paths) and SIGUSR2
+     * (metrics control) signals and creates an fdio instance to monitor it.
      */
     void registerSignalHandler();
 
+    /**
+     * @brief Handle the metrics, flight recorder and inotify event capture
+     *        control request received via SIGUSR2
+     *
+     * @param[in] command - The metrics::Command value sent via sigqueue();
+     *                      0 to toggle the metrics collection.
+     */
+    void handleMetricsRequest(int command);
+
     /**
      * @brief Write all watched paths to a JSON file
      *
@@ -333,12 +649,23 @@ class Manager
      */
     sdbusplus::async::context& _ctx;
 
+    /**
+     * @brief The clock to wait on for the periodic syncs and the retries
+     */
+    clock::Clock& _clock;
+
     /**
      * @brief An external data interface object used to seamlessly retrieve
      *        external dependent data.
      */
     std::unique_ptr<ext_data::ExternalDataIFaces> _extDataIfaces;
 
+    /**
+     * @brief The aggregator which the error logs are created through, so
+     *        that a failure of many paths doesn't flood the logging service.
+     */
+    error_log::Aggregator _errorLogs;
+
     /**
      * @brief The data sync configuration directory
      */
@@ -353,6 +680,17 @@ class Manager
      */
     dbus_ifaces::SyncBMCDataIface _syncBMCDataIface;
 
+    /**
+     * @brief The SyncPath barrier method object
+     */
+    dbus_ifaces::SyncPathIface _syncPathIface;
+
+    /**
+     * @brief The shared status page which publishes the sync status and
+     *        counters to the monitoring readers without D-Bus.
+     */
+    status::StatusPageWriter _statusPage;
+
     /**
      * @brief To store the list of notification requests.
      *        Auto cleanup will be done once notification
@@ -368,6 +706,165 @@ class Manager
      */
     std::map<fs::path, std::unique_ptr<watch::inotify::DataWatcher>>
         _activeWatchers;
+
+    /**
+     * @brief The shard threads which run the watchers instead, if
+     *        configured with the watch_shards option
+     */
+    std::unique_ptr<watch::shard::ShardPool> _watchShards;
+
+    /**
+     * @brief Map of config paths to the handles of their watchers on the
+     *        shards, declared after the shards so that they go away first
+     */
+    std::map<fs::path, std::unique_ptr<watch::shard::ShardedWatch>>
+        _shardedWatches;
+
+    /**
+     * @brief The change rate trackers of the configurations which batch
+     *        their hot paths.
+     *
+     * Key: Configured path from JSON
+     * Value: The tracker of the paths under it
+     */
+    std::map<fs::path, hot_path::HotPathTracker> _hotPathTrackers;
+
+    /**
+     * @brief Whether the dirty-path ring is being consumed, the ring has a
+     *        single consumer.
+     */
+    bool _dirtyRingMonitored{false};
+
+    /**
+     * @brief The paths whose last sync attempt was interrupted mid-transfer,
+     *        so that the next successful sync accounts the resumed bytes.
+     */
+    std::set<fs::path> _interruptedPaths;
+
+    /**
+     * @brief Chooses the transfer mode per file for the configurations in
+     *        the Auto transfer mode.
+     */
+    transfer::TransferSelector _transferSelector;
+
+    /**
+     * @brief The background scrub over the configured data, run if the
+     *        scrub_kib_per_sec option is set.
+     */
+    scrub::Scrubber _scrubber;
+
+    /**
+     * @brief Whether the background scrub is running.
+     */
+    bool _scrubbing{false};
+
+    /**
+     * @brief The paths which the scrub found to differ on the sibling, their
+     *        next sync compares the content of the files by checksum as the
+     *        size and the times may match.
+     */
+    std::set<fs::path> _scrubMismatches;
+
+    /**
+     * @brief Whether the filesystem of a bidirectional config supports the
+     *        origin tag, probed on its first sync.
+     */
+    std::map<const config::DataSyncConfig*, bool> _originTagging;
+
+    /**
+     * @brief The waiters of the in-progress syncs.
+     *
+     * Key: The path being synced
+     * Value: The callbacks to resume once its sync completes
+     */
+    std::map<fs::path, std::vector<std::function<void()>>> _syncDoneWaiters;
+
+    /**
+     * @brief The scheduler lanes of the extra peers, which receive the
+     *        syncs to the sibling BMC as well.
+     */
+    std::vector<std::unique_ptr<peer::PeerLane>> _peerLanes;
+
+    /**
+     * @brief The sequence number of the last batch file
+     */
+    uint64_t _batchSeq{0};
+
+    /**
+     * @brief The changes of a standby configuration.
+     */
+    struct StandbyDirtyPaths
+    {
+        std::set<fs::path> paths;
+
+        // Too many changes to track, the whole configuration is caught up
+        bool overflow{false};
+    };
+
+    /**
+     * @brief The number of the changed paths tracked per standby
+     *        configuration.
+     */
+    static constexpr size_t maxStandbyDirtyPaths = 1024;
+
+    /**
+     * @brief The catch-up syncs of the recorded changes which run at once.
+     */
+    static constexpr size_t maxCatchUpSyncs = 4;
+
+    /**
+     * @brief The recorded changes waiting for their catch-up sync, and the
+     *        number of the tasks syncing them.
+     */
+    std::deque<std::pair<const config::DataSyncConfig*, fs::path>>
+        _catchUpPaths;
+    size_t _catchUpSyncs{0};
+
+    /**
+     * @brief The changes recorded by the standby sync units.
+     *
+     * Key: The standby configuration
+     * Value: Its changed paths
+     */
+    std::map<const config::DataSyncConfig*, StandbyDirtyPaths>
+        _standbyDirtyPaths;
+
+    /**
+     * @brief The delay to gather a burst of metadata changes (e.g. of a
+     *        recursive chmod) into one sync, and the paths synced at most by
+     *        one rsync.
+     */
+    static constexpr auto metadataBatchDelay = std::chrono::milliseconds(100);
+    static constexpr size_t maxMetadataPathsPerSync = 64;
+
+    /**
+     * @brief The delay to let a received sync finish, so that its files are
+     *        backed up as one version.
+     */
+    static constexpr auto backupSettleDelay = std::chrono::seconds(30);
+
+    /**
+     * @brief Whether the received data changed since the last backup was
+     *        taken, and whether a backup task runs to take it.
+     */
+    bool _backupPending{false};
+    bool _backupRunning{false};
+
+    /**
+     * @brief The paths waiting for their metadata sync.
+     *
+     * Key: The configuration of the paths
+     * Value: The paths whose metadata changed
+     */
+    std::map<const config::DataSyncConfig*, std::set<fs::path>>
+        _pendingMetadata;
+
+    /**
+     * @brief The threads which run the blocking filesystem work off the
+     *        event loop. Declared last, so that the running jobs finish
+     *        before the state they were given goes away.
+     */
+    worker::Pool _workers;
 };
 
 } // namespace data_sync
@@ -5,6 +5,7 @@
 #include "notify_service.hpp"
 
 #include "external_data_ifaces.hpp"
+#include "flight_recorder.hpp"
 
 #include <nlohmann/json.hpp>
 #include <phosphor-logging/lg2.hpp>
@@ -30,8 +31,10 @@ nlohmann::json readFromFile(const fs::path& notifyFilePath)
 NotifyService::NotifyService(
     sdbusplus::async::context& ctx,
     data_sync::ext_data::ExternalDataIFaces& extDataIfaces,
-    const fs::path& notifyFilePath, CleanupCallback cleanup) :
-    _ctx(ctx), _extDataIfaces(extDataIfaces), _cleanup(std::move(cleanup))
+    const fs::path& notifyFilePath, CleanupCallback cleanup,
+    clock::Clock& clock, error_log::Aggregator* errorLogs) :
+    _ctx(ctx), _extDataIfaces(extDataIfaces), _clock(clock),
+    _errorLogs(errorLogs), _cleanup(std::move(cleanup))
 {
     _ctx.spawn(init(notifyFilePath));
 }
@@ -64,7 +67,8 @@ sdbusplus::async::task<bool>
             "ATTEMPT", retryAttempt, "MAX", DEFAULT_RETRY_ATTEMPTS, "SERVICE",
             service, "SEC", DEFAULT_RETRY_INTERVAL);
 
-        co_await sleep_for(_ctx, std::chrono::seconds(DEFAULT_RETRY_INTERVAL));
+        co_await _clock.sleepFor(_ctx,
+                                 std::chrono::seconds(DEFAULT_RETRY_INTERVAL));
     }
 
     lg2::error(
@@ -100,9 +104,20 @@ sdbusplus::async::task<>
                 {"DS_Notify_Request", notifyRqstJson.dump()},
                 {"DS_Notify_Msg",
                  "Failed to send systemd notification for the service"}};
-            co_await _extDataIfaces.createErrorLog(
-                "xyz.openbmc_project.RBMC_DataSync.Error.NotifyFailure",
-                ext_data::ErrorLevel::Informational, additionalDetails);
+            static constexpr auto errMsg =
+                "xyz.openbmc_project.RBMC_DataSync.Error.NotifyFailure";
+            if (_errorLogs != nullptr)
+            {
+                co_await _errorLogs->createErrorLog(
+                    errMsg, ext_data::ErrorLevel::Informational, service,
+                    modifiedPath, additionalDetails);
+            }
+            else
+            {
+                co_await _extDataIfaces.createErrorLog(
+                    errMsg, ext_data::ErrorLevel::Informational,
+                    additionalDetails);
+            }
         }
     }
     co_return;
@@ -144,6 +159,9 @@ sdbusplus::async::task<> NotifyService::init(fs::path notifyFilePath)
     else if ((notifyRqstJson["NotifyInfo"]["Mode"] == "Systemd"))
     {
         co_await systemdNotify(notifyRqstJson);
+        recorder::record(
+            recorder::EventType::NotifyApplied,
+            notifyRqstJson["ModifiedDataPath"].get_ref<const std::string&>());
     }
     else
     {
@@ -1,7 +1,9 @@
 // SPDX-License-Identifier: Apache-2.0
 #pragma once
 
+#include "clock.hpp"
 #include "data_sync_config.hpp"
+#include "error_log_aggregator.hpp"
 #include "external_data_ifaces_impl.hpp"
 
 #include <sdbusplus/async.hpp>
@@ -34,10 +36,15 @@ class NotifyService
      * @param[in] notifyFilePath - The root path of the received notify request
      * @param[in] cleanup - Callback function to remove the object from parent
      *                      container
+     * @param[in] clock - The clock to schedule the retries on
+     * @param[in] errorLogs - The aggregator to create the error logs through,
+     *                        if null they are created right away
      */
     NotifyService(sdbusplus::async::context& ctx,
                   data_sync::ext_data::ExternalDataIFaces& extDataIfaces,
-                  const fs::path& notifyFilePath, CleanupCallback cleanup);
+                  const fs::path& notifyFilePath, CleanupCallback cleanup,
+                  clock::Clock& clock = clock::steady(),
+                  error_log::Aggregator* errorLogs = nullptr);
 
   private:
     /**
@@ -87,6 +94,16 @@ class NotifyService
      */
     data_sync::ext_data::ExternalDataIFaces& _extDataIfaces;
 
+    /**
+     * @brief The clock to wait on for the retries
+     */
+    clock::Clock& _clock;
+
+    /**
+     * @brief The aggregator of the error logs, if any
+     */
+    error_log::Aggregator* _errorLogs;
+
     /**
      * @brief  Callback function invoked when notification processing
      *         completes to remove the NotifyService object from the
@@ -9,12 +9,28 @@
 #include <nlohmann/json.hpp>
 #include <phosphor-logging/lg2.hpp>
 
+#include <algorithm>
 #include <cstdlib>
 #include <fstream>
 #include <iostream>
 
 namespace data_sync::notify
 {
+namespace
+{
+
+/**
+ * @brief Check whether the given path is the given base path or under it.
+ */
+bool isSameOrUnder(const fs::path& path, const fs::path& basePath)
+{
+    const auto base = basePath.has_filename() ? basePath
+                                              : basePath.parent_path();
+    return std::ranges::mismatch(base, path).in1 == base.end();
+}
+
+} // namespace
+
 namespace file_operations
 {
 fs::path writeToFile(const auto& jsonData)
@@ -113,4 +129,31 @@ nlohmann::json
     }
 }
 
+std::vector<fs::path> NotifySibling::getPathsToNotify(
+    const config::DataSyncConfig& dataSyncConfig, const fs::path& syncedPath,
+    const std::vector<fs::path>& changedPaths)
+{
+    std::vector<fs::path> pathsToNotify;
+    if (changedPaths.empty() || !dataSyncConfig._notifySibling.has_value())
+    {
+        return pathsToNotify;
+    }
+
+    const auto& notifyOnPaths = dataSyncConfig._notifySibling->_paths;
+    if (!notifyOnPaths.has_value())
+    {
+        pathsToNotify.emplace_back(syncedPath);
+        return pathsToNotify;
+    }
+
+    std::ranges::copy_if(*notifyOnPaths, std::back_inserter(pathsToNotify),
+                         [&changedPaths](const fs::path& notifyPath) {
+        return std::ranges::any_of(changedPaths,
+                                   [&notifyPath](const fs::path& path) {
+            return isSameOrUnder(path, notifyPath);
+        });
+    });
+    return pathsToNotify;
+}
+
 } // namespace data_sync::notify
@@ -5,6 +5,7 @@
 #include "data_sync_config.hpp"
 
 #include <filesystem>
+#include <vector>
 
 namespace data_sync::notify
 {
@@ -33,6 +34,23 @@ class NotifySibling
      */
     fs::path getNotifyFilePath() const;
 
+    /**
+     * @brief API to get the paths to notify the sibling about once a sync
+     *        changed the given paths.
+     *
+     * @param[in] dataSyncConfig - Reference to the synced DataSyncConfig
+     * @param[in] syncedPath - The synced path inside the configured path
+     * @param[in] changedPaths - The paths which the sync changed
+     *
+     * @return The configured NotifyOnPaths which got changed (themselves or
+     *         any path under them). The synced path if no NotifyOnPaths is
+     *         configured and any path got changed. Otherwise none.
+     */
+    static std::vector<fs::path>
+        getPathsToNotify(const config::DataSyncConfig& dataSyncConfig,
+                         const fs::path& syncedPath,
+                         const std::vector<fs::path>& changedPaths);
+
   private:
     /**
      * @brief API to frame the sibling notification request in JSON form.
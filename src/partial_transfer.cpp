@@ -0,0 +1,111 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "partial_transfer.hpp"
+
+#include <phosphor-logging/lg2.hpp>
+
+#include <algorithm>
+#include <vector>
+
+namespace data_sync::partial
+{
+
+namespace
+{
+
+void cleanupStagingDir(const fs::path& stagingDir,
+                       fs::file_time_type oldestKept, CleanupResult& result)
+{
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator(stagingDir, ec))
+    {
+        std::error_code entryEc;
+        if (!entry.is_regular_file(entryEc) ||
+            entry.last_write_time(entryEc) >= oldestKept || entryEc)
+        {
+            continue;
+        }
+
+        const auto size = entry.file_size(entryEc);
+        if (fs::remove(entry.path(), entryEc))
+        {
+            ++result.removedFiles;
+            result.removedBytes += entryEc ? 0 : size;
+        }
+    }
+
+    // Fails if a partial data is still kept
+    fs::remove(stagingDir, ec);
+}
+
+} // namespace
+
+bool isInterrupted(int exitCode) noexcept
+{
+    switch (exitCode)
+    {
+        case 10: // error in socket I/O
+        case 12: // error in rsync protocol data stream
+        case 20: // received SIGUSR1 or SIGINT
+        case 30: // timeout in data send/receive
+        case 35: // timeout waiting for daemon connection
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool isStaging(const fs::path& path)
+{
+    return std::ranges::any_of(
+        path, [](const fs::path& part) { return part == stagingDirName; });
+}
+
+CleanupResult cleanupStaging(const fs::path& dir, bool recursive,
+                             std::chrono::seconds maxAge)
+{
+    CleanupResult result;
+    const auto oldestKept = fs::file_time_type::clock::now() - maxAge;
+
+    std::error_code ec;
+    if (fs::is_directory(dir / stagingDirName, ec))
+    {
+        cleanupStagingDir(dir / stagingDirName, oldestKept, result);
+    }
+
+    if (!recursive)
+    {
+        return result;
+    }
+
+    std::vector<fs::path> stagingDirs;
+    for (auto it = fs::recursive_directory_iterator(
+             dir, fs::directory_options::skip_permission_denied, ec);
+         !ec && it != fs::recursive_directory_iterator(); it.increment(ec))
+    {
+        std::error_code entryEc;
+        if (it->path().filename() == stagingDirName &&
+            it->is_directory(entryEc))
+        {
+            stagingDirs.push_back(it->path());
+            it.disable_recursion_pending();
+        }
+    }
+    if (ec)
+    {
+        lg2::debug("Failed to walk {DIR} for the partial data : {ERROR}",
+                   "DIR", dir, "ERROR", ec.message());
+    }
+
+    for (const auto& stagingDir : stagingDirs)
+    {
+        // The top one is done already
+        if (stagingDir != dir / stagingDirName)
+        {
+            cleanupStagingDir(stagingDir, oldestKept, result);
+        }
+    }
+    return result;
+}
+
+} // namespace data_sync::partial
@@ -0,0 +1,69 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+
+namespace data_sync::partial
+{
+
+namespace fs = std::filesystem;
+
+/**
+ * @brief The staging directory, relative to the directory of each
+ *        transferred file on the receiver, where rsync keeps the partial data
+ *        of an interrupted transfer for the next attempt to resume from.
+ *
+ * @note rsync excludes a relative partial directory from the transfer and
+ *       from the deletion on its own.
+ */
+constexpr auto stagingDirName = ".pds-partial";
+
+/**
+ * @brief The age after which the unclaimed partial data is removed, and the
+ *        interval to look for it.
+ */
+constexpr auto maxStagingAge = std::chrono::hours(24);
+constexpr auto stagingCleanupInterval = std::chrono::hours(1);
+
+/**
+ * @brief Check whether the given rsync exit code is of an interrupted
+ *        transfer, which keeps the partial data on the receiver.
+ *
+ * @param[in] exitCode - The rsync exit code
+ *
+ * @return true if interrupted; otherwise false
+ */
+bool isInterrupted(int exitCode) noexcept;
+
+/**
+ * @brief Check whether the given path is (or is under) a staging directory.
+ */
+bool isStaging(const fs::path& path);
+
+/**
+ * @brief The outcome of a staging cleanup.
+ */
+struct CleanupResult
+{
+    size_t removedFiles{0};
+    uintmax_t removedBytes{0};
+};
+
+/**
+ * @brief Remove the partial data older than the given age from the staging
+ *        directories, and the staging directories left empty.
+ *
+ * @param[in] dir - The directory whose staging directory to clean up
+ * @param[in] recursive - Whether to clean up the staging directories of all
+ *                        the subdirectories as well
+ * @param[in] maxAge - The age of the partial data to remove
+ *
+ * @return The removed partial data
+ */
+CleanupResult cleanupStaging(const fs::path& dir, bool recursive,
+                             std::chrono::seconds maxAge);
+
+} // namespace data_sync::partial
@@ -0,0 +1,289 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "peer_lane.hpp"
+
+#include "async_command_exec.hpp"
+#include "data_sync_config.hpp"
+
+#include <phosphor-logging/lg2.hpp>
+
+#include <experimental/scope>
+#include <fstream>
+#include <stdexcept>
+
+namespace data_sync::peer
+{
+
+namespace
+{
+
+/**
+ * @brief The defaults of the circuit breaker of a peer.
+ */
+constexpr uint8_t defaultFailureThreshold = 3;
+constexpr auto defaultOpenInterval = std::chrono::seconds(60);
+
+} // namespace
+
+PeerConfig::PeerConfig(const nlohmann::json& json) :
+    _name(json.at("Name").get<std::string>()),
+    _url(json.at("URL").get<std::string>()),
+    _failureThreshold(
+        json.value("FailureThreshold", defaultFailureThreshold)),
+    _openInterval(defaultOpenInterval)
+{
+    if (_url.empty())
+    {
+        throw std::invalid_argument("Empty URL of the peer " + _name);
+    }
+
+    if (_failureThreshold == 0)
+    {
+        throw std::invalid_argument("Zero FailureThreshold of the peer " +
+                                    _name);
+    }
+
+    if (json.contains("OpenInterval"))
+    {
+        const auto openInterval =
+            config::DataSyncConfig::convertISODurationToSec(
+                json["OpenInterval"].get<std::string>());
+        if (!openInterval.has_value())
+        {
+            throw std::invalid_argument("Invalid OpenInterval of the peer " +
+                                        _name);
+        }
+        _openInterval = openInterval.value();
+    }
+}
+
+std::vector<PeerConfig> parsePeers(const fs::path& peersFile)
+{
+    std::vector<PeerConfig> peers;
+    if (!fs::exists(peersFile))
+    {
+        return peers;
+    }
+
+    std::ifstream file(peersFile);
+    const auto peersJSON = nlohmann::json::parse(file);
+    for (const auto& peer : peersJSON.at("Peers"))
+    {
+        peers.emplace_back(peer);
+    }
+    return peers;
+}
+
+CircuitBreaker::CircuitBreaker(uint8_t failureThreshold,
+                               clock::Duration openInterval) :
+    _failureThreshold(failureThreshold), _openInterval(openInterval)
+{}
+
+bool CircuitBreaker::allow(clock::TimePoint now)
+{
+    if (_state == State::Open)
+    {
+        if (now < _openUntil)
+        {
+            return false;
+        }
+        _state = State::HalfOpen;
+    }
+    return true;
+}
+
+void CircuitBreaker::onSuccess() noexcept
+{
+    _state = State::Closed;
+    _failures = 0;
+}
+
+bool CircuitBreaker::onFailure(clock::TimePoint now)
+{
+    if (_failures < _failureThreshold)
+    {
+        ++_failures;
+    }
+
+    // A failed probe opens it again right away
+    if (_state == State::Open ||
+        (_state == State::Closed && _failures < _failureThreshold))
+    {
+        return false;
+    }
+    _state = State::Open;
+    _openUntil = now + _openInterval;
+    return true;
+}
+
+clock::Duration CircuitBreaker::retryAfter(clock::TimePoint now) const
+{
+    if (_state != State::Open || now >= _openUntil)
+    {
+        return clock::Duration::zero();
+    }
+    return _openUntil - now;
+}
+
+bool fitsInBatch(const fs::path& path, uintmax_t limit)
+{
+    std::error_code ec;
+    if (!fs::is_directory(path, ec))
+    {
+        const auto size = fs::file_size(path, ec);
+        return !ec && size <= limit;
+    }
+
+    uintmax_t total{0};
+    fs::recursive_directory_iterator it(path, ec);
+    for (; !ec && it != fs::recursive_directory_iterator(); it.increment(ec))
+    {
+        if (!it->is_regular_file(ec))
+        {
+            continue;
+        }
+        // A file removed meanwhile isn't synced either
+        const auto size = it->file_size(ec);
+        total += ec ? 0 : size;
+        if (total > limit)
+        {
+            return false;
+        }
+    }
+    return !ec;
+}
+
+BatchFile::BatchFile(fs::path path) : _path(std::move(path)) {}
+
+BatchFile::~BatchFile()
+{
+    // rsync writes a shell script along with the batch to replay it
+    std::error_code ec;
+    fs::remove(_path, ec);
+    fs::remove(_path.string() + ".sh", ec);
+}
+
+PeerLane::PeerLane(sdbusplus::async::context& ctx, clock::Clock& clock,
+                   PeerConfig config) :
+    _ctx(ctx), _clock(clock), _config(std::move(config)),
+    _breaker(_config._failureThreshold, _config._openInterval)
+{}
+
+void PeerLane::submit(Transfer transfer)
+{
+    _queue.push_back(std::move(transfer));
+    if (!_draining)
+    {
+        _draining = true;
+        _ctx.spawn(drain());
+    }
+}
+
+// NOLINTNEXTLINE
+sdbusplus::async::task<> PeerLane::drain()
+{
+    auto cleanup =
+        std::experimental::scope_exit([this]() { _draining = false; });
+
+    // The backlog is retried once per drain (and once per reopen), so that
+    // a path which the peer keeps rejecting isn't retried in a loop.
+    bool backlogTried{false};
+
+    while (!_ctx.stop_requested())
+    {
+        if (!_breaker.allow(_clock.now()))
+        {
+            // The peer misses these batches, so resync the paths later
+            for (auto& transfer : _queue)
+            {
+                _backlog.insert_or_assign(transfer.path,
+                                          std::move(transfer.resyncCmd));
+            }
+            _queue.clear();
+
+            co_await _clock.sleepFor(_ctx, _breaker.retryAfter(_clock.now()));
+            backlogTried = false;
+            continue;
+        }
+
+        if (!_queue.empty())
+        {
+            auto transfer = std::move(_queue.front());
+            _queue.pop_front();
+
+            const bool missedBatch = _backlog.erase(transfer.path) != 0;
+            const auto& cmd = (missedBatch || !transfer.batch)
+                                  ? transfer.resyncCmd
+                                  : transfer.replayCmd;
+            // NOLINTNEXTLINE
+            if (!co_await run(transfer.path, cmd))
+            {
+                _backlog.insert_or_assign(transfer.path,
+                                          std::move(transfer.resyncCmd));
+            }
+            continue;
+        }
+
+        if (_backlog.empty() || backlogTried)
+        {
+            break;
+        }
+
+        backlogTried = true;
+        lg2::info("Resyncing {COUNT} paths to the peer {PEER}", "COUNT",
+                  _backlog.size(), "PEER", _config._name);
+        auto backlog = std::exchange(_backlog, {});
+        for (auto& [path, cmd] : backlog)
+        {
+            // NOLINTNEXTLINE
+            if (!_breaker.allow(_clock.now()) || !co_await run(path, cmd))
+            {
+                // A newer transfer of the path may be in the backlog already
+                _backlog.try_emplace(path, std::move(cmd));
+            }
+        }
+    }
+    co_return;
+}
+
+// NOLINTNEXTLINE
+sdbusplus::async::task<bool> PeerLane::run(const fs::path& path,
+                                           const std::string& cmd)
+{
+    lg2::debug("Rsync command to the peer {PEER}: {CMD}", "PEER",
+               _config._name, "CMD", cmd);
+
+    data_sync::async::AsyncCommandExecutor executor(_ctx);
+    std::pair<int, std::string> result;
+    {
+        clock::BusyScope busy(_clock);
+        // NOLINTNEXTLINE
+        result = co_await executor.execCmd(cmd);
+    }
+
+    if (result.first == 0 || result.first == 24)
+    {
+        if (_breaker.state() != CircuitBreaker::State::Closed)
+        {
+            lg2::info("The peer {PEER} is reachable again", "PEER",
+                      _config._name);
+        }
+        _breaker.onSuccess();
+        co_return true;
+    }
+
+    lg2::warning("Failed to transfer [{PATH}] to the peer {PEER}, ErrCode: "
+                 "{ERRCODE}, ErrMsg: {ERRMSG}",
+                 "PATH", path, "PEER", _config._name, "ERRCODE", result.first,
+                 "ERRMSG", result.second);
+    if (_breaker.onFailure(_clock.now()))
+    {
+        lg2::error("Stopping the transfers to the peer {PEER} for {INTERVAL}s "
+                   "after the consecutive failures",
+                   "PEER", _config._name, "INTERVAL",
+                   _config._openInterval.count());
+    }
+    co_return false;
+}
+
+} // namespace data_sync::peer
@@ -0,0 +1,291 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "clock.hpp"
+
+#include <nlohmann/json.hpp>
+#include <sdbusplus/async.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace data_sync::peer
+{
+
+namespace fs = std::filesystem;
+
+/**
+ * @brief The structure contains the details of an extra peer which receives
+ *        the synced data besides the sibling BMC.
+ */
+struct PeerConfig
+{
+    /**
+     * @brief The constructor
+     *
+     * @param[in] json - The JSON object of the peer
+     *
+     * @throw std::exception if a required field is missing or invalid
+     */
+    explicit PeerConfig(const nlohmann::json& json);
+
+    /**
+     * @brief The name of the peer, used in the logs
+     */
+    std::string _name;
+
+    /**
+     * @brief The rsync URL of the peer's module, e.g.
+     *        "rsync://backup-bmc:873/bmc_fs"
+     */
+    std::string _url;
+
+    /**
+     * @brief The consecutive failures which open the circuit breaker of the
+     *        peer, and the time it stays open before the next attempt.
+     */
+    uint8_t _failureThreshold;
+    std::chrono::seconds _openInterval;
+};
+
+/**
+ * @brief Parse the extra peers from the given configuration file.
+ *
+ * @param[in] peersFile - The peers configuration file
+ *
+ * @return The configured peers, none if the file doesn't exist
+ *
+ * @throw std::exception if the file is invalid
+ */
+std::vector<PeerConfig> parsePeers(const fs::path& peersFile);
+
+/**
+ * @brief The largest data a sync writes a batch for. The batch directory is
+ *        in memory, so the bigger transfers are synced to the peers from
+ *        scratch instead.
+ */
+constexpr uintmax_t maxBatchBytes = 16 * 1024 * 1024;
+
+/**
+ * @brief Check whether the data under the given path fits in a batch.
+ *
+ * @param[in] path - The file or directory to sync
+ * @param[in] limit - The largest size of the batched data
+ *
+ * @return true if the data is at most the limit; otherwise false, also if
+ *         the path can't be sized
+ */
+bool fitsInBatch(const fs::path& path, uintmax_t limit = maxBatchBytes);
+
+/**
+ * @class CircuitBreaker
+ *
+ * @brief Stops the transfers to an unreachable peer after the consecutive
+ *        failures, and lets a single probe through once the open interval
+ *        elapsed.
+ */
+class CircuitBreaker
+{
+  public:
+    enum class State
+    {
+        Closed,
+        Open,
+        HalfOpen
+    };
+
+    /**
+     * @brief The constructor
+     *
+     * @param[in] failureThreshold - The consecutive failures to open
+     * @param[in] openInterval - The time to stay open
+     */
+    CircuitBreaker(uint8_t failureThreshold, clock::Duration openInterval);
+
+    /**
+     * @brief Check whether a transfer can be attempted, an open breaker
+     *        turns half-open once the open interval elapsed.
+     *
+     * @param[in] now - The current time
+     */
+    bool allow(clock::TimePoint now);
+
+    /**
+     * @brief Account a successful transfer, which closes the breaker.
+     */
+    void onSuccess() noexcept;
+
+    /**
+     * @brief Account a failed transfer.
+     *
+     * @param[in] now - The current time
+     *
+     * @return true if the breaker opened; otherwise false
+     */
+    bool onFailure(clock::TimePoint now);
+
+    /**
+     * @brief Get the time left until the open breaker lets a probe through.
+     */
+    clock::Duration retryAfter(clock::TimePoint now) const;
+
+    State state() const noexcept
+    {
+        return _state;
+    }
+
+  private:
+    uint8_t _failureThreshold;
+    clock::Duration _openInterval;
+    State _state{State::Closed};
+    uint8_t _failures{0};
+    clock::TimePoint _openUntil;
+};
+
+/**
+ * @class BatchFile
+ *
+ * @brief Owns an rsync batch file written by a sync to the sibling, the
+ *        transfer is prepared once and replayed to every peer. The file is
+ *        removed once the last peer is done with it.
+ */
+class BatchFile
+{
+  public:
+    BatchFile(const BatchFile&) = delete;
+    BatchFile& operator=(const BatchFile&) = delete;
+    BatchFile(BatchFile&&) = delete;
+    BatchFile& operator=(BatchFile&&) = delete;
+
+    explicit BatchFile(fs::path path);
+    ~BatchFile();
+
+    const fs::path& path() const noexcept
+    {
+        return _path;
+    }
+
+  private:
+    fs::path _path;
+};
+
+/**
+ * @brief A transfer of a synced path to a peer.
+ */
+struct Transfer
+{
+    /**
+     * @brief The synced path, or the configured path if the whole
+     *        configuration got synced
+     */
+    fs::path path;
+
+    /**
+     * @brief The batch of the sync, null if the sync wrote none
+     */
+    std::shared_ptr<const BatchFile> batch;
+
+    /**
+     * @brief The command to replay the batch to the peer, and the command to
+     *        sync the path to the peer from scratch in case the peer missed
+     *        an earlier batch of it.
+     */
+    std::string replayCmd;
+    std::string resyncCmd;
+};
+
+/**
+ * @class PeerLane
+ *
+ * @brief The scheduler lane of an extra peer, which replays the transfers to
+ *        the peer in order and independently of the other peers.
+ *
+ * The lane keeps the paths whose transfer it skipped (while the circuit
+ * breaker is open) or which failed in its backlog, and resyncs them from
+ * scratch once the peer is reachable again, as a replayed batch is only
+ * valid on top of the previous ones.
+ */
+class PeerLane
+{
+  public:
+    PeerLane(const PeerLane&) = delete;
+    PeerLane& operator=(const PeerLane&) = delete;
+    PeerLane(PeerLane&&) = delete;
+    PeerLane& operator=(PeerLane&&) = delete;
+    ~PeerLane() = default;
+
+    /**
+     * @brief The constructor
+     *
+     * @param[in] ctx - The async context
+     * @param[in] clock - The clock of the circuit breaker
+     * @param[in] config - The peer
+     */
+    PeerLane(sdbusplus::async::context& ctx, clock::Clock& clock,
+             PeerConfig config);
+
+    /**
+     * @brief Queue the given transfer to the peer.
+     */
+    void submit(Transfer transfer);
+
+    const PeerConfig& config() const noexcept
+    {
+        return _config;
+    }
+
+    /**
+     * @brief Check whether the lane runs the transfers now, i.e. the circuit
+     *        breaker of the peer isn't open. The transfers submitted
+     *        meanwhile go to the backlog without their batch.
+     */
+    bool accepting() const
+    {
+        return _breaker.retryAfter(_clock.now()) == clock::Duration::zero();
+    }
+
+    /**
+     * @brief Get the number of the paths waiting for a resync.
+     */
+    size_t backlogSize() const noexcept
+    {
+        return _backlog.size();
+    }
+
+  private:
+    /**
+     * @brief Run the queued transfers and the backlog until both are empty.
+     */
+    sdbusplus::async::task<> drain();
+
+    /**
+     * @brief Run the given rsync command to the peer and account the result
+     *        in the circuit breaker.
+     *
+     * @return true on success; otherwise false
+     */
+    sdbusplus::async::task<bool> run(const fs::path& path,
+                                     const std::string& cmd);
+
+    sdbusplus::async::context& _ctx;
+    clock::Clock& _clock;
+    PeerConfig _config;
+    CircuitBreaker _breaker;
+    std::deque<Transfer> _queue;
+
+    /**
+     * @brief The paths to resync, and their resync command
+     */
+    std::map<fs::path, std::string> _backlog;
+
+    bool _draining{false};
+};
+
+} // namespace data_sync::peer
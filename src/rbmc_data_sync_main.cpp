@@ -3,7 +3,9 @@
 #include "config.h"
 
 #include "external_data_ifaces_impl.hpp"
+#include "io_ring.hpp"
 #include "manager.hpp"
+#include "tls_transport.hpp"
 #include "utility.hpp"
 
 #include <phosphor-logging/lg2.hpp>
@@ -45,6 +47,14 @@ int main()
     sdbusplus::async::context ctx;
     sdbusplus::server::manager_t objManager{ctx, SyncBMCData::instance_path};
 
+    // The reads of the event loop go through io_uring where available, the
+    // ring is set up ahead of the watchers and goes away after them.
+    auto ioRing = data_sync::io::start(ctx);
+
+    // The rsync connections to the sibling go over the TLS session of the
+    // transport thread where built with it, in place of stunnel.
+    auto tlsTransport = data_sync::tls::start();
+
     data_sync::Manager manager{
         ctx, std::make_unique<data_sync::ext_data::ExternalDataIFacesImpl>(ctx),
         DATA_SYNC_CONFIG_DIR};
@@ -0,0 +1,160 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "scrubber.hpp"
+
+#include "partial_transfer.hpp"
+
+#include <algorithm>
+
+namespace data_sync::scrub
+{
+
+namespace
+{
+
+/**
+ * @brief Check whether the given path is excluded by the configuration.
+ */
+bool isExcluded(const config::DataSyncConfig& dataSyncCfg,
+                const fs::path& path)
+{
+    return dataSyncCfg._excludeList.has_value() &&
+           dataSyncCfg._excludeList->first.contains(path);
+}
+
+void listTree(const config::DataSyncConfig& dataSyncCfg, const fs::path& root,
+              std::vector<ScrubFile>& files)
+{
+    std::error_code ec;
+    if (fs::is_regular_file(root, ec))
+    {
+        files.push_back({root, fs::file_size(root, ec)});
+        return;
+    }
+
+    for (auto it = fs::recursive_directory_iterator(
+             root, fs::directory_options::skip_permission_denied, ec);
+         !ec && it != fs::recursive_directory_iterator(); it.increment(ec))
+    {
+        std::error_code entryEc;
+        const auto& path = it->path();
+        if (isExcluded(dataSyncCfg, path) ||
+            isExcluded(dataSyncCfg, path / "") || partial::isStaging(path))
+        {
+            if (it->is_directory(entryEc))
+            {
+                it.disable_recursion_pending();
+            }
+            continue;
+        }
+
+        if (it->is_regular_file(entryEc))
+        {
+            const auto size = it->file_size(entryEc);
+            if (!entryEc)
+            {
+                files.push_back({path, size});
+            }
+        }
+    }
+}
+
+} // namespace
+
+std::vector<ScrubFile> listFiles(const config::DataSyncConfig& dataSyncCfg)
+{
+    std::vector<ScrubFile> files;
+    if (dataSyncCfg._includeList.has_value())
+    {
+        for (const auto& includePath : *dataSyncCfg._includeList)
+        {
+            listTree(dataSyncCfg, includePath, files);
+        }
+    }
+    else
+    {
+        listTree(dataSyncCfg, dataSyncCfg._path, files);
+    }
+    return files;
+}
+
+Scrubber::Scrubber(uint64_t bytesPerSec) :
+    _bytesPerSec(std::max<uint64_t>(bytesPerSec, 1))
+{}
+
+void Scrubber::startPass(
+    std::vector<std::pair<const config::DataSyncConfig*,
+                          std::vector<ScrubFile>>>&& files,
+    clock::TimePoint now)
+{
+    _pending.clear();
+    for (auto& [cfg, cfgFiles] : files)
+    {
+        for (auto& file : cfgFiles)
+        {
+            _pending.emplace_back(cfg, std::move(file));
+        }
+    }
+    _pass = {.totalFiles = _pending.size(),
+             .scrubbedFiles = 0,
+             .scrubbedBytes = 0,
+             .mismatches = 0,
+             .startTime = now};
+    _started = true;
+}
+
+std::optional<Chunk> Scrubber::nextChunk()
+{
+    if (_pending.empty())
+    {
+        return std::nullopt;
+    }
+
+    const auto sliceBytes =
+        _bytesPerSec *
+        static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::seconds>(sliceInterval)
+                .count());
+
+    Chunk chunk{.cfg = _pending.front().first, .paths = {}, .bytes = 0};
+    while (!_pending.empty() && _pending.front().first == chunk.cfg &&
+           chunk.paths.size() < maxChunkFiles &&
+           (chunk.paths.empty() ||
+            chunk.bytes + _pending.front().second.size <= sliceBytes))
+    {
+        chunk.bytes += _pending.front().second.size;
+        chunk.paths.emplace_back(std::move(_pending.front().second.path));
+        _pending.pop_front();
+    }
+    return chunk;
+}
+
+void Scrubber::onScrubbed(const Chunk& chunk, size_t mismatches)
+{
+    _pass.scrubbedFiles += chunk.paths.size();
+    _pass.scrubbedBytes += chunk.bytes;
+    _pass.mismatches += mismatches;
+}
+
+clock::Duration Scrubber::pause(const Chunk& chunk) const
+{
+    // A big file alone takes the slices of all its bytes
+    const auto budgetTime =
+        std::chrono::duration_cast<clock::Duration>(std::chrono::duration<
+                                                    double>(
+            static_cast<double>(chunk.bytes) /
+            static_cast<double>(_bytesPerSec)));
+    return std::max<clock::Duration>(budgetTime, sliceInterval);
+}
+
+clock::Duration Scrubber::untilNextPass(clock::TimePoint now) const
+{
+    if (!_started)
+    {
+        return clock::Duration::zero();
+    }
+    return std::max<clock::Duration>(
+        _pass.startTime + minPassInterval - now, clock::Duration::zero());
+}
+
+} // namespace data_sync::scrub
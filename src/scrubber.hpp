@@ -0,0 +1,184 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "clock.hpp"
+#include "data_sync_config.hpp"
+
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace data_sync::scrub
+{
+
+namespace fs = std::filesystem;
+
+/**
+ * @brief The files compared with the sibling's copies in a single rsync.
+ */
+constexpr size_t maxChunkFiles = 32;
+
+/**
+ * @brief The time slice of a chunk, a chunk holds the bytes of the budget
+ *        for it and the next one starts once it has passed.
+ */
+constexpr auto sliceInterval = std::chrono::seconds(1);
+
+/**
+ * @brief The minimum interval between the starts of two passes over the
+ *        configured data, so that a small data set isn't walked over and
+ *        over again.
+ */
+constexpr auto minPassInterval = std::chrono::hours(1);
+
+/**
+ * @brief A file to scrub.
+ */
+struct ScrubFile
+{
+    fs::path path;
+    uintmax_t size{0};
+};
+
+/**
+ * @brief The files of a configuration compared with the sibling's copies
+ *        together.
+ */
+struct Chunk
+{
+    const config::DataSyncConfig* cfg{nullptr};
+    std::vector<fs::path> paths;
+    uintmax_t bytes{0};
+};
+
+/**
+ * @brief The progress of a pass over the configured data.
+ */
+struct PassStats
+{
+    size_t totalFiles{0};
+    size_t scrubbedFiles{0};
+    uintmax_t scrubbedBytes{0};
+
+    /**
+     * @brief The files found to differ from the sibling's copies
+     */
+    size_t mismatches{0};
+
+    clock::TimePoint startTime{};
+};
+
+/**
+ * @brief List the regular files of a configuration, leaving out the
+ *        excluded paths and the partial transfer staging directories.
+ *
+ * @param[in] dataSyncCfg - The configuration
+ *
+ * @return The files with their sizes
+ */
+std::vector<ScrubFile> listFiles(const config::DataSyncConfig& dataSyncCfg);
+
+/**
+ * @class Scrubber
+ *
+ * @brief Splits the passes of the background scrub over the configured data
+ *        into time-sliced chunks within its I/O budget.
+ *
+ * The scrub compares the checksums of the files with the ones of the
+ * sibling's copies to find the divergence which the event driven syncs
+ * missed, e.g. a manual edit on the sibling or a bit flip on its flash.
+ *
+ * @note Not thread-safe, all updates are expected from the event loop thread.
+ */
+class Scrubber
+{
+  public:
+    /**
+     * @brief The constructor
+     *
+     * @param[in] bytesPerSec - The bytes to read per second at most
+     */
+    explicit Scrubber(uint64_t bytesPerSec);
+
+    /**
+     * @brief Start a pass over the given files.
+     *
+     * @param[in] files - The files to scrub per configuration
+     * @param[in] now - The start time of the pass
+     */
+    void startPass(std::vector<std::pair<const config::DataSyncConfig*,
+                                         std::vector<ScrubFile>>>&& files,
+                   clock::TimePoint now);
+
+    /**
+     * @brief Check whether the files of the current pass are all scrubbed.
+     */
+    bool passDone() const noexcept
+    {
+        return _pending.empty();
+    }
+
+    /**
+     * @brief Take the next chunk of the current pass, the files of a single
+     *        configuration up to the budget of a time slice, at least one.
+     *
+     * @return The chunk, or nullopt once the pass is done
+     */
+    std::optional<Chunk> nextChunk();
+
+    /**
+     * @brief Account a scrubbed chunk.
+     *
+     * @param[in] chunk - The chunk
+     * @param[in] mismatches - The files of it which differ on the sibling
+     */
+    void onScrubbed(const Chunk& chunk, size_t mismatches);
+
+    /**
+     * @brief Get the time to wait after the given chunk to keep the reads
+     *        within the budget.
+     */
+    clock::Duration pause(const Chunk& chunk) const;
+
+    /**
+     * @brief Get the time to wait before the next pass can start.
+     *
+     * @param[in] now - The current time
+     */
+    clock::Duration untilNextPass(clock::TimePoint now) const;
+
+    /**
+     * @brief Get the progress of the current pass.
+     */
+    const PassStats& pass() const noexcept
+    {
+        return _pass;
+    }
+
+  private:
+    /**
+     * @brief The read budget in bytes per second.
+     */
+    uint64_t _bytesPerSec;
+
+    /**
+     * @brief The files of the current pass yet to scrub.
+     */
+    std::deque<std::pair<const config::DataSyncConfig*, ScrubFile>> _pending;
+
+    /**
+     * @brief The progress of the current pass.
+     */
+    PassStats _pass;
+
+    /**
+     * @brief Whether any pass has started yet.
+     */
+    bool _started{false};
+};
+
+} // namespace data_sync::scrub
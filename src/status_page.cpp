@@ -0,0 +1,205 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "status_page.hpp"
+
+#include "utility.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <phosphor-logging/lg2.hpp>
+
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+
+namespace data_sync::status
+{
+
+uint64_t nowInUs()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+
+void copyPath(char (&dest)[maxPathLen], std::string_view path)
+{
+    if (path.size() >= maxPathLen)
+    {
+        // Keep the tail as it is the most meaningful part of the path.
+        path.remove_prefix(path.size() - (maxPathLen - 1));
+    }
+    std::memset(dest, '\0', maxPathLen);
+    std::memcpy(dest, path.data(), path.size());
+}
+
+StatusPageWriter::StatusPageWriter(const fs::path& pagePath) :
+    _pagePath(pagePath)
+{
+    std::error_code ec;
+    fs::create_directories(_pagePath.parent_path(), ec);
+
+    // Always start with a fresh page, so that the readers which mapped the
+    // page of the previous daemon instance won't see the new counters mixed
+    // with the old ones.
+    fs::remove(_pagePath, ec);
+
+    utility::FD pageFd(
+        open(_pagePath.c_str(), O_CREAT | O_EXCL | O_RDWR | O_CLOEXEC, 0644));
+    if (pageFd() < 0)
+    {
+        lg2::error("Failed to create the status page [{PATH}], error : {ERROR}",
+                   "PATH", _pagePath, "ERROR", strerror(errno));
+        return;
+    }
+
+    if (ftruncate(pageFd(), sizeof(Page)) != 0)
+    {
+        lg2::error("Failed to size the status page [{PATH}], error : {ERROR}",
+                   "PATH", _pagePath, "ERROR", strerror(errno));
+        fs::remove(_pagePath, ec);
+        return;
+    }
+
+    void* addr = mmap(nullptr, sizeof(Page), PROT_READ | PROT_WRITE,
+                      MAP_SHARED, pageFd(), 0);
+    if (addr == MAP_FAILED)
+    {
+        lg2::error("Failed to map the status page [{PATH}], error : {ERROR}",
+                   "PATH", _pagePath, "ERROR", strerror(errno));
+        fs::remove(_pagePath, ec);
+        return;
+    }
+
+    // The file is zero filled by ftruncate, so only the header is required.
+    _page = static_cast<Page*>(addr);
+    _page->version = pageVersion;
+    _page->configCapacity = maxConfigs;
+    _page->daemonPid = static_cast<uint32_t>(getpid());
+    _page->updatedTimeUs = nowInUs();
+
+    // Publish the magic at last, readers treat the page as valid only then.
+    std::atomic_thread_fence(std::memory_order_release);
+    _page->magic = pageMagic;
+}
+
+StatusPageWriter::~StatusPageWriter()
+{
+    if (_page != nullptr)
+    {
+        munmap(_page, sizeof(Page));
+        std::error_code ec;
+        fs::remove(_pagePath, ec);
+    }
+}
+
+std::optional<size_t> StatusPageWriter::configSlot(const fs::path& cfgPath)
+{
+    if (_page == nullptr)
+    {
+        return std::nullopt;
+    }
+
+    char pathInPage[maxPathLen];
+    copyPath(pathInPage, cfgPath.native());
+
+    for (size_t slot = 0; slot < _page->configCount; ++slot)
+    {
+        if (std::strncmp(_page->configs[slot].path, pathInPage, maxPathLen) ==
+            0)
+        {
+            return slot;
+        }
+    }
+
+    if (_page->configCount >= maxConfigs)
+    {
+        lg2::debug("No status page slot left for [{PATH}]", "PATH", cfgPath);
+        return std::nullopt;
+    }
+
+    size_t slot = _page->configCount;
+    update([&pathInPage, slot](Page& page) {
+        std::memcpy(page.configs[slot].path, pathInPage, maxPathLen);
+        page.configCount = slot + 1;
+    });
+    return slot;
+}
+
+StatusPageReader::StatusPageReader(const fs::path& pagePath)
+{
+    utility::FD pageFd(open(pagePath.c_str(), O_RDONLY | O_CLOEXEC));
+    if (pageFd() < 0)
+    {
+        throw std::runtime_error("Failed to open the status page " +
+                                 pagePath.string() + " : " +
+                                 std::strerror(errno));
+    }
+
+    struct stat pageStat{};
+    if (fstat(pageFd(), &pageStat) != 0 ||
+        static_cast<size_t>(pageStat.st_size) < sizeof(Page))
+    {
+        throw std::runtime_error("Unexpected status page size " +
+                                 pagePath.string());
+    }
+
+    void* addr = mmap(nullptr, sizeof(Page), PROT_READ, MAP_SHARED, pageFd(),
+                      0);
+    if (addr == MAP_FAILED)
+    {
+        throw std::runtime_error("Failed to map the status page " +
+                                 pagePath.string() + " : " +
+                                 std::strerror(errno));
+    }
+    _page = static_cast<const Page*>(addr);
+
+    if (_page->magic != pageMagic || _page->version != pageVersion)
+    {
+        munmap(const_cast<Page*>(_page), sizeof(Page)); // NOLINT
+        _page = nullptr;
+        throw std::runtime_error("Invalid or unsupported status page " +
+                                 pagePath.string());
+    }
+}
+
+StatusPageReader::~StatusPageReader()
+{
+    if (_page != nullptr)
+    {
+        munmap(const_cast<Page*>(_page), sizeof(Page)); // NOLINT
+    }
+}
+
+std::optional<Page> StatusPageReader::snapshot() const
+{
+    // The page is mapped read-only, the atomic loads don't modify it.
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+    std::atomic_ref<uint32_t> sequence(const_cast<Page*>(_page)->sequence);
+
+    constexpr auto maxAttempts = 1000;
+    Page copy{};
+    for (auto attempt = 0; attempt < maxAttempts; ++attempt)
+    {
+        const auto begin = sequence.load(std::memory_order_acquire);
+        if ((begin & 1U) != 0)
+        {
+            // Writer is in the middle of an update
+            continue;
+        }
+
+        std::memcpy(&copy, _page, sizeof(Page));
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        if (sequence.load(std::memory_order_relaxed) == begin)
+        {
+            return copy;
+        }
+    }
+    return std::nullopt;
+}
+
+} // namespace data_sync::status
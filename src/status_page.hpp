@@ -0,0 +1,310 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace data_sync::status
+{
+
+namespace fs = std::filesystem;
+
+/**
+ * @brief Identifies a valid status page ("DSSP") and its layout version.
+ *
+ * Readers must reject a page if either of them doesn't match, the layout of
+ * the page is only extended by bumping the version.
+ */
+constexpr uint32_t pageMagic = 0x50535344;
+constexpr uint16_t pageVersion = 5;
+
+/**
+ * @brief The maximum number of configured paths tracked in the page and the
+ *        maximum length of a path stored in it (including the terminator).
+ */
+constexpr size_t maxConfigs = 128;
+constexpr size_t maxPathLen = 128;
+
+/**
+ * @brief The per configured path sync counters.
+ *
+ * All the counters are monotonic from the daemon start, so readers can derive
+ * rates by diffing two snapshots.
+ */
+struct SyncStats
+{
+    /**
+     * @brief The configured path, truncated from the front if it doesn't fit.
+     */
+    char path[maxPathLen];
+
+    uint64_t syncsStarted;
+    uint64_t syncsSucceeded;
+    uint64_t syncsFailed;
+    uint64_t retries;
+
+    /**
+     * @brief The sum of "Literal data" bytes reported by rsync.
+     */
+    uint64_t bytesTransferred;
+
+    /**
+     * @brief The CLOCK_REALTIME timestamp (in microseconds) and duration of
+     *        the last finished sync attempt.
+     */
+    uint64_t lastSyncTimeUs;
+    uint64_t lastSyncDurationUs;
+    int32_t lastExitCode;
+
+    /**
+     * @brief The number of rsync commands currently running for the path.
+     */
+    uint32_t inFlight;
+
+    /**
+     * @brief The number of paths currently synced in the batched mode as
+     *        they change too often, and the number of mode changes.
+     */
+    uint32_t batchedPaths;
+    uint32_t modeChanges;
+
+    /**
+     * @brief The number of sync attempts interrupted mid-transfer, and the
+     *        sum of "Matched data" bytes which the syncs after them resumed
+     *        from the partial data kept on the sibling.
+     */
+    uint64_t interruptedSyncs;
+    uint64_t resumedBytes;
+
+    /**
+     * @brief The sum of "Matched data" bytes reported by rsync, the part of
+     *        the files found on the sibling already. Against the literal
+     *        bytes it gives the efficiency of the delta transfer.
+     */
+    uint64_t matchedBytes;
+
+    /**
+     * @brief The files and bytes which the background scrub compared with
+     *        the sibling's copies, and the files found to differ.
+     */
+    uint64_t scrubbedFiles;
+    uint64_t scrubbedBytes;
+    uint64_t scrubMismatches;
+};
+
+/**
+ * @brief The fixed layout of the status page shared with the readers.
+ *
+ * The writer is the daemon's event loop thread. The readers (monitoring
+ * agents, datasynctool) map the file read-only and use the seqlock
+ * (`sequence`) to take a consistent snapshot without ever blocking the
+ * writer.
+ */
+struct Page
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t configCapacity;
+
+    /**
+     * @brief The seqlock counter, odd while the writer is updating the page.
+     *
+     * @note Accessed only through std::atomic_ref to keep the page trivially
+     *       copyable for the readers.
+     */
+    alignas(std::atomic_ref<uint32_t>::required_alignment) uint32_t sequence;
+    uint32_t daemonPid;
+
+    /**
+     * @brief The CLOCK_REALTIME timestamp (in microseconds) of the last update
+     */
+    uint64_t updatedTimeUs;
+
+    /**
+     * @brief The underlying values of the SyncBMCData D-Bus enum properties.
+     */
+    uint8_t syncEventsHealth;
+    uint8_t fullSyncStatus;
+    uint8_t disableSync;
+    uint8_t reserved;
+
+    /**
+     * @brief The number of sync requests accepted but not finished yet
+     *        (including the ones waiting for a retry) and the number of rsync
+     *        commands currently running.
+     */
+    uint32_t queueDepth;
+    uint32_t inFlightSyncs;
+    uint32_t configCount;
+
+    /**
+     * @brief The finished background scrub passes over the configured data,
+     *        and the percentage of the files of the current pass scrubbed.
+     */
+    uint32_t scrubPasses;
+    uint32_t scrubCoverage;
+
+    SyncStats configs[maxConfigs];
+};
+
+static_assert(std::atomic_ref<uint32_t>::is_always_lock_free,
+              "The status page seqlock requires a lock free 32bit atomic");
+static_assert(std::is_trivially_copyable_v<Page>,
+              "The status page must be trivially copyable");
+
+/**
+ * @brief Get the CLOCK_REALTIME time in microseconds as stored in the page.
+ */
+uint64_t nowInUs();
+
+/**
+ * @class StatusPageWriter
+ *
+ * @brief Publishes the daemon status into a fixed layout page backed by a
+ *        file (typically under /run) which the readers can map.
+ *
+ * @note Not thread-safe, all updates are expected from the event loop thread.
+ */
+class StatusPageWriter
+{
+  public:
+    StatusPageWriter(const StatusPageWriter&) = delete;
+    StatusPageWriter& operator=(const StatusPageWriter&) = delete;
+    StatusPageWriter(StatusPageWriter&&) = delete;
+    StatusPageWriter& operator=(StatusPageWriter&&) = delete;
+
+    /**
+     * @brief The constructor creates and maps the status page.
+     *
+     * Failing to create the page isn't fatal for the daemon, all the updates
+     * will be ignored in that case.
+     *
+     * @param[in] pagePath - The file path to publish the page
+     */
+    explicit StatusPageWriter(const fs::path& pagePath);
+
+    /**
+     * @brief The destructor unmaps the page and removes the file so that the
+     *        readers won't consume stale data.
+     */
+    ~StatusPageWriter();
+
+    /**
+     * @brief Apply the given modification on the page under the seqlock.
+     *
+     * @param[in] modifier - The callable which updates the page
+     */
+    template <typename Modifier>
+    void update(Modifier&& modifier)
+    {
+        if (_page == nullptr)
+        {
+            return;
+        }
+        std::atomic_ref<uint32_t> sequence(_page->sequence);
+        const auto seq = sequence.load(std::memory_order_relaxed);
+        sequence.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        std::forward<Modifier>(modifier)(*_page);
+        _page->updatedTimeUs = nowInUs();
+
+        sequence.store(seq + 2, std::memory_order_release);
+    }
+
+    /**
+     * @brief Get the slot index of the given configured path, a new slot is
+     *        allocated if the path is not yet tracked.
+     *
+     * @param[in] cfgPath - The configured path
+     *
+     * @return The slot index; std::nullopt if the page is not available or
+     *         no more slots are left.
+     */
+    std::optional<size_t> configSlot(const fs::path& cfgPath);
+
+    /**
+     * @brief Helper API to update the counters of the given configured path.
+     *
+     * @param[in] cfgPath - The configured path
+     * @param[in] modifier - The callable which updates the counters
+     */
+    template <typename Modifier>
+    void updateStats(const fs::path& cfgPath, Modifier&& modifier)
+    {
+        if (auto slot = configSlot(cfgPath); slot.has_value())
+        {
+            update([&modifier, &slot](Page& page) {
+                std::forward<Modifier>(modifier)(page.configs[*slot]);
+            });
+        }
+    }
+
+  private:
+    /**
+     * @brief The published file path
+     */
+    fs::path _pagePath;
+
+    /**
+     * @brief The mapped page, nullptr if the page is not available.
+     */
+    Page* _page{nullptr};
+};
+
+/**
+ * @class StatusPageReader
+ *
+ * @brief Maps the published status page read-only and takes consistent
+ *        snapshots of it.
+ */
+class StatusPageReader
+{
+  public:
+    StatusPageReader(const StatusPageReader&) = delete;
+    StatusPageReader& operator=(const StatusPageReader&) = delete;
+    StatusPageReader(StatusPageReader&&) = delete;
+    StatusPageReader& operator=(StatusPageReader&&) = delete;
+
+    /**
+     * @brief The constructor maps the status page.
+     *
+     * @param[in] pagePath - The published file path of the page
+     *
+     * @throw std::runtime_error if the page is not available or not valid.
+     */
+    explicit StatusPageReader(const fs::path& pagePath);
+
+    ~StatusPageReader();
+
+    /**
+     * @brief Take a consistent copy of the page.
+     *
+     * @return The copy of the page; std::nullopt if a consistent copy
+     *         couldn't be taken within a bounded number of attempts.
+     */
+    std::optional<Page> snapshot() const;
+
+  private:
+    /**
+     * @brief The mapped page
+     */
+    const Page* _page{nullptr};
+};
+
+/**
+ * @brief Store the given path into the fixed size buffer of the page, keeping
+ *        the tail of the path if it doesn't fit.
+ *
+ * @param[out] dest - The page buffer
+ * @param[in] path - The path to store
+ */
+void copyPath(char (&dest)[maxPathLen], std::string_view path);
+
+} // namespace data_sync::status
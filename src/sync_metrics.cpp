@@ -0,0 +1,216 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "sync_metrics.hpp"
+
+#include <phosphor-logging/lg2.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <experimental/scope>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+
+namespace data_sync::metrics
+{
+
+namespace
+{
+
+std::atomic<bool> collectionEnabled{false};
+bool loopLagProbeRunning{false};
+
+// The watch shard threads time their inotify stages too
+std::mutex histogramsMutex;
+std::array<Histogram, static_cast<size_t>(Stage::Count)> histograms{};
+
+} // namespace
+
+size_t Histogram::bucketOf(uint64_t durationUs)
+{
+    return std::min<size_t>(std::bit_width(durationUs), numBuckets - 1);
+}
+
+void Histogram::record(std::chrono::nanoseconds duration)
+{
+    const auto durationUs = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(duration)
+            .count());
+    ++_buckets[bucketOf(durationUs)];
+    ++_count;
+    _sumUs += durationUs;
+    _maxUs = std::max(_maxUs, durationUs);
+}
+
+void Histogram::reset()
+{
+    _buckets.fill(0);
+    _count = 0;
+    _sumUs = 0;
+    _maxUs = 0;
+}
+
+uint64_t Histogram::percentileUs(double percentile) const
+{
+    if (_count == 0)
+    {
+        return 0;
+    }
+
+    const auto rank = static_cast<uint64_t>(
+        (percentile / 100.0) * static_cast<double>(_count - 1));
+    uint64_t seen = 0;
+    for (size_t bucket = 0; bucket < numBuckets; ++bucket)
+    {
+        seen += _buckets[bucket];
+        if (seen > rank)
+        {
+            // The upper bound of the bucket, limited by the observed max
+            return std::min<uint64_t>((uint64_t{1} << bucket) - 1, _maxUs);
+        }
+    }
+    return _maxUs;
+}
+
+nlohmann::json Histogram::toJson() const
+{
+    nlohmann::json buckets = nlohmann::json::object();
+    for (size_t bucket = 0; bucket < numBuckets; ++bucket)
+    {
+        if (_buckets[bucket] != 0)
+        {
+            // Keyed by the exclusive upper bound of the bucket
+            buckets[std::to_string(uint64_t{1} << bucket)] = _buckets[bucket];
+        }
+    }
+
+    return {{"Count", _count},
+            {"AvgUs", _count != 0 ? _sumUs / _count : 0},
+            {"P50Us", percentileUs(50)},
+            {"P99Us", percentileUs(99)},
+            {"MaxUs", _maxUs},
+            {"BucketsUs", std::move(buckets)}};
+}
+
+bool enabled() noexcept
+{
+    return collectionEnabled.load(std::memory_order_relaxed);
+}
+
+void setEnabled(bool enable) noexcept
+{
+    collectionEnabled.store(enable, std::memory_order_relaxed);
+}
+
+void record(Stage stage, std::chrono::nanoseconds duration)
+{
+    if (!enabled() || stage >= Stage::Count)
+    {
+        return;
+    }
+    std::lock_guard lock(histogramsMutex);
+    histograms[static_cast<size_t>(stage)].record(duration);
+}
+
+Histogram histogram(Stage stage)
+{
+    std::lock_guard lock(histogramsMutex);
+    return histograms.at(static_cast<size_t>(stage));
+}
+
+void reset()
+{
+    std::lock_guard lock(histogramsMutex);
+    std::ranges::for_each(histograms, [](auto& hist) { hist.reset(); });
+}
+
+std::string_view stageName(Stage stage)
+{
+    switch (stage)
+    {
+        case Stage::InotifyRead:
+            return "InotifyRead";
+        case Stage::EventFilter:
+            return "EventFilter";
+        case Stage::RsyncCmdBuild:
+            return "RsyncCmdBuild";
+        case Stage::Spawn:
+            return "Spawn";
+        case Stage::Transfer:
+            return "Transfer";
+        case Stage::Reap:
+            return "Reap";
+        case Stage::Notify:
+            return "Notify";
+        case Stage::LoopLag:
+            return "LoopLag";
+        default:
+            return "Unknown";
+    }
+}
+
+nlohmann::json toJson()
+{
+    nlohmann::json stages = nlohmann::json::object();
+    std::lock_guard lock(histogramsMutex);
+    for (size_t stage = 0; stage < histograms.size(); ++stage)
+    {
+        stages[std::string(stageName(static_cast<Stage>(stage)))] =
+            histograms[stage].toJson();
+    }
+    return {{"Enabled", enabled()}, {"Stages", std::move(stages)}};
+}
+
+void dumpToFile(const std::string& filePath)
+{
+    try
+    {
+        // Write into a temporary file and rename, so that the readers never
+        // see a partially written dump.
+        const std::string tmpFilePath = filePath + ".tmp";
+        {
+            std::ofstream file(tmpFilePath);
+            if (!file.is_open())
+            {
+                lg2::error("Failed to open file for dumping metrics: {FILE}",
+                           "FILE", tmpFilePath);
+                return;
+            }
+            file << toJson().dump(4);
+        }
+        std::filesystem::rename(tmpFilePath, filePath);
+
+        lg2::info("Dumped data-sync metrics to {FILE}", "FILE", filePath);
+    }
+    catch (const std::exception& e)
+    {
+        lg2::error("Error writing metrics file: {ERROR}", "ERROR", e);
+    }
+}
+
+// NOLINTNEXTLINE
+sdbusplus::async::task<> monitorLoopLag(sdbusplus::async::context& ctx)
+{
+    if (loopLagProbeRunning)
+    {
+        co_return;
+    }
+    loopLagProbeRunning = true;
+    auto probeGuard = std::experimental::scope_exit(
+        []() noexcept { loopLagProbeRunning = false; });
+
+    while (!ctx.stop_requested() && enabled())
+    {
+        const auto scheduledAt = std::chrono::steady_clock::now() +
+                                 loopLagProbeInterval;
+        co_await sdbusplus::async::sleep_for(ctx, loopLagProbeInterval);
+
+        // The time the loop took to resume the probe after it was due
+        const auto lag = std::chrono::steady_clock::now() - scheduledAt;
+        record(Stage::LoopLag, std::max(lag, std::chrono::nanoseconds(0)));
+    }
+    co_return;
+}
+
+} // namespace data_sync::metrics
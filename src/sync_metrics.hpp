@@ -0,0 +1,221 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <nlohmann/json.hpp>
+#include <sdbusplus/async.hpp>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+namespace data_sync::metrics
+{
+
+/**
+ * @brief The timed stages of the sync pipeline.
+ */
+enum class Stage : uint8_t
+{
+    InotifyRead,   // Reading the inotify events from the kernel
+    EventFilter,   // Filtering the events into data operations
+    RsyncCmdBuild, // Building the rsync command line
+    Spawn,         // posix_spawn of the command
+    Transfer,      // Child run time until its output is closed
+    Reap,          // waitpid on the finished child
+    Notify,        // Sibling notification round trip
+    LoopLag,       // Delay of the scheduled work on the event loop
+    Count
+};
+
+/**
+ * @brief The commands accepted along with SIGUSR2 (sent via sigqueue()).
+ *
+ * A plain SIGUSR2 (kill) toggles the collection and dumps the collected
+ * metrics when the collection is turned off.
+ */
+enum class Command : int
+{
+    Enable = 1,
+    Disable = 2,
+    Dump = 3,
+    Reset = 4,
+    DumpFlightRecorder = 5,
+    StartEventCapture = 6,
+    StopEventCapture = 7
+};
+
+/**
+ * @brief The file where the collected metrics are dumped on request.
+ */
+constexpr auto dumpFile = "/tmp/data_sync_metrics.json";
+
+/**
+ * @brief The interval at which the loop lag probe schedules its work.
+ */
+constexpr auto loopLagProbeInterval = std::chrono::milliseconds(100);
+
+/**
+ * @class Histogram
+ *
+ * @brief A fixed log2 bucketed histogram of durations in microseconds.
+ *
+ * The bucket N (N > 0) counts the durations in [2^(N-1), 2^N) microseconds
+ * and the bucket 0 counts the durations below a microsecond.
+ *
+ * @note Not thread-safe, the stage histograms are guarded by the metrics
+ *       functions below.
+ */
+class Histogram
+{
+  public:
+    static constexpr size_t numBuckets = 32;
+
+    /**
+     * @brief Record the given duration.
+     *
+     * @param[in] duration - The duration to record
+     */
+    void record(std::chrono::nanoseconds duration);
+
+    /**
+     * @brief Clear all the recorded durations.
+     */
+    void reset();
+
+    /**
+     * @brief Get the upper bound (in microseconds) of the bucket which holds
+     *        the given percentile.
+     *
+     * @param[in] percentile - The percentile in [0, 100]
+     *
+     * @return The percentile upper bound; 0 if nothing is recorded.
+     */
+    uint64_t percentileUs(double percentile) const;
+
+    /**
+     * @brief Get the histogram as JSON.
+     */
+    nlohmann::json toJson() const;
+
+    uint64_t count() const
+    {
+        return _count;
+    }
+
+    uint64_t maxUs() const
+    {
+        return _maxUs;
+    }
+
+    /**
+     * @brief Get the bucket index of the given duration.
+     *
+     * @param[in] durationUs - The duration in microseconds
+     */
+    static size_t bucketOf(uint64_t durationUs);
+
+  private:
+    std::array<uint64_t, numBuckets> _buckets{};
+    uint64_t _count{0};
+    uint64_t _sumUs{0};
+    uint64_t _maxUs{0};
+};
+
+/**
+ * @brief Whether the metrics collection is enabled.
+ *
+ * This is the only cost of the instrumentation when the collection is off.
+ */
+bool enabled() noexcept;
+
+/**
+ * @brief Enable or disable the metrics collection.
+ *
+ * @param[in] enable - true to enable the collection
+ */
+void setEnabled(bool enable) noexcept;
+
+/**
+ * @brief Record a duration against the given stage if enabled.
+ *
+ * @param[in] stage - The pipeline stage
+ * @param[in] duration - The measured duration
+ */
+void record(Stage stage, std::chrono::nanoseconds duration);
+
+/**
+ * @brief Get a copy of the histogram of the given stage.
+ *
+ * @param[in] stage - The pipeline stage
+ */
+Histogram histogram(Stage stage);
+
+/**
+ * @brief Clear the histograms of all stages.
+ */
+void reset();
+
+/**
+ * @brief Get the name of the given stage.
+ */
+std::string_view stageName(Stage stage);
+
+/**
+ * @brief Get the histograms of all stages as JSON.
+ */
+nlohmann::json toJson();
+
+/**
+ * @brief Dump the histograms of all stages into the given file.
+ *
+ * @param[in] filePath - The file to write
+ */
+void dumpToFile(const std::string& filePath = dumpFile);
+
+/**
+ * @brief Periodically measure how late the event loop runs the scheduled
+ *        work, until the collection is disabled.
+ *
+ * @param[in] ctx - The async context object
+ */
+sdbusplus::async::task<> monitorLoopLag(sdbusplus::async::context& ctx);
+
+/**
+ * @class ScopedSpan
+ *
+ * @brief Times the enclosing scope into the given stage, the clock is read
+ *        only if the collection is enabled when the span starts.
+ */
+class ScopedSpan
+{
+  public:
+    ScopedSpan(const ScopedSpan&) = delete;
+    ScopedSpan& operator=(const ScopedSpan&) = delete;
+    ScopedSpan(ScopedSpan&&) = delete;
+    ScopedSpan& operator=(ScopedSpan&&) = delete;
+
+    explicit ScopedSpan(Stage stage) : _stage(stage)
+    {
+        if (enabled())
+        {
+            _start = std::chrono::steady_clock::now();
+        }
+    }
+
+    ~ScopedSpan()
+    {
+        if (_start.has_value())
+        {
+            record(_stage, std::chrono::steady_clock::now() - *_start);
+        }
+    }
+
+  private:
+    Stage _stage;
+    std::optional<std::chrono::steady_clock::time_point> _start;
+};
+
+} // namespace data_sync::metrics
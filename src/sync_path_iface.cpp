@@ -0,0 +1,101 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "sync_path_iface.hpp"
+
+#include "manager.hpp"
+
+#include <phosphor-logging/lg2.hpp>
+#include <xyz/openbmc_project/Common/error.hpp>
+
+#include <algorithm>
+
+namespace data_sync::dbus_ifaces
+{
+
+using SyncBMCData =
+    sdbusplus::common::xyz::openbmc_project::control::SyncBMCData;
+
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays)
+const sdbusplus::vtable_t SyncPathIface::_vtable[] = {
+    sdbusplus::vtable::start(),
+    sdbusplus::vtable::method("SyncPath", "st", "b",
+                              SyncPathIface::callSyncPath),
+    sdbusplus::vtable::end()};
+
+SyncPathIface::SyncPathIface(sdbusplus::async::context& ctx,
+                             data_sync::Manager& manager) :
+    _manager(manager),
+    _interface(ctx.get_bus(), SyncBMCData::instance_path, interface, _vtable,
+               this)
+{
+    _interface.emit_added();
+}
+
+int SyncPathIface::callSyncPath(sd_bus_message* msg, void* context,
+                                sd_bus_error* error)
+{
+    auto* self = static_cast<SyncPathIface*>(context);
+    try
+    {
+        // Keeps a reference to the call until the deferred reply
+        sdbusplus::message_t call(msg);
+
+        std::string path;
+        uint64_t timeoutMs{0};
+        call.read(path, timeoutMs);
+
+        if (self->_manager.getDisableSyncStatus())
+        {
+            lg2::error("Sync is Disabled, cannot sync {PATH}.", "PATH", path);
+            throw sdbusplus::xyz::openbmc_project::Control::SyncBMCData::
+                Error::SyncDisabled();
+        }
+
+        if (self->_manager.findSyncCfg(path) == nullptr)
+        {
+            lg2::error("{PATH} is not synced from this BMC", "PATH", path);
+            throw sdbusplus::xyz::openbmc_project::Common::Error::
+                InvalidArgument();
+        }
+
+        const auto timeout = std::min(
+            std::chrono::milliseconds(timeoutMs),
+            std::chrono::milliseconds(maxTimeout));
+        self->_manager.syncPath(
+            path, timeout,
+            [call = std::move(call), path](bool synced) mutable {
+            reply(call, path, synced);
+        });
+    }
+    catch (const sdbusplus::exception_t& e)
+    {
+        return sd_bus_error_set(error, e.name(), e.description());
+    }
+    catch (const std::exception& e)
+    {
+        lg2::error("Failed to handle the SyncPath request : {ERROR}", "ERROR",
+                   e);
+        return -EINVAL;
+    }
+
+    // The reply is sent once the sync completes or times out
+    return 1;
+}
+
+void SyncPathIface::reply(sdbusplus::message_t& msg, const std::string& path,
+                          bool synced)
+{
+    try
+    {
+        auto methodReturn = msg.new_method_return();
+        methodReturn.append(synced);
+        methodReturn.method_return();
+    }
+    catch (const std::exception& e)
+    {
+        lg2::error("Failed to reply the SyncPath request of {PATH} : {ERROR}",
+                   "PATH", path, "ERROR", e);
+    }
+}
+
+} // namespace data_sync::dbus_ifaces
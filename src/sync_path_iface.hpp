@@ -0,0 +1,90 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <systemd/sd-bus.h>
+
+#include <sdbusplus/async.hpp>
+#include <sdbusplus/message.hpp>
+#include <sdbusplus/server/interface.hpp>
+#include <sdbusplus/vtable.hpp>
+
+#include <chrono>
+#include <string>
+
+namespace data_sync
+{
+class Manager;
+
+namespace dbus_ifaces
+{
+
+/**
+ * @class SyncPathIface
+ *
+ * @brief SyncPathIface implements the SyncPath barrier method, on the object
+ *        of the SyncBMCData interface, for the writers which need their write
+ *        on the sibling before acknowledging it.
+ *
+ *        SyncPath(s path, t timeoutMs) -> b synced
+ *
+ *        The reply is deferred until the sibling confirms the sync of the
+ *        path or the timeout expires, without blocking the other D-Bus
+ *        requests meanwhile.
+ */
+class SyncPathIface
+{
+  public:
+    SyncPathIface(const SyncPathIface&) = delete;
+    SyncPathIface& operator=(const SyncPathIface&) = delete;
+    SyncPathIface(SyncPathIface&&) = delete;
+    SyncPathIface& operator=(SyncPathIface&&) = delete;
+    ~SyncPathIface() = default;
+
+    static constexpr auto interface =
+        "xyz.openbmc_project.Control.SyncBMCData.SyncPath";
+
+    /**
+     * @brief The upper bound of the requested timeout, it stays below the
+     *        default D-Bus method call timeout (25s) of the callers.
+     */
+    static constexpr auto maxTimeout = std::chrono::seconds(20);
+
+    /**
+     * @brief Constructor for SyncPathIface.
+     *
+     * @param[in] ctx Reference to the async D-Bus context.
+     * @param[in] manager Reference of the manager.
+     */
+    SyncPathIface(sdbusplus::async::context& ctx, data_sync::Manager& manager);
+
+  private:
+    /**
+     * @brief The sd-bus callback of the SyncPath method, it validates the
+     *        request and starts the sync which replies later.
+     */
+    static int callSyncPath(sd_bus_message* msg, void* context,
+                            sd_bus_error* error);
+
+    /**
+     * @brief Reply to the method call with the result of the sync.
+     *
+     * @param[in] msg - The method call to reply
+     * @param[in] path - The synced path, for the logs
+     * @param[in] synced - Whether the sibling confirmed the sync in time
+     */
+    static void reply(sdbusplus::message_t& msg, const std::string& path,
+                      bool synced);
+
+    /**
+     * @brief Reference to the Manager object.
+     */
+    Manager& _manager;
+
+    static const sdbusplus::vtable_t _vtable[];
+
+    sdbusplus::server::interface_t _interface;
+};
+
+} // namespace dbus_ifaces
+} // namespace data_sync
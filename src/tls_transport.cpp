@@ -0,0 +1,859 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "config.h"
+
+#include "tls_transport.hpp"
+
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#if TLS_TRANSPORT
+#include <openssl/err.h>
+#include <openssl/ssl.h>
+#endif
+
+#include <phosphor-logging/lg2.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+namespace data_sync::tls
+{
+
+#if TLS_TRANSPORT
+
+namespace
+{
+
+/**
+ * @brief The frame types.
+ */
+constexpr uint8_t frameOpen = 0;
+constexpr uint8_t frameData = 1;
+constexpr uint8_t frameClose = 2;
+
+/**
+ * @brief The frame header, the channel id and the payload length in the
+ *        network byte order around the type.
+ */
+constexpr size_t frameHeaderSize = sizeof(uint32_t) + 1 + sizeof(uint32_t);
+
+/**
+ * @brief The TCP keepalive of the session, to find out a sibling gone
+ *        without a close in about a minute.
+ */
+constexpr int keepAliveIdleSec = 30;
+constexpr int keepAliveIntervalSec = 10;
+constexpr int keepAliveProbes = 3;
+
+void setOption(int fd, int level, int option, int value)
+{
+    // Best effort, the transport works without them
+    ::setsockopt(fd, level, option, &value, sizeof(value));
+}
+
+utility::FD listenOn(uint16_t port, bool loopbackOnly)
+{
+    utility::FD socket(
+        ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0));
+    if (socket() < 0)
+    {
+        throw std::runtime_error("Failed to create a socket, error: " +
+                                 std::string(strerror(errno)));
+    }
+    setOption(socket(), SOL_SOCKET, SO_REUSEADDR, 1);
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(loopbackOnly ? INADDR_LOOPBACK
+                                                 : INADDR_ANY);
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    if (::bind(socket(), reinterpret_cast<sockaddr*>(&address),
+               sizeof(address)) != 0 ||
+        ::listen(socket(), SOMAXCONN) != 0)
+    {
+        throw std::runtime_error("Failed to listen on the port " +
+                                 std::to_string(port) +
+                                 ", error: " + strerror(errno));
+    }
+    return socket;
+}
+
+void wakeUp(int fd)
+{
+    const uint64_t count{1};
+    [[maybe_unused]] const auto bytes = ::write(fd, &count, sizeof(count));
+}
+
+std::string sslError()
+{
+    std::array<char, 256> message{};
+    ERR_error_string_n(ERR_get_error(), message.data(), message.size());
+    ERR_clear_error();
+    return message.data();
+}
+
+} // namespace
+
+
+void Transport::SslDeleter::operator()(ssl_st* ssl) const
+{
+    SSL_free(ssl);
+}
+
+void Transport::SslDeleter::operator()(ssl_ctx_st* sslCtx) const
+{
+    SSL_CTX_free(sslCtx);
+}
+
+void Transport::SslDeleter::operator()(ssl_session_st* session) const
+{
+    SSL_SESSION_free(session);
+}
+
+Transport::Transport(Settings settings) :
+    _settings(std::move(settings)),
+    _localListener(listenOn(_settings.localPort, true)),
+    _sessionListener(_settings.listenPort.has_value()
+                         ? listenOn(*_settings.listenPort, false)
+                         : utility::FD(-1)),
+    _wakeFd(::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)), _sessionSocket(-1)
+{
+    if (_wakeFd() < 0)
+    {
+        throw std::runtime_error("Failed to create the eventfd of the TLS "
+                                 "transport");
+    }
+
+    const auto createCtx = [this](bool server) {
+        std::unique_ptr<ssl_ctx_st, SslDeleter> sslCtx(
+            SSL_CTX_new(server ? TLS_server_method() : TLS_client_method()));
+        const auto& credentials = _settings.credentials;
+        if (!sslCtx ||
+            SSL_CTX_set_min_proto_version(sslCtx.get(), TLS1_2_VERSION) != 1 ||
+            SSL_CTX_use_certificate_chain_file(
+                sslCtx.get(), credentials.certFile.c_str()) != 1 ||
+            SSL_CTX_use_PrivateKey_file(sslCtx.get(),
+                                        credentials.keyFile.c_str(),
+                                        SSL_FILETYPE_PEM) != 1 ||
+            SSL_CTX_check_private_key(sslCtx.get()) != 1 ||
+            SSL_CTX_load_verify_locations(
+                sslCtx.get(), credentials.caFile.c_str(), nullptr) != 1)
+        {
+            throw std::runtime_error("Failed to load the TLS credentials, "
+                                     "error: " +
+                                     sslError());
+        }
+
+        // Both the sides present a certificate signed by the CA
+        SSL_CTX_set_verify(sslCtx.get(),
+                           SSL_VERIFY_PEER | SSL_VERIFY_FAIL_IF_NO_PEER_CERT,
+                           nullptr);
+        SSL_CTX_set_mode(sslCtx.get(), SSL_MODE_ENABLE_PARTIAL_WRITE |
+                                           SSL_MODE_ACCEPT_MOVING_WRITE_BUFFER);
+        if (server)
+        {
+            // The sessions are resumed with the client certificate verified
+            static constexpr std::string_view sessionContext{
+                "phosphor-data-sync"};
+            SSL_CTX_set_session_id_context(
+                sslCtx.get(),
+                // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+                reinterpret_cast<const unsigned char*>(sessionContext.data()),
+                sessionContext.size());
+        }
+        if (_settings.kernelTls)
+        {
+#ifdef SSL_OP_ENABLE_KTLS
+            SSL_CTX_set_options(sslCtx.get(), SSL_OP_ENABLE_KTLS);
+#else
+            lg2::warning("The OpenSSL build doesn't support kTLS, the "
+                         "records are encrypted in the daemon");
+#endif
+        }
+        return sslCtx;
+    };
+    _serverCtx = createCtx(true);
+    _clientCtx = createCtx(false);
+
+    _thread = std::jthread(
+        [this](const std::stop_token& stopToken) { run(stopToken); });
+}
+
+Transport::~Transport()
+{
+    _thread.request_stop();
+    wakeUp(_wakeFd());
+    _thread.join();
+}
+
+void Transport::reconnect()
+{
+    _reconnect = true;
+    wakeUp(_wakeFd());
+}
+
+Stats Transport::stats() const noexcept
+{
+    return {.handshakes = _handshakes.load(),
+            .resumedHandshakes = _resumedHandshakes.load(),
+            .channels = _openedChannels.load(),
+            .bytesSent = _bytesSent.load(),
+            .bytesReceived = _bytesReceived.load()};
+}
+
+void Transport::run(const std::stop_token& stopToken)
+{
+    std::vector<pollfd> fds;
+    std::vector<uint32_t> channelIds;
+
+    while (!stopToken.stop_requested())
+    {
+        const auto now = std::chrono::steady_clock::now();
+        if (_reconnect.exchange(false))
+        {
+            closeSession();
+            _nextDial = now;
+            _dialDelay = minReconnectDelay;
+        }
+        if (_settings.dial.has_value() && !_ssl)
+        {
+            dial(now);
+        }
+
+        const bool localBacklog =
+            std::ranges::any_of(_channels, [](const auto& entry) {
+            return entry.second.toLocal.size() >= maxPendingBytes;
+        });
+
+        fds.clear();
+        channelIds.clear();
+        fds.push_back({_wakeFd(), POLLIN, 0});
+        fds.push_back({_localListener(), POLLIN, 0});
+        fds.push_back({_sessionListener(), POLLIN, 0});
+        if (_ssl)
+        {
+            short events{0};
+            if (_dialing || _sslWantsWrite || !_toSibling.empty())
+            {
+                events |= POLLOUT;
+            }
+            if (!_dialing && !localBacklog)
+            {
+                events |= POLLIN;
+            }
+            fds.push_back({_sessionSocket(), events, 0});
+        }
+        for (const auto& [id, channel] : _channels)
+        {
+            short events{0};
+            if (channel.connecting || !channel.toLocal.empty())
+            {
+                events |= POLLOUT;
+            }
+            if (!channel.connecting && !channel.localEnded &&
+                _toSibling.size() < maxPendingBytes)
+            {
+                events |= POLLIN;
+            }
+            fds.push_back({channel.fd(), events, 0});
+            channelIds.push_back(id);
+        }
+
+        int timeout{-1};
+        if (_settings.dial.has_value() && !_ssl)
+        {
+            timeout = static_cast<int>(std::max<int64_t>(
+                std::chrono::duration_cast<std::chrono::milliseconds>(
+                    _nextDial - now)
+                    .count(),
+                0));
+        }
+
+        if (::poll(fds.data(), fds.size(), timeout) < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            lg2::error("Failed to poll the TLS transport, error: {ERROR}",
+                       "ERROR", strerror(errno));
+            break;
+        }
+
+        if ((fds[0].revents & POLLIN) != 0)
+        {
+            uint64_t count{0};
+            [[maybe_unused]] const auto bytes =
+                ::read(_wakeFd(), &count, sizeof(count));
+        }
+        if ((fds[1].revents & POLLIN) != 0)
+        {
+            acceptLocal();
+        }
+
+        const size_t channelsStart = fds.size() - channelIds.size();
+        for (size_t index = 0; index < channelIds.size(); ++index)
+        {
+            const auto revents = fds[channelsStart + index].revents;
+            auto it = _channels.find(channelIds[index]);
+            if (revents != 0 && it != _channels.end() &&
+                !serviceChannel(it->first, it->second, revents))
+            {
+                _channels.erase(it);
+            }
+        }
+
+        if (_ssl && _dialing &&
+            (fds[3].revents & (POLLOUT | POLLERR | POLLHUP)) != 0)
+        {
+            int error{0};
+            socklen_t length = sizeof(error);
+            ::getsockopt(_sessionSocket(), SOL_SOCKET, SO_ERROR, &error,
+                         &length);
+            if (error != 0)
+            {
+                lg2::warning("Failed to connect to the sibling's transport, "
+                             "error: {ERROR}",
+                             "ERROR", strerror(error));
+                closeSession();
+            }
+            _dialing = false;
+        }
+        if (_ssl && !_dialing)
+        {
+            serviceSession();
+        }
+
+        if ((fds[2].revents & POLLIN) != 0)
+        {
+            utility::FD socket(::accept4(_sessionListener(), nullptr, nullptr,
+                                         SOCK_NONBLOCK | SOCK_CLOEXEC));
+            if (socket() >= 0)
+            {
+                // A new session of the sibling replaces the old one, e.g.
+                // after its restart
+                startSession(std::move(socket), false);
+            }
+        }
+
+        // Pass the end of the sibling's data on once written, and drop the
+        // channels ended both ways
+        for (auto& [id, channel] : _channels)
+        {
+            if (channel.remoteEnded && !channel.shutDown &&
+                !channel.connecting && channel.toLocal.empty())
+            {
+                ::shutdown(channel.fd(), SHUT_WR);
+                channel.shutDown = true;
+            }
+        }
+        std::erase_if(_channels, [](const auto& entry) {
+            return entry.second.localEnded && entry.second.shutDown;
+        });
+    }
+
+    closeSession();
+}
+
+void Transport::startSession(utility::FD socket, bool client)
+{
+    closeSession();
+
+    setOption(socket(), IPPROTO_TCP, TCP_NODELAY, 1);
+    setOption(socket(), SOL_SOCKET, SO_KEEPALIVE, 1);
+    setOption(socket(), IPPROTO_TCP, TCP_KEEPIDLE, keepAliveIdleSec);
+    setOption(socket(), IPPROTO_TCP, TCP_KEEPINTVL, keepAliveIntervalSec);
+    setOption(socket(), IPPROTO_TCP, TCP_KEEPCNT, keepAliveProbes);
+
+    _ssl.reset(SSL_new(client ? _clientCtx.get() : _serverCtx.get()));
+    if (!_ssl || SSL_set_fd(_ssl.get(), socket()) != 1)
+    {
+        lg2::error("Failed to set up the TLS session, error: {ERROR}",
+                   "ERROR", sslError());
+        _ssl.reset();
+        return;
+    }
+
+    if (client)
+    {
+        SSL_set_connect_state(_ssl.get());
+        if (_savedSession)
+        {
+            SSL_set_session(_ssl.get(), _savedSession.get());
+        }
+    }
+    else
+    {
+        SSL_set_accept_state(_ssl.get());
+    }
+    _sessionSocket = std::move(socket);
+    _handshakeDone = false;
+
+    // The ids of the two sides never collide
+    _nextChannelId = client ? 1 : 2;
+}
+
+void Transport::closeSession()
+{
+    if (!_ssl)
+    {
+        return;
+    }
+
+    if (_handshakeDone)
+    {
+        if (SSL_is_server(_ssl.get()) == 0)
+        {
+            // The tickets of TLS 1.3 arrive after the handshake
+            if (auto* session = SSL_get1_session(_ssl.get());
+                session != nullptr)
+            {
+                _savedSession.reset(session);
+            }
+        }
+        SSL_shutdown(_ssl.get());
+        lg2::info("Closed the TLS session to the sibling, {CHANNELS} channels "
+                  "dropped",
+                  "CHANNELS", _channels.size());
+    }
+
+    _ssl.reset();
+    _sessionSocket.reset();
+    _dialing = false;
+    _handshakeDone = false;
+    _connected = false;
+    _channels.clear();
+    _fromSibling.clear();
+    _toSibling.clear();
+    _retryWriteLength = 0;
+    _sslWantsWrite = false;
+
+    if (_settings.dial.has_value())
+    {
+        _nextDial = std::chrono::steady_clock::now() + _dialDelay;
+        _dialDelay = std::min<std::chrono::seconds>(_dialDelay * 2,
+                                                    maxReconnectDelay);
+    }
+}
+
+void Transport::dial(std::chrono::steady_clock::time_point now)
+{
+    if (now < _nextDial)
+    {
+        return;
+    }
+
+    const auto& endpoint = *_settings.dial;
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* addresses{nullptr};
+    if (const auto rc = ::getaddrinfo(endpoint.host.c_str(),
+                                      std::to_string(endpoint.port).c_str(),
+                                      &hints, &addresses);
+        rc != 0 || addresses == nullptr)
+    {
+        lg2::warning("Failed to resolve the sibling's transport {HOST}, "
+                     "error: {ERROR}",
+                     "HOST", endpoint.host, "ERROR", gai_strerror(rc));
+        _nextDial = now + maxReconnectDelay;
+        return;
+    }
+
+    utility::FD socket(::socket(addresses->ai_family,
+                                SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC,
+                                0));
+    const auto rc = socket() < 0
+                        ? -1
+                        : ::connect(socket(), addresses->ai_addr,
+                                    addresses->ai_addrlen);
+    const auto error = errno;
+    ::freeaddrinfo(addresses);
+    if (rc != 0 && error != EINPROGRESS)
+    {
+        lg2::warning("Failed to connect to the sibling's transport, error: "
+                     "{ERROR}",
+                     "ERROR", strerror(error));
+        _nextDial = now + _dialDelay;
+        _dialDelay = std::min<std::chrono::seconds>(_dialDelay * 2,
+                                                    maxReconnectDelay);
+        return;
+    }
+
+    startSession(std::move(socket), true);
+    _dialing = _ssl && rc != 0;
+}
+
+bool Transport::serviceSession()
+{
+    _sslWantsWrite = false;
+    const auto failed = [this](std::string_view stage, int rc) {
+        const auto error = SSL_get_error(_ssl.get(), rc);
+        if (error == SSL_ERROR_WANT_READ)
+        {
+            return false;
+        }
+        if (error == SSL_ERROR_WANT_WRITE)
+        {
+            _sslWantsWrite = true;
+            return false;
+        }
+        if (error != SSL_ERROR_ZERO_RETURN)
+        {
+            lg2::error("The TLS session to the sibling failed in the {STAGE}, "
+                       "error: {ERROR}",
+                       "STAGE", stage, "ERROR",
+                       error == SSL_ERROR_SYSCALL ? strerror(errno)
+                                                  : sslError());
+        }
+        closeSession();
+        return true;
+    };
+
+    if (!_handshakeDone)
+    {
+        if (const auto rc = SSL_do_handshake(_ssl.get()); rc != 1)
+        {
+            return !failed("handshake", rc);
+        }
+
+        _handshakeDone = true;
+        _connected = true;
+        _dialDelay = minReconnectDelay;
+        ++_handshakes;
+        const bool resumed = SSL_session_reused(_ssl.get()) == 1;
+        _resumedHandshakes += resumed ? 1 : 0;
+        bool kernelTls{false};
+#ifdef BIO_get_ktls_send
+        kernelTls = BIO_get_ktls_send(SSL_get_wbio(_ssl.get())) != 0;
+#endif
+        lg2::info("Established the TLS session to the sibling, {VERSION}, "
+                  "resumed: {RESUMED}, kTLS: {KTLS}",
+                  "VERSION", SSL_get_version(_ssl.get()), "RESUMED", resumed,
+                  "KTLS", kernelTls);
+    }
+
+    std::array<char, maxFramePayload> buffer{};
+    while (std::ranges::none_of(_channels, [](const auto& entry) {
+        return entry.second.toLocal.size() >= maxPendingBytes;
+    }))
+    {
+        const auto rc = SSL_read(_ssl.get(), buffer.data(),
+                                 static_cast<int>(buffer.size()));
+        if (rc <= 0)
+        {
+            if (failed("read", rc))
+            {
+                return false;
+            }
+            break;
+        }
+        _fromSibling.append(buffer.data(), rc);
+        if (!handleFrames())
+        {
+            lg2::error("Received a malformed frame from the sibling");
+            closeSession();
+            return false;
+        }
+    }
+
+    while (!_toSibling.empty())
+    {
+        const auto length =
+            _retryWriteLength != 0
+                ? _retryWriteLength
+                : std::min(_toSibling.size(), maxFramePayload);
+        const auto rc = SSL_write(_ssl.get(), _toSibling.data(),
+                                  static_cast<int>(length));
+        if (rc <= 0)
+        {
+            // OpenSSL requires the retry with the same length
+            _retryWriteLength = length;
+            if (failed("write", rc))
+            {
+                return false;
+            }
+            break;
+        }
+        _retryWriteLength = 0;
+        _toSibling.erase(0, rc);
+    }
+    return true;
+}
+
+
+bool Transport::handleFrames()
+{
+    size_t offset{0};
+    while (_fromSibling.size() - offset >= frameHeaderSize)
+    {
+        uint32_t id{0};
+        uint32_t length{0};
+        const auto* header = _fromSibling.data() + offset;
+        std::memcpy(&id, header, sizeof(id));
+        const auto type = static_cast<uint8_t>(header[sizeof(id)]);
+        std::memcpy(&length, header + sizeof(id) + 1, sizeof(length));
+        id = ntohl(id);
+        length = ntohl(length);
+        if (length > maxFramePayload)
+        {
+            return false;
+        }
+        if (_fromSibling.size() - offset < frameHeaderSize + length)
+        {
+            break;
+        }
+        const std::string_view payload(header + frameHeaderSize, length);
+        offset += frameHeaderSize + length;
+
+        auto it = _channels.find(id);
+        if (type == frameOpen)
+        {
+            // Connect the channel of the sibling to the local rsyncd
+            sockaddr_in address{};
+            address.sin_family = AF_INET;
+            address.sin_port = htons(_settings.servicePort);
+            address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            utility::FD socket(::socket(
+                AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0));
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+            auto* socketAddress = reinterpret_cast<sockaddr*>(&address);
+            const auto rc =
+                socket() < 0
+                    ? -1
+                    : ::connect(socket(), socketAddress, sizeof(address));
+            if (rc != 0 && errno != EINPROGRESS)
+            {
+                lg2::warning("Failed to connect a channel of the sibling to "
+                             "the local service, error: {ERROR}",
+                             "ERROR", strerror(errno));
+                queueFrame(id, frameClose);
+                continue;
+            }
+            setOption(socket(), IPPROTO_TCP, TCP_NODELAY, 1);
+            _channels.insert_or_assign(id,
+                                       Channel(std::move(socket), rc != 0));
+            ++_openedChannels;
+        }
+        else if (it == _channels.end())
+        {
+            // A channel dropped on this side, e.g. on a local error
+            continue;
+        }
+        else if (type == frameData)
+        {
+            it->second.toLocal.append(payload);
+            _bytesReceived += length;
+        }
+        else if (type == frameClose)
+        {
+            it->second.remoteEnded = true;
+        }
+        else
+        {
+            return false;
+        }
+    }
+    _fromSibling.erase(0, offset);
+    return true;
+}
+
+bool Transport::serviceChannel(uint32_t id, Channel& channel, short events)
+{
+    if (channel.connecting)
+    {
+        int error{0};
+        socklen_t length = sizeof(error);
+        ::getsockopt(channel.fd(), SOL_SOCKET, SO_ERROR, &error, &length);
+        if (error != 0)
+        {
+            lg2::warning("Failed to connect a channel of the sibling to the "
+                         "local service, error: {ERROR}",
+                         "ERROR", strerror(error));
+            queueFrame(id, frameClose);
+            return false;
+        }
+        channel.connecting = false;
+    }
+    else if ((events & POLLERR) != 0)
+    {
+        if (!channel.localEnded)
+        {
+            queueFrame(id, frameClose);
+        }
+        return false;
+    }
+
+    if ((events & (POLLIN | POLLHUP | POLLERR)) != 0 && !channel.localEnded)
+    {
+        std::array<char, maxFramePayload> buffer{};
+        const auto bytes = ::read(channel.fd(), buffer.data(), buffer.size());
+        if (bytes > 0)
+        {
+            queueFrame(id, frameData,
+                       std::string_view(buffer.data(),
+                                        static_cast<size_t>(bytes)));
+            _bytesSent += static_cast<uint64_t>(bytes);
+        }
+        else if (bytes == 0)
+        {
+            channel.localEnded = true;
+            queueFrame(id, frameClose);
+        }
+        else if (errno != EAGAIN && errno != EINTR)
+        {
+            queueFrame(id, frameClose);
+            return false;
+        }
+    }
+
+    if ((events & POLLOUT) != 0 && !channel.toLocal.empty())
+    {
+        const auto bytes = ::send(channel.fd(), channel.toLocal.data(),
+                                  channel.toLocal.size(), MSG_NOSIGNAL);
+        if (bytes > 0)
+        {
+            channel.toLocal.erase(0, static_cast<size_t>(bytes));
+        }
+        else if (errno != EAGAIN && errno != EINTR)
+        {
+            if (!channel.localEnded)
+            {
+                queueFrame(id, frameClose);
+            }
+            return false;
+        }
+    }
+    return true;
+}
+
+void Transport::queueFrame(uint32_t id, uint8_t type, std::string_view payload)
+{
+    const auto networkId = htonl(id);
+    const auto networkLength = htonl(static_cast<uint32_t>(payload.size()));
+    std::array<char, frameHeaderSize> header{};
+    std::memcpy(header.data(), &networkId, sizeof(networkId));
+    header[sizeof(networkId)] = static_cast<char>(type);
+    std::memcpy(header.data() + sizeof(networkId) + 1, &networkLength,
+                sizeof(networkLength));
+    _toSibling.append(header.data(), header.size());
+    _toSibling.append(payload);
+}
+
+void Transport::acceptLocal()
+{
+    utility::FD socket(::accept4(_localListener(), nullptr, nullptr,
+                                 SOCK_NONBLOCK | SOCK_CLOEXEC));
+    if (socket() < 0)
+    {
+        return;
+    }
+
+    if (!_handshakeDone)
+    {
+        // Fail the rsync at once, it retries like on an unreachable sibling
+        lg2::debug("No TLS session to the sibling, dropping a connection");
+        return;
+    }
+
+    setOption(socket(), IPPROTO_TCP, TCP_NODELAY, 1);
+    const auto id = _nextChannelId;
+    _nextChannelId += 2;
+    _channels.insert_or_assign(id, Channel(std::move(socket), false));
+    queueFrame(id, frameOpen);
+    ++_openedChannels;
+}
+
+std::unique_ptr<Transport> start()
+{
+    try
+    {
+        std::ifstream positionFile("/run/openbmc/bmc_position");
+        unsigned position{0};
+        if (!(positionFile >> position) || position > 1)
+        {
+            throw std::runtime_error("Failed to get the BMC position");
+        }
+
+        const fs::path certsDir(TLS_CERTS_DIR);
+        const auto name = "bmc" + std::to_string(position);
+        const auto port = [](const char* value) {
+            return static_cast<uint16_t>(std::stoul(value));
+        };
+
+        Settings settings{
+            .credentials = {.certFile = certsDir / (name + ".crt"),
+                            .keyFile = certsDir / (name + ".key"),
+                            .caFile = certsDir / "ca.crt"},
+            .localPort = port(position == 0 ? BMC1_RSYNC_PORT
+                                            : BMC0_RSYNC_PORT),
+            .servicePort = port(position == 0 ? BMC0_RSYNC_PORT
+                                              : BMC1_RSYNC_PORT),
+            .dial = std::nullopt,
+            .listenPort = std::nullopt,
+            .kernelTls = TLS_KERNEL_OFFLOAD != 0};
+        if (position == 0)
+        {
+            settings.dial = Endpoint{.host = BMC1_IP,
+                                     .port = port(BMC1_TLS_PORT)};
+        }
+        else
+        {
+            settings.listenPort = port(BMC1_TLS_PORT);
+        }
+
+        auto transport = std::make_unique<Transport>(std::move(settings));
+        lg2::info("Carrying the rsync connections to the sibling over the TLS "
+                  "transport");
+        return transport;
+    }
+    catch (const std::exception& e)
+    {
+        lg2::error("Failed to start the TLS transport, error: {ERROR}",
+                   "ERROR", e);
+    }
+    return nullptr;
+}
+
+#else
+
+void Transport::SslDeleter::operator()(ssl_st* /*ssl*/) const {}
+void Transport::SslDeleter::operator()(ssl_ctx_st* /*sslCtx*/) const {}
+void Transport::SslDeleter::operator()(ssl_session_st* /*session*/) const {}
+
+Transport::Transport(Settings settings) :
+    _settings(std::move(settings)), _localListener(-1), _sessionListener(-1),
+    _wakeFd(-1), _sessionSocket(-1)
+{
+    throw std::runtime_error("Built without the TLS transport");
+}
+
+Transport::~Transport() = default;
+
+void Transport::reconnect() {}
+
+Stats Transport::stats() const noexcept
+{
+    return {};
+}
+
+std::unique_ptr<Transport> start()
+{
+    return nullptr;
+}
+
+#endif
+
+} // namespace data_sync::tls
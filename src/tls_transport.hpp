@@ -0,0 +1,347 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "utility.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+
+struct ssl_st;
+struct ssl_ctx_st;
+struct ssl_session_st;
+
+namespace data_sync::tls
+{
+
+namespace fs = std::filesystem;
+
+/**
+ * @brief The payload of a frame at most, a TLS record fits one.
+ */
+constexpr size_t maxFramePayload = 16 * 1024;
+
+/**
+ * @brief The bytes queued towards the sibling or a local socket above which
+ *        the transport stops reading more for them.
+ */
+constexpr size_t maxPendingBytes = 256 * 1024;
+
+/**
+ * @brief The delays between the attempts to connect to the sibling, doubled
+ *        on each failed one.
+ */
+constexpr auto minReconnectDelay = std::chrono::seconds(1);
+constexpr auto maxReconnectDelay = std::chrono::seconds(30);
+
+/**
+ * @brief The certificate and the private key of this BMC and the CA which
+ *        signed the sibling's certificate, in the PEM format as generated by
+ *        scripts/gen_certs.sh.
+ */
+struct Credentials
+{
+    fs::path certFile;
+    fs::path keyFile;
+    fs::path caFile;
+};
+
+/**
+ * @brief The endpoint of the sibling's transport.
+ */
+struct Endpoint
+{
+    std::string host;
+    uint16_t port{0};
+};
+
+/**
+ * @brief The settings of a transport, the counterparts of the stunnel
+ *        configuration of a BMC.
+ */
+struct Settings
+{
+    Credentials credentials;
+
+    /**
+     * @brief The loopback port the local rsync connects to, to reach the
+     *        sibling's rsyncd.
+     */
+    uint16_t localPort{0};
+
+    /**
+     * @brief The loopback port of the local rsyncd, which the channels the
+     *        sibling opens connect to.
+     */
+    uint16_t servicePort{0};
+
+    /**
+     * @brief The sibling's transport to connect to, if this BMC sets up the
+     *        session.
+     */
+    std::optional<Endpoint> dial;
+
+    /**
+     * @brief The port to accept the sibling's session on, if the sibling sets
+     *        up the session.
+     */
+    std::optional<uint16_t> listenPort;
+
+    /**
+     * @brief Whether to let the kernel encrypt the records (kTLS), where the
+     *        kernel and the OpenSSL build support it.
+     */
+    bool kernelTls{false};
+};
+
+/**
+ * @brief The counters of a transport.
+ */
+struct Stats
+{
+    /**
+     * @brief The completed TLS handshakes, and the ones of them which resumed
+     *        an earlier session
+     */
+    uint64_t handshakes{0};
+    uint64_t resumedHandshakes{0};
+
+    /**
+     * @brief The channels opened in both directions
+     */
+    uint64_t channels{0};
+
+    /**
+     * @brief The bytes of the channels sent to and received from the sibling
+     */
+    uint64_t bytesSent{0};
+    uint64_t bytesReceived{0};
+};
+
+/**
+ * @class Transport
+ *
+ * @brief Carries the rsync connections to the sibling over a single,
+ *        persistent and mutually authenticated TLS session, instead of a TLS
+ *        connection per rsync through stunnel.
+ *
+ * Each connection of the local rsync to the local port opens a channel on
+ * the session, and the sibling connects the channel to its rsyncd, the same
+ * way in both directions. The channels are multiplexed on the session in
+ * frames of a channel id, a type (open, data or close) and the payload, a
+ * close ends the data of one direction like a TCP half close. The side which
+ * dials reconnects with a backoff, resuming the previous session to skip the
+ * full handshake.
+ *
+ * The transport runs on a thread of its own, with non-blocking sockets and
+ * TLS. A channel whose peer doesn't keep up holds the reads of the others
+ * back, which keeps the memory bounded by maxPendingBytes per direction.
+ */
+class Transport
+{
+  public:
+    Transport(const Transport&) = delete;
+    Transport& operator=(const Transport&) = delete;
+    Transport(Transport&&) = delete;
+    Transport& operator=(Transport&&) = delete;
+
+    /**
+     * @brief The constructor, which starts the transport thread.
+     *
+     * @param[in] settings - The settings of the transport
+     *
+     * @throw std::runtime_error if the credentials can't be loaded or the
+     *        ports can't be listened on
+     */
+    explicit Transport(Settings settings);
+
+    /**
+     * @brief The destructor, which closes the session and the channels.
+     */
+    ~Transport();
+
+    /**
+     * @brief Check whether the session to the sibling is up.
+     */
+    bool connected() const noexcept
+    {
+        return _connected.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Drop the session to the sibling, e.g. after a network change,
+     *        the dialing side reconnects at once.
+     */
+    void reconnect();
+
+    /**
+     * @brief Get the counters of the transport.
+     */
+    Stats stats() const noexcept;
+
+  private:
+    /**
+     * @brief A connection of a local socket carried on the session.
+     */
+    struct Channel
+    {
+        Channel(utility::FD fd, bool connecting) :
+            fd(std::move(fd)), connecting(connecting)
+        {}
+
+        utility::FD fd;
+
+        /**
+         * @brief The data received from the sibling yet to write locally
+         */
+        std::string toLocal;
+
+        /**
+         * @brief Whether the local connection is still being set up
+         */
+        bool connecting{false};
+
+        /**
+         * @brief Whether the local socket and the sibling ended their data
+         */
+        bool localEnded{false};
+        bool remoteEnded{false};
+
+        /**
+         * @brief Whether the end of the sibling's data was passed on locally
+         */
+        bool shutDown{false};
+    };
+
+    struct SslDeleter
+    {
+        void operator()(ssl_st* ssl) const;
+        void operator()(ssl_ctx_st* sslCtx) const;
+        void operator()(ssl_session_st* session) const;
+    };
+
+    /**
+     * @brief The loop of the transport thread, until the transport is
+     *        destroyed.
+     */
+    void run(const std::stop_token& stopToken);
+
+    /**
+     * @brief Start a session on the given connected socket.
+     */
+    void startSession(utility::FD socket, bool client);
+
+    /**
+     * @brief Close the session and all of its channels.
+     */
+    void closeSession();
+
+    /**
+     * @brief Connect to the sibling's transport, if due.
+     */
+    void dial(std::chrono::steady_clock::time_point now);
+
+    /**
+     * @brief Drive the handshake, the reads and the writes of the session.
+     *
+     * @return false if the session failed and got closed
+     */
+    bool serviceSession();
+
+    /**
+     * @brief Handle the frames received from the sibling.
+     *
+     * @return false on a malformed frame
+     */
+    bool handleFrames();
+
+    /**
+     * @brief Handle the events of a channel socket.
+     *
+     * @return false if the channel is done and can be dropped
+     */
+    bool serviceChannel(uint32_t id, Channel& channel, short events);
+
+    /**
+     * @brief Queue a frame to the sibling.
+     */
+    void queueFrame(uint32_t id, uint8_t type, std::string_view payload = {});
+
+    /**
+     * @brief Accept a connection of the local rsync and open a channel for it.
+     */
+    void acceptLocal();
+
+    const Settings _settings;
+
+    std::unique_ptr<ssl_ctx_st, SslDeleter> _serverCtx;
+    std::unique_ptr<ssl_ctx_st, SslDeleter> _clientCtx;
+
+    utility::FD _localListener;
+    utility::FD _sessionListener;
+    utility::FD _wakeFd;
+
+    /**
+     * @brief The session to the sibling, and its socket
+     */
+    std::unique_ptr<ssl_st, SslDeleter> _ssl;
+    utility::FD _sessionSocket;
+    bool _dialing{false};
+    bool _handshakeDone{false};
+
+    /**
+     * @brief The session to resume on the next connect
+     */
+    std::unique_ptr<ssl_session_st, SslDeleter> _savedSession;
+
+    /**
+     * @brief The decrypted bytes yet to parse, the frames yet to encrypt and
+     *        the length of the last write to retry, as OpenSSL requires.
+     */
+    std::string _fromSibling;
+    std::string _toSibling;
+    size_t _retryWriteLength{0};
+    bool _sslWantsWrite{false};
+
+    std::map<uint32_t, Channel> _channels;
+    uint32_t _nextChannelId{0};
+
+    std::chrono::steady_clock::time_point _nextDial{};
+    std::chrono::seconds _dialDelay{minReconnectDelay};
+
+    std::atomic<bool> _connected{false};
+    std::atomic<bool> _reconnect{false};
+
+    std::atomic<uint64_t> _handshakes{0};
+    std::atomic<uint64_t> _resumedHandshakes{0};
+    std::atomic<uint64_t> _openedChannels{0};
+    std::atomic<uint64_t> _bytesSent{0};
+    std::atomic<uint64_t> _bytesReceived{0};
+
+    /**
+     * @brief The transport thread, stopped and joined first on destruction
+     */
+    std::jthread _thread;
+};
+
+/**
+ * @brief Start the transport of this BMC in place of stunnel, with the ports
+ *        of the sync socket configuration and the certificates of the BMC
+ *        position.
+ *
+ * The BMC0 transport dials the BMC1 one, which accepts the session.
+ *
+ * @return The transport, or nullptr if it can't be started
+ */
+std::unique_ptr<Transport> start();
+
+} // namespace data_sync::tls
@@ -0,0 +1,143 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "transfer_selector.hpp"
+
+#include <sys/stat.h>
+
+namespace data_sync::transfer
+{
+
+namespace
+{
+
+/**
+ * @brief The literal data of a sync from which on it measures the link
+ *        throughput, the smaller ones take mostly the rsync start up.
+ */
+constexpr uint64_t minThroughputBytes = 256 * 1024;
+
+/**
+ * @brief The weight of the last sync in the throughput average.
+ */
+constexpr double throughputWeight = 0.25;
+
+/**
+ * @brief The number of tracked paths above which one is dropped for a new
+ *        one.
+ */
+constexpr size_t maxTrackedPaths = 1024;
+
+/**
+ * @brief The size of the blocks st_blocks counts.
+ */
+constexpr uintmax_t statBlockSize = 512;
+
+} // namespace
+
+std::string_view rsyncFlags(config::TransferMode mode)
+{
+    switch (mode)
+    {
+        case config::TransferMode::WholeFile:
+            return " --whole-file";
+        case config::TransferMode::InPlace:
+            return " --inplace";
+        case config::TransferMode::Sparse:
+            return " --sparse";
+        case config::TransferMode::Delta:
+        case config::TransferMode::Auto:
+            break;
+    }
+    return "";
+}
+
+config::TransferMode
+    TransferSelector::select(const config::DataSyncConfig& dataSyncCfg,
+                             const fs::path& path) const
+{
+    if (dataSyncCfg._transferMode != config::TransferMode::Auto)
+    {
+        return dataSyncCfg._transferMode;
+    }
+
+    // A directory holds files of all kinds, so it keeps to the delta
+    // transfer which suits them all.
+    struct stat fileStat{};
+    if (::stat(path.c_str(), &fileStat) != 0 || !S_ISREG(fileStat.st_mode))
+    {
+        return config::TransferMode::Delta;
+    }
+    return choose(path, static_cast<uintmax_t>(fileStat.st_size),
+                  static_cast<uintmax_t>(fileStat.st_blocks) * statBlockSize);
+}
+
+config::TransferMode TransferSelector::choose(const fs::path& path,
+                                              uintmax_t size,
+                                              uintmax_t allocatedSize) const
+{
+    if (size <= smallFileSize)
+    {
+        return config::TransferMode::WholeFile;
+    }
+
+    if (allocatedSize < size / 2)
+    {
+        return config::TransferMode::Sparse;
+    }
+
+    // Sending the matched part takes matchedRatio * size / throughput, and
+    // the checksum pass size / checksumBytesPerSec.
+    if (const auto it = _paths.find(path);
+        it != _paths.end() && _throughput.has_value() &&
+        it->second.wholeSyncs < deltaProbeInterval &&
+        it->second.matchedRatio < *_throughput / checksumBytesPerSec)
+    {
+        return config::TransferMode::WholeFile;
+    }
+
+    return config::TransferMode::Delta;
+}
+
+void TransferSelector::onTransferred(const fs::path& path,
+                                     config::TransferMode mode,
+                                     uint64_t literalBytes,
+                                     uint64_t matchedBytes,
+                                     std::chrono::microseconds duration)
+{
+    if (literalBytes >= minThroughputBytes && duration.count() > 0)
+    {
+        const auto rate = static_cast<double>(literalBytes) /
+                          std::chrono::duration<double>(duration).count();
+        _throughput = _throughput.has_value()
+                          ? (throughputWeight * rate) +
+                                ((1 - throughputWeight) * *_throughput)
+                          : rate;
+    }
+
+    if (mode == config::TransferMode::WholeFile)
+    {
+        // Nothing gets matched, the efficiency stays the one of the last
+        // delta sync.
+        if (auto it = _paths.find(path); it != _paths.end())
+        {
+            ++it->second.wholeSyncs;
+        }
+        return;
+    }
+
+    const auto totalBytes = literalBytes + matchedBytes;
+    if (totalBytes == 0)
+    {
+        return;
+    }
+
+    if (_paths.size() >= maxTrackedPaths && !_paths.contains(path))
+    {
+        _paths.erase(_paths.begin());
+    }
+    _paths[path] = {.matchedRatio = static_cast<double>(matchedBytes) /
+                                    static_cast<double>(totalBytes),
+                    .wholeSyncs = 0};
+}
+
+} // namespace data_sync::transfer
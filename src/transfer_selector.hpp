@@ -0,0 +1,143 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "data_sync_config.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+
+namespace data_sync::transfer
+{
+
+namespace fs = std::filesystem;
+
+/**
+ * @brief The files up to this size are sent whole, the block checksums of a
+ *        few blocks save nothing over sending them.
+ */
+constexpr uintmax_t smallFileSize = 64 * 1024;
+
+/**
+ * @brief The rate (in bytes per second) at which the BMC computes the block
+ *        checksums of a file, the cost of the delta transfer besides the
+ *        literal data.
+ */
+constexpr double checksumBytesPerSec = 32.0 * 1024 * 1024;
+
+/**
+ * @brief The syncs of a path sent whole after which the delta transfer is
+ *        tried again, to find out whether its changes got smaller.
+ */
+constexpr uint32_t deltaProbeInterval = 16;
+
+/**
+ * @brief Get the rsync flags of the given transfer mode.
+ *
+ * @param[in] mode - The transfer mode, other than Auto
+ *
+ * @return The flags with a leading space, or empty for the delta transfer
+ */
+std::string_view rsyncFlags(config::TransferMode mode);
+
+/**
+ * @class TransferSelector
+ *
+ * @brief Chooses the transfer mode of the syncs of the configurations in the
+ *        Auto mode, per file.
+ *
+ * A small file is sent whole and a sparse file keeps its holes. Otherwise,
+ * the delta transfer costs the block checksum pass over the file on top of
+ * sending its changed part, while the whole-file transfer sends all of it.
+ * So the file is sent whole if the part its previous delta syncs matched
+ * with the receiver's copy, sent over the measured link throughput, takes
+ * less than the checksum pass.
+ *
+ * The in place update is never chosen, an interrupted one leaves the
+ * sibling's only copy half old and half new, while the delta transfer
+ * resumes from its partial data.
+ *
+ * @note Not thread-safe, all updates are expected from the event loop thread.
+ */
+class TransferSelector
+{
+  public:
+    /**
+     * @brief Get the transfer mode of a sync.
+     *
+     * @param[in] dataSyncCfg - The configuration of the sync
+     * @param[in] path - The synced path
+     *
+     * @return The mode of the configuration, or the one chosen for the path
+     *         in the Auto mode
+     */
+    config::TransferMode select(const config::DataSyncConfig& dataSyncCfg,
+                                const fs::path& path) const;
+
+    /**
+     * @brief Choose the transfer mode of a regular file.
+     *
+     * @param[in] path - The file path
+     * @param[in] size - The size of the file
+     * @param[in] allocatedSize - The bytes allocated on the disk for it
+     *
+     * @return The chosen mode, other than Auto
+     */
+    config::TransferMode choose(const fs::path& path, uintmax_t size,
+                                uintmax_t allocatedSize) const;
+
+    /**
+     * @brief Account a finished sync of a path.
+     *
+     * @param[in] path - The synced path
+     * @param[in] mode - The transfer mode of the sync
+     * @param[in] literalBytes - The "Literal data" bytes reported by rsync
+     * @param[in] matchedBytes - The "Matched data" bytes reported by rsync
+     * @param[in] duration - The duration of the sync
+     */
+    void onTransferred(const fs::path& path, config::TransferMode mode,
+                       uint64_t literalBytes, uint64_t matchedBytes,
+                       std::chrono::microseconds duration);
+
+    /**
+     * @brief Get the measured link throughput in bytes per second.
+     */
+    std::optional<double> throughput() const noexcept
+    {
+        return _throughput;
+    }
+
+  private:
+    /**
+     * @brief The delta efficiency of the syncs of a path.
+     */
+    struct PathHistory
+    {
+        /**
+         * @brief The part of the file matched with the receiver's copy by
+         *        its last delta sync.
+         */
+        double matchedRatio{0};
+
+        /**
+         * @brief The syncs sent whole since the last delta sync.
+         */
+        uint32_t wholeSyncs{0};
+    };
+
+    /**
+     * @brief The delta efficiency of the synced files.
+     */
+    std::unordered_map<fs::path, PathHistory> _paths;
+
+    /**
+     * @brief The moving average of the literal data rate of the syncs.
+     */
+    std::optional<double> _throughput;
+};
+
+} // namespace data_sync::transfer
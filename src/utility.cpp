@@ -10,6 +10,8 @@
 
 #include <filesystem>
 #include <regex>
+#include <sstream>
+#include <string_view>
 #include <utility>
 
 namespace data_sync::utility
@@ -53,10 +55,9 @@ int FD::operator()() const
 
 void setupPaths()
 {
-    const fs::path persistPath{"/var/lib/phosphor-data-sync/"};
     std::error_code ec;
     // Directory to keep the sibling BMC's data as backup on local BMC
-    const fs::path bkpPath{persistPath / "bmc_data_bkp/"};
+    const fs::path bkpPath{backupDataDir};
     if (!fs::exists(bkpPath))
     {
         if (!fs::create_directories(bkpPath, ec))
@@ -98,17 +99,90 @@ void setupPaths()
 namespace rsync
 {
 
-size_t getTransferredDataBytes(const std::string& rsyncOpStr)
+namespace
+{
+
+/**
+ * @brief The prefix of the itemized lines, see itemizedOutFormat.
+ */
+constexpr std::string_view itemPrefix{"pds-item:"};
+
+/**
+ * @brief Get the numeric value of the given "--stats" field, rsync groups the
+ *        digits of the large values with commas (e.g. "1,234,567 bytes").
+ */
+size_t getStatValue(const std::string& rsyncOpStr, const std::string& field)
 {
-    // Regex to capture the numeric value of "Literal data:"
-    std::regex re(R"(Literal data:\s*([0-9]+(?:\.[0-9]+)?\s*\w+))");
+    std::regex re(field + R"(:\s*([0-9][0-9,]*(?:\.[0-9]+)?))");
     std::smatch match;
 
     if (std::regex_search(rsyncOpStr, match, re))
     {
-        return static_cast<size_t>(std::stod(match[1].str()));
+        auto value = match[1].str();
+        std::erase(value, ',');
+        return static_cast<size_t>(std::stod(value));
     }
     return 0;
 }
+
+} // namespace
+
+size_t getTransferredDataBytes(const std::string& rsyncOpStr)
+{
+    return getStatValue(rsyncOpStr, "Literal data");
+}
+
+size_t getMatchedDataBytes(const std::string& rsyncOpStr)
+{
+    return getStatValue(rsyncOpStr, "Matched data");
+}
+
+std::vector<fs::path> getChangedPaths(const std::string& rsyncOpStr)
+{
+    std::vector<fs::path> changedPaths;
+    std::istringstream output(rsyncOpStr);
+    for (std::string line; std::getline(output, line);)
+    {
+        const auto separator = line.find('|');
+        if (!line.starts_with(itemPrefix) || separator == std::string::npos)
+        {
+            continue;
+        }
+
+        // e.g. ">f.st......", "cL+++++++++", "*deleting  "
+        const std::string_view item(line.data() + itemPrefix.size(),
+                                    separator - itemPrefix.size());
+        const bool deleted = item.starts_with("*deleting");
+        if (!deleted && (item.size() < 2 || item[1] == 'd' ||
+                         std::string_view("<>ch").find(item[0]) ==
+                             std::string_view::npos))
+        {
+            continue;
+        }
+
+        // The names are relative to the root with "--relative"
+        fs::path path = "/" + line.substr(separator + 1);
+        if (!path.has_filename())
+        {
+            path = path.parent_path();
+        }
+        changedPaths.emplace_back(std::move(path));
+    }
+    return changedPaths;
+}
+
+std::string withoutItemizedPaths(const std::string& rsyncOpStr)
+{
+    std::string message;
+    std::istringstream output(rsyncOpStr);
+    for (std::string line; std::getline(output, line);)
+    {
+        if (!line.starts_with(itemPrefix))
+        {
+            message.append(line).push_back('\n');
+        }
+    }
+    return message;
+}
 } // namespace rsync
 } // namespace data_sync::utility
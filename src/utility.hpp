@@ -3,7 +3,9 @@
 #pragma once
 
 #include <cstddef>
+#include <filesystem>
 #include <string>
+#include <vector>
 namespace data_sync::utility
 {
 
@@ -54,6 +56,12 @@ class FD
     int fd = -1;
 };
 
+/**
+ * @brief The directory to keep the sibling BMC's data as backup on local BMC,
+ *        the sibling syncs a plain copy of it here.
+ */
+constexpr auto backupDataDir = "/var/lib/phosphor-data-sync/bmc_data_bkp/";
+
 /**
  * @brief Create the necessary persistent paths during startup
  *
@@ -83,5 +91,47 @@ namespace rsync
  */
 size_t getTransferredDataBytes(const std::string& rsyncOpStr);
 
+/**
+ * @brief Extract the bytes of file data matched with the receiver's basis
+ *        file, i.e. not transferred.
+ *
+ * @param[in] rsyncOpStr - rsync output string containing the transfer
+ *                         summary.
+ * @return size_t - numeric value of the matched size
+ *                - Returns 0 if the value is not found
+ */
+size_t getMatchedDataBytes(const std::string& rsyncOpStr);
+
+/**
+ * @brief The rsync "--out-format" which itemizes each path of the transfer
+ *        on its own line, prefixed to tell it apart from the rest of the
+ *        output. The itemized changes and the name are separated by "|".
+ */
+constexpr auto itemizedOutFormat = "pds-item:%i|%n";
+
+/**
+ * @brief Extract the paths which a sync changed on the receiver from the
+ *        itemized output of rsync (see itemizedOutFormat).
+ *
+ * A path counts as changed if its content got transferred, or it got
+ * created, hard linked or deleted. The directories which only got created
+ * and the paths whose attributes only changed are left out.
+ *
+ * @param[in] rsyncOpStr - rsync output string containing the itemized
+ *                         paths of a transfer with "--relative".
+ * @return std::vector<std::filesystem::path> - The absolute changed paths
+ */
+std::vector<std::filesystem::path>
+    getChangedPaths(const std::string& rsyncOpStr);
+
+/**
+ * @brief Drop the itemized paths from the output of rsync, to log it or to
+ *        add it to an error log without a line per changed path.
+ *
+ * @param[in] rsyncOpStr - rsync output string
+ * @return std::string - The output without the itemized lines
+ */
+std::string withoutItemizedPaths(const std::string& rsyncOpStr);
+
 } // namespace rsync
 } // namespace data_sync::utility
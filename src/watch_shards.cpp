@@ -0,0 +1,312 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "watch_shards.hpp"
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <phosphor-logging/lg2.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <iterator>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+
+namespace data_sync::watch::shard
+{
+
+namespace
+{
+
+void wakeUp(int eventFd)
+{
+    const uint64_t count = 1;
+    [[maybe_unused]] const auto written =
+        ::write(eventFd, &count, sizeof(count));
+}
+
+void clearWakeUps(int eventFd)
+{
+    uint64_t count{0};
+    [[maybe_unused]] const auto bytes = ::read(eventFd, &count, sizeof(count));
+}
+
+} // namespace
+
+Channel::Channel(WatchSpec spec) :
+    spec(std::move(spec)), readyFd(::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK))
+{
+    if (readyFd() < 0)
+    {
+        throw std::runtime_error("Failed to create the eventfd of the watcher "
+                                 "of " +
+                                 this->spec.path.string());
+    }
+}
+
+void Channel::deliver(inotify::DataOperations operations,
+                      std::exception_ptr error)
+{
+    if (outcomes.push(Outcome{std::move(operations), std::move(error)}))
+    {
+        wakeUp(readyFd());
+    }
+}
+
+void Channel::publishWatchedPaths()
+{
+    std::vector<fs::path> paths;
+    if (watcher)
+    {
+        const auto& wds = watcher->getWatchDescriptors();
+        paths.reserve(wds.size());
+        std::ranges::copy(wds | std::views::values, std::back_inserter(paths));
+    }
+    std::lock_guard lock(watchedPathsMutex);
+    watchedPaths = std::move(paths);
+}
+
+Shard::Shard(size_t id) :
+    _id(id), _epollFd(::epoll_create1(EPOLL_CLOEXEC)),
+    _wakeFd(::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK))
+{
+    if (_epollFd() < 0 || _wakeFd() < 0)
+    {
+        throw std::runtime_error("Failed to create the reactor of the shard " +
+                                 std::to_string(_id));
+    }
+
+    // The wake up of the shard is told apart by the null channel
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.ptr = nullptr;
+    if (::epoll_ctl(_epollFd(), EPOLL_CTL_ADD, _wakeFd(), &event) != 0)
+    {
+        throw std::runtime_error("Failed to watch the wake up of the shard " +
+                                 std::to_string(_id));
+    }
+
+    _thread = std::jthread(
+        [this](const std::stop_token& stopToken) { run(stopToken); });
+}
+
+Shard::~Shard()
+{
+    _thread.request_stop();
+    wakeUp(_wakeFd());
+    _thread.join();
+}
+
+void Shard::post(std::shared_ptr<Channel> channel)
+{
+    if (!channel->removed.load(std::memory_order_acquire))
+    {
+        _load.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (_posted.push(std::move(channel)))
+    {
+        wakeUp(_wakeFd());
+    }
+}
+
+void Shard::run(const std::stop_token& stopToken)
+{
+    lg2::debug("Watch shard {SHARD} started", "SHARD", _id);
+
+    constexpr size_t maxEvents = 16;
+    std::array<epoll_event, maxEvents> events{};
+    while (!stopToken.stop_requested())
+    {
+        const auto count = ::epoll_wait(_epollFd(), events.data(),
+                                        static_cast<int>(events.size()), -1);
+        if (count < 0)
+        {
+            if (errno != EINTR)
+            {
+                lg2::error("Watch shard {SHARD} failed to wait for the events, "
+                           "error: {ERROR}",
+                           "SHARD", _id, "ERROR", strerror(errno));
+                break;
+            }
+            continue;
+        }
+
+        bool posted{false};
+        const auto ready = std::span(events).first(static_cast<size_t>(count));
+        for (const auto& event : ready)
+        {
+            if (event.data.ptr == nullptr)
+            {
+                posted = true;
+                continue;
+            }
+
+            auto* channel = static_cast<Channel*>(event.data.ptr);
+            if (channel->removed.load(std::memory_order_acquire) ||
+                !channel->watcher)
+            {
+                // Destroyed once its removal is handled
+                continue;
+            }
+
+            try
+            {
+                auto operations = channel->watcher->handleEvents();
+                channel->publishWatchedPaths();
+                if (!operations.empty())
+                {
+                    channel->deliver(std::move(operations));
+                }
+            }
+            catch (const std::exception& e)
+            {
+                lg2::error("Watch shard {SHARD} failed to process the events "
+                           "of {PATH}, error: {ERROR}",
+                           "SHARD", _id, "PATH", channel->spec.path, "ERROR",
+                           e);
+                ::epoll_ctl(_epollFd(), EPOLL_CTL_DEL, channel->watcher->fd(),
+                            nullptr);
+                channel->watcher.reset();
+                channel->deliver({}, std::current_exception());
+            }
+        }
+
+        // After the events of the batch, as a removal may free a channel
+        if (posted)
+        {
+            clearWakeUps(_wakeFd());
+            handlePosted();
+        }
+    }
+
+    // The watchers go away on the thread they ran on
+    for (const auto& channel : _channels)
+    {
+        channel->watcher.reset();
+    }
+    _channels.clear();
+    lg2::debug("Watch shard {SHARD} stopped", "SHARD", _id);
+}
+
+void Shard::handlePosted()
+{
+    for (auto& channel : _posted.drain())
+    {
+        if (channel->removed.load(std::memory_order_acquire))
+        {
+            if (channel->watcher)
+            {
+                ::epoll_ctl(_epollFd(), EPOLL_CTL_DEL, channel->watcher->fd(),
+                            nullptr);
+                channel->watcher.reset();
+            }
+            std::erase(_channels, channel);
+            _load.fetch_sub(1, std::memory_order_relaxed);
+            continue;
+        }
+
+        try
+        {
+            // The initial walk of the tree runs here, off the event loop
+            const auto& spec = channel->spec;
+            channel->watcher = std::make_unique<inotify::DataWatcher>(
+                IN_NONBLOCK | IN_CLOEXEC, spec.eventMasks, spec.path,
+                spec.excludeList, spec.includeList);
+
+            epoll_event event{};
+            event.events = EPOLLIN;
+            event.data.ptr = channel.get();
+            if (::epoll_ctl(_epollFd(), EPOLL_CTL_ADD, channel->watcher->fd(),
+                            &event) != 0)
+            {
+                throw std::runtime_error("Failed to add the inotify instance "
+                                         "to the reactor, error: " +
+                                         std::string(strerror(errno)));
+            }
+            channel->publishWatchedPaths();
+            _channels.emplace_back(std::move(channel));
+        }
+        catch (const std::exception& e)
+        {
+            lg2::error("Watch shard {SHARD} failed to create the watcher of "
+                       "{PATH}, error: {ERROR}",
+                       "SHARD", _id, "PATH", channel->spec.path, "ERROR", e);
+            channel->watcher.reset();
+            channel->deliver({}, std::current_exception());
+            _channels.emplace_back(std::move(channel));
+        }
+    }
+}
+
+ShardedWatch::ShardedWatch(sdbusplus::async::context& ctx,
+                           std::shared_ptr<Channel> channel, Shard& shard) :
+    _channel(std::move(channel)), _shard(shard),
+    _readyFdio(std::make_unique<sdbusplus::async::fdio>(ctx,
+                                                        _channel->readyFd()))
+{
+    _shard.post(_channel);
+}
+
+ShardedWatch::~ShardedWatch()
+{
+    _readyFdio.reset();
+    _channel->removed.store(true, std::memory_order_release);
+    _shard.post(_channel);
+}
+
+// NOLINTNEXTLINE
+sdbusplus::async::task<inotify::DataOperations> ShardedWatch::onDataChange()
+{
+    while (true)
+    {
+        // NOLINTNEXTLINE
+        co_await _readyFdio->next();
+        clearWakeUps(_channel->readyFd());
+
+        inotify::DataOperations operations;
+        for (auto& outcome : _channel->outcomes.drain())
+        {
+            if (outcome.error)
+            {
+                std::rethrow_exception(outcome.error);
+            }
+            std::ranges::move(outcome.operations,
+                              std::back_inserter(operations));
+        }
+        if (!operations.empty())
+        {
+            co_return operations;
+        }
+    }
+}
+
+std::vector<fs::path> ShardedWatch::watchedPaths() const
+{
+    std::lock_guard lock(_channel->watchedPathsMutex);
+    return _channel->watchedPaths;
+}
+
+ShardPool::ShardPool(sdbusplus::async::context& ctx, size_t shards) :
+    _ctx(ctx)
+{
+    for (size_t id = 0; id < std::max<size_t>(shards, 1); ++id)
+    {
+        _shards.emplace_back(std::make_unique<Shard>(id));
+    }
+    lg2::info("Processing the inotify events on {COUNT} watch shards", "COUNT",
+              _shards.size());
+}
+
+std::unique_ptr<ShardedWatch> ShardPool::watch(WatchSpec spec)
+{
+    auto& shard = *std::ranges::min_element(
+        _shards, {}, [](const auto& shard) { return shard->load(); });
+    return std::make_unique<ShardedWatch>(
+        _ctx, std::make_shared<Channel>(std::move(spec)), *shard);
+}
+
+} // namespace data_sync::watch::shard
@@ -0,0 +1,325 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "data_watcher.hpp"
+#include "utility.hpp"
+
+#include <sdbusplus/async.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+namespace data_sync::watch::shard
+{
+
+namespace fs = std::filesystem;
+
+/**
+ * @class MpscQueue
+ *
+ * @brief A lock-free queue of many producers and a single consumer.
+ *
+ * The producers push onto an intrusive stack with a compare and swap, the
+ * consumer takes the whole stack with an exchange and reverses it into the
+ * push order, so neither side ever waits on the other.
+ */
+template <typename T>
+class MpscQueue
+{
+  public:
+    MpscQueue() = default;
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+    MpscQueue(MpscQueue&&) = delete;
+    MpscQueue& operator=(MpscQueue&&) = delete;
+
+    ~MpscQueue()
+    {
+        drain();
+    }
+
+    /**
+     * @brief Push the given value, from any thread.
+     *
+     * @return true if the queue was empty, so the consumer needs a wake up;
+     *         otherwise false as one is due already
+     */
+    bool push(T value)
+    {
+        // NOLINTNEXTLINE(cppcoreguidelines-owning-memory)
+        auto* node = new Node{std::move(value),
+                              _head.load(std::memory_order_relaxed)};
+        while (!_head.compare_exchange_weak(node->next, node,
+                                            std::memory_order_release,
+                                            std::memory_order_relaxed))
+        {}
+        return node->next == nullptr;
+    }
+
+    /**
+     * @brief Take all the pushed values in their push order, from the
+     *        consumer thread only.
+     */
+    std::vector<T> drain()
+    {
+        std::vector<T> values;
+        auto* node = _head.exchange(nullptr, std::memory_order_acquire);
+        while (node != nullptr)
+        {
+            values.emplace_back(std::move(node->value));
+            // NOLINTNEXTLINE(cppcoreguidelines-owning-memory)
+            delete std::exchange(node, node->next);
+        }
+        std::ranges::reverse(values);
+        return values;
+    }
+
+  private:
+    struct Node
+    {
+        T value;
+        Node* next;
+    };
+
+    std::atomic<Node*> _head{nullptr};
+};
+
+/**
+ * @brief What a watcher is created for on its shard.
+ */
+struct WatchSpec
+{
+    fs::path path;
+    uint32_t eventMasks{0};
+    std::optional<std::unordered_set<fs::path>> excludeList;
+    std::optional<std::unordered_set<fs::path>> includeList;
+};
+
+/**
+ * @brief The state of a sharded watcher, shared by its shard thread and the
+ *        event loop thread.
+ */
+struct Channel
+{
+    explicit Channel(WatchSpec spec);
+
+    /**
+     * @brief Hand the given outcome of the watcher over to the event loop.
+     */
+    void deliver(inotify::DataOperations operations,
+                 std::exception_ptr error = nullptr);
+
+    /**
+     * @brief Publish the paths the watcher currently watches.
+     */
+    void publishWatchedPaths();
+
+    const WatchSpec spec;
+
+    /**
+     * @brief The watcher, created, driven and destroyed on the shard thread
+     */
+    std::unique_ptr<inotify::DataWatcher> watcher;
+
+    /**
+     * @brief The outcomes of the watcher for the event loop, and the
+     *        eventfd which wakes the event loop up for them
+     */
+    struct Outcome
+    {
+        inotify::DataOperations operations;
+        std::exception_ptr error;
+    };
+    MpscQueue<Outcome> outcomes;
+    utility::FD readyFd;
+
+    /**
+     * @brief Set by the event loop once it doesn't want the watcher anymore
+     */
+    std::atomic<bool> removed{false};
+
+    /**
+     * @brief The watched paths as published by the shard thread
+     */
+    mutable std::mutex watchedPathsMutex;
+    std::vector<fs::path> watchedPaths;
+};
+
+/**
+ * @class Shard
+ *
+ * @brief An event loop thread with a reactor of its own, which reads and
+ *        processes the inotify events of the watchers assigned to it.
+ */
+class Shard
+{
+  public:
+    Shard(const Shard&) = delete;
+    Shard& operator=(const Shard&) = delete;
+    Shard(Shard&&) = delete;
+    Shard& operator=(Shard&&) = delete;
+
+    /**
+     * @brief The constructor, which starts the thread.
+     *
+     * @param[in] id - The index of the shard, for the logs
+     *
+     * @throw std::runtime_error if the reactor can't be created
+     */
+    explicit Shard(size_t id);
+
+    /**
+     * @brief The destructor, which stops the thread and destroys the
+     *        watchers on it.
+     */
+    ~Shard();
+
+    /**
+     * @brief Ask the shard to create the watcher of the given channel, or
+     *        destroy it once the channel is marked removed.
+     */
+    void post(std::shared_ptr<Channel> channel);
+
+    /**
+     * @brief Get the number of the watchers assigned to the shard.
+     */
+    size_t load() const noexcept
+    {
+        return _load.load(std::memory_order_relaxed);
+    }
+
+  private:
+    /**
+     * @brief The reactor loop of the shard thread.
+     */
+    void run(const std::stop_token& stopToken);
+
+    /**
+     * @brief Create or destroy the watchers of the posted channels.
+     */
+    void handlePosted();
+
+    size_t _id;
+    utility::FD _epollFd;
+    utility::FD _wakeFd;
+    MpscQueue<std::shared_ptr<Channel>> _posted;
+
+    /**
+     * @brief The channels with a live watcher, used by the shard thread only
+     */
+    std::vector<std::shared_ptr<Channel>> _channels;
+
+    std::atomic<size_t> _load{0};
+
+    /**
+     * @brief The shard thread, stopped and joined first on destruction
+     */
+    std::jthread _thread;
+};
+
+/**
+ * @class ShardedWatch
+ *
+ * @brief The handle of a watcher which runs on a shard, on the event loop.
+ *
+ * It stands in for the DataWatcher of the configuration, so the data
+ * operations are received on the event loop thread as from one.
+ */
+class ShardedWatch
+{
+  public:
+    ShardedWatch(const ShardedWatch&) = delete;
+    ShardedWatch& operator=(const ShardedWatch&) = delete;
+    ShardedWatch(ShardedWatch&&) = delete;
+    ShardedWatch& operator=(ShardedWatch&&) = delete;
+
+    /**
+     * @brief The constructor
+     *
+     * @param[in] ctx - The async context to receive the operations on
+     * @param[in] channel - The channel of the watcher
+     * @param[in] shard - The shard which runs the watcher
+     */
+    ShardedWatch(sdbusplus::async::context& ctx,
+                 std::shared_ptr<Channel> channel, Shard& shard);
+
+    /**
+     * @brief The destructor, which has the shard destroy the watcher.
+     */
+    ~ShardedWatch();
+
+    /**
+     * @brief Wait for the data operations of the watcher.
+     *
+     * @returns The data operations of the events received since the last
+     *          call
+     *
+     * @throw The exception of the watcher if it failed on the shard
+     */
+    sdbusplus::async::task<inotify::DataOperations> onDataChange();
+
+    /**
+     * @brief Get the paths the watcher currently watches.
+     */
+    std::vector<fs::path> watchedPaths() const;
+
+  private:
+    std::shared_ptr<Channel> _channel;
+    Shard& _shard;
+    std::unique_ptr<sdbusplus::async::fdio> _readyFdio;
+};
+
+/**
+ * @class ShardPool
+ *
+ * @brief Spreads the watchers of the configurations over the given number
+ *        of shards, so that a burst of events on a big tree doesn't hold up
+ *        the D-Bus server and the other configurations on the event loop.
+ *
+ * Only the inotify reading and processing, including the walks of the new
+ * directories, runs on the shards. The resulting data operations are queued
+ * back to the event loop, which schedules the syncs and keeps all the sync
+ * and D-Bus state as before.
+ */
+class ShardPool
+{
+  public:
+    ShardPool(const ShardPool&) = delete;
+    ShardPool& operator=(const ShardPool&) = delete;
+    ShardPool(ShardPool&&) = delete;
+    ShardPool& operator=(ShardPool&&) = delete;
+    ~ShardPool() = default;
+
+    /**
+     * @brief The constructor
+     *
+     * @param[in] ctx - The async context to receive the operations on
+     * @param[in] shards - The number of the shard threads
+     */
+    ShardPool(sdbusplus::async::context& ctx, size_t shards);
+
+    /**
+     * @brief Create a watcher on the least loaded shard.
+     *
+     * @param[in] spec - What to watch
+     *
+     * @return The handle of the watcher on the event loop, which must not
+     *         outlive the pool
+     */
+    std::unique_ptr<ShardedWatch> watch(WatchSpec spec);
+
+  private:
+    sdbusplus::async::context& _ctx;
+    std::vector<std::unique_ptr<Shard>> _shards;
+};
+
+} // namespace data_sync::watch::shard
@@ -0,0 +1,65 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "worker_pool.hpp"
+
+#include <phosphor-logging/lg2.hpp>
+
+#include <algorithm>
+
+namespace data_sync::worker
+{
+
+Pool::Pool(sdbusplus::async::context& ctx, clock::Clock& clock,
+           size_t threads) : _ctx(ctx), _clock(clock)
+{
+    for (size_t i = 0; i < std::max<size_t>(threads, 1); ++i)
+    {
+        _threads.emplace_back(
+            [this](const std::stop_token& stopToken) { work(stopToken); });
+    }
+}
+
+Pool::~Pool()
+{
+    for (auto& thread : _threads)
+    {
+        thread.request_stop();
+    }
+    _threads.clear();
+
+    if (!_jobs.empty())
+    {
+        lg2::debug("Dropping {COUNT} queued jobs of the worker pool", "COUNT",
+                   _jobs.size());
+    }
+}
+
+void Pool::submit(std::function<void()> job)
+{
+    {
+        std::lock_guard lock(_mutex);
+        _jobs.emplace_back(std::move(job));
+    }
+    _jobAvailable.notify_one();
+}
+
+void Pool::work(const std::stop_token& stopToken)
+{
+    while (true)
+    {
+        std::function<void()> job;
+        {
+            std::unique_lock lock(_mutex);
+            if (!_jobAvailable.wait(lock, stopToken,
+                                    [this]() { return !_jobs.empty(); }))
+            {
+                return;
+            }
+            job = std::move(_jobs.front());
+            _jobs.pop_front();
+        }
+        job();
+    }
+}
+
+} // namespace data_sync::worker
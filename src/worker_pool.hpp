@@ -0,0 +1,187 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "clock.hpp"
+#include "utility.hpp"
+
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <sdbusplus/async.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+namespace data_sync::worker
+{
+
+/**
+ * @brief The threads of the pool, the blocking work is mostly bound by the
+ *        flash, so a couple are enough to keep one slow write from holding up
+ *        the rest.
+ */
+constexpr size_t defaultThreads = 2;
+
+/**
+ * @class Pool
+ *
+ * @brief Runs the blocking filesystem work off the event loop thread.
+ *
+ * The daemon runs on a single event loop, so a stat, a walk or a write which
+ * stalls on the flash would hold up every sync and the D-Bus server. A job
+ * run through the pool executes on one of its threads and the awaiting task
+ * resumes on the event loop once it finishes, with the result or the
+ * exception of the job.
+ *
+ * The jobs run concurrently with the event loop and with each other, so they
+ * must only touch what they are given, never the state of the daemon.
+ */
+class Pool
+{
+  public:
+    Pool(const Pool&) = delete;
+    Pool& operator=(const Pool&) = delete;
+    Pool(Pool&&) = delete;
+    Pool& operator=(Pool&&) = delete;
+
+    /**
+     * @brief The destructor, which waits for the running jobs and drops the
+     *        queued ones.
+     */
+    ~Pool();
+
+    /**
+     * @brief The constructor
+     *
+     * @param[in] ctx - The async context to resume the awaiting tasks on
+     * @param[in] clock - The clock to mark busy while a job runs, as a
+     *                    virtual clock can't see the work of the threads
+     * @param[in] threads - The number of the worker threads
+     */
+    Pool(sdbusplus::async::context& ctx, clock::Clock& clock,
+         size_t threads = defaultThreads);
+
+    /**
+     * @brief Run the given job on a worker thread.
+     *
+     * The job runs inline if the completion can't be awaited, so that the
+     * work is done either way.
+     *
+     * @param[in] job - The callable to run, it is kept alive until it
+     *                  finishes even if the awaiting task is cancelled
+     *
+     * @return The result of the job, or rethrows its exception
+     */
+    template <typename Job>
+    sdbusplus::async::task<std::invoke_result_t<Job>> run(Job job);
+
+  private:
+    /**
+     * @brief Queue the given job for the next free worker thread.
+     */
+    void submit(std::function<void()> job);
+
+    /**
+     * @brief The loop of a worker thread, until the pool is destroyed.
+     */
+    void work(const std::stop_token& stopToken);
+
+    sdbusplus::async::context& _ctx;
+    clock::Clock& _clock;
+
+    std::mutex _mutex;
+    std::condition_variable_any _jobAvailable;
+    std::deque<std::function<void()>> _jobs;
+
+    /**
+     * @brief The worker threads, stopped and joined first on destruction
+     */
+    std::vector<std::jthread> _threads;
+};
+
+template <typename Job>
+// NOLINTNEXTLINE
+sdbusplus::async::task<std::invoke_result_t<Job>> Pool::run(Job job)
+{
+    using Result = std::invoke_result_t<Job>;
+
+    /**
+     * @brief The job and its outcome, shared by the awaiting task and the
+     *        worker thread.
+     */
+    struct State
+    {
+        explicit State(Job&& job) :
+            job(std::move(job)),
+            doneFd(::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK))
+        {}
+
+        Job job;
+        utility::FD doneFd;
+        std::atomic<bool> done{false};
+        std::conditional_t<std::is_void_v<Result>, std::monostate,
+                           std::optional<Result>>
+            result;
+        std::exception_ptr error;
+    };
+
+    auto state = std::make_shared<State>(std::move(job));
+    if (state->doneFd() < 0)
+    {
+        co_return state->job();
+    }
+
+    submit([state]() {
+        try
+        {
+            if constexpr (std::is_void_v<Result>)
+            {
+                state->job();
+            }
+            else
+            {
+                state->result.emplace(state->job());
+            }
+        }
+        catch (...)
+        {
+            state->error = std::current_exception();
+        }
+        state->done.store(true, std::memory_order_release);
+
+        const uint64_t wakeUp = 1;
+        [[maybe_unused]] const auto written =
+            ::write(state->doneFd(), &wakeUp, sizeof(wakeUp));
+    });
+
+    {
+        clock::BusyScope busy(_clock);
+        sdbusplus::async::fdio doneFdio(_ctx, state->doneFd());
+        while (!state->done.load(std::memory_order_acquire))
+        {
+            co_await doneFdio.next();
+        }
+    }
+
+    if (state->error)
+    {
+        std::rethrow_exception(state->error);
+    }
+    if constexpr (!std::is_void_v<Result>)
+    {
+        co_return std::move(*state->result);
+    }
+}
+
+} // namespace data_sync::worker
@@ -0,0 +1,190 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "chunk_store.hpp"
+
+#include <fstream>
+#include <random>
+#include <set>
+
+#include <gtest/gtest.h>
+
+namespace backup = data_sync::backup;
+namespace fs = std::filesystem;
+
+namespace
+{
+
+std::vector<uint8_t> randomData(size_t size, uint32_t seed)
+{
+    std::mt19937 gen(seed);
+    std::vector<uint8_t> data(size);
+    for (auto& byte : data)
+    {
+        byte = static_cast<uint8_t>(gen());
+    }
+    return data;
+}
+
+void writeData(const fs::path& path, const std::vector<uint8_t>& data)
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    file.write(reinterpret_cast<const char*>(data.data()),
+               static_cast<std::streamsize>(data.size()));
+}
+
+std::vector<uint8_t> readData(const fs::path& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    return {std::istreambuf_iterator<char>(file),
+            std::istreambuf_iterator<char>()};
+}
+
+} // namespace
+
+class ChunkStoreTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        fs::remove_all(testDir);
+        fs::create_directories(sourceDir / "logs");
+    }
+
+    void TearDown() override
+    {
+        fs::remove_all(testDir);
+    }
+
+    const fs::path testDir{"/tmp/phosphor-data-sync/chunk_store_test"};
+    const fs::path sourceDir{testDir / "source"};
+    const fs::path storeDir{testDir / "store"};
+    const fs::path restoreDir{testDir / "restore"};
+};
+
+TEST_F(ChunkStoreTest, TestChunksSurviveInsertion)
+{
+    auto data = randomData(1024 * 1024, 1);
+    const auto sizes = backup::splitChunks(data);
+
+    size_t total = 0;
+    for (size_t i = 0; i < sizes.size(); ++i)
+    {
+        total += sizes[i];
+        EXPECT_LE(sizes[i], backup::maxChunkSize);
+        if (i + 1 < sizes.size())
+        {
+            EXPECT_GE(sizes[i], backup::minChunkSize);
+        }
+    }
+    EXPECT_EQ(total, data.size());
+
+    auto chunkSet = [](const std::vector<uint8_t>& bytes) {
+        std::set<std::vector<uint8_t>> chunks;
+        size_t offset = 0;
+        for (const auto size : backup::splitChunks(bytes))
+        {
+            chunks.emplace(bytes.begin() + offset,
+                           bytes.begin() + offset + size);
+            offset += size;
+        }
+        return chunks;
+    };
+
+    // Only the chunks around the inserted bytes change
+    const auto before = chunkSet(data);
+    data.insert(data.begin() + 1000, 100, 0x55);
+    const auto after = chunkSet(data);
+    size_t shared = 0;
+    for (const auto& chunk : after)
+    {
+        shared += before.contains(chunk) ? 1 : 0;
+    }
+    EXPECT_GE(shared + 3, before.size());
+}
+
+TEST_F(ChunkStoreTest, TestBackupDedupAndRestore)
+{
+    auto log = randomData(256 * 1024, 2);
+    writeData(sourceDir / "logs" / "events.log", log);
+    writeData(sourceDir / "config.json", randomData(100, 3));
+    fs::create_symlink("logs/events.log", sourceDir / "latest");
+    fs::permissions(sourceDir / "config.json", fs::perms::owner_read);
+
+    backup::ChunkStore store(storeDir, 5);
+    const auto first = store.backup(sourceDir);
+    EXPECT_EQ(first.version, 1U);
+    EXPECT_EQ(first.files, 2U);
+    EXPECT_EQ(first.logicalBytes, log.size() + 100);
+    EXPECT_EQ(first.newChunks, first.chunks);
+
+    // Appending to the log writes only its tail chunk and the manifest
+    const auto appended = randomData(4096, 4);
+    log.insert(log.end(), appended.begin(), appended.end());
+    writeData(sourceDir / "logs" / "events.log", log);
+    const auto second = store.backup(sourceDir);
+    EXPECT_EQ(second.version, 2U);
+    EXPECT_LE(second.newChunks, 3U);
+    EXPECT_LT(second.writeAmplification(), 0.2);
+
+    const auto stats = store.stats();
+    EXPECT_EQ(stats.versions, 2U);
+    EXPECT_GT(stats.dedupRatio(), 1.8);
+
+    store.restore(1, restoreDir);
+    EXPECT_EQ(readData(restoreDir / "logs" / "events.log").size(),
+              256U * 1024);
+    EXPECT_EQ(readData(restoreDir / "config.json"),
+              readData(sourceDir / "config.json"));
+    EXPECT_EQ(fs::read_symlink(restoreDir / "latest"), "logs/events.log");
+    EXPECT_EQ(fs::status(restoreDir / "config.json").permissions(),
+              fs::perms::owner_read);
+
+    store.restore(2, restoreDir);
+    EXPECT_EQ(readData(restoreDir / "logs" / "events.log"), log);
+}
+
+TEST_F(ChunkStoreTest, TestRetentionPrunesVersionsAndChunks)
+{
+    backup::ChunkStore store(storeDir, 2);
+    for (uint32_t seed = 0; seed < 3; ++seed)
+    {
+        writeData(sourceDir / "logs" / "events.log",
+                  randomData(64 * 1024, seed));
+        store.backup(sourceDir / "logs" / "events.log");
+    }
+
+    const auto versions = store.versions();
+    ASSERT_EQ(versions.size(), 2U);
+    EXPECT_EQ(versions[0].version, 2U);
+    EXPECT_EQ(versions[1].version, 3U);
+    EXPECT_EQ(versions[1].files, 1U);
+    EXPECT_THROW(store.restore(1, restoreDir), std::runtime_error);
+
+    // The chunks of the pruned version are gone with it
+    const auto stats = store.stats();
+    EXPECT_LT(stats.storedBytes, 2U * 64 * 1024 + 4096);
+
+    // A backed up file is restored under its name
+    store.restore(3, restoreDir);
+    EXPECT_EQ(readData(restoreDir / "events.log"), randomData(64 * 1024, 2));
+}
+
+TEST_F(ChunkStoreTest, TestStoreUnderSourceIsNotBackedUp)
+{
+    writeData(sourceDir / "logs" / "events.log", randomData(64 * 1024, 5));
+
+    // Given with a trailing separator, as the configured paths are
+    backup::ChunkStore store(sourceDir / "store/", 5);
+    const auto first = store.backup(sourceDir);
+    const auto second = store.backup(sourceDir);
+
+    // Only the log, not the chunks and the manifest of the first version
+    EXPECT_EQ(first.files, 1U);
+    EXPECT_EQ(second.files, 1U);
+    EXPECT_EQ(second.newChunks, 0U);
+
+    store.restore(2, restoreDir);
+    EXPECT_FALSE(fs::exists(restoreDir / "store"));
+    EXPECT_EQ(readData(restoreDir / "logs" / "events.log"),
+              randomData(64 * 1024, 5));
+}
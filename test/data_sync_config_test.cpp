@@ -488,3 +488,111 @@ TEST(DataSyncConfigParserTest, TestSyncConfigWithSelectivePathSiblingNotify)
     EXPECT_EQ(dataSyncConfig._excludeList, std::nullopt);
     EXPECT_EQ(dataSyncConfig._includeList, std::nullopt);
 }
+
+/*
+ * Test when the input JSON opts to batch the syncs of the hot paths, with an
+ * exit rate which is not below the enter rate.
+ */
+TEST(DataSyncConfigParserTest, TestImmediateFileSyncWithHotPathBatching)
+{
+    const auto configJSON = R"(
+        {
+            "Path": "/file/path/to/sync",
+            "Description": "Add details about the data and purpose of the synchronization",
+            "SyncDirection": "Active2Passive",
+            "SyncType": "Immediate",
+            "HotPathBatching": {
+                "EnterRatePerMin": 12,
+                "ExitRatePerMin": 12,
+                "MinSyncInterval": "PT1M"
+            }
+        }
+    )"_json;
+
+    data_sync::config::DataSyncConfig dataSyncConfig(configJSON, false);
+
+    ASSERT_TRUE(dataSyncConfig._hotPathBatching.has_value());
+    EXPECT_EQ(dataSyncConfig._hotPathBatching->_enterRatePerMin, 12U);
+    EXPECT_EQ(dataSyncConfig._hotPathBatching->_exitRatePerMin, 6U);
+    EXPECT_EQ(dataSyncConfig._hotPathBatching->_minSyncInterval,
+              std::chrono::seconds(60));
+
+    // The defaults apply to the missing limits
+    const auto defaultsJSON = R"(
+        {
+            "Path": "/file/path/to/sync",
+            "Description": "Add details about the data and purpose of the synchronization",
+            "SyncDirection": "Active2Passive",
+            "SyncType": "Immediate",
+            "HotPathBatching": {}
+        }
+    )"_json;
+
+    data_sync::config::DataSyncConfig defaultsConfig(defaultsJSON, false);
+    EXPECT_EQ(defaultsConfig._hotPathBatching,
+              data_sync::config::HotPathBatching(20, 5,
+                                                 std::chrono::seconds(30)));
+}
+
+TEST(DataSyncConfigParserTest, TestImmediateFileSyncWithMetadata)
+{
+    const auto configJSON = R"(
+        {
+            "Path": "/file/path/to/sync",
+            "Description": "Add details about the data and purpose of the synchronization",
+            "SyncDirection": "Active2Passive",
+            "SyncType": "Immediate",
+            "SyncMetadata": true
+        }
+    )"_json;
+
+    data_sync::config::DataSyncConfig dataSyncConfig(configJSON, false);
+    EXPECT_TRUE(dataSyncConfig._syncMetadata);
+
+    // Not applicable to the periodic sync, it syncs the metadata anyway
+    const auto periodicJSON = R"(
+        {
+            "Path": "/file/path/to/sync",
+            "Description": "Add details about the data and purpose of the synchronization",
+            "SyncDirection": "Active2Passive",
+            "SyncType": "Periodic",
+            "Periodicity": "PT1M",
+            "SyncMetadata": true
+        }
+    )"_json;
+
+    data_sync::config::DataSyncConfig periodicConfig(periodicJSON, false);
+    EXPECT_FALSE(periodicConfig._syncMetadata);
+}
+
+TEST(DataSyncConfigParserTest, TestFileSyncWithTransferMode)
+{
+    const auto configJSON = R"(
+        {
+            "Path": "/file/path/to/sync",
+            "Description": "Add details about the data and purpose of the synchronization",
+            "SyncDirection": "Active2Passive",
+            "SyncType": "Immediate",
+            "TransferMode": "Auto"
+        }
+    )"_json;
+
+    data_sync::config::DataSyncConfig dataSyncConfig(configJSON, false);
+    EXPECT_EQ(dataSyncConfig._transferMode,
+              data_sync::config::TransferMode::Auto);
+
+    // An unsupported mode falls back to the delta transfer
+    const auto invalidJSON = R"(
+        {
+            "Path": "/file/path/to/sync",
+            "Description": "Add details about the data and purpose of the synchronization",
+            "SyncDirection": "Active2Passive",
+            "SyncType": "Immediate",
+            "TransferMode": "Compressed"
+        }
+    )"_json;
+
+    data_sync::config::DataSyncConfig invalidConfig(invalidJSON, false);
+    EXPECT_EQ(invalidConfig._transferMode,
+              data_sync::config::TransferMode::Delta);
+}
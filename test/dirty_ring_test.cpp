@@ -0,0 +1,238 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "dirty_ring.hpp"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace fs = std::filesystem;
+using namespace data_sync::dirty_ring;
+
+class DirtyRingTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        const auto* testInfo =
+            ::testing::UnitTest::GetInstance()->current_test_info();
+        ringPath = fs::temp_directory_path() / "dirty_ring_test" /
+                   testInfo->name();
+    }
+
+    void TearDown() override
+    {
+        fs::remove_all(ringPath.parent_path());
+    }
+
+    static bool wakeupPending(const DirtyRingReader& reader)
+    {
+        pollfd wakeFd{reader.wakeFd(), POLLIN, 0};
+        return poll(&wakeFd, 1, 0) == 1;
+    }
+
+    /**
+     * @brief Claim the next slot for a producer which died before publishing
+     *        it.
+     */
+    void claimByDeadProducer() const
+    {
+        const auto deadPid = fork();
+        if (deadPid == 0)
+        {
+            _exit(0);
+        }
+        ASSERT_GT(deadPid, 0);
+        waitpid(deadPid, nullptr, 0);
+
+        const int ringFd = open(ringPath.c_str(), O_RDWR | O_CLOEXEC);
+        ASSERT_GE(ringFd, 0);
+        void* addr = mmap(nullptr, sizeof(Ring), PROT_READ | PROT_WRITE,
+                          MAP_SHARED, ringFd, 0);
+        close(ringFd);
+        ASSERT_NE(addr, MAP_FAILED);
+        auto* ring = static_cast<Ring*>(addr);
+        ring->slots[ring->head & (ringCapacity - 1)].pid =
+            static_cast<uint32_t>(deadPid);
+        ++ring->head;
+        munmap(addr, sizeof(Ring));
+    }
+
+    fs::path ringPath;
+};
+
+TEST_F(DirtyRingTest, TestPushAndPop)
+{
+    EXPECT_THROW(DirtyRingWriter{ringPath}, std::runtime_error);
+
+    DirtyRingReader reader(ringPath);
+    ASSERT_TRUE(fs::exists(ringPath));
+    ASSERT_TRUE(fs::is_fifo(wakePath(ringPath)));
+    EXPECT_FALSE(reader.pop().has_value());
+
+    DirtyRingWriter writer(ringPath);
+    EXPECT_TRUE(writer.push("/var/lib/a"));
+    EXPECT_TRUE(writer.push("/var/lib/b/file"));
+    EXPECT_FALSE(writer.push(""));
+    EXPECT_FALSE(writer.push(std::string(maxPathLen, 'x')));
+
+    EXPECT_EQ(reader.pop(), "/var/lib/a");
+    EXPECT_EQ(reader.pop(), "/var/lib/b/file");
+    EXPECT_FALSE(reader.pop().has_value());
+    EXPECT_EQ(reader.dropped(), 0U);
+}
+
+TEST_F(DirtyRingTest, TestFullRingDropsAndRecovers)
+{
+    DirtyRingReader reader(ringPath);
+    DirtyRingWriter writer(ringPath);
+
+    for (uint32_t i = 0; i < ringCapacity; ++i)
+    {
+        ASSERT_TRUE(writer.push("/var/lib/" + std::to_string(i)));
+    }
+    EXPECT_FALSE(writer.push("/var/lib/overflow"));
+    EXPECT_EQ(reader.dropped(), 1U);
+
+    // Each consumed record frees a slot for the next lap
+    EXPECT_EQ(reader.pop(), "/var/lib/0");
+    EXPECT_TRUE(writer.push("/var/lib/next-lap"));
+
+    for (uint32_t i = 1; i < ringCapacity; ++i)
+    {
+        ASSERT_EQ(reader.pop(), "/var/lib/" + std::to_string(i));
+    }
+    EXPECT_EQ(reader.pop(), "/var/lib/next-lap");
+    EXPECT_FALSE(reader.pop().has_value());
+}
+
+TEST_F(DirtyRingTest, TestConcurrentProducers)
+{
+    DirtyRingReader reader(ringPath);
+
+    constexpr auto producers = 4;
+    constexpr auto recordsPerProducer = 5000;
+    std::vector<std::jthread> threads;
+    for (auto producer = 0; producer < producers; ++producer)
+    {
+        threads.emplace_back([this, producer]() {
+            DirtyRingWriter writer(ringPath);
+            for (auto i = 0; i < recordsPerProducer; ++i)
+            {
+                const auto path = "/p" + std::to_string(producer) + "/" +
+                                  std::to_string(i);
+                while (!writer.push(path))
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    // Each record is consumed once and in the order of its producer
+    std::set<std::string> consumed;
+    std::vector<int> lastIndex(producers, -1);
+    while (consumed.size() < producers * recordsPerProducer)
+    {
+        auto path = reader.pop();
+        if (!path.has_value())
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        const auto producer = std::stoi(path->substr(2));
+        const auto index = std::stoi(path->substr(path->rfind('/') + 1));
+        EXPECT_GT(index, lastIndex[producer]);
+        lastIndex[producer] = index;
+        EXPECT_TRUE(consumed.insert(*path).second) << *path;
+    }
+    EXPECT_FALSE(reader.pop().has_value());
+}
+
+TEST_F(DirtyRingTest, TestWakeupOnlyWhileWaiting)
+{
+    DirtyRingReader reader(ringPath);
+    DirtyRingWriter writer(ringPath);
+
+    // No wakeup while the consumer is busy
+    EXPECT_TRUE(writer.push("/var/lib/a"));
+    EXPECT_FALSE(wakeupPending(reader));
+
+    // The consumer can't wait with a record pending
+    EXPECT_FALSE(reader.prepareWait());
+    EXPECT_EQ(reader.pop(), "/var/lib/a");
+
+    ASSERT_TRUE(reader.prepareWait());
+    EXPECT_TRUE(writer.push("/var/lib/b"));
+    EXPECT_TRUE(wakeupPending(reader));
+
+    reader.finishWait();
+    EXPECT_FALSE(wakeupPending(reader));
+    EXPECT_EQ(reader.pop(), "/var/lib/b");
+}
+
+TEST_F(DirtyRingTest, TestRecordsSurviveConsumerRestart)
+{
+    auto reader = std::make_unique<DirtyRingReader>(ringPath);
+    DirtyRingWriter writer(ringPath);
+    ASSERT_TRUE(reader->prepareWait());
+    reader.reset();
+
+    // Pushed while the daemon restarts, the wakeup is lost without harm
+    EXPECT_TRUE(writer.push("/var/lib/a"));
+
+    reader = std::make_unique<DirtyRingReader>(ringPath);
+    EXPECT_EQ(reader->pop(), "/var/lib/a");
+
+    ASSERT_TRUE(reader->prepareWait());
+    EXPECT_TRUE(writer.push("/var/lib/b"));
+    EXPECT_TRUE(wakeupPending(*reader));
+}
+
+TEST_F(DirtyRingTest, TestDeadProducerSlotIsSkipped)
+{
+    auto reader = std::make_unique<DirtyRingReader>(ringPath);
+    DirtyRingWriter writer(ringPath);
+    claimByDeadProducer();
+
+    // Kept over a restart of the daemon
+    reader = std::make_unique<DirtyRingReader>(ringPath);
+    EXPECT_TRUE(writer.push("/var/lib/a"));
+    EXPECT_FALSE(reader->pop().has_value());
+
+    // Skipped once seen stalled again, and counted for a resync
+    EXPECT_EQ(reader->pop(), "/var/lib/a");
+    EXPECT_EQ(reader->dropped(), 1U);
+    EXPECT_FALSE(reader->pop().has_value());
+}
+
+TEST_F(DirtyRingTest, TestFullRingWakesTheConsumer)
+{
+    DirtyRingReader reader(ringPath);
+    DirtyRingWriter writer(ringPath);
+    claimByDeadProducer();
+
+    for (uint32_t i = 1; i < ringCapacity; ++i)
+    {
+        ASSERT_TRUE(writer.push("/var/lib/" + std::to_string(i)));
+    }
+
+    // The consumer waits at the stalled slot, a drop wakes it up
+    ASSERT_TRUE(reader.prepareWait());
+    EXPECT_FALSE(wakeupPending(reader));
+    EXPECT_FALSE(writer.push("/var/lib/overflow"));
+    EXPECT_TRUE(wakeupPending(reader));
+    reader.finishWait();
+
+    EXPECT_FALSE(reader.pop().has_value());
+    EXPECT_EQ(reader.pop(), "/var/lib/1");
+    EXPECT_EQ(reader.dropped(), 2U);
+}
@@ -0,0 +1,154 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "error_log_aggregator.hpp"
+#include "mock_ext_data_ifaces.hpp"
+
+#include <sdbusplus/async.hpp>
+
+#include <gtest/gtest.h>
+
+namespace extData = data_sync::ext_data;
+using namespace std::literals;
+
+namespace
+{
+
+constexpr auto syncFailure =
+    "xyz.openbmc_project.RBMC_DataSync.Error.SyncFailure";
+constexpr auto notifyFailure =
+    "xyz.openbmc_project.RBMC_DataSync.Error.NotifyFailure";
+
+/**
+ * @brief The error logs created through the mocked interfaces.
+ */
+struct CreatedLog
+{
+    std::string errMsg;
+    extData::AdditionalData details;
+};
+
+std::unique_ptr<extData::MockExternalDataIFaces>
+    makeExtDataIfaces(std::vector<CreatedLog>& createdLogs)
+{
+    auto extDataIfaces = std::make_unique<extData::MockExternalDataIFaces>();
+    EXPECT_CALL(*extDataIfaces,
+                createErrorLog(testing::_, testing::_, testing::_, testing::_))
+        .WillRepeatedly(
+            [&createdLogs](const std::string& errMsg,
+                           const extData::ErrorLevel&,
+                           extData::AdditionalData& details,
+                           const std::optional<nlohmann::json>&)
+                -> sdbusplus::async::task<> {
+        createdLogs.emplace_back(errMsg, details);
+        co_return;
+    });
+    return extDataIfaces;
+}
+
+} // namespace
+
+TEST(ErrorLogAggregatorTest, TestRepeatedErrorsFoldedIntoSummary)
+{
+    sdbusplus::async::context ctx;
+    data_sync::clock::VirtualClock clock;
+    std::vector<CreatedLog> createdLogs;
+    auto extDataIfaces = makeExtDataIfaces(createdLogs);
+    data_sync::error_log::Aggregator aggregator(ctx, clock, *extDataIfaces,
+                                                1min, 10);
+
+    auto testTask = [&]() -> sdbusplus::async::task<> {
+        for (const auto* path : {"/a/file1", "/a/file2", "/a/file1"})
+        {
+            extData::AdditionalData details{
+                {"DS_Sync_Path", path},
+                {"DS_Sync_ErrMsg", std::string(1000, 'x')}};
+            co_await aggregator.createErrorLog(
+                syncFailure, extData::ErrorLevel::Warning, "/a", path,
+                details);
+        }
+
+        // Another configuration is another kind of error
+        extData::AdditionalData details{{"DS_Sync_Path", "/b/file"}};
+        co_await aggregator.createErrorLog(
+            syncFailure, extData::ErrorLevel::Warning, "/b", "/b/file",
+            details);
+
+        // Only the first of each kind is created within the window
+        EXPECT_EQ(createdLogs.size(), 2U);
+        EXPECT_EQ(aggregator.foldedLogs(), 2U);
+
+        co_await clock.sleepFor(ctx, 61s);
+
+        EXPECT_EQ(createdLogs.size(), 3U);
+        if (createdLogs.size() == 3)
+        {
+            const auto& summary = createdLogs.back();
+            EXPECT_EQ(summary.errMsg, syncFailure);
+            EXPECT_EQ(summary.details.at("DS_Aggregated_Count"), "2");
+            EXPECT_EQ(summary.details.at("DS_Aggregated_Source"), "/a");
+            EXPECT_EQ(summary.details.at("DS_Aggregated_Paths"),
+                      "/a/file2,/a/file1");
+            EXPECT_EQ(summary.details.at("DS_Sync_Path"), "/a/file2");
+            EXPECT_LT(summary.details.at("DS_Sync_ErrMsg").size(), 1000U);
+        }
+
+        // A new window starts with an immediate error log again
+        co_await aggregator.createErrorLog(
+            syncFailure, extData::ErrorLevel::Warning, "/a", "/a/file1",
+            details);
+        EXPECT_EQ(createdLogs.size(), 4U);
+
+        ctx.request_stop();
+        co_return;
+    };
+
+    ctx.spawn(testTask());
+    ctx.run();
+}
+
+TEST(ErrorLogAggregatorTest, TestRateLimitExceptCriticalErrors)
+{
+    sdbusplus::async::context ctx;
+    data_sync::clock::VirtualClock clock;
+    std::vector<CreatedLog> createdLogs;
+    auto extDataIfaces = makeExtDataIfaces(createdLogs);
+    data_sync::error_log::Aggregator aggregator(ctx, clock, *extDataIfaces,
+                                                1min, 1);
+
+    auto testTask = [&]() -> sdbusplus::async::task<> {
+        extData::AdditionalData details;
+        co_await aggregator.createErrorLog(
+            notifyFailure, extData::ErrorLevel::Informational, "service1",
+            "/a/file", details);
+
+        // Rate limited, so folded into its summary
+        co_await aggregator.createErrorLog(
+            notifyFailure, extData::ErrorLevel::Informational, "service2",
+            "/a/file", details);
+        EXPECT_EQ(createdLogs.size(), 1U);
+
+        // Critical, so created regardless
+        co_await aggregator.createErrorLog(
+            syncFailure, extData::ErrorLevel::Warning, "/a", "/a/file",
+            details, true);
+        EXPECT_EQ(createdLogs.size(), 2U);
+
+        // The summary of the folded one follows once the window elapses
+        co_await clock.sleepFor(ctx, 61s);
+        EXPECT_EQ(createdLogs.size(), 3U);
+        if (createdLogs.size() == 3)
+        {
+            EXPECT_EQ(createdLogs.back().errMsg, notifyFailure);
+            EXPECT_EQ(createdLogs.back().details.at("DS_Aggregated_Source"),
+                      "service2");
+            EXPECT_EQ(createdLogs.back().details.at("DS_Aggregated_Count"),
+                      "1");
+        }
+
+        ctx.request_stop();
+        co_return;
+    };
+
+    ctx.spawn(testTask());
+    ctx.run();
+}
@@ -0,0 +1,168 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "data_watcher.hpp"
+#include "event_capture.hpp"
+#include "event_replay.hpp"
+
+#include <sys/inotify.h>
+
+#include <sdbusplus/async.hpp>
+
+#include <cstring>
+#include <fstream>
+#include <functional>
+
+#include <gtest/gtest.h>
+
+namespace fs = std::filesystem;
+namespace capture = data_sync::capture;
+namespace inotify = data_sync::watch::inotify;
+namespace replay = data_sync::watch::replay;
+
+class EventCaptureTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        char tmpdir[] = "/tmp/pdsEventCaptureXXXXXX";
+        testDir = mkdtemp(tmpdir);
+        dataDir = testDir / "data";
+        fs::create_directories(dataDir);
+        captureFile = testDir / "capture.bin";
+    }
+
+    void TearDown() override
+    {
+        capture::stop();
+        fs::remove_all(testDir);
+    }
+
+    static void writeData(const fs::path& path, const std::string& data)
+    {
+        std::ofstream(path) << data;
+    }
+
+    fs::path testDir;
+    fs::path dataDir;
+    fs::path captureFile;
+};
+
+TEST_F(EventCaptureTest, TestRecordsRoundTrip)
+{
+    ASSERT_TRUE(capture::start(captureFile));
+    EXPECT_TRUE(capture::active());
+
+    capture::watcher(1, IN_CLOSE_WRITE, "/var/lib/a/", {"/var/lib/a/x"}, {});
+    capture::watchAdded(1, 7, "/var/lib/a/");
+
+    const std::string name{"file"};
+    std::vector<uint8_t> buffer(sizeof(inotify_event) + 16);
+    inotify_event event{};
+    event.wd = 7;
+    event.mask = IN_CLOSE_WRITE;
+    event.len = 16;
+    std::memcpy(buffer.data(), &event, sizeof(event));
+    std::memcpy(buffer.data() + sizeof(event), name.c_str(), name.size());
+    capture::batch(1, buffer);
+
+    capture::watchRemoved(1, 7);
+    capture::stop();
+    EXPECT_FALSE(capture::active());
+
+    // Nothing is written once stopped
+    capture::watchRemoved(1, 8);
+
+    capture::FileHeader header{};
+    auto records = capture::readCapture(captureFile, header);
+    EXPECT_EQ(header.magic, capture::captureMagic);
+    EXPECT_EQ(header.version, capture::captureVersion);
+    ASSERT_EQ(records.size(), 4U);
+
+    EXPECT_EQ(records[0].header.type, capture::RecordType::Watcher);
+    EXPECT_EQ(records[1].header.type, capture::RecordType::WatchAdded);
+    EXPECT_EQ(records[2].header.type, capture::RecordType::Batch);
+    EXPECT_EQ(records[2].payload, buffer);
+    EXPECT_EQ(records[3].header.type, capture::RecordType::WatchRemoved);
+    for (const auto& record : records)
+    {
+        EXPECT_EQ(record.header.watcher, 1U);
+    }
+    EXPECT_LE(records[0].header.timeNs, records[3].header.timeNs);
+}
+
+TEST_F(EventCaptureTest, TestInvalidCapture)
+{
+    writeData(captureFile, "not a capture");
+
+    capture::FileHeader header{};
+    EXPECT_THROW(capture::readCapture(captureFile, header),
+                 std::runtime_error);
+}
+
+TEST_F(EventCaptureTest, TestReplayMatchesLiveOperations)
+{
+    using namespace std::literals;
+
+    ASSERT_TRUE(capture::start(captureFile));
+
+    sdbusplus::async::context ctx;
+    inotify::DataWatcher watcher(
+        ctx, IN_NONBLOCK | IN_CLOEXEC,
+        IN_CLOSE_WRITE | IN_MOVE | IN_DELETE_SELF | IN_CREATE | IN_DELETE,
+        dataDir / "");
+
+    // The write of the "done" file marks the end of the live operations
+    inotify::DataOperations liveOperations;
+    auto collect = [&]() -> sdbusplus::async::task<> {
+        while (!ctx.stop_requested())
+        {
+            auto operations = co_await watcher.onDataChange();
+            for (const auto& operation : operations)
+            {
+                liveOperations.push_back(operation);
+                if (operation.first.filename() == "done")
+                {
+                    ctx.request_stop();
+                }
+            }
+        }
+        co_return;
+    };
+
+    auto modify = [&]() -> sdbusplus::async::task<> {
+        const std::vector<std::function<void()>> steps{
+            [&]() { writeData(dataDir / "file1", "data"); },
+            [&]() { writeData(dataDir / "file1", "modified"); },
+            [&]() { fs::create_directory(dataDir / "sub"); },
+            [&]() { writeData(dataDir / "sub" / "file2", "data"); },
+            [&]() { fs::rename(dataDir / "file1", dataDir / "file3"); },
+            [&]() { fs::remove(dataDir / "sub" / "file2"); },
+            [&]() { writeData(dataDir / "done", ""); }};
+        for (const auto& step : steps)
+        {
+            co_await sdbusplus::async::sleep_for(ctx, 100ms);
+            step();
+        }
+        co_return;
+    };
+
+    ctx.spawn(collect());
+    ctx.spawn(modify());
+    ctx.run();
+    capture::stop();
+
+    ASSERT_FALSE(liveOperations.empty());
+
+    auto report = replay::replay(ctx, captureFile,
+                                 {.shadowRoot = testDir / "shadow"});
+    EXPECT_EQ(report.unmatchedEvents, 0U);
+
+    inotify::DataOperations replayedOperations;
+    for (const auto& batch : report.batches)
+    {
+        EXPECT_EQ(batch.watcherPath, dataDir / "");
+        replayedOperations.insert(replayedOperations.end(),
+                                  batch.operations.begin(),
+                                  batch.operations.end());
+    }
+    EXPECT_EQ(replayedOperations, liveOperations);
+}
@@ -0,0 +1,215 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <ranges>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace data_sync::test
+{
+
+namespace fs = std::filesystem;
+
+/**
+ * @class FaultInjectingRsync
+ *
+ * @brief A stand-in for the rsync towards the sibling BMC, which injects
+ *        faults on a schedule so that the retry logic can be exercised
+ *        against a slow, flapping or failing sibling.
+ *
+ * It installs an "rsync" script in front of the real rsync on the PATH of the
+ * test process. Each rsync invocation consumes the next step of the armed
+ * schedule, once the schedule is exhausted (or before it is armed) the
+ * invocations pass through to the real rsync. The supported steps are:
+ *
+ * - "pass" : Run the real rsync.
+ * - "exit <code>" : Fail with the given rsync exit code without transferring.
+ * - "delay <seconds>" : Add latency, then run the real rsync.
+ * - "bwlimit <KBps>" : Run the real rsync with the bandwidth capped.
+ * - "reset <seconds> [<KBps>]" : Start the real rsync (optionally with the
+ *                                bandwidth capped) and drop it after the
+ *                                given time, as rsync does on a connection
+ *                                reset (exit 12).
+ *
+ * @note The steps are consumed in the order of the rsync invocations, the
+ *       tests arm the schedule only when no other sync is in progress.
+ */
+class FaultInjectingRsync
+{
+  public:
+    FaultInjectingRsync(const FaultInjectingRsync&) = delete;
+    FaultInjectingRsync& operator=(const FaultInjectingRsync&) = delete;
+    FaultInjectingRsync(FaultInjectingRsync&&) = delete;
+    FaultInjectingRsync& operator=(FaultInjectingRsync&&) = delete;
+
+    /**
+     * @brief An rsync invocation as seen by the stand-in.
+     */
+    struct Invocation
+    {
+        /**
+         * @brief The CLOCK_REALTIME time of the invocation
+         */
+        std::chrono::nanoseconds time;
+
+        /**
+         * @brief The injected step
+         */
+        std::string step;
+    };
+
+    /**
+     * @brief The constructor installs the stand-in in front of the real rsync.
+     *
+     * @param[in] dir - The directory to install the stand-in and its state
+     *
+     * @throw std::runtime_error if the real rsync is not found.
+     */
+    explicit FaultInjectingRsync(const fs::path& dir) : _dir(dir)
+    {
+        const char* path = std::getenv("PATH");
+        _origPath = path != nullptr ? path : "";
+
+        fs::path realRsync;
+        for (const auto& entry : std::views::split(_origPath, ':'))
+        {
+            const fs::path candidate =
+                fs::path(std::string_view(entry)) / "rsync";
+            if (fs::exists(candidate))
+            {
+                realRsync = candidate;
+                break;
+            }
+        }
+        if (realRsync.empty())
+        {
+            throw std::runtime_error("rsync is not found in PATH");
+        }
+
+        fs::create_directories(_dir);
+        writeScript(realRsync);
+        arm({});
+
+        setenv("PATH", (_dir.string() + ":" + _origPath).c_str(), 1);
+    }
+
+    /**
+     * @brief The destructor restores the PATH and removes the stand-in.
+     */
+    ~FaultInjectingRsync()
+    {
+        setenv("PATH", _origPath.c_str(), 1);
+        std::error_code ec;
+        fs::remove_all(_dir, ec);
+    }
+
+    /**
+     * @brief Arm the given schedule, the next rsync invocation consumes its
+     *        first step. The invocations seen so far are forgotten.
+     *
+     * @param[in] schedule - The steps to inject
+     */
+    void arm(const std::vector<std::string>& schedule)
+    {
+        std::ofstream scheduleFile(_dir / "schedule");
+        for (const auto& step : schedule)
+        {
+            scheduleFile << step << '\n';
+        }
+        std::ofstream(_dir / "count") << 0 << '\n';
+        std::ofstream(_dir / "invocations", std::ios::trunc);
+    }
+
+    /**
+     * @brief Get the rsync invocations seen since the schedule was armed.
+     */
+    std::vector<Invocation> invocations() const
+    {
+        std::vector<Invocation> result;
+        std::ifstream log(_dir / "invocations");
+        std::string line;
+        while (std::getline(log, line))
+        {
+            std::istringstream fields(line);
+            int64_t timeInNs{0};
+            std::string step;
+            fields >> timeInNs;
+            std::getline(fields >> std::ws, step);
+            result.push_back({std::chrono::nanoseconds(timeInNs), step});
+        }
+        return result;
+    }
+
+  private:
+    void writeScript(const fs::path& realRsync)
+    {
+        const auto script = _dir / "rsync";
+        std::ofstream out(script);
+        out << R"sh(#!/bin/sh
+# rsync stand-in generated by the data-sync unit tests
+dir=$(dirname "$0")
+real=")sh" << realRsync.string()
+            << R"sh("
+
+exec 9>"$dir/lock"
+flock 9
+n=$(cat "$dir/count")
+echo $((n + 1)) > "$dir/count"
+step=$(sed -n "$((n + 1))p" "$dir/schedule")
+step=${step:-pass}
+echo "$(date +%s%N) $step" >> "$dir/invocations"
+flock -u 9
+exec 9>&-
+
+arg=${step#* }
+case "$step" in
+    "exit "*)
+        echo "rsync error: injected failure (code $arg)" >&2
+        exit "$arg"
+        ;;
+    "delay "*)
+        sleep "$arg"
+        exec "$real" "$@"
+        ;;
+    "bwlimit "*)
+        exec "$real" --bwlimit="$arg" "$@"
+        ;;
+    "reset "*)
+        secs=${arg%% *}
+        kbps=${arg#"$secs"}
+        kbps=${kbps# }
+        "$real" ${kbps:+--bwlimit=$kbps} "$@" &
+        sleep "$secs"
+        kill -9 $! 2>/dev/null
+        wait $! 2>/dev/null
+        echo "rsync: connection reset by peer" >&2
+        exit 12
+        ;;
+    *)
+        exec "$real" "$@"
+        ;;
+esac
+)sh";
+        out.close();
+        fs::permissions(script, fs::perms::owner_all, fs::perm_options::add);
+    }
+
+    /**
+     * @brief The directory of the stand-in and its state
+     */
+    fs::path _dir;
+
+    /**
+     * @brief The PATH of the test process before the stand-in got installed
+     */
+    std::string _origPath;
+};
+
+} // namespace data_sync::test
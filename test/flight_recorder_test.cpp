@@ -0,0 +1,93 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "flight_recorder.hpp"
+
+#include <fstream>
+
+#include <gtest/gtest.h>
+
+namespace recorder = data_sync::recorder;
+
+class FlightRecorderTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        recorder::reset();
+    }
+
+    void TearDown() override
+    {
+        recorder::reset();
+        std::filesystem::remove(dumpFile);
+    }
+
+    const std::filesystem::path dumpFile{
+        "/tmp/phosphor-data-sync/flight_recorder_test.bin"};
+};
+
+TEST_F(FlightRecorderTest, TestRecordAndSnapshot)
+{
+    recorder::record(recorder::EventType::SyncStarted, "/var/lib/a", 0);
+    recorder::record(recorder::EventType::SyncFinished, "/var/lib/a", 23,
+                     4096);
+
+    auto records = recorder::snapshot();
+    ASSERT_EQ(records.size(), 2U);
+
+    EXPECT_EQ(records[0].type, recorder::EventType::SyncStarted);
+    EXPECT_STREQ(records[0].path, "/var/lib/a");
+    EXPECT_EQ(records[1].type, recorder::EventType::SyncFinished);
+    EXPECT_EQ(records[1].code, 23);
+    EXPECT_EQ(records[1].value, 4096U);
+    EXPECT_LE(records[0].timeUs, records[1].timeUs);
+}
+
+TEST_F(FlightRecorderTest, TestLongPathKeepsTail)
+{
+    std::string longPath = "/" + std::string(100, 'x') + "/tail";
+    recorder::record(recorder::EventType::EventReceived, longPath);
+
+    auto records = recorder::snapshot();
+    ASSERT_EQ(records.size(), 1U);
+
+    std::string storedPath(records[0].path);
+    EXPECT_EQ(storedPath.size(), recorder::maxPathLen - 1);
+    EXPECT_TRUE(storedPath.ends_with("/tail"));
+}
+
+TEST_F(FlightRecorderTest, TestWrapAroundKeepsNewest)
+{
+    const auto total = recorder::capacity + 10;
+    for (size_t i = 0; i < total; ++i)
+    {
+        recorder::record(recorder::EventType::Retry, "/var/lib/a",
+                         static_cast<int32_t>(i));
+    }
+
+    auto records = recorder::snapshot();
+    ASSERT_EQ(records.size(), recorder::capacity);
+    EXPECT_EQ(records.front().code, 10);
+    EXPECT_EQ(records.back().code, static_cast<int32_t>(total - 1));
+}
+
+TEST_F(FlightRecorderTest, TestDumpAndRead)
+{
+    recorder::record(recorder::EventType::NotifySent, "/var/lib/b", 0);
+    recorder::record(recorder::EventType::HealthChanged, "", 2);
+    ASSERT_TRUE(recorder::dumpToFile(dumpFile));
+
+    recorder::DumpHeader header{};
+    auto records = recorder::readDump(dumpFile, header);
+    EXPECT_EQ(header.magic, recorder::dumpMagic);
+    EXPECT_EQ(header.recordCount, 2U);
+    EXPECT_EQ(header.daemonPid, static_cast<uint32_t>(getpid()));
+    ASSERT_EQ(records.size(), 2U);
+    EXPECT_EQ(records[0].type, recorder::EventType::NotifySent);
+    EXPECT_STREQ(records[0].path, "/var/lib/b");
+    EXPECT_EQ(records[1].type, recorder::EventType::HealthChanged);
+    EXPECT_EQ(records[1].code, 2);
+
+    // Corrupted dump
+    std::filesystem::resize_file(dumpFile, sizeof(recorder::DumpHeader) + 10);
+    EXPECT_THROW(recorder::readDump(dumpFile, header), std::runtime_error);
+}
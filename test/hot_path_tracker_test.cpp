@@ -0,0 +1,96 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "hot_path_tracker.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace std::chrono_literals;
+using data_sync::hot_path::HotPathTracker;
+using data_sync::hot_path::Mode;
+
+class HotPathTrackerTest : public ::testing::Test
+{
+  protected:
+    HotPathTracker tracker{data_sync::config::HotPathBatching(10, 2, 30s)};
+    data_sync::clock::TimePoint now{};
+    const std::filesystem::path hotPath{"/var/lib/app/counter"};
+};
+
+TEST_F(HotPathTrackerTest, TestSlowChangesStayImmediate)
+{
+    // Once per 10 seconds is 6 changes per minute, below the enter rate
+    for (int i = 0; i < 100; ++i)
+    {
+        now += 10s;
+        EXPECT_EQ(tracker.onChange(hotPath, now), Mode::Immediate);
+    }
+    EXPECT_EQ(tracker.batchedCount(), 0U);
+    EXPECT_FALSE(tracker.takePending(hotPath));
+}
+
+TEST_F(HotPathTrackerTest, TestBurstSwitchesToBatched)
+{
+    // The earlier changes of a burst decay a bit, so a burst reaches the
+    // enter rate on its 11th change
+    for (int i = 1; i <= 10; ++i)
+    {
+        now += 100ms;
+        EXPECT_EQ(tracker.onChange(hotPath, now), Mode::Immediate) << i;
+    }
+    now += 100ms;
+    EXPECT_EQ(tracker.onChange(hotPath, now), Mode::Batched);
+    EXPECT_EQ(tracker.batchedCount(), 1U);
+
+    // The changes of a batched path are coalesced into one pending sync
+    now += 100ms;
+    EXPECT_EQ(tracker.onChange(hotPath, now), Mode::Batched);
+    EXPECT_TRUE(tracker.takePending(hotPath));
+    EXPECT_FALSE(tracker.takePending(hotPath));
+
+    // Other paths are not affected
+    EXPECT_EQ(tracker.onChange("/var/lib/app/config", now), Mode::Immediate);
+}
+
+TEST_F(HotPathTrackerTest, TestCoolDownWithHysteresis)
+{
+    for (int i = 0; i < 11; ++i)
+    {
+        now += 100ms;
+        tracker.onChange(hotPath, now);
+    }
+    ASSERT_EQ(tracker.batchedCount(), 1U);
+    tracker.takePending(hotPath);
+
+    // Below the enter rate but above the exit rate, it stays batched
+    now += 1min;
+    EXPECT_GT(tracker.rate(hotPath, now), 2);
+    EXPECT_LT(tracker.rate(hotPath, now), 10);
+    EXPECT_EQ(tracker.refresh(hotPath, now), Mode::Batched);
+
+    // A pending change keeps it batched until synced
+    now += 2min;
+    EXPECT_EQ(tracker.onChange(hotPath, now), Mode::Batched);
+    now += 5min;
+    EXPECT_EQ(tracker.refresh(hotPath, now), Mode::Batched);
+    EXPECT_TRUE(tracker.takePending(hotPath));
+
+    EXPECT_LE(tracker.rate(hotPath, now), 2);
+    EXPECT_EQ(tracker.refresh(hotPath, now), Mode::Immediate);
+    EXPECT_EQ(tracker.batchedCount(), 0U);
+
+    now += 1s;
+    EXPECT_EQ(tracker.onChange(hotPath, now), Mode::Immediate);
+}
+
+TEST_F(HotPathTrackerTest, TestColdPathsArePruned)
+{
+    // The files of a directory which change once each
+    for (int i = 0; i < 1000; ++i)
+    {
+        now += 10s;
+        EXPECT_EQ(tracker.onChange("/var/lib/app/file" + std::to_string(i),
+                                   now),
+                  Mode::Immediate);
+    }
+    EXPECT_EQ(tracker.rate("/var/lib/app/file0", now), 0);
+    EXPECT_GT(tracker.rate("/var/lib/app/file999", now), 0);
+}
@@ -1,12 +1,20 @@
 // SPDX-License-Identifier: Apache-2.0
 
+#include "config.h"
+
 #include "data_watcher.hpp"
+#include "dirty_ring.hpp"
+#include "echo_suppression.hpp"
+#include "fault_injecting_rsync.hpp"
 #include "manager_test.hpp"
 
+#include <sys/stat.h>
+
 #include <sdbusplus/async.hpp>
 
 #include <filesystem>
 #include <string_view>
+#include <thread>
 
 namespace fs = std::filesystem;
 
@@ -914,3 +922,699 @@ TEST_F(ManagerTest, ImmediateSyncVanishedPathRetrySucceeds)
     ctx->spawn(triggerAndWatchSyncOp());
     ctx->run();
 }
+
+/*
+ * Test the echo suppression of a Bidirectional sync: a local change is synced
+ * once, while a write received from the sibling (tagged with the sibling as
+ * its origin) is not synced back.
+ */
+TEST_F(ManagerTest, testBidirectionalEchoIsNotSyncedBack)
+{
+    using namespace std::literals;
+    namespace extData = data_sync::ext_data;
+
+    auto extDataIface = std::make_unique<extData::MockExternalDataIFaces>();
+    extData::MockExternalDataIFaces* mockExtDataIfaces =
+        dynamic_cast<extData::MockExternalDataIFaces*>(extDataIface.get());
+
+    ON_CALL(*mockExtDataIfaces, fetchBMCRedundancyMgrProps())
+        .WillByDefault([mockExtDataIfaces]() -> sdbusplus::async::task<> {
+        mockExtDataIfaces->setBMCRole(extData::BMCRole::Active);
+        mockExtDataIfaces->setBMCRedundancy(true);
+        co_return;
+    });
+
+    EXPECT_CALL(*mockExtDataIfaces, fetchBMCPosition())
+        .WillRepeatedly([]() -> sdbusplus::async::task<> { co_return; });
+
+    EXPECT_CALL(*mockExtDataIfaces,
+                createErrorLog(testing::_, testing::_, testing::_, testing::_))
+        .WillRepeatedly([]() -> sdbusplus::async::task<> { co_return; });
+
+    nlohmann::json jsonData = {
+        {"Files",
+         {{{"Path", ManagerTest::tmpDataSyncDataDir.string() + "/srcFile"},
+           {"DestinationPath", ManagerTest::destDir.string()},
+           {"Description", "File to test the echo suppression"},
+           {"SyncDirection", "Bidirectional"},
+           {"SyncType", "Immediate"}}}}};
+
+    fs::path srcPath{jsonData["Files"][0]["Path"]};
+    fs::path destDir{jsonData["Files"][0]["DestinationPath"]};
+    fs::path destPath = destDir / fs::relative(srcPath, "/");
+
+    writeConfig(jsonData);
+    ManagerTest::writeData(srcPath, "Src: Initial Data\n");
+
+    // The filesystem must support the origin tag
+    if (!data_sync::echo::tagOrigin(srcPath, 0))
+    {
+        GTEST_SKIP() << "User extended attributes are not supported";
+    }
+
+    // Count the rsync invocations of the manager
+    char tmpShimDir[] = "/tmp/pdsRsyncShimXXXXXX";
+    data_sync::test::FaultInjectingRsync rsyncCounter(mkdtemp(tmpShimDir));
+
+    auto ctx = std::make_shared<sdbusplus::async::context>();
+    auto manager = std::make_shared<data_sync::Manager>(
+        *ctx, std::move(extDataIface), ManagerTest::dataSyncCfgDir);
+
+    const std::string localData{"Src: Local change\n"};
+    auto testTask = [&]() -> sdbusplus::async::task<> {
+        auto status = manager->getFullSyncStatus();
+        while (status != FullSyncStatus::FullSyncCompleted &&
+               status != FullSyncStatus::FullSyncFailed)
+        {
+            co_await sdbusplus::async::sleep_for(*ctx, 50ms);
+            status = manager->getFullSyncStatus();
+        }
+
+        // Let the manager start watching the source
+        co_await sdbusplus::async::sleep_for(*ctx, 1s);
+        rsyncCounter.arm({});
+
+        // A real local change
+        ManagerTest::writeData(srcPath, localData);
+        for (int i = 0; i < 100 && ManagerTest::readData(destPath) != localData;
+             ++i)
+        {
+            co_await sdbusplus::async::sleep_for(*ctx, 50ms);
+        }
+        EXPECT_EQ(ManagerTest::readData(destPath), localData);
+
+        // A write received from the sibling (BMC position 1), which rsync
+        // stores into a temporary file and renames over the source.
+        const auto tmpPath = srcPath.parent_path() / ".srcFile.XXXXXX";
+        ManagerTest::writeData(tmpPath, "Src: Received from sibling\n");
+        EXPECT_TRUE(data_sync::echo::tagOrigin(tmpPath, 1));
+        fs::rename(tmpPath, srcPath);
+
+        co_await sdbusplus::async::sleep_for(*ctx, 1500ms);
+
+        EXPECT_EQ(rsyncCounter.invocations().size(), 1U)
+            << "Expected one transfer for the local change only";
+        EXPECT_EQ(ManagerTest::readData(destPath), localData)
+            << "The received write must not be synced back";
+
+        // Force an inotify event so the running immediate sync tasks wake up
+        // and exit once the context stop is requested
+        ManagerTest::writeData(srcPath, "Dummy data to stop ctx");
+        ctx->request_stop();
+        co_return;
+    };
+
+    ctx->spawn(testTask());
+    ctx->run();
+}
+
+TEST_F(ManagerTest, testOriginTagIsWrittenOnce)
+{
+    const auto srcPath = ManagerTest::tmpDataSyncDataDir / "taggedFile";
+    ManagerTest::writeData(srcPath, "Src: Initial Data\n");
+    if (!data_sync::echo::tagOrigin(srcPath, 0))
+    {
+        GTEST_SKIP() << "User extended attributes are not supported";
+    }
+
+    // The IN_ATTRIB of the tag write isn't a metadata change to sync
+    EXPECT_TRUE(data_sync::echo::isOwnTagWrite(srcPath));
+    EXPECT_FALSE(data_sync::echo::isOwnTagWrite(srcPath));
+
+    // The tag matches the content already, the file isn't written to
+    const auto ctime = [&srcPath]() {
+        struct stat st{};
+        EXPECT_EQ(lstat(srcPath.c_str(), &st), 0);
+        return std::make_pair(st.st_ctim.tv_sec, st.st_ctim.tv_nsec);
+    };
+    const auto taggedCtime = ctime();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_TRUE(data_sync::echo::tagOrigin(srcPath, 0));
+    EXPECT_EQ(ctime(), taggedCtime);
+    EXPECT_FALSE(data_sync::echo::isOwnTagWrite(srcPath));
+
+    // A change of the attributes after the tag write is synced
+    ManagerTest::writeData(srcPath, "Src: Local change\n");
+    EXPECT_TRUE(data_sync::echo::tagOrigin(srcPath, 0));
+    fs::permissions(srcPath, fs::perms::owner_exec, fs::perm_options::add);
+    EXPECT_FALSE(data_sync::echo::isOwnTagWrite(srcPath));
+}
+
+TEST_F(ManagerTest, testReceivedTagIsKept)
+{
+    const auto srcPath = ManagerTest::tmpDataSyncDataDir / "receivedFile";
+    ManagerTest::writeData(srcPath, "Src: Received from sibling\n");
+    if (!data_sync::echo::supportsTags(srcPath) ||
+        !data_sync::echo::tagOrigin(srcPath, 1))
+    {
+        GTEST_SKIP() << "User extended attributes are not supported";
+    }
+    EXPECT_TRUE(data_sync::echo::isOwnTagWrite(srcPath));
+
+    // A directory sync of this BMC keeps the tag of the received file, a
+    // rewrite would flip it back on the sibling
+    const auto ctime = [&srcPath]() {
+        struct stat st{};
+        EXPECT_EQ(lstat(srcPath.c_str(), &st), 0);
+        return std::make_pair(st.st_ctim.tv_sec, st.st_ctim.tv_nsec);
+    };
+    const auto receivedCtime = ctime();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_TRUE(data_sync::echo::tagOrigin(srcPath.parent_path(), 0));
+    EXPECT_EQ(ctime(), receivedCtime);
+    EXPECT_TRUE(data_sync::echo::isEcho(srcPath, 0));
+
+    // The local change is tagged with this BMC
+    ManagerTest::writeData(srcPath, "Src: Local change\n");
+    EXPECT_TRUE(data_sync::echo::tagOrigin(srcPath.parent_path(), 0));
+    EXPECT_FALSE(data_sync::echo::isEcho(srcPath, 0));
+    EXPECT_TRUE(data_sync::echo::isEcho(srcPath, 1));
+}
+
+TEST_F(ManagerTest, testSyncPathBarrier)
+{
+    using namespace std::literals;
+    namespace extData = data_sync::ext_data;
+
+    auto extDataIface = std::make_unique<extData::MockExternalDataIFaces>();
+    extData::MockExternalDataIFaces* mockExtDataIfaces =
+        dynamic_cast<extData::MockExternalDataIFaces*>(extDataIface.get());
+
+    ON_CALL(*mockExtDataIfaces, fetchBMCRedundancyMgrProps())
+        .WillByDefault([mockExtDataIfaces]() -> sdbusplus::async::task<> {
+        mockExtDataIfaces->setBMCRole(extData::BMCRole::Active);
+        mockExtDataIfaces->setBMCRedundancy(true);
+        co_return;
+    });
+
+    EXPECT_CALL(*mockExtDataIfaces, fetchBMCPosition())
+        .WillRepeatedly([]() -> sdbusplus::async::task<> { co_return; });
+
+    EXPECT_CALL(*mockExtDataIfaces,
+                createErrorLog(testing::_, testing::_, testing::_, testing::_))
+        .WillRepeatedly([]() -> sdbusplus::async::task<> { co_return; });
+
+    nlohmann::json jsonData = {
+        {"Files",
+         {{{"Path", ManagerTest::tmpDataSyncDataDir.string() + "/srcFile"},
+           {"DestinationPath", ManagerTest::destDir.string()},
+           {"Description", "File to test the SyncPath barrier"},
+           {"SyncDirection", "Active2Passive"},
+           {"SyncType", "Immediate"}}}}};
+
+    fs::path srcPath{jsonData["Files"][0]["Path"]};
+    fs::path destDir{jsonData["Files"][0]["DestinationPath"]};
+    fs::path destPath = destDir / fs::relative(srcPath, "/");
+
+    writeConfig(jsonData);
+    ManagerTest::writeData(srcPath, "Src: Initial Data\n");
+
+    char tmpShimDir[] = "/tmp/pdsRsyncShimXXXXXX";
+    data_sync::test::FaultInjectingRsync rsyncShim(mkdtemp(tmpShimDir));
+
+    auto ctx = std::make_shared<sdbusplus::async::context>();
+    auto manager = std::make_shared<data_sync::Manager>(
+        *ctx, std::move(extDataIface), ManagerTest::dataSyncCfgDir);
+
+    // The barrier replies once, from the sync or from its timeout
+    auto syncPath = [&ctx, &manager](fs::path path,
+                                     std::chrono::milliseconds timeout)
+        -> sdbusplus::async::task<bool> {
+        auto replies = std::make_shared<std::vector<bool>>();
+        manager->syncPath(std::move(path), timeout, [replies](bool synced) {
+            replies->push_back(synced);
+        });
+        while (replies->empty())
+        {
+            co_await sdbusplus::async::sleep_for(*ctx, 10ms);
+        }
+        co_await sdbusplus::async::sleep_for(*ctx, 100ms);
+        EXPECT_EQ(replies->size(), 1U);
+        co_return replies->front();
+    };
+
+    auto testTask = [&]() -> sdbusplus::async::task<> {
+        auto status = manager->getFullSyncStatus();
+        while (status != FullSyncStatus::FullSyncCompleted &&
+               status != FullSyncStatus::FullSyncFailed)
+        {
+            co_await sdbusplus::async::sleep_for(*ctx, 50ms);
+            status = manager->getFullSyncStatus();
+        }
+
+        // The write is on the sibling once the barrier returns
+        const std::string barrierData{"Src: Data behind the barrier\n"};
+        ManagerTest::writeData(srcPath, barrierData);
+        EXPECT_TRUE(co_await syncPath(srcPath, 5s));
+        EXPECT_EQ(ManagerTest::readData(destPath), barrierData);
+
+        // Not configured paths are not synced
+        EXPECT_FALSE(co_await syncPath(
+            ManagerTest::tmpDataSyncDataDir / "notConfigured", 5s));
+
+        // A slow sibling expires the barrier
+        co_await sdbusplus::async::sleep_for(*ctx, 500ms);
+        rsyncShim.arm({"delay 2"});
+        EXPECT_FALSE(co_await syncPath(srcPath, 200ms));
+
+        // Let the delayed sync finish
+        co_await sdbusplus::async::sleep_for(*ctx, 2500ms);
+
+        // Force an inotify event so the running immediate sync tasks wake up
+        // and exit once the context stop is requested
+        ManagerTest::writeData(srcPath, "Dummy data to stop ctx");
+        ctx->request_stop();
+        co_return;
+    };
+
+    ctx->spawn(testTask());
+    ctx->run();
+}
+
+TEST_F(ManagerTest, testNotifiedPathSyncedByDirtyRing)
+{
+    using namespace std::literals;
+    namespace extData = data_sync::ext_data;
+
+    auto extDataIface = std::make_unique<extData::MockExternalDataIFaces>();
+    extData::MockExternalDataIFaces* mockExtDataIfaces =
+        dynamic_cast<extData::MockExternalDataIFaces*>(extDataIface.get());
+
+    ON_CALL(*mockExtDataIfaces, fetchBMCRedundancyMgrProps())
+        .WillByDefault([mockExtDataIfaces]() -> sdbusplus::async::task<> {
+        mockExtDataIfaces->setBMCRole(extData::BMCRole::Active);
+        mockExtDataIfaces->setBMCRedundancy(true);
+        co_return;
+    });
+
+    EXPECT_CALL(*mockExtDataIfaces, fetchBMCPosition())
+        .WillRepeatedly([]() -> sdbusplus::async::task<> { co_return; });
+
+    EXPECT_CALL(*mockExtDataIfaces,
+                createErrorLog(testing::_, testing::_, testing::_, testing::_))
+        .WillRepeatedly([]() -> sdbusplus::async::task<> { co_return; });
+
+    nlohmann::json jsonData = {
+        {"Directories",
+         {{{"Path", ManagerTest::tmpDataSyncDataDir.string() + "/srcDir/"},
+           {"DestinationPath", ManagerTest::destDir.string()},
+           {"Description", "Directory to test the dirty-path ring"},
+           {"SyncDirection", "Active2Passive"},
+           {"SyncType", "Notified"}}}}};
+
+    fs::path srcDir{jsonData["Directories"][0]["Path"]};
+    fs::path destDir{jsonData["Directories"][0]["DestinationPath"]};
+    fs::create_directories(srcDir);
+    const fs::path srcFile = srcDir / "srcFile";
+    const fs::path destFile = destDir / fs::relative(srcFile, "/");
+
+    writeConfig(jsonData);
+    ManagerTest::writeData(srcFile, "Src: Initial Data\n");
+
+    auto ctx = std::make_shared<sdbusplus::async::context>();
+    auto manager = std::make_shared<data_sync::Manager>(
+        *ctx, std::move(extDataIface), ManagerTest::dataSyncCfgDir);
+
+    auto testTask = [&]() -> sdbusplus::async::task<> {
+        auto status = manager->getFullSyncStatus();
+        while (status != FullSyncStatus::FullSyncCompleted &&
+               status != FullSyncStatus::FullSyncFailed)
+        {
+            co_await sdbusplus::async::sleep_for(*ctx, 50ms);
+            status = manager->getFullSyncStatus();
+        }
+        co_await sdbusplus::async::sleep_for(*ctx, 100ms);
+
+        // The path is not watched, so the write alone isn't synced
+        const std::string notifiedData{"Src: Notified change\n"};
+        ManagerTest::writeData(srcFile, notifiedData);
+        co_await sdbusplus::async::sleep_for(*ctx, 1s);
+        EXPECT_NE(ManagerTest::readData(destFile), notifiedData);
+
+        EXPECT_TRUE(data_sync::dirty_ring::notifyPathChanged(srcFile));
+        for (int i = 0;
+             i < 100 && ManagerTest::readData(destFile) != notifiedData; ++i)
+        {
+            co_await sdbusplus::async::sleep_for(*ctx, 50ms);
+        }
+        EXPECT_EQ(ManagerTest::readData(destFile), notifiedData);
+
+        // Wake the ring consumer up so that it exits once the context stop is
+        // requested
+        ctx->request_stop();
+        data_sync::dirty_ring::notifyPathChanged(srcFile);
+        co_return;
+    };
+
+    ctx->spawn(testTask());
+    ctx->run();
+}
+
+TEST_F(ManagerTest, testSyncFannedOutToPeers)
+{
+    using namespace std::literals;
+    namespace extData = data_sync::ext_data;
+
+    auto extDataIface = std::make_unique<extData::MockExternalDataIFaces>();
+    extData::MockExternalDataIFaces* mockExtDataIfaces =
+        dynamic_cast<extData::MockExternalDataIFaces*>(extDataIface.get());
+
+    ON_CALL(*mockExtDataIfaces, fetchBMCRedundancyMgrProps())
+        .WillByDefault([mockExtDataIfaces]() -> sdbusplus::async::task<> {
+        mockExtDataIfaces->setBMCRole(extData::BMCRole::Active);
+        mockExtDataIfaces->setBMCRedundancy(true);
+        co_return;
+    });
+
+    EXPECT_CALL(*mockExtDataIfaces, fetchBMCPosition())
+        .WillRepeatedly([]() -> sdbusplus::async::task<> { co_return; });
+
+    EXPECT_CALL(*mockExtDataIfaces,
+                createErrorLog(testing::_, testing::_, testing::_, testing::_))
+        .WillRepeatedly([]() -> sdbusplus::async::task<> { co_return; });
+
+    nlohmann::json jsonData = {
+        {"Files",
+         {{{"Path", ManagerTest::tmpDataSyncDataDir.string() + "/srcFile"},
+           {"DestinationPath", ManagerTest::destDir.string()},
+           {"Description", "File to test the fan-out to the extra peers"},
+           {"SyncDirection", "Active2Passive"},
+           {"SyncType", "Immediate"}}}}};
+
+    fs::path srcPath{jsonData["Files"][0]["Path"]};
+    fs::path destDir{jsonData["Files"][0]["DestinationPath"]};
+    fs::path destPath = destDir / fs::relative(srcPath, "/");
+
+    // The peer receives the same destination path under its own root, and
+    // an unreachable peer must not hold it back.
+    const fs::path peerDir = ManagerTest::tmpDataSyncDataDir / "peerDir";
+    const fs::path peerPath = peerDir.string() + destPath.string();
+    fs::create_directories(peerDir.string() + destDir.string());
+    fs::create_directories(fs::path(PEERS_CONFIG_FILE).parent_path());
+    std::ofstream(PEERS_CONFIG_FILE)
+        << nlohmann::json{{"Peers",
+                           {{{"Name", "backup"}, {"URL", peerDir.string()}},
+                            {{"Name", "unreachable"},
+                             {"URL", "/nonexistent/peer"},
+                             {"FailureThreshold", 1},
+                             {"OpenInterval", "PT1S"}}}}};
+
+    writeConfig(jsonData);
+    ManagerTest::writeData(srcPath, "Src: Initial Data\n");
+
+    auto ctx = std::make_shared<sdbusplus::async::context>();
+    auto manager = std::make_shared<data_sync::Manager>(
+        *ctx, std::move(extDataIface), ManagerTest::dataSyncCfgDir);
+
+    auto testTask = [&]() -> sdbusplus::async::task<> {
+        auto status = manager->getFullSyncStatus();
+        while (status != FullSyncStatus::FullSyncCompleted &&
+               status != FullSyncStatus::FullSyncFailed)
+        {
+            co_await sdbusplus::async::sleep_for(*ctx, 50ms);
+            status = manager->getFullSyncStatus();
+        }
+
+        // Let the manager start watching the source before the write
+        co_await sdbusplus::async::sleep_for(*ctx, 1s);
+
+        const std::string data{"Src: Data for all the peers\n"};
+        ManagerTest::writeData(srcPath, data);
+        for (int i = 0; i < 100 && ManagerTest::readData(peerPath) != data; ++i)
+        {
+            co_await sdbusplus::async::sleep_for(*ctx, 50ms);
+        }
+        EXPECT_EQ(ManagerTest::readData(destPath), data);
+        EXPECT_EQ(ManagerTest::readData(peerPath), data);
+
+        // Force an inotify event so the running immediate sync tasks wake up
+        // and exit once the context stop is requested
+        ManagerTest::writeData(srcPath, "Dummy data to stop ctx");
+        ctx->request_stop();
+        co_return;
+    };
+
+    ctx->spawn(testTask());
+    ctx->run();
+
+    fs::remove(PEERS_CONFIG_FILE);
+    manager.reset();
+    EXPECT_TRUE(fs::is_empty(FANOUT_BATCH_DIR))
+        << "The batches are removed along with their last transfer";
+}
+
+TEST_F(ManagerTest, testStandbyUnitTakesOverOnRoleChange)
+{
+    using namespace std::literals;
+    namespace extData = data_sync::ext_data;
+
+    auto extDataIface = std::make_unique<extData::MockExternalDataIFaces>();
+    extData::MockExternalDataIFaces* mockExtDataIfaces =
+        dynamic_cast<extData::MockExternalDataIFaces*>(extDataIface.get());
+
+    ON_CALL(*mockExtDataIfaces, fetchBMCRedundancyMgrProps())
+        .WillByDefault([mockExtDataIfaces]() -> sdbusplus::async::task<> {
+        mockExtDataIfaces->setBMCRole(extData::BMCRole::Passive);
+        mockExtDataIfaces->setBMCRedundancy(true);
+        co_return;
+    });
+
+    EXPECT_CALL(*mockExtDataIfaces, fetchBMCPosition())
+        .WillRepeatedly([]() -> sdbusplus::async::task<> { co_return; });
+
+    EXPECT_CALL(*mockExtDataIfaces,
+                createErrorLog(testing::_, testing::_, testing::_, testing::_))
+        .WillRepeatedly([]() -> sdbusplus::async::task<> { co_return; });
+
+    nlohmann::json jsonData = {
+        {"Files",
+         {{{"Path", ManagerTest::tmpDataSyncDataDir.string() + "/srcFile"},
+           {"DestinationPath", ManagerTest::destDir.string()},
+           {"Description", "File to test the handover on a role change"},
+           {"SyncDirection", "Active2Passive"},
+           {"SyncType", "Immediate"}}}}};
+
+    fs::path srcPath{jsonData["Files"][0]["Path"]};
+    fs::path destDir{jsonData["Files"][0]["DestinationPath"]};
+    fs::path destPath = destDir / fs::relative(srcPath, "/");
+
+    writeConfig(jsonData);
+    ManagerTest::writeData(srcPath, "Src: Initial Data\n");
+
+    auto ctx = std::make_shared<sdbusplus::async::context>();
+    auto manager = std::make_shared<data_sync::Manager>(
+        *ctx, std::move(extDataIface), ManagerTest::dataSyncCfgDir);
+
+    auto testTask = [&]() -> sdbusplus::async::task<> {
+        auto status = manager->getFullSyncStatus();
+        while (status != FullSyncStatus::FullSyncCompleted &&
+               status != FullSyncStatus::FullSyncFailed)
+        {
+            co_await sdbusplus::async::sleep_for(*ctx, 50ms);
+            status = manager->getFullSyncStatus();
+        }
+
+        // Let the manager arm the standby watcher before the write
+        co_await sdbusplus::async::sleep_for(*ctx, 1s);
+
+        // The sibling owns the data in the Passive role
+        const std::string standbyData{"Src: Data written in standby\n"};
+        ManagerTest::writeData(srcPath, standbyData);
+        co_await sdbusplus::async::sleep_for(*ctx, 500ms);
+        EXPECT_FALSE(fs::exists(destPath));
+
+        // The recorded change is caught up on the failover
+        mockExtDataIfaces->setBMCRole(extData::BMCRole::Active);
+        for (int i = 0; i < 100 && ManagerTest::readData(destPath).empty(); ++i)
+        {
+            co_await sdbusplus::async::sleep_for(*ctx, 20ms);
+        }
+        EXPECT_EQ(ManagerTest::readData(destPath), standbyData);
+
+        // And the next change is synced right away
+        const std::string activeData{"Src: Data written as Active\n"};
+        ManagerTest::writeData(srcPath, activeData);
+        for (int i = 0;
+             i < 100 && ManagerTest::readData(destPath) != activeData; ++i)
+        {
+            co_await sdbusplus::async::sleep_for(*ctx, 20ms);
+        }
+        EXPECT_EQ(ManagerTest::readData(destPath), activeData);
+
+        // Force an inotify event so the running immediate sync tasks wake up
+        // and exit once the context stop is requested
+        ManagerTest::writeData(srcPath, "Dummy data to stop ctx");
+        ctx->request_stop();
+        co_return;
+    };
+
+    ctx->spawn(testTask());
+    ctx->run();
+}
+
+TEST_F(ManagerTest, testMetadataChangeInFile)
+{
+    using namespace std::literals;
+    namespace extData = data_sync::ext_data;
+
+    auto extDataIface = std::make_unique<extData::MockExternalDataIFaces>();
+    extData::MockExternalDataIFaces* mockExtDataIfaces =
+        dynamic_cast<extData::MockExternalDataIFaces*>(extDataIface.get());
+
+    ON_CALL(*mockExtDataIfaces, fetchBMCRedundancyMgrProps())
+        .WillByDefault([mockExtDataIfaces]() -> sdbusplus::async::task<> {
+        mockExtDataIfaces->setBMCRole(extData::BMCRole::Active);
+        mockExtDataIfaces->setBMCRedundancy(true);
+        co_return;
+    });
+
+    EXPECT_CALL(*mockExtDataIfaces, fetchBMCPosition())
+        .WillRepeatedly([]() -> sdbusplus::async::task<> { co_return; });
+
+    EXPECT_CALL(*mockExtDataIfaces,
+                createErrorLog(testing::_, testing::_, testing::_, testing::_))
+        .WillRepeatedly([]() -> sdbusplus::async::task<> { co_return; });
+
+    nlohmann::json jsonData = {
+        {"Files",
+         {{{"Path", ManagerTest::tmpDataSyncDataDir.string() + "/srcFile"},
+           {"DestinationPath", ManagerTest::destDir.string()},
+           {"Description", "File to test the sync of a metadata change"},
+           {"SyncDirection", "Active2Passive"},
+           {"SyncType", "Immediate"},
+           {"SyncMetadata", true}}}}};
+
+    fs::path srcPath{jsonData["Files"][0]["Path"]};
+    fs::path destDir{jsonData["Files"][0]["DestinationPath"]};
+    fs::path destPath = destDir / fs::relative(srcPath, "/");
+
+    writeConfig(jsonData);
+    const std::string data{"Src: Initial Data\n"};
+    ManagerTest::writeData(srcPath, data);
+    fs::permissions(srcPath, fs::perms::owner_read | fs::perms::owner_write |
+                                 fs::perms::group_read);
+
+    auto ctx = std::make_shared<sdbusplus::async::context>();
+    auto manager = std::make_shared<data_sync::Manager>(
+        *ctx, std::move(extDataIface), ManagerTest::dataSyncCfgDir);
+
+    auto testTask = [&]() -> sdbusplus::async::task<> {
+        auto status = manager->getFullSyncStatus();
+        while (status != FullSyncStatus::FullSyncCompleted &&
+               status != FullSyncStatus::FullSyncFailed)
+        {
+            co_await sdbusplus::async::sleep_for(*ctx, 50ms);
+            status = manager->getFullSyncStatus();
+        }
+        EXPECT_EQ(ManagerTest::readData(destPath), data);
+
+        // Let the manager arm the watcher before the change
+        co_await sdbusplus::async::sleep_for(*ctx, 1s);
+
+        // Only the mode changes, no write follows
+        constexpr auto newPerms = fs::perms::owner_read;
+        fs::permissions(srcPath, newPerms);
+        for (int i = 0; i < 100 && (fs::status(destPath).permissions() &
+                                    fs::perms::all) != newPerms;
+             ++i)
+        {
+            co_await sdbusplus::async::sleep_for(*ctx, 20ms);
+        }
+        EXPECT_EQ(fs::status(destPath).permissions() & fs::perms::all,
+                  newPerms);
+        EXPECT_EQ(ManagerTest::readData(destPath), data);
+
+        // Force an inotify event so the running immediate sync tasks wake up
+        // and exit once the context stop is requested
+        fs::permissions(srcPath, fs::perms::owner_read |
+                                     fs::perms::owner_write);
+        ManagerTest::writeData(srcPath, "Dummy data to stop ctx");
+        ctx->request_stop();
+        co_return;
+    };
+
+    ctx->spawn(testTask());
+    ctx->run();
+}
+
+TEST_F(ManagerTest, testMetadataChangeKeepsNewerSiblingContent)
+{
+    using namespace std::literals;
+    namespace extData = data_sync::ext_data;
+
+    auto extDataIface = std::make_unique<extData::MockExternalDataIFaces>();
+    extData::MockExternalDataIFaces* mockExtDataIfaces =
+        dynamic_cast<extData::MockExternalDataIFaces*>(extDataIface.get());
+
+    ON_CALL(*mockExtDataIfaces, fetchBMCRedundancyMgrProps())
+        .WillByDefault([mockExtDataIfaces]() -> sdbusplus::async::task<> {
+        mockExtDataIfaces->setBMCRole(extData::BMCRole::Active);
+        mockExtDataIfaces->setBMCRedundancy(true);
+        co_return;
+    });
+
+    EXPECT_CALL(*mockExtDataIfaces, fetchBMCPosition())
+        .WillRepeatedly([]() -> sdbusplus::async::task<> { co_return; });
+
+    EXPECT_CALL(*mockExtDataIfaces,
+                createErrorLog(testing::_, testing::_, testing::_, testing::_))
+        .WillRepeatedly([]() -> sdbusplus::async::task<> { co_return; });
+
+    nlohmann::json jsonData = {
+        {"Files",
+         {{{"Path", ManagerTest::tmpDataSyncDataDir.string() + "/srcSizeFile"},
+           {"DestinationPath", ManagerTest::destDir.string()},
+           {"Description", "File to test a metadata change of a resized file"},
+           {"SyncDirection", "Active2Passive"},
+           {"SyncType", "Immediate"},
+           {"SyncMetadata", true}}}}};
+
+    fs::path srcPath{jsonData["Files"][0]["Path"]};
+    fs::path destDir{jsonData["Files"][0]["DestinationPath"]};
+    fs::path destPath = destDir / fs::relative(srcPath, "/");
+
+    writeConfig(jsonData);
+    const std::string data{"Src: Initial Data\n"};
+    ManagerTest::writeData(srcPath, data);
+    fs::permissions(srcPath, fs::perms::owner_read | fs::perms::owner_write |
+                                 fs::perms::group_read);
+
+    auto ctx = std::make_shared<sdbusplus::async::context>();
+    auto manager = std::make_shared<data_sync::Manager>(
+        *ctx, std::move(extDataIface), ManagerTest::dataSyncCfgDir);
+
+    auto testTask = [&]() -> sdbusplus::async::task<> {
+        auto status = manager->getFullSyncStatus();
+        while (status != FullSyncStatus::FullSyncCompleted &&
+               status != FullSyncStatus::FullSyncFailed)
+        {
+            co_await sdbusplus::async::sleep_for(*ctx, 50ms);
+            status = manager->getFullSyncStatus();
+        }
+        EXPECT_EQ(ManagerTest::readData(destPath), data);
+
+        // The sibling's copy got a newer edit of another size
+        const std::string siblingData{"Dest: A newer edit of another size\n"};
+        ManagerTest::writeData(destPath, siblingData);
+        fs::last_write_time(destPath, fs::last_write_time(srcPath) + 1h);
+
+        // Let the manager arm the watcher before the change
+        co_await sdbusplus::async::sleep_for(*ctx, 1s);
+
+        // The mode change takes the regular sync, which keeps the newer copy
+        fs::permissions(srcPath, fs::perms::owner_read);
+        co_await sdbusplus::async::sleep_for(*ctx, 2s);
+        EXPECT_EQ(ManagerTest::readData(destPath), siblingData);
+
+        // Force an inotify event so the running immediate sync tasks wake up
+        // and exit once the context stop is requested
+        fs::permissions(srcPath, fs::perms::owner_read |
+                                     fs::perms::owner_write);
+        ManagerTest::writeData(srcPath, "Dummy data to stop ctx");
+        ctx->request_stop();
+        co_return;
+    };
+
+    ctx->spawn(testTask());
+    ctx->run();
+}
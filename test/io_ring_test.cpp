@@ -0,0 +1,167 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "async_command_exec.hpp"
+#include "io_ring.hpp"
+
+#include <unistd.h>
+
+#include <sdbusplus/async.hpp>
+
+#include <array>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace io = data_sync::io;
+
+using namespace std::literals;
+
+class IoRingTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        ring = io::start(ctx);
+        if (!ring)
+        {
+            GTEST_SKIP() << "io_uring isn't available";
+        }
+    }
+
+    sdbusplus::async::context ctx;
+    std::unique_ptr<io::Ring> ring;
+};
+
+TEST_F(IoRingTest, TestReadsCompleteTogether)
+{
+    std::array<int, 2> bigPipe{};
+    std::array<int, 2> smallPipe{};
+    ASSERT_EQ(pipe(bigPipe.data()), 0);
+    ASSERT_EQ(pipe(smallPipe.data()), 0);
+    data_sync::utility::FD bigRead(bigPipe[0]);
+    data_sync::utility::FD smallRead(smallPipe[0]);
+
+    std::string bigOutput;
+    std::string smallOutput;
+    auto readAll = [&](int fd, std::string& output,
+                       size_t size) -> sdbusplus::async::task<> {
+        std::vector<char> buffer(size);
+        while (true)
+        {
+            const auto bytes = co_await ring->read(fd, buffer);
+            if (bytes <= 0)
+            {
+                EXPECT_EQ(bytes, 0);
+                break;
+            }
+            output.append(buffer.data(), bytes);
+        }
+        co_return;
+    };
+
+    auto writeAll = [&]() -> sdbusplus::async::task<> {
+        // More than a registered buffer, in pieces a pipe can hold
+        const std::string data(3 * io::registeredBufferSize, 'x');
+        for (size_t offset = 0; offset < data.size(); offset += 4096)
+        {
+            EXPECT_EQ(write(bigPipe[1], data.data() + offset, 4096), 4096);
+            EXPECT_EQ(write(smallPipe[1], "a", 1), 1);
+            co_await sdbusplus::async::sleep_for(ctx, 1ms);
+        }
+        close(bigPipe[1]);
+        close(smallPipe[1]);
+        co_return;
+    };
+
+    auto testTask = [&]() -> sdbusplus::async::task<> {
+        co_await sdbusplus::async::execution::when_all(
+            readAll(bigRead(), bigOutput, io::registeredBufferSize),
+            readAll(smallRead(), smallOutput, 16), writeAll());
+        ctx.request_stop();
+        co_return;
+    };
+
+    ctx.spawn(testTask());
+    ctx.run();
+
+    EXPECT_EQ(bigOutput, std::string(3 * io::registeredBufferSize, 'x'));
+    EXPECT_EQ(smallOutput.size(), 3 * io::registeredBufferSize / 4096);
+    EXPECT_EQ(ring->stats().operations, ring->stats().completions);
+    EXPECT_GT(ring->stats().submits, 0U);
+}
+
+TEST_F(IoRingTest, TestLeasedReadsKeepTheRegisteredBuffer)
+{
+    std::array<int, 2> pipeFds{};
+    ASSERT_EQ(pipe(pipeFds.data()), 0);
+    data_sync::utility::FD readEnd(pipeFds[0]);
+
+    std::string output;
+    size_t reads{0};
+    auto readAll = [&]() -> sdbusplus::async::task<> {
+        io::Ring::Lease lease(*ring);
+        while (true)
+        {
+            const auto bytes = co_await ring->read(readEnd(), lease);
+            if (bytes <= 0)
+            {
+                EXPECT_EQ(bytes, 0);
+                EXPECT_TRUE(lease.data().empty());
+                break;
+            }
+            EXPECT_EQ(lease.data().size(), static_cast<size_t>(bytes));
+            output.append(lease.data().data(), lease.data().size());
+            ++reads;
+        }
+        co_return;
+    };
+
+    auto writeAll = [&]() -> sdbusplus::async::task<> {
+        for (char piece = 'a'; piece <= 'h'; ++piece)
+        {
+            const std::string data(4096, piece);
+            EXPECT_EQ(write(pipeFds[1], data.data(), data.size()), 4096);
+            co_await sdbusplus::async::sleep_for(ctx, 1ms);
+        }
+        close(pipeFds[1]);
+        co_return;
+    };
+
+    auto testTask = [&]() -> sdbusplus::async::task<> {
+        co_await sdbusplus::async::execution::when_all(readAll(), writeAll());
+        ctx.request_stop();
+        co_return;
+    };
+
+    ctx.spawn(testTask());
+    ctx.run();
+
+    std::string expected;
+    for (char piece = 'a'; piece <= 'h'; ++piece)
+    {
+        expected.append(4096, piece);
+    }
+    EXPECT_EQ(output, expected);
+    EXPECT_GT(reads, 0U);
+}
+
+TEST_F(IoRingTest, TestCommandOutputThroughRing)
+{
+    data_sync::async::AsyncCommandExecutor executor(ctx);
+
+    auto testTask = [&]() -> sdbusplus::async::task<> {
+        const auto [exitCode, output] = co_await executor.execCmd(
+            "head -c 100000 /dev/zero | tr '\\0' y; echo done");
+        EXPECT_EQ(exitCode, 0);
+        EXPECT_EQ(output, std::string(100000, 'y') + "done\n");
+
+        ctx.request_stop();
+        co_return;
+    };
+
+    ctx.spawn(testTask());
+    ctx.run();
+
+    EXPECT_GT(ring->stats().completions, 0U);
+}
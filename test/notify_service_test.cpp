@@ -133,3 +133,85 @@ TEST_F(NotifyServiceTest, TestSystemDRestartNotificationRqst)
 
     ctx.run();
 }
+
+/**
+ * @brief Case to test the retries of a failing systemd notification on a
+ *        virtual clock, so that the retry intervals elapse instantly
+ */
+TEST_F(NotifyServiceTest, TestSystemDNotificationRetriesOnVirtualClock)
+{
+    namespace extData = data_sync::ext_data;
+    using namespace std::literals;
+
+    sdbusplus::async::context ctx;
+    data_sync::clock::VirtualClock clock;
+
+    nlohmann::json notifyRqstJson = R"(
+    {
+    "ModifiedDataPath": "/var/tmp/data-sync/a2p/Host/ID",
+    "NotifyInfo": {
+        "Method": "Restart",
+        "Mode": "Systemd",
+        "NotifyServices": ["Service1"]
+    }
+    })"_json;
+
+    std::unique_ptr<extData::ExternalDataIFaces> extDataIfaces =
+        std::make_unique<extData::MockExternalDataIFaces>();
+
+    extData::MockExternalDataIFaces* mockExtDataIfaces =
+        dynamic_cast<extData::MockExternalDataIFaces*>(extDataIfaces.get());
+
+    // Fail until the last retry
+    constexpr size_t totalAttempts = DEFAULT_RETRY_ATTEMPTS + 1;
+    std::vector<data_sync::clock::TimePoint> attempts;
+    EXPECT_CALL(*mockExtDataIfaces,
+                systemdServiceAction("Service1", "RestartUnit"))
+        .Times(totalAttempts)
+        .WillRepeatedly([&attempts, &clock]() -> sdbusplus::async::task<bool> {
+        attempts.push_back(clock.now());
+        co_return attempts.size() == totalAttempts;
+    });
+
+    fs::path notifyRqstFileName = NOTIFY_SERVICES_DIR /
+                                  fs::path{"dummyNotifyRqst.json"};
+
+    NotifyServiceTest::createDummyRqst(notifyRqstFileName, notifyRqstJson);
+
+    std::vector<std::unique_ptr<data_sync::notify::NotifyService>> _notifyReqs;
+    const auto realStart = std::chrono::steady_clock::now();
+
+    auto testTask = [&ctx, &clock, mockExtDataIfaces, notifyRqstFileName,
+                     &_notifyReqs,
+                     totalAttempts]() -> sdbusplus::async::task<> {
+        _notifyReqs.emplace_back(
+            std::make_unique<data_sync::notify::NotifyService>(
+                ctx, *mockExtDataIfaces, notifyRqstFileName,
+                [&_notifyReqs](data_sync::notify::NotifyService* ptr) {
+            std::erase_if(_notifyReqs,
+                          [ptr](const auto& p) { return p.get() == ptr; });
+        }, clock));
+
+        // Wait past the last retry on the virtual clock
+        co_await clock.sleepFor(
+            ctx, std::chrono::seconds(DEFAULT_RETRY_INTERVAL) * totalAttempts);
+
+        EXPECT_FALSE(fs::exists(notifyRqstFileName));
+
+        ctx.request_stop();
+        co_return;
+    };
+
+    ctx.spawn(testTask());
+
+    ctx.run();
+
+    ASSERT_EQ(attempts.size(), totalAttempts);
+    for (size_t i = 1; i < attempts.size(); ++i)
+    {
+        EXPECT_EQ(attempts[i] - attempts[i - 1],
+                  std::chrono::seconds(DEFAULT_RETRY_INTERVAL));
+    }
+    EXPECT_LT(std::chrono::steady_clock::now() - realStart,
+              std::chrono::seconds(DEFAULT_RETRY_INTERVAL));
+}
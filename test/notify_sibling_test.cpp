@@ -2,6 +2,10 @@
 
 #include "notify_sibling_test.hpp"
 
+#include "utility.hpp"
+
+#include <algorithm>
+
 namespace fs = std::filesystem;
 
 /**
@@ -111,3 +115,60 @@ TEST_F(NotifySiblingTest, TestWhenSiblingNotificationEnabledOnPaths)
     // Validate the JSON
     EXPECT_EQ(notifyRqstJson, expectedJson);
 }
+
+TEST_F(NotifySiblingTest, TestNotifyOnlyTheChangedPaths)
+{
+    const auto configJSON = R"(
+        {
+            "Path": "/directory/path/to/sync/",
+            "Description": "Configuration to test the sibling notification",
+            "SyncDirection": "Active2Passive",
+            "SyncType": "Immediate",
+            "NotifySibling" : {
+                "NotifyOnPaths" : ["/directory/path/to/sync/testFile",
+                                   "/directory/path/to/sync/subDir/",
+                                   "/directory/path/to/sync/untouched"],
+                "Mode": "DBus",
+                "NotifyServices": ["service1"]
+            }
+        }
+    )"_json;
+    data_sync::config::DataSyncConfig dataSyncConfig(configJSON, true);
+
+    // The itemized output of a directory sync
+    const std::string rsyncOutput =
+        "pds-item:cd+++++++++|directory/path/to/sync/subDir/\n"
+        "pds-item:>f+++++++++|directory/path/to/sync/subDir/newFile\n"
+        "pds-item:.f...p.....|directory/path/to/sync/untouched\n"
+        "pds-item:*deleting  |directory/path/to/sync/testFile\n"
+        "pds-item:<f.st......|directory/path/to/sync/other\n"
+        "Number of files: 4 (reg: 3, dir: 1)\n"
+        "Literal data: 1,024 bytes\n";
+
+    const auto changedPaths =
+        data_sync::utility::rsync::getChangedPaths(rsyncOutput);
+    const std::vector<fs::path> expectedChangedPaths{
+        "/directory/path/to/sync/subDir/newFile",
+        "/directory/path/to/sync/testFile", "/directory/path/to/sync/other"};
+    EXPECT_EQ(changedPaths, expectedChangedPaths);
+
+    // The rest of the output to log
+    EXPECT_EQ(data_sync::utility::rsync::withoutItemizedPaths(rsyncOutput),
+              "Number of files: 4 (reg: 3, dir: 1)\n"
+              "Literal data: 1,024 bytes\n");
+
+    auto pathsToNotify = data_sync::notify::NotifySibling::getPathsToNotify(
+        dataSyncConfig, dataSyncConfig._path, changedPaths);
+    std::ranges::sort(pathsToNotify);
+    const std::vector<fs::path> expectedPathsToNotify{
+        "/directory/path/to/sync/subDir/", "/directory/path/to/sync/testFile"};
+    EXPECT_EQ(pathsToNotify, expectedPathsToNotify);
+
+    // Nothing to notify about if only the attributes changed
+    EXPECT_TRUE(data_sync::notify::NotifySibling::getPathsToNotify(
+                    dataSyncConfig, dataSyncConfig._path,
+                    data_sync::utility::rsync::getChangedPaths(
+                        "pds-item:.f...p.....|directory/path/to/sync/"
+                        "testFile\n"))
+                    .empty());
+}
@@ -0,0 +1,93 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "partial_transfer.hpp"
+#include "utility.hpp"
+
+#include <fstream>
+
+#include <gtest/gtest.h>
+
+namespace fs = std::filesystem;
+using namespace std::chrono_literals;
+using namespace data_sync::partial;
+
+class PartialTransferTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        char tmpDir[] = "/tmp/pdsPartialXXXXXX";
+        root = mkdtemp(tmpDir);
+    }
+
+    void TearDown() override
+    {
+        fs::remove_all(root);
+    }
+
+    /**
+     * @brief Write a partial file of the given size and age.
+     */
+    static void writePartial(const fs::path& path, size_t size,
+                             std::chrono::hours age)
+    {
+        fs::create_directories(path.parent_path());
+        std::ofstream(path) << std::string(size, 'x');
+        fs::last_write_time(path, fs::file_time_type::clock::now() - age);
+    }
+
+    fs::path root;
+};
+
+TEST_F(PartialTransferTest, TestStagingPaths)
+{
+    EXPECT_TRUE(isStaging("/var/lib/app/.pds-partial/file"));
+    EXPECT_TRUE(isStaging("/var/lib/app/.pds-partial"));
+    EXPECT_FALSE(isStaging("/var/lib/app/file"));
+    EXPECT_FALSE(isStaging("/var/lib/app/.pds-partial-file"));
+
+    EXPECT_TRUE(isInterrupted(12));
+    EXPECT_TRUE(isInterrupted(30));
+    EXPECT_FALSE(isInterrupted(0));
+    EXPECT_FALSE(isInterrupted(23));
+}
+
+TEST_F(PartialTransferTest, TestCleanupRemovesOnlyOldPartialData)
+{
+    writePartial(root / stagingDirName / "old", 100, 25h);
+    writePartial(root / stagingDirName / "new", 100, 1h);
+    writePartial(root / "sub" / stagingDirName / "old", 50, 48h);
+    writePartial(root / "old", 10, 48h);
+
+    // Only the top staging directory without the recursion
+    auto removed = cleanupStaging(root, false, maxStagingAge);
+    EXPECT_EQ(removed.removedFiles, 1U);
+    EXPECT_EQ(removed.removedBytes, 100U);
+    EXPECT_TRUE(fs::exists(root / stagingDirName / "new"));
+    EXPECT_TRUE(fs::exists(root / "sub" / stagingDirName / "old"));
+
+    removed = cleanupStaging(root, true, maxStagingAge);
+    EXPECT_EQ(removed.removedFiles, 1U);
+    EXPECT_EQ(removed.removedBytes, 50U);
+    EXPECT_FALSE(fs::exists(root / "sub" / stagingDirName));
+    EXPECT_TRUE(fs::exists(root / "sub"));
+
+    // The staging directory goes away with its last partial data, and the
+    // data outside of it is never touched
+    removed = cleanupStaging(root, true, 0s);
+    EXPECT_EQ(removed.removedFiles, 1U);
+    EXPECT_FALSE(fs::exists(root / stagingDirName));
+    EXPECT_TRUE(fs::exists(root / "old"));
+}
+
+TEST_F(PartialTransferTest, TestResumedBytesFromStats)
+{
+    const std::string stats = "Number of files: 1 (reg: 1)\n"
+                              "Total file size: 2,097,152 bytes\n"
+                              "Literal data: 1,572,864 bytes\n"
+                              "Matched data: 524,288 bytes\n";
+
+    EXPECT_EQ(data_sync::utility::rsync::getTransferredDataBytes(stats),
+              1572864U);
+    EXPECT_EQ(data_sync::utility::rsync::getMatchedDataBytes(stats), 524288U);
+    EXPECT_EQ(data_sync::utility::rsync::getMatchedDataBytes("no stats"), 0U);
+}
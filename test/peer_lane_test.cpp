@@ -0,0 +1,100 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "peer_lane.hpp"
+
+#include <fstream>
+
+#include <gtest/gtest.h>
+
+using namespace std::chrono_literals;
+using data_sync::peer::CircuitBreaker;
+using data_sync::peer::PeerConfig;
+using State = CircuitBreaker::State;
+
+TEST(PeerConfigTest, TestPeerWithDefaults)
+{
+    const PeerConfig peer(nlohmann::json{
+        {"Name", "backup"}, {"URL", "rsync://backup-bmc:873/bmc_fs"}});
+
+    EXPECT_EQ(peer._name, "backup");
+    EXPECT_EQ(peer._url, "rsync://backup-bmc:873/bmc_fs");
+    EXPECT_EQ(peer._failureThreshold, 3);
+    EXPECT_EQ(peer._openInterval, 60s);
+}
+
+TEST(PeerConfigTest, TestInvalidPeers)
+{
+    EXPECT_ANY_THROW(PeerConfig(nlohmann::json{{"Name", "backup"}}));
+    EXPECT_ANY_THROW(PeerConfig(nlohmann::json{
+        {"Name", "backup"}, {"URL", "rsync://backup-bmc:873/bmc_fs"},
+        {"FailureThreshold", 0}}));
+    EXPECT_ANY_THROW(PeerConfig(nlohmann::json{
+        {"Name", "backup"}, {"URL", "rsync://backup-bmc:873/bmc_fs"},
+        {"OpenInterval", "1 minute"}}));
+
+    // No peers file, only the sibling BMC
+    EXPECT_TRUE(data_sync::peer::parsePeers("/nonexistent/peers.json").empty());
+}
+
+TEST(CircuitBreakerTest, TestOpensAfterConsecutiveFailures)
+{
+    CircuitBreaker breaker(3, 10s);
+    data_sync::clock::TimePoint now{};
+
+    // A success in between resets the count
+    EXPECT_FALSE(breaker.onFailure(now));
+    EXPECT_FALSE(breaker.onFailure(now));
+    breaker.onSuccess();
+    EXPECT_FALSE(breaker.onFailure(now));
+    EXPECT_FALSE(breaker.onFailure(now));
+    EXPECT_EQ(breaker.state(), State::Closed);
+    EXPECT_TRUE(breaker.allow(now));
+
+    EXPECT_TRUE(breaker.onFailure(now));
+    EXPECT_EQ(breaker.state(), State::Open);
+    EXPECT_FALSE(breaker.allow(now + 5s));
+    EXPECT_EQ(breaker.retryAfter(now + 5s), 5s);
+}
+
+TEST(CircuitBreakerTest, TestHalfOpenProbe)
+{
+    CircuitBreaker breaker(1, 10s);
+    data_sync::clock::TimePoint now{};
+
+    ASSERT_TRUE(breaker.onFailure(now));
+
+    // A failed probe opens it for another interval
+    now += 10s;
+    EXPECT_TRUE(breaker.allow(now));
+    EXPECT_EQ(breaker.state(), State::HalfOpen);
+    EXPECT_TRUE(breaker.onFailure(now));
+    EXPECT_FALSE(breaker.allow(now + 9s));
+
+    // A successful probe closes it
+    now += 10s;
+    EXPECT_TRUE(breaker.allow(now));
+    breaker.onSuccess();
+    EXPECT_EQ(breaker.state(), State::Closed);
+    EXPECT_EQ(breaker.retryAfter(now), 0s);
+}
+
+TEST(BatchTest, TestBigTransfersAreNotBatched)
+{
+    namespace fs = std::filesystem;
+    char tmpdir[] = "/tmp/pdsBatchXXXXXX";
+    const fs::path dir(mkdtemp(tmpdir));
+    fs::create_directories(dir / "sub");
+    for (const auto& file : {dir / "file", dir / "sub" / "file"})
+    {
+        std::ofstream(file) << std::string(1024, 'x');
+    }
+
+    EXPECT_TRUE(data_sync::peer::fitsInBatch(dir / "file", 1024));
+    EXPECT_FALSE(data_sync::peer::fitsInBatch(dir / "file", 1023));
+    EXPECT_TRUE(data_sync::peer::fitsInBatch(dir, 2048));
+    EXPECT_FALSE(data_sync::peer::fitsInBatch(dir, 2047));
+
+    // Nothing to size
+    EXPECT_FALSE(data_sync::peer::fitsInBatch(dir / "nonexistent"));
+
+    fs::remove_all(dir);
+}
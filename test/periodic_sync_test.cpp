@@ -594,3 +594,83 @@ TEST_F(ManagerTest, PeriodicDataSyncTestWithExcludeList)
         sdbusplus::async::execution::then([&ctx]() { ctx.request_stop(); }));
     ctx.run();
 }
+
+TEST_F(ManagerTest, PeriodicDataSyncOnVirtualClockTest)
+{
+    using namespace std::literals;
+    namespace ed = data_sync::ext_data;
+
+    std::unique_ptr<ed::ExternalDataIFaces> extDataIface =
+        std::make_unique<ed::MockExternalDataIFaces>();
+
+    ed::MockExternalDataIFaces* mockExtDataIfaces =
+        dynamic_cast<ed::MockExternalDataIFaces*>(extDataIface.get());
+
+    ON_CALL(*mockExtDataIfaces, fetchBMCRedundancyMgrProps())
+        // NOLINTNEXTLINE
+        .WillByDefault([&mockExtDataIfaces]() -> sdbusplus::async::task<> {
+        mockExtDataIfaces->setBMCRole(ed::BMCRole::Active);
+        mockExtDataIfaces->setBMCRedundancy(true);
+        co_return;
+    });
+
+    EXPECT_CALL(*mockExtDataIfaces, fetchBMCPosition())
+        // NOLINTNEXTLINE
+        .WillRepeatedly([]() -> sdbusplus::async::task<> { co_return; });
+
+    // A periodicity which the test can't wait for in real time
+    nlohmann::json jsonData = {
+        {"Files",
+         {{{"Path", ManagerTest::tmpDataSyncDataDir.string() + "/srcFile1"},
+           {"DestinationPath", ManagerTest::destDir.string()},
+           {"Description", "Parse test file"},
+           {"SyncDirection", "Bidirectional"},
+           {"SyncType", "Periodic"},
+           {"Periodicity", "PT1H"}}}}};
+
+    fs::path srcFile{jsonData["Files"][0]["Path"]};
+    fs::path destDir{jsonData["Files"][0]["DestinationPath"]};
+    fs::path destFile = destDir / fs::relative(srcFile, "/");
+
+    writeConfig(jsonData);
+    sdbusplus::async::context ctx;
+    data_sync::clock::VirtualClock clock;
+
+    std::string data{"Initial Data\n"};
+    ManagerTest::writeData(srcFile, data);
+
+    data_sync::Manager manager{ctx, std::move(extDataIface),
+                               ManagerTest::dataSyncCfgDir, clock};
+
+    std::string updatedData{"Data got updated\n"};
+    const auto realStart = std::chrono::steady_clock::now();
+
+    auto testTask = [&]() -> sdbusplus::async::task<> {
+        // The full sync at the startup replicates the initial data
+        auto status = manager.getFullSyncStatus();
+        while (status != data_sync::FullSyncStatus::FullSyncCompleted &&
+               status != data_sync::FullSyncStatus::FullSyncFailed)
+        {
+            co_await clock.sleepFor(ctx, 1s);
+            status = manager.getFullSyncStatus();
+        }
+        EXPECT_EQ(ManagerTest::readData(destFile), data);
+
+        // The update is synced only once the period elapses
+        ManagerTest::writeData(srcFile, updatedData);
+        co_await clock.sleepFor(ctx, 58min);
+        EXPECT_NE(ManagerTest::readData(destFile), updatedData);
+
+        co_await clock.sleepFor(ctx, 4min);
+        EXPECT_EQ(ManagerTest::readData(destFile), updatedData);
+
+        ctx.request_stop();
+        co_return;
+    };
+
+    ctx.spawn(testTask());
+    ctx.run();
+
+    EXPECT_GE(clock.elapsed(), 1h);
+    EXPECT_LT(std::chrono::steady_clock::now() - realStart, 1min);
+}
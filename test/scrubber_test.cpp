@@ -0,0 +1,261 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "manager_test.hpp"
+#include "partial_transfer.hpp"
+#include "scrubber.hpp"
+
+#include <nlohmann/json.hpp>
+#include <sdbusplus/async.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <fstream>
+
+#include <gtest/gtest.h>
+
+namespace fs = std::filesystem;
+namespace scrub = data_sync::scrub;
+
+using namespace std::literals;
+
+std::filesystem::path ManagerTest::dataSyncCfgDir;
+std::filesystem::path ManagerTest::tmpDataSyncDataDir;
+nlohmann::json ManagerTest::commonJsonData;
+std::filesystem::path ManagerTest::destDir;
+
+namespace
+{
+
+/**
+ * @brief Exposes the rsync command framing of the Manager.
+ */
+class ScrubManager : public data_sync::Manager
+{
+  public:
+    using data_sync::Manager::getRsyncCmd;
+    using data_sync::Manager::Manager;
+};
+
+/**
+ * @brief Run the given command and return its output.
+ */
+std::string runCommand(const std::string& cmd)
+{
+    std::string output;
+    if (auto* pipe = popen(cmd.c_str(), "r"); pipe != nullptr)
+    {
+        std::array<char, 256> buffer{};
+        while (fgets(buffer.data(), buffer.size(), pipe) != nullptr)
+        {
+            output.append(buffer.data());
+        }
+        pclose(pipe);
+    }
+    return output;
+}
+
+} // namespace
+
+TEST(ScrubberTest, TestFilesOfTheConfigAreListed)
+{
+    char tmpdir[] = "/tmp/pdsScrubberXXXXXX";
+    const fs::path dataDir = mkdtemp(tmpdir);
+    const auto stagingDir = dataDir / "kept" /
+                            data_sync::partial::stagingDirName;
+    fs::create_directories(stagingDir);
+    fs::create_directories(dataDir / "skipped");
+    std::ofstream(dataDir / "kept" / "file") << "data";
+    std::ofstream(dataDir / "skipped" / "file") << "data";
+    std::ofstream(stagingDir / "file") << "partial";
+
+    const auto configJSON = nlohmann::json{
+        {"Path", dataDir.string() + "/"},
+        {"Description", "The scrub test data"},
+        {"SyncDirection", "Active2Passive"},
+        {"SyncType", "Immediate"},
+        {"ExcludeList", {(dataDir / "skipped").string() + "/"}}};
+    data_sync::config::DataSyncConfig dataSyncConfig(configJSON, true);
+
+    const auto files = scrub::listFiles(dataSyncConfig);
+    ASSERT_EQ(files.size(), 1U);
+    EXPECT_EQ(files.front().path, dataDir / "kept" / "file");
+    EXPECT_EQ(files.front().size, 4U);
+
+    fs::remove_all(dataDir);
+}
+
+TEST(ScrubberTest, TestPassIsSlicedWithinTheBudget)
+{
+    const auto configJSON = R"(
+        {
+            "Path": "/directory/path/to/sync/",
+            "Description": "Add details about the data and purpose of the synchronization",
+            "SyncDirection": "Active2Passive",
+            "SyncType": "Immediate"
+        }
+    )"_json;
+    data_sync::config::DataSyncConfig cfg1(configJSON, true);
+    data_sync::config::DataSyncConfig cfg2(configJSON, true);
+
+    // 1000 bytes per second, per slice
+    scrub::Scrubber scrubber(1000);
+    EXPECT_EQ(scrubber.untilNextPass(data_sync::clock::TimePoint{}),
+              data_sync::clock::Duration::zero());
+
+    const data_sync::clock::TimePoint start{1h};
+    std::vector<std::pair<const data_sync::config::DataSyncConfig*,
+                          std::vector<scrub::ScrubFile>>>
+        files;
+    files.emplace_back(&cfg1, std::vector<scrub::ScrubFile>{{"/a", 400},
+                                                            {"/b", 400},
+                                                            {"/c", 400}});
+    files.emplace_back(&cfg2, std::vector<scrub::ScrubFile>{{"/d", 5000}});
+    scrubber.startPass(std::move(files), start);
+    EXPECT_EQ(scrubber.pass().totalFiles, 4U);
+
+    // The files of a configuration up to the bytes of a slice
+    auto chunk = scrubber.nextChunk();
+    ASSERT_TRUE(chunk.has_value());
+    EXPECT_EQ(chunk->cfg, &cfg1);
+    EXPECT_EQ(chunk->paths, (std::vector<fs::path>{"/a", "/b"}));
+    EXPECT_EQ(scrubber.pause(*chunk), scrub::sliceInterval);
+    scrubber.onScrubbed(*chunk, 1);
+
+    chunk = scrubber.nextChunk();
+    ASSERT_TRUE(chunk.has_value());
+    EXPECT_EQ(chunk->paths, (std::vector<fs::path>{"/c"}));
+    scrubber.onScrubbed(*chunk, 0);
+
+    // A big file alone takes the slices of all its bytes
+    chunk = scrubber.nextChunk();
+    ASSERT_TRUE(chunk.has_value());
+    EXPECT_EQ(chunk->cfg, &cfg2);
+    EXPECT_EQ(scrubber.pause(*chunk), 5s);
+    scrubber.onScrubbed(*chunk, 0);
+
+    EXPECT_FALSE(scrubber.nextChunk().has_value());
+    EXPECT_TRUE(scrubber.passDone());
+    EXPECT_EQ(scrubber.pass().scrubbedFiles, 4U);
+    EXPECT_EQ(scrubber.pass().scrubbedBytes, 6200U);
+    EXPECT_EQ(scrubber.pass().mismatches, 1U);
+
+    EXPECT_EQ(scrubber.untilNextPass(start + 10min),
+              scrub::minPassInterval - 10min);
+    EXPECT_EQ(scrubber.untilNextPass(start + scrub::minPassInterval),
+              data_sync::clock::Duration::zero());
+}
+
+TEST_F(ManagerTest, TestScrubFindsNewerCopyOfSibling)
+{
+    namespace extData = data_sync::ext_data;
+
+    const auto srcDir = ManagerTest::tmpDataSyncDataDir / "scrubSrc";
+    const auto srcFile = srcDir / "file";
+    fs::create_directories(srcDir);
+    ManagerTest::writeData(srcFile, "Local data");
+
+    // A copy of the same size edited later on the sibling, which a sync
+    // with --update skips
+    const auto siblingFile = ManagerTest::destDir / srcFile.relative_path();
+    fs::create_directories(siblingFile.parent_path());
+    ManagerTest::writeData(siblingFile, "Other data");
+    fs::last_write_time(siblingFile, fs::last_write_time(srcFile) + 1h);
+
+    const nlohmann::json configJSON = {
+        {"Path", srcDir.string() + "/"},
+        {"DestinationPath", ManagerTest::destDir.string()},
+        {"Description", "The scrub test data"},
+        {"SyncDirection", "Active2Passive"},
+        {"SyncType", "Immediate"}};
+    const data_sync::config::DataSyncConfig dataSyncConfig(configJSON, true);
+
+    auto extDataIface =
+        std::make_unique<testing::NiceMock<extData::MockExternalDataIFaces>>();
+    ON_CALL(*extDataIface, fetchBMCRedundancyMgrProps())
+        .WillByDefault([]() -> sdbusplus::async::task<> { co_return; });
+    ON_CALL(*extDataIface, fetchBMCPosition())
+        .WillByDefault([]() -> sdbusplus::async::task<> { co_return; });
+    ON_CALL(*extDataIface, watchRedundancyMgrProps())
+        .WillByDefault([]() -> sdbusplus::async::task<> { co_return; });
+
+    sdbusplus::async::context ctx;
+    ScrubManager manager(ctx, std::move(extDataIface),
+                         ManagerTest::dataSyncCfgDir);
+
+    std::string scrubCmd;
+    manager.getRsyncCmd(data_sync::RsyncMode::Scrub, dataSyncConfig,
+                        srcFile.string(), scrubCmd);
+    EXPECT_FALSE(scrubCmd.contains("--update"));
+
+    EXPECT_EQ(
+        data_sync::utility::rsync::getChangedPaths(runCommand(scrubCmd)),
+        std::vector<fs::path>{srcFile});
+
+    // The dry run leaves the sibling's copy alone
+    EXPECT_EQ(ManagerTest::readData(siblingFile), "Other data");
+
+    ctx.spawn(sdbusplus::async::execution::just() |
+              sdbusplus::async::execution::then(
+                  [&ctx]() { ctx.request_stop(); }));
+    ctx.run();
+}
+
+TEST_F(ManagerTest, TestScrubKeepsNewerBidirectionalCopyOfSibling)
+{
+    namespace extData = data_sync::ext_data;
+
+    const auto srcDir = ManagerTest::tmpDataSyncDataDir / "scrubBidirSrc";
+    const auto srcFile = srcDir / "file";
+    fs::create_directories(srcDir);
+    ManagerTest::writeData(srcFile, "Local data");
+
+    // The sibling edited its copy later, which syncs back to this BMC
+    const auto siblingFile = ManagerTest::destDir / srcFile.relative_path();
+    fs::create_directories(siblingFile.parent_path());
+    ManagerTest::writeData(siblingFile, "Other data");
+    fs::last_write_time(siblingFile, fs::last_write_time(srcFile) + 1h);
+
+    const nlohmann::json configJSON = {
+        {"Path", srcDir.string() + "/"},
+        {"DestinationPath", ManagerTest::destDir.string()},
+        {"Description", "The bidirectional scrub test data"},
+        {"SyncDirection", "Bidirectional"},
+        {"SyncType", "Immediate"}};
+    const data_sync::config::DataSyncConfig dataSyncConfig(configJSON, true);
+
+    auto extDataIface =
+        std::make_unique<testing::NiceMock<extData::MockExternalDataIFaces>>();
+    ON_CALL(*extDataIface, fetchBMCRedundancyMgrProps())
+        .WillByDefault([]() -> sdbusplus::async::task<> { co_return; });
+    ON_CALL(*extDataIface, fetchBMCPosition())
+        .WillByDefault([]() -> sdbusplus::async::task<> { co_return; });
+    ON_CALL(*extDataIface, watchRedundancyMgrProps())
+        .WillByDefault([]() -> sdbusplus::async::task<> { co_return; });
+
+    sdbusplus::async::context ctx;
+    ScrubManager manager(ctx, std::move(extDataIface),
+                         ManagerTest::dataSyncCfgDir);
+
+    // Both BMCs scrub the path, neither takes the other's newer copy for a
+    // mismatch
+    std::string scrubCmd;
+    manager.getRsyncCmd(data_sync::RsyncMode::Scrub, dataSyncConfig,
+                        srcFile.string(), scrubCmd);
+    EXPECT_TRUE(scrubCmd.contains("--update"));
+    EXPECT_TRUE(
+        data_sync::utility::rsync::getChangedPaths(runCommand(scrubCmd))
+            .empty());
+
+    // Nor does a sync of the path overwrite it
+    std::string syncCmd;
+    manager.getRsyncCmd(data_sync::RsyncMode::Sync, dataSyncConfig,
+                        srcFile.string(), syncCmd);
+    runCommand(syncCmd);
+    EXPECT_EQ(ManagerTest::readData(siblingFile), "Other data");
+
+    ctx.spawn(sdbusplus::async::execution::just() |
+              sdbusplus::async::execution::then(
+                  [&ctx]() { ctx.request_stop(); }));
+    ctx.run();
+}
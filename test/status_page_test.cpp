@@ -0,0 +1,123 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "status_page.hpp"
+
+#include <fstream>
+
+#include <gtest/gtest.h>
+
+namespace fs = std::filesystem;
+
+class StatusPageTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        const auto* testInfo =
+            ::testing::UnitTest::GetInstance()->current_test_info();
+        pagePath = fs::temp_directory_path() / "status_page_test" /
+                   testInfo->name();
+    }
+
+    void TearDown() override
+    {
+        fs::remove_all(pagePath.parent_path());
+    }
+
+    fs::path pagePath;
+};
+
+TEST_F(StatusPageTest, TestWriteAndSnapshot)
+{
+    data_sync::status::StatusPageWriter writer(pagePath);
+    ASSERT_TRUE(fs::exists(pagePath));
+
+    writer.update([](data_sync::status::Page& page) {
+        page.syncEventsHealth = 2;
+        page.queueDepth = 3;
+    });
+    writer.updateStats("/var/lib/a", [](data_sync::status::SyncStats& stats) {
+        ++stats.syncsStarted;
+        ++stats.syncsSucceeded;
+        stats.bytesTransferred += 1024;
+    });
+    writer.updateStats("/var/lib/b", [](data_sync::status::SyncStats& stats) {
+        ++stats.syncsFailed;
+        stats.lastExitCode = 23;
+    });
+    writer.updateStats("/var/lib/a", [](data_sync::status::SyncStats& stats) {
+        ++stats.retries;
+    });
+
+    data_sync::status::StatusPageReader reader(pagePath);
+    auto page = reader.snapshot();
+    ASSERT_TRUE(page.has_value());
+
+    EXPECT_EQ(page->magic, data_sync::status::pageMagic);
+    EXPECT_EQ(page->version, data_sync::status::pageVersion);
+    EXPECT_EQ(page->daemonPid, static_cast<uint32_t>(getpid()));
+    EXPECT_EQ(page->sequence % 2, 0U);
+    EXPECT_EQ(page->syncEventsHealth, 2);
+    EXPECT_EQ(page->queueDepth, 3U);
+
+    ASSERT_EQ(page->configCount, 2U);
+    EXPECT_STREQ(page->configs[0].path, "/var/lib/a");
+    EXPECT_EQ(page->configs[0].syncsStarted, 1U);
+    EXPECT_EQ(page->configs[0].syncsSucceeded, 1U);
+    EXPECT_EQ(page->configs[0].retries, 1U);
+    EXPECT_EQ(page->configs[0].bytesTransferred, 1024U);
+    EXPECT_STREQ(page->configs[1].path, "/var/lib/b");
+    EXPECT_EQ(page->configs[1].syncsFailed, 1U);
+    EXPECT_EQ(page->configs[1].lastExitCode, 23);
+}
+
+TEST_F(StatusPageTest, TestLongPathKeepsTail)
+{
+    data_sync::status::StatusPageWriter writer(pagePath);
+
+    std::string longPath = "/" + std::string(200, 'x') + "/tail";
+    writer.updateStats(longPath, [](data_sync::status::SyncStats& stats) {
+        ++stats.syncsStarted;
+    });
+    // The same path must map to the same slot
+    writer.updateStats(longPath, [](data_sync::status::SyncStats& stats) {
+        ++stats.syncsStarted;
+    });
+
+    data_sync::status::StatusPageReader reader(pagePath);
+    auto page = reader.snapshot();
+    ASSERT_TRUE(page.has_value());
+    ASSERT_EQ(page->configCount, 1U);
+    EXPECT_EQ(page->configs[0].syncsStarted, 2U);
+
+    std::string storedPath(page->configs[0].path);
+    EXPECT_EQ(storedPath.size(), data_sync::status::maxPathLen - 1);
+    EXPECT_TRUE(storedPath.ends_with("/tail"));
+}
+
+TEST_F(StatusPageTest, TestPageRemovedOnWriterExit)
+{
+    {
+        data_sync::status::StatusPageWriter writer(pagePath);
+        EXPECT_TRUE(fs::exists(pagePath));
+    }
+    EXPECT_FALSE(fs::exists(pagePath));
+    EXPECT_THROW(data_sync::status::StatusPageReader reader(pagePath),
+                 std::runtime_error);
+}
+
+TEST_F(StatusPageTest, TestInvalidPageRejected)
+{
+    fs::create_directories(pagePath.parent_path());
+    {
+        std::ofstream pageFile(pagePath, std::ios::binary);
+        std::string garbage(sizeof(data_sync::status::Page), 'x');
+        pageFile.write(garbage.data(), garbage.size());
+    }
+    EXPECT_THROW(data_sync::status::StatusPageReader reader(pagePath),
+                 std::runtime_error);
+
+    // Truncated page
+    fs::resize_file(pagePath, 16);
+    EXPECT_THROW(data_sync::status::StatusPageReader reader(pagePath),
+                 std::runtime_error);
+}
@@ -0,0 +1,383 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "fault_injecting_rsync.hpp"
+#include "manager_test.hpp"
+#include "partial_transfer.hpp"
+
+#include <sdbusplus/async.hpp>
+
+#include <algorithm>
+#include <filesystem>
+#include <random>
+
+namespace fs = std::filesystem;
+
+std::filesystem::path ManagerTest::dataSyncCfgDir;
+std::filesystem::path ManagerTest::tmpDataSyncDataDir;
+nlohmann::json ManagerTest::commonJsonData;
+std::filesystem::path ManagerTest::destDir;
+
+using FullSyncStatus = sdbusplus::common::xyz::openbmc_project::control::
+    SyncBMCData::FullSyncStatus;
+using SyncEventsHealth = sdbusplus::common::xyz::openbmc_project::control::
+    SyncBMCData::SyncEventsHealth;
+
+namespace extData = data_sync::ext_data;
+
+/**
+ * @brief The outcome of an immediate sync scenario against the faulty
+ *        sibling.
+ */
+struct ScenarioResult
+{
+    /**
+     * @brief Whether the data reached the destination
+     */
+    bool replicated{false};
+
+    /**
+     * @brief The time from the source write until the data reached the
+     *        destination (or the scenario gave up)
+     */
+    std::chrono::milliseconds recoveryTime{0};
+
+    /**
+     * @brief The rsync invocations seen by the sibling stand-in, which is
+     *        the process churn caused by the scenario
+     */
+    std::vector<data_sync::test::FaultInjectingRsync::Invocation> invocations;
+
+    /**
+     * @brief Whether the destination kept the partial data of an interrupted
+     *        transfer at some point
+     */
+    bool partialKept{false};
+
+    SyncEventsHealth health{SyncEventsHealth::Ok};
+};
+
+class SyncFaultInjectionTest : public ManagerTest
+{
+  protected:
+    void SetUp() override
+    {
+        ManagerTest::SetUp();
+        char tmpShimDir[] = "/tmp/pdsRsyncShimXXXXXX";
+        rsyncShim = std::make_unique<data_sync::test::FaultInjectingRsync>(
+            mkdtemp(tmpShimDir));
+    }
+
+    void TearDown() override
+    {
+        rsyncShim.reset();
+        ManagerTest::TearDown();
+    }
+
+    /**
+     * @brief Get the external data interfaces of an active redundant BMC.
+     *
+     * @param[in] syncFailureLogs - The expected "SyncFailure" error logs
+     */
+    static std::unique_ptr<extData::ExternalDataIFaces>
+        makeExtDataIfaces(int syncFailureLogs)
+    {
+        auto extDataIface = std::make_unique<
+            testing::NiceMock<extData::MockExternalDataIFaces>>();
+        auto* mockExtDataIfaces = extDataIface.get();
+
+        ON_CALL(*mockExtDataIfaces, fetchBMCRedundancyMgrProps())
+            .WillByDefault([mockExtDataIfaces]() -> sdbusplus::async::task<> {
+            mockExtDataIfaces->setBMCRole(extData::BMCRole::Active);
+            mockExtDataIfaces->setBMCRedundancy(true);
+            co_return;
+        });
+        ON_CALL(*mockExtDataIfaces, fetchBMCPosition())
+            .WillByDefault([]() -> sdbusplus::async::task<> { co_return; });
+        ON_CALL(*mockExtDataIfaces, createErrorLog(testing::_, testing::_,
+                                                   testing::_, testing::_))
+            .WillByDefault([]() -> sdbusplus::async::task<> { co_return; });
+
+        EXPECT_CALL(*mockExtDataIfaces, createErrorLog(testing::_, testing::_,
+                                                       testing::_, testing::_))
+            .Times(testing::AnyNumber());
+        EXPECT_CALL(*mockExtDataIfaces,
+                    createErrorLog(
+                        "xyz.openbmc_project.RBMC_DataSync.Error.SyncFailure",
+                        testing::_, testing::_, testing::_))
+            .Times(syncFailureLogs);
+
+        return extDataIface;
+    }
+
+    /**
+     * @brief Run an immediate file sync with the given fault schedule armed
+     *        after the full sync.
+     *
+     * The scenario ends once the data reached the destination, or once all
+     * the scheduled faults got consumed and no retry followed within the
+     * retry interval, or on timeout.
+     *
+     * @param[in] schedule - The faults to inject
+     * @param[in] retryAttempts - The configured retry attempts
+     * @param[in] syncFailureLogs - The expected "SyncFailure" error logs
+     * @param[in] data - The data to write into the source file
+     *
+     * @return The outcome of the scenario
+     */
+    ScenarioResult runScenario(const std::vector<std::string>& schedule,
+                               int retryAttempts, int syncFailureLogs = 0,
+                               const std::string& data = "Modified data\n")
+    {
+        using namespace std::literals;
+
+        nlohmann::json jsonData = {
+            {"Files",
+             {{{"Path",
+                ManagerTest::tmpDataSyncDataDir.string() + "/srcFile"},
+               {"DestinationPath", ManagerTest::destDir.string()},
+               {"Description", "File to test sync against a faulty sibling"},
+               {"SyncDirection", "Active2Passive"},
+               {"SyncType", "Immediate"},
+               {"RetryAttempts", retryAttempts},
+               {"RetryInterval", "PT1S"}}}}};
+
+        const fs::path srcPath{jsonData["Files"][0]["Path"]};
+        const fs::path destPath = ManagerTest::destDir /
+                                  fs::relative(srcPath, "/");
+        const auto stagingDir = destPath.parent_path() /
+                                data_sync::partial::stagingDirName;
+
+        writeConfig(jsonData);
+        ManagerTest::writeData(srcPath, "Initial data\n");
+
+        auto ctx = std::make_shared<sdbusplus::async::context>();
+        auto manager = std::make_shared<data_sync::Manager>(
+            *ctx, makeExtDataIfaces(syncFailureLogs),
+            ManagerTest::dataSyncCfgDir);
+
+        // Give up well after the retry budget is spent
+        const auto timeout = std::chrono::seconds(retryAttempts + 1) * 2 + 5s;
+        const auto maxInvocations = schedule.size();
+
+        ScenarioResult result;
+        auto scenario = [&]() -> sdbusplus::async::task<void> {
+            auto status = manager->getFullSyncStatus();
+            while (status != FullSyncStatus::FullSyncCompleted &&
+                   status != FullSyncStatus::FullSyncFailed)
+            {
+                co_await sdbusplus::async::sleep_for(*ctx, 50ms);
+                status = manager->getFullSyncStatus();
+            }
+
+            // Let the manager start watching the source before the write
+            co_await sdbusplus::async::sleep_for(*ctx, 1s);
+
+            rsyncShim->arm(schedule);
+            const auto start = std::chrono::steady_clock::now();
+            ManagerTest::writeData(srcPath, data);
+
+            while (std::chrono::steady_clock::now() - start < timeout)
+            {
+                result.partialKept |= fs::exists(stagingDir);
+                if (ManagerTest::readData(destPath) == data)
+                {
+                    result.replicated = true;
+                    break;
+                }
+
+                // All the scheduled faults got consumed and the sync was
+                // given up.
+                if (auto invocations = rsyncShim->invocations();
+                    !invocations.empty() &&
+                    invocations.size() >= maxInvocations &&
+                    std::chrono::system_clock::now().time_since_epoch() -
+                            invocations.back().time >
+                        2s)
+                {
+                    break;
+                }
+                co_await sdbusplus::async::sleep_for(*ctx, 20ms);
+            }
+            result.recoveryTime =
+                std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::steady_clock::now() - start);
+
+            // Let a pending retry (if any) to spawn its rsync, which must not
+            // happen for the scenarios which replicated the data already.
+            co_await sdbusplus::async::sleep_for(*ctx, 1500ms);
+            result.invocations = rsyncShim->invocations();
+            result.health = manager->getSyncEventsHealth();
+
+            // Force an inotify event so the running immediate sync tasks
+            // wake up and exit once the context stop is requested
+            rsyncShim->arm({});
+            ManagerTest::writeData(srcPath, "Dummy data to stop ctx");
+            ctx->request_stop();
+            co_return;
+        };
+
+        ctx->spawn(scenario());
+        ctx->run();
+        return result;
+    }
+
+    /**
+     * @brief Get the gaps between the consecutive rsync invocations.
+     */
+    static std::vector<std::chrono::milliseconds> invocationGaps(
+        const std::vector<data_sync::test::FaultInjectingRsync::Invocation>&
+            invocations)
+    {
+        std::vector<std::chrono::milliseconds> gaps;
+        for (size_t i = 1; i < invocations.size(); ++i)
+        {
+            gaps.push_back(
+                std::chrono::duration_cast<std::chrono::milliseconds>(
+                    invocations[i].time - invocations[i - 1].time));
+        }
+        return gaps;
+    }
+
+    std::unique_ptr<data_sync::test::FaultInjectingRsync> rsyncShim;
+};
+
+/*
+ * Test when the sibling fails once with a retryable rsync exit code.
+ * The sync should recover with exactly one retry after the retry interval.
+ */
+class SyncFaultInjectionExitCodeTest :
+    public SyncFaultInjectionTest,
+    public ::testing::WithParamInterface<int>
+{};
+
+TEST_P(SyncFaultInjectionExitCodeTest, TransientErrorRecoversWithOneRetry)
+{
+    using namespace std::literals;
+
+    const auto exitCode = GetParam();
+    auto result = runScenario({"exit " + std::to_string(exitCode)}, 2);
+
+    EXPECT_TRUE(result.replicated)
+        << "Sync should recover from exit code " << exitCode;
+    ASSERT_EQ(result.invocations.size(), 2U)
+        << "Expected the initial attempt and one retry";
+    EXPECT_EQ(result.invocations[0].step, "exit " + std::to_string(exitCode));
+    EXPECT_EQ(result.invocations[1].step, "pass");
+    EXPECT_GE(invocationGaps(result.invocations)[0], 1s)
+        << "The retry should wait for the retry interval";
+    EXPECT_NE(result.health, SyncEventsHealth::Critical);
+}
+
+INSTANTIATE_TEST_SUITE_P(RetryableExitCodes, SyncFaultInjectionExitCodeTest,
+                         ::testing::Values(10, 12, 23, 30, 35));
+
+/*
+ * Test when the sibling reports vanished source files (exit code 24).
+ * It is treated as success, so no retry should be attempted.
+ */
+TEST_F(SyncFaultInjectionTest, VanishedExitCodeIsNotRetried)
+{
+    auto result = runScenario({"exit 24"}, 2);
+
+    EXPECT_FALSE(result.replicated)
+        << "The injected failure didn't transfer the data";
+    EXPECT_EQ(result.invocations.size(), 1U)
+        << "Exit code 24 should not be retried";
+    EXPECT_NE(result.health, SyncEventsHealth::Critical);
+}
+
+/*
+ * Test when the sibling flaps with different failures (including a dropped
+ * connection in the middle of a transfer) before it comes back.
+ * The sync should recover within the retry budget, one rsync per attempt.
+ */
+TEST_F(SyncFaultInjectionTest, FlappingSiblingRecoversWithinRetryBudget)
+{
+    using namespace std::literals;
+
+    auto result = runScenario({"exit 10", "reset 0.2", "exit 35"}, 3);
+
+    EXPECT_TRUE(result.replicated);
+    ASSERT_EQ(result.invocations.size(), 4U)
+        << "Expected the initial attempt and three retries";
+    EXPECT_EQ(result.invocations[3].step, "pass");
+    for (const auto& gap : invocationGaps(result.invocations))
+    {
+        EXPECT_GE(gap, 1s) << "Each retry should wait for the retry interval";
+    }
+    EXPECT_GE(result.recoveryTime, 3s);
+    EXPECT_NE(result.health, SyncEventsHealth::Critical);
+}
+
+/*
+ * Test when the sibling keeps failing beyond the retry budget.
+ * The sync should give up after the configured retries, mark the sync events
+ * health as Critical and create the SyncFailure error log.
+ */
+TEST_F(SyncFaultInjectionTest, RetriesExhaustedMarksHealthCritical)
+{
+    auto result = runScenario({"exit 30", "exit 30", "exit 30"}, 2, 1);
+
+    EXPECT_FALSE(result.replicated);
+    EXPECT_EQ(result.invocations.size(), 3U)
+        << "Expected the initial attempt and two retries, and no more";
+    EXPECT_EQ(result.health, SyncEventsHealth::Critical);
+}
+
+/*
+ * Test when the sibling is slow to respond.
+ * The latency alone must not be treated as a failure, so the data should
+ * get synced without any retry.
+ */
+TEST_F(SyncFaultInjectionTest, SlowSiblingIsNotRetried)
+{
+    using namespace std::literals;
+
+    auto result = runScenario({"delay 1.5"}, 2);
+
+    EXPECT_TRUE(result.replicated);
+    EXPECT_EQ(result.invocations.size(), 1U);
+    EXPECT_GE(result.recoveryTime, 1500ms);
+    EXPECT_NE(result.health, SyncEventsHealth::Critical);
+}
+
+/*
+ * Test when the link to the sibling is bandwidth capped.
+ * The slow transfer should complete in a single rsync invocation.
+ */
+TEST_F(SyncFaultInjectionTest, BandwidthCappedSiblingIsNotRetried)
+{
+    auto result = runScenario({"bwlimit 64"}, 2, 0,
+                              std::string(256 * 1024, 'x'));
+
+    EXPECT_TRUE(result.replicated);
+    EXPECT_EQ(result.invocations.size(), 1U);
+    EXPECT_NE(result.health, SyncEventsHealth::Critical);
+}
+
+/*
+ * Test when the connection to the sibling resets in the middle of a large
+ * file transfer.
+ * The sibling should keep the partial data, and the retry should resume from
+ * it and clean it up once the file is complete.
+ */
+TEST_F(SyncFaultInjectionTest, InterruptedTransferResumesFromPartialData)
+{
+    // Random data, so that the compression doesn't shrink the transfer
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> dist('a', 'z');
+    std::string data(2 * 1024 * 1024, '\0');
+    std::ranges::generate(data, [&] { return static_cast<char>(dist(gen)); });
+
+    auto result = runScenario({"reset 1 512"}, 2, 0, data);
+
+    EXPECT_TRUE(result.replicated);
+    ASSERT_EQ(result.invocations.size(), 2U)
+        << "Expected the interrupted attempt and one retry";
+    EXPECT_EQ(result.invocations[1].step, "pass");
+    EXPECT_TRUE(result.partialKept);
+    EXPECT_FALSE(fs::exists(ManagerTest::destDir /
+                            fs::relative(ManagerTest::tmpDataSyncDataDir, "/") /
+                            data_sync::partial::stagingDirName));
+    EXPECT_NE(result.health, SyncEventsHealth::Critical);
+}
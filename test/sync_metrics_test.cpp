@@ -0,0 +1,99 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "sync_metrics.hpp"
+
+#include <fstream>
+
+#include <gtest/gtest.h>
+
+using namespace std::chrono_literals;
+using data_sync::metrics::Histogram;
+using data_sync::metrics::Stage;
+
+class SyncMetricsTest : public ::testing::Test
+{
+  protected:
+    void TearDown() override
+    {
+        data_sync::metrics::setEnabled(false);
+        data_sync::metrics::reset();
+    }
+};
+
+TEST_F(SyncMetricsTest, TestHistogramBuckets)
+{
+    EXPECT_EQ(Histogram::bucketOf(0), 0U);
+    EXPECT_EQ(Histogram::bucketOf(1), 1U);
+    EXPECT_EQ(Histogram::bucketOf(3), 2U);
+    EXPECT_EQ(Histogram::bucketOf(1024), 11U);
+    EXPECT_EQ(Histogram::bucketOf(UINT64_MAX), Histogram::numBuckets - 1);
+
+    Histogram hist;
+    EXPECT_EQ(hist.percentileUs(50), 0U);
+
+    // 98 fast and 2 slow samples
+    for (auto i = 0; i < 98; ++i)
+    {
+        hist.record(10us);
+    }
+    hist.record(5ms);
+    hist.record(9ms);
+
+    EXPECT_EQ(hist.count(), 100U);
+    EXPECT_EQ(hist.maxUs(), 9000U);
+    // The upper bound of the [8, 16) us bucket
+    EXPECT_EQ(hist.percentileUs(50), 15U);
+    // The upper bound of the [4096, 8192) us bucket
+    EXPECT_EQ(hist.percentileUs(99), 8191U);
+    EXPECT_EQ(hist.percentileUs(100), 9000U);
+
+    auto histJson = hist.toJson();
+    EXPECT_EQ(histJson["Count"], 100);
+    EXPECT_EQ(histJson["BucketsUs"]["16"], 98);
+
+    hist.reset();
+    EXPECT_EQ(hist.count(), 0U);
+    EXPECT_EQ(hist.maxUs(), 0U);
+}
+
+TEST_F(SyncMetricsTest, TestRecordOnlyWhenEnabled)
+{
+    data_sync::metrics::record(Stage::Spawn, 100us);
+    {
+        data_sync::metrics::ScopedSpan span(Stage::Transfer);
+    }
+    EXPECT_EQ(data_sync::metrics::histogram(Stage::Spawn).count(), 0U);
+    EXPECT_EQ(data_sync::metrics::histogram(Stage::Transfer).count(), 0U);
+
+    data_sync::metrics::setEnabled(true);
+    data_sync::metrics::record(Stage::Spawn, 100us);
+    {
+        data_sync::metrics::ScopedSpan span(Stage::Transfer);
+    }
+    EXPECT_EQ(data_sync::metrics::histogram(Stage::Spawn).count(), 1U);
+    EXPECT_EQ(data_sync::metrics::histogram(Stage::Transfer).count(), 1U);
+
+    // A span started while disabled isn't recorded
+    data_sync::metrics::setEnabled(false);
+    {
+        data_sync::metrics::ScopedSpan span(Stage::Reap);
+        data_sync::metrics::setEnabled(true);
+    }
+    EXPECT_EQ(data_sync::metrics::histogram(Stage::Reap).count(), 0U);
+}
+
+TEST_F(SyncMetricsTest, TestDumpToFile)
+{
+    const std::string dumpFile = "/tmp/sync_metrics_test_dump.json";
+
+    data_sync::metrics::setEnabled(true);
+    data_sync::metrics::record(Stage::InotifyRead, 3us);
+    data_sync::metrics::dumpToFile(dumpFile);
+
+    std::ifstream file(dumpFile);
+    auto dumpJson = nlohmann::json::parse(file);
+    EXPECT_EQ(dumpJson["Enabled"], true);
+    EXPECT_EQ(dumpJson["Stages"]["InotifyRead"]["Count"], 1);
+    EXPECT_EQ(dumpJson["Stages"]["LoopLag"]["Count"], 0);
+
+    std::filesystem::remove(dumpFile);
+}
@@ -0,0 +1,316 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "config.h"
+
+#include "tls_transport.hpp"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+namespace fs = std::filesystem;
+namespace tls = data_sync::tls;
+
+using namespace std::literals;
+
+namespace
+{
+
+sockaddr_in loopback(uint16_t port)
+{
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    return address;
+}
+
+/**
+ * @brief Listen on a free loopback port.
+ */
+data_sync::utility::FD listenOnLoopback(uint16_t& port)
+{
+    data_sync::utility::FD listener(::socket(AF_INET, SOCK_STREAM, 0));
+    auto address = loopback(0);
+    socklen_t length = sizeof(address);
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    auto* socketAddress = reinterpret_cast<sockaddr*>(&address);
+    if (::bind(listener(), socketAddress, length) != 0 ||
+        ::listen(listener(), SOMAXCONN) != 0 ||
+        ::getsockname(listener(), socketAddress, &length) != 0)
+    {
+        throw std::runtime_error("Failed to listen on the loopback");
+    }
+    port = ntohs(address.sin_port);
+    return listener;
+}
+
+uint16_t freePort()
+{
+    uint16_t port{0};
+    listenOnLoopback(port);
+    return port;
+}
+
+/**
+ * @brief A service echoing back the data of each connection until its end.
+ */
+class EchoService
+{
+  public:
+    EchoService() :
+        _listener(listenOnLoopback(_port)), _thread([this] {
+            while (true)
+            {
+                data_sync::utility::FD connection(
+                    ::accept(_listener(), nullptr, nullptr));
+                if (connection() < 0)
+                {
+                    return;
+                }
+                std::array<char, 4096> buffer{};
+                ssize_t bytes{0};
+                while ((bytes = ::read(connection(), buffer.data(),
+                                       buffer.size())) > 0)
+                {
+                    ::send(connection(), buffer.data(),
+                           static_cast<size_t>(bytes), MSG_NOSIGNAL);
+                }
+            }
+        })
+    {}
+
+    ~EchoService()
+    {
+        // Wakes the accept up
+        ::shutdown(_listener(), SHUT_RDWR);
+    }
+
+    EchoService(const EchoService&) = delete;
+    EchoService& operator=(const EchoService&) = delete;
+    EchoService(EchoService&&) = delete;
+    EchoService& operator=(EchoService&&) = delete;
+
+    uint16_t port() const
+    {
+        return _port;
+    }
+
+  private:
+    uint16_t _port{0};
+    data_sync::utility::FD _listener;
+    std::jthread _thread;
+};
+
+/**
+ * @brief Send the data to the local port of a transport and return what comes
+ *        back until the end.
+ */
+std::string roundTrip(uint16_t port, const std::string& data)
+{
+    data_sync::utility::FD socket(::socket(AF_INET, SOCK_STREAM, 0));
+    const auto address = loopback(port);
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    if (::connect(socket(), reinterpret_cast<const sockaddr*>(&address),
+                  sizeof(address)) != 0)
+    {
+        return {};
+    }
+
+    std::jthread writer([&socket, &data] {
+        size_t offset{0};
+        while (offset < data.size())
+        {
+            const auto bytes = ::send(socket(), data.data() + offset,
+                                      data.size() - offset, MSG_NOSIGNAL);
+            if (bytes <= 0)
+            {
+                break;
+            }
+            offset += static_cast<size_t>(bytes);
+        }
+        ::shutdown(socket(), SHUT_WR);
+    });
+
+    std::string received;
+    std::array<char, 4096> buffer{};
+    ssize_t bytes{0};
+    while ((bytes = ::read(socket(), buffer.data(), buffer.size())) > 0)
+    {
+        received.append(buffer.data(), static_cast<size_t>(bytes));
+    }
+    return received;
+}
+
+bool waitFor(const std::function<bool()>& condition)
+{
+    for (auto waited = 0ms; waited < 10s; waited += 10ms)
+    {
+        if (condition())
+        {
+            return true;
+        }
+        std::this_thread::sleep_for(10ms);
+    }
+    return false;
+}
+
+} // namespace
+
+class TlsTransportTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        if (!TLS_TRANSPORT)
+        {
+            GTEST_SKIP() << "Built without the TLS transport";
+        }
+
+        char tmpdir[] = "/tmp/pdsTlsXXXXXX";
+        certsDir = fs::path(mkdtemp(tmpdir)) / "certs";
+        const auto command = "sh " + std::string(GEN_CERTS_SCRIPT) + " " +
+                             certsDir.string() + " > /dev/null 2>&1";
+        // NOLINTNEXTLINE(cert-env33-c)
+        if (std::system(command.c_str()) != 0)
+        {
+            GTEST_SKIP() << "Failed to generate the certificates";
+        }
+    }
+
+    void TearDown() override
+    {
+        if (!certsDir.empty())
+        {
+            fs::remove_all(certsDir.parent_path());
+        }
+    }
+
+    tls::Settings settings(const std::string& name, uint16_t localPort,
+                           uint16_t servicePort) const
+    {
+        return {.credentials = {.certFile = certsDir / (name + ".crt"),
+                                .keyFile = certsDir / (name + ".key"),
+                                .caFile = certsDir / "ca.crt"},
+                .localPort = localPort,
+                .servicePort = servicePort,
+                .dial = std::nullopt,
+                .listenPort = std::nullopt,
+                .kernelTls = false};
+    }
+
+    fs::path certsDir;
+};
+
+TEST_F(TlsTransportTest, TestChannelsAreCarriedBothWays)
+{
+    EchoService bmc0Service;
+    EchoService bmc1Service;
+    const auto bmc0LocalPort = freePort();
+    const auto bmc1LocalPort = freePort();
+    const auto sessionPort = freePort();
+
+    auto bmc1Settings = settings("bmc1", bmc1LocalPort, bmc1Service.port());
+    bmc1Settings.listenPort = sessionPort;
+    tls::Transport bmc1(std::move(bmc1Settings));
+
+    auto bmc0Settings = settings("bmc0", bmc0LocalPort, bmc0Service.port());
+    bmc0Settings.dial = tls::Endpoint{.host = "127.0.0.1",
+                                      .port = sessionPort};
+    tls::Transport bmc0(std::move(bmc0Settings));
+
+    ASSERT_TRUE(waitFor([&] { return bmc0.connected() && bmc1.connected(); }));
+
+    // More than a frame and than the pending bytes, both ways
+    std::string data(1024 * 1024, '\0');
+    for (size_t index = 0; index < data.size(); ++index)
+    {
+        data[index] = static_cast<char>(index * 31 % 251);
+    }
+    EXPECT_EQ(roundTrip(bmc0LocalPort, data), data);
+    EXPECT_EQ(roundTrip(bmc1LocalPort, "from bmc1"), "from bmc1");
+
+    // Concurrent channels on the single session
+    std::vector<std::jthread> clients;
+    std::array<std::string, 4> received;
+    for (size_t index = 0; index < received.size(); ++index)
+    {
+        clients.emplace_back([&, index] {
+            received[index] = roundTrip(bmc0LocalPort,
+                                       "channel " + std::to_string(index));
+        });
+    }
+    clients.clear();
+    for (size_t index = 0; index < received.size(); ++index)
+    {
+        EXPECT_EQ(received[index], "channel " + std::to_string(index));
+    }
+
+    EXPECT_EQ(bmc0.stats().handshakes, 1U);
+    EXPECT_EQ(bmc0.stats().channels, 6U);
+    EXPECT_EQ(bmc1.stats().channels, 6U);
+    EXPECT_EQ(bmc0.stats().bytesSent,
+              data.size() + "from bmc1"s.size() + 4 * "channel 0"s.size());
+}
+
+TEST_F(TlsTransportTest, TestReconnectResumesTheSession)
+{
+    EchoService bmc1Service;
+    const auto bmc0LocalPort = freePort();
+    const auto sessionPort = freePort();
+
+    auto bmc1Settings = settings("bmc1", freePort(), bmc1Service.port());
+    bmc1Settings.listenPort = sessionPort;
+    tls::Transport bmc1(std::move(bmc1Settings));
+
+    auto bmc0Settings = settings("bmc0", bmc0LocalPort, freePort());
+    bmc0Settings.dial = tls::Endpoint{.host = "127.0.0.1",
+                                      .port = sessionPort};
+    tls::Transport bmc0(std::move(bmc0Settings));
+
+    ASSERT_TRUE(waitFor([&] { return bmc0.connected(); }));
+    EXPECT_EQ(roundTrip(bmc0LocalPort, "before"), "before");
+
+    bmc0.reconnect();
+    ASSERT_TRUE(waitFor([&] {
+        return bmc0.stats().handshakes == 2 && bmc0.connected();
+    }));
+    EXPECT_EQ(bmc0.stats().resumedHandshakes, 1U);
+    EXPECT_EQ(roundTrip(bmc0LocalPort, "after"), "after");
+}
+
+TEST_F(TlsTransportTest, TestUntrustedSiblingIsRejected)
+{
+    // A certificate of another CA
+    const auto otherDir = certsDir.parent_path() / "other";
+    const auto command = "sh " + std::string(GEN_CERTS_SCRIPT) + " " +
+                         otherDir.string() + " > /dev/null 2>&1";
+    // NOLINTNEXTLINE(cert-env33-c)
+    ASSERT_EQ(std::system(command.c_str()), 0);
+
+    const auto sessionPort = freePort();
+    auto bmc1Settings = settings("bmc1", freePort(), freePort());
+    bmc1Settings.listenPort = sessionPort;
+    tls::Transport bmc1(std::move(bmc1Settings));
+
+    auto bmc0Settings = settings("bmc0", freePort(), freePort());
+    bmc0Settings.credentials.certFile = otherDir / "bmc0.crt";
+    bmc0Settings.credentials.keyFile = otherDir / "bmc0.key";
+    bmc0Settings.dial = tls::Endpoint{.host = "127.0.0.1",
+                                      .port = sessionPort};
+    tls::Transport bmc0(std::move(bmc0Settings));
+
+    std::this_thread::sleep_for(500ms);
+    EXPECT_FALSE(bmc0.connected());
+    EXPECT_FALSE(bmc1.connected());
+    EXPECT_EQ(bmc1.stats().handshakes, 0U);
+}
@@ -0,0 +1,99 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "transfer_selector.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <fstream>
+
+#include <gtest/gtest.h>
+
+namespace fs = std::filesystem;
+namespace transfer = data_sync::transfer;
+
+using data_sync::config::TransferMode;
+
+using namespace std::literals;
+
+TEST(TransferSelectorTest, TestModeOfTheConfigIsKept)
+{
+    const auto configJSON = R"(
+        {
+            "Path": "/file/path/to/sync",
+            "Description": "Add details about the data and purpose of the synchronization",
+            "SyncDirection": "Active2Passive",
+            "SyncType": "Immediate",
+            "TransferMode": "WholeFile"
+        }
+    )"_json;
+    data_sync::config::DataSyncConfig dataSyncConfig(configJSON, false);
+
+    transfer::TransferSelector selector;
+    EXPECT_EQ(selector.select(dataSyncConfig, dataSyncConfig._path),
+              TransferMode::WholeFile);
+    EXPECT_EQ(transfer::rsyncFlags(TransferMode::WholeFile), " --whole-file");
+    EXPECT_EQ(transfer::rsyncFlags(TransferMode::Delta), "");
+}
+
+TEST(TransferSelectorTest, TestAutoModeChoosesPerFile)
+{
+    char tmpdir[] = "/tmp/pdsTransferSelectorXXXXXX";
+    const fs::path dataDir = mkdtemp(tmpdir);
+
+    const auto configJSON = nlohmann::json{
+        {"Path", dataDir.string() + "/"},
+        {"Description", "The transfer mode test data"},
+        {"SyncDirection", "Active2Passive"},
+        {"SyncType", "Immediate"},
+        {"TransferMode", "Auto"}};
+    data_sync::config::DataSyncConfig dataSyncConfig(configJSON, true);
+
+    std::ofstream(dataDir / "small") << "data";
+    fs::resize_file(dataDir / "small", transfer::smallFileSize);
+    std::ofstream(dataDir / "holes").close();
+    fs::resize_file(dataDir / "holes", 16 * 1024 * 1024);
+
+    transfer::TransferSelector selector;
+    EXPECT_EQ(selector.select(dataSyncConfig, dataDir), TransferMode::Delta);
+    EXPECT_EQ(selector.select(dataSyncConfig, dataDir / "small"),
+              TransferMode::WholeFile);
+    EXPECT_EQ(selector.select(dataSyncConfig, dataDir / "holes"),
+              TransferMode::Sparse);
+
+    fs::remove_all(dataDir);
+}
+
+TEST(TransferSelectorTest, TestRewrittenFileIsSentWhole)
+{
+    const fs::path file{"/file/path/to/sync"};
+    constexpr uintmax_t size = 4 * 1024 * 1024;
+
+    transfer::TransferSelector selector;
+    EXPECT_EQ(selector.choose(file, size, size), TransferMode::Delta);
+
+    // A big file too, an interrupted in place update would corrupt it
+    constexpr uintmax_t bigSize = 64 * 1024 * 1024;
+    EXPECT_EQ(selector.choose(file, bigSize, bigSize), TransferMode::Delta);
+
+    // 8MiB/s over the link, below the checksum rate, a delta sync matching
+    // 10% of the file costs more than sending the whole of it
+    selector.onTransferred(file, TransferMode::Delta, size * 9 / 10,
+                           size / 10, 450ms);
+    ASSERT_TRUE(selector.throughput().has_value());
+    EXPECT_EQ(selector.choose(file, size, size), TransferMode::WholeFile);
+
+    // A delta sync matching 90% of it saves more than the checksum pass
+    selector.onTransferred(file, TransferMode::Delta, size / 10,
+                           size * 9 / 10, 50ms);
+    EXPECT_EQ(selector.choose(file, size, size), TransferMode::Delta);
+
+    // The delta transfer is probed again after a number of whole syncs
+    selector.onTransferred(file, TransferMode::Delta, size * 9 / 10,
+                           size / 10, 450ms);
+    for (uint32_t sync = 0; sync < transfer::deltaProbeInterval; ++sync)
+    {
+        EXPECT_EQ(selector.choose(file, size, size), TransferMode::WholeFile);
+        selector.onTransferred(file, TransferMode::WholeFile, size, 0, 500ms);
+    }
+    EXPECT_EQ(selector.choose(file, size, size), TransferMode::Delta);
+}
@@ -0,0 +1,153 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "event_capture.hpp"
+#include "sync_metrics.hpp"
+#include "watch_shards.hpp"
+
+#include <sys/inotify.h>
+
+#include <sdbusplus/async.hpp>
+
+#include <fstream>
+#include <map>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+namespace fs = std::filesystem;
+namespace shard = data_sync::watch::shard;
+namespace inotify = data_sync::watch::inotify;
+
+using namespace std::literals;
+
+TEST(WatchShardsTest, TestQueueKeepsTheOrderOfEachProducer)
+{
+    constexpr size_t producers = 4;
+    constexpr size_t valuesPerProducer = 10000;
+
+    shard::MpscQueue<std::pair<size_t, size_t>> queue;
+    std::vector<std::jthread> threads;
+    for (size_t producer = 0; producer < producers; ++producer)
+    {
+        threads.emplace_back([&queue, producer]() {
+            for (size_t value = 0; value < valuesPerProducer; ++value)
+            {
+                queue.push({producer, value});
+            }
+        });
+    }
+
+    // Drain while the producers push, each one's values stay in order
+    std::map<size_t, size_t> nextValues;
+    size_t received{0};
+    while (received < producers * valuesPerProducer)
+    {
+        for (const auto& [producer, value] : queue.drain())
+        {
+            ASSERT_EQ(value, nextValues[producer]++);
+            ++received;
+        }
+    }
+    EXPECT_TRUE(queue.drain().empty());
+}
+
+TEST(WatchShardsTest, TestOperationsComeBackToTheLoop)
+{
+    char tmpdir[] = "/tmp/pdsWatchShardsXXXXXX";
+    const fs::path dataDir = mkdtemp(tmpdir);
+
+    sdbusplus::async::context ctx;
+    shard::ShardPool pool(ctx, 2);
+    auto watch = pool.watch(
+        {dataDir / "", IN_CLOSE_WRITE | IN_MOVE | IN_DELETE_SELF | IN_CREATE |
+                           IN_DELETE,
+         std::nullopt, std::nullopt});
+
+    auto testTask = [&]() -> sdbusplus::async::task<> {
+        // The watcher gets created on its shard meanwhile
+        while (watch->watchedPaths().empty())
+        {
+            co_await sdbusplus::async::sleep_for(ctx, 10ms);
+        }
+        EXPECT_EQ(watch->watchedPaths().size(), 1U);
+
+        const auto loopThread = std::this_thread::get_id();
+        std::ofstream(dataDir / "file") << "data";
+
+        auto operations = co_await watch->onDataChange();
+        EXPECT_EQ(std::this_thread::get_id(), loopThread);
+        EXPECT_EQ(operations.size(), 1U);
+        if (!operations.empty())
+        {
+            EXPECT_EQ(operations.front().first, dataDir / "file");
+            EXPECT_EQ(operations.front().second, inotify::DataOps::COPY);
+        }
+
+        ctx.request_stop();
+        co_return;
+    };
+
+    ctx.spawn(testTask());
+    ctx.run();
+
+    watch.reset();
+    fs::remove_all(dataDir);
+}
+
+TEST(WatchShardsTest, TestShardedWatcherIsCapturedAndTimed)
+{
+    char tmpdir[] = "/tmp/pdsWatchShardsXXXXXX";
+    const fs::path testDir = mkdtemp(tmpdir);
+    const auto dataDir = testDir / "data";
+    const auto captureFile = testDir / "capture.bin";
+    fs::create_directories(dataDir);
+
+    using Stage = data_sync::metrics::Stage;
+    data_sync::metrics::reset();
+    data_sync::metrics::setEnabled(true);
+
+    sdbusplus::async::context ctx;
+    shard::ShardPool pool(ctx, 1);
+    auto watch = pool.watch(
+        {dataDir / "", IN_CLOSE_WRITE | IN_MOVE | IN_DELETE_SELF | IN_CREATE |
+                           IN_DELETE,
+         std::nullopt, std::nullopt});
+
+    auto testTask = [&]() -> sdbusplus::async::task<> {
+        while (watch->watchedPaths().empty())
+        {
+            co_await sdbusplus::async::sleep_for(ctx, 10ms);
+        }
+
+        // Started after the watcher got created on its shard
+        EXPECT_TRUE(data_sync::capture::start(captureFile));
+        std::ofstream(dataDir / "file") << "data";
+        auto operations = co_await watch->onDataChange();
+        EXPECT_EQ(operations.size(), 1U);
+
+        ctx.request_stop();
+        co_return;
+    };
+
+    ctx.spawn(testTask());
+    ctx.run();
+    data_sync::capture::stop();
+    data_sync::metrics::setEnabled(false);
+
+    EXPECT_GE(data_sync::metrics::histogram(Stage::InotifyRead).count(), 1U);
+    EXPECT_GE(data_sync::metrics::histogram(Stage::EventFilter).count(), 1U);
+
+    // The state of the watcher comes ahead of its events
+    data_sync::capture::FileHeader header{};
+    const auto records = data_sync::capture::readCapture(captureFile, header);
+    ASSERT_GE(records.size(), 3U);
+    EXPECT_EQ(records[0].header.type, data_sync::capture::RecordType::Watcher);
+    EXPECT_EQ(records[1].header.type,
+              data_sync::capture::RecordType::WatchAdded);
+    EXPECT_EQ(records.back().header.type,
+              data_sync::capture::RecordType::Batch);
+
+    watch.reset();
+    data_sync::metrics::reset();
+    fs::remove_all(testDir);
+}
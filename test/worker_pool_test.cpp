@@ -0,0 +1,76 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "worker_pool.hpp"
+
+#include <sdbusplus/async.hpp>
+
+#include <stdexcept>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+using namespace std::literals;
+
+TEST(WorkerPoolTest, TestResultsComeBackToTheLoop)
+{
+    sdbusplus::async::context ctx;
+    data_sync::clock::VirtualClock clock;
+    data_sync::worker::Pool pool(ctx, clock);
+
+    auto testTask = [&]() -> sdbusplus::async::task<> {
+        const auto loopThread = std::this_thread::get_id();
+
+        const auto jobThread = co_await pool.run(
+            []() { return std::this_thread::get_id(); });
+        EXPECT_NE(jobThread, loopThread);
+        EXPECT_EQ(std::this_thread::get_id(), loopThread);
+
+        int counter{0};
+        co_await pool.run([&counter]() { counter = 42; });
+        EXPECT_EQ(counter, 42);
+
+        EXPECT_THROW(co_await pool.run([]() -> int {
+            throw std::runtime_error("Failed job");
+        }),
+                     std::runtime_error);
+
+        ctx.request_stop();
+        co_return;
+    };
+
+    ctx.spawn(testTask());
+    ctx.run();
+}
+
+TEST(WorkerPoolTest, TestBlockingJobDoesNotStallTheLoop)
+{
+    sdbusplus::async::context ctx;
+    data_sync::clock::VirtualClock clock;
+    data_sync::worker::Pool pool(ctx, clock);
+
+    size_t ticks{0};
+    bool jobDone{false};
+
+    auto ticker = [&]() -> sdbusplus::async::task<> {
+        while (!jobDone)
+        {
+            co_await sdbusplus::async::sleep_for(ctx, 10ms);
+            ++ticks;
+        }
+        co_return;
+    };
+
+    auto testTask = [&]() -> sdbusplus::async::task<> {
+        // A stalled flash write, the loop keeps ticking meanwhile
+        co_await pool.run([]() { std::this_thread::sleep_for(300ms); });
+        jobDone = true;
+        EXPECT_GE(ticks, 5U);
+
+        ctx.request_stop();
+        co_return;
+    };
+
+    ctx.spawn(ticker());
+    ctx.spawn(testTask());
+    ctx.run();
+}